@@ -206,6 +206,23 @@ function(wl_test NAME)
   add_dependencies(wl_tests ${NAME})
 endfunction()
 
+# Common benchmark target definition. Benchmarks are standalone binaries that
+# are neither installed nor run by ctest.
+function(wl_benchmark NAME)
+
+  if (NOT OPTION_BUILD_BENCHMARKS)
+    return()
+  endif()
+
+  _parse_common_args("${ARGN}")
+
+  add_executable(${NAME} ${ARG_SRCS})
+
+  _common_compile_tasks()
+
+  add_dependencies(wl_benchmarks ${NAME})
+endfunction()
+
 # Checks a single 'SRC' file using Codecheck and writes a file named
 # codecheck_<shasum of input> if the codecheck did not yield anything. The
 # target for the codecheck will be added as a dependency to 'NAME' for debug
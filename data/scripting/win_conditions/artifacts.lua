@@ -28,14 +28,9 @@ return {
    init = function()
       -- Find all artifacts
       local map = wl.Game().map
-      for x=0, map.width-1 do
-         for y=0, map.height-1 do
-            local field = map:get_field(x,y)
-            if field.immovable and field.immovable:has_attribute("artifact") then
-               -- This assumes that the immovable has size small or medium, i.e. only occupies one field
-               table.insert(artifact_fields, map:get_field(x,y))
-            end
-         end
+      -- This assumes that the immovable has size small or medium, i.e. only occupies one field
+      for i, index in ipairs(map:find_fields{immovable_attribute = "artifact"}) do
+         table.insert(artifact_fields, map:get_field(index % map.width, index // map.width))
       end
    end,
    func = function()
@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2019 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include "base/frame_profiler.h"
+
+#include <chrono>
+#include <limits>
+
+namespace {
+
+// Duration of events whose scope has not been left yet.
+constexpr uint64_t kOpen = std::numeric_limits<uint64_t>::max();
+
+void append_event(const char* name, uint64_t start_us, uint64_t duration_us, std::string* json) {
+	*json += "{\"name\":\"";
+	for (const char* c = name; *c != '\0'; ++c) {
+		if (*c == '"' || *c == '\\') {
+			*json += '\\';
+		}
+		*json += *c;
+	}
+	*json += "\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":";
+	*json += std::to_string(start_us);
+	*json += ",\"dur\":";
+	*json += std::to_string(duration_us);
+	*json += "}";
+}
+
+}  // namespace
+
+constexpr size_t FrameProfiler::kMaxFrames;
+
+void FrameProfiler::Scope::start(FrameProfiler* profiler, const char* name) {
+	if (!profiler->in_frame_ || std::this_thread::get_id() != profiler->thread_) {
+		return;
+	}
+	profiler_ = profiler;
+	frame_serial_ = profiler->frame_serial_;
+	index_ = profiler->current_.events.size();
+	profiler->current_.events.push_back(Event{name, profiler->depth_, profiler->now_us(), kOpen});
+	++profiler->depth_;
+}
+
+void FrameProfiler::Scope::stop() {
+	// The frame might have been ended while we were in this scope.
+	if (!profiler_->in_frame_ || frame_serial_ != profiler_->frame_serial_) {
+		return;
+	}
+	Event& event = profiler_->current_.events[index_];
+	event.duration_us = profiler_->now_us() - event.start_us;
+	--profiler_->depth_;
+}
+
+// static
+FrameProfiler& FrameProfiler::instance() {
+	static FrameProfiler profiler;
+	return profiler;
+}
+
+void FrameProfiler::set_enabled(const bool enabled) {
+	if (enabled == enabled_) {
+		return;
+	}
+	enabled_ = enabled;
+	if (enabled_) {
+		frames_.clear();
+		epoch_us_ = 0;
+		epoch_us_ = now_us();
+	}
+}
+
+void FrameProfiler::begin_frame() {
+	if (in_frame_) {
+		end_frame();
+	}
+	if (!enabled_) {
+		return;
+	}
+	in_frame_ = true;
+	++frame_serial_;
+	depth_ = 0;
+	thread_ = std::this_thread::get_id();
+	current_.events.clear();
+	current_.start_us = now_us();
+}
+
+void FrameProfiler::end_frame() {
+	if (!in_frame_) {
+		return;
+	}
+	in_frame_ = false;
+	const uint64_t now = now_us();
+	current_.duration_us = now - current_.start_us;
+	for (Event& event : current_.events) {
+		if (event.duration_us == kOpen) {
+			event.duration_us = now - event.start_us;
+		}
+	}
+
+	// Reuse the memory of the oldest frame for the next one.
+	Frame recycled;
+	if (frames_.size() == kMaxFrames) {
+		recycled = std::move(frames_.front());
+		frames_.pop_front();
+	}
+	frames_.push_back(std::move(current_));
+	current_ = std::move(recycled);
+}
+
+std::string FrameProfiler::chrome_trace() const {
+	std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	bool first = true;
+	for (const Frame& frame : frames_) {
+		if (!first) {
+			json += ",\n";
+		}
+		first = false;
+		append_event("Frame", frame.start_us, frame.duration_us, &json);
+		for (const Event& event : frame.events) {
+			json += ",\n";
+			append_event(event.name, event.start_us, event.duration_us, &json);
+		}
+	}
+	json += "]}\n";
+	return json;
+}
+
+uint64_t FrameProfiler::now_us() const {
+	return std::chrono::duration_cast<std::chrono::microseconds>(
+	          std::chrono::steady_clock::now().time_since_epoch())
+	          .count() -
+	       epoch_us_;
+}
@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2019 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#ifndef WL_BASE_FRAME_PROFILER_H
+#define WL_BASE_FRAME_PROFILER_H
+
+#include <deque>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <stdint.h>
+
+#include "base/macros.h"
+
+/**
+ * Records how long the named scopes of the main loop take in every frame.
+ *
+ * The main loop calls 'begin_frame' and 'end_frame' around each iteration.
+ * In between, every 'FrameProfiler::Scope' that is created on the thread that
+ * began the frame records an event with its name, start and duration. Scopes
+ * nest, so the events of a frame form a tree. The last 'kMaxFrames' frames are
+ * kept for the overlay and can be exported in the Chrome trace format, which
+ * chrome://tracing and https://ui.perfetto.dev can display.
+ *
+ * When the profiler is disabled, a Scope costs a single branch.
+ */
+class FrameProfiler {
+public:
+	// About 20 seconds at the default of 30 frames per second.
+	static constexpr size_t kMaxFrames = 600;
+
+	struct Event {
+		// The name that was given to the Scope. Must be a string literal.
+		const char* name;
+		// 0 for the outermost scopes of a frame.
+		uint32_t depth;
+		// In microseconds since the profiler was enabled.
+		uint64_t start_us;
+		uint64_t duration_us;
+	};
+
+	struct Frame {
+		uint64_t start_us = 0;
+		uint64_t duration_us = 0;
+		// Ordered by start, parents before their children.
+		std::vector<Event> events;
+	};
+
+	// Records an event from construction to destruction.
+	class Scope {
+	public:
+		explicit Scope(const char* name) {
+			FrameProfiler& profiler = FrameProfiler::instance();
+			if (profiler.enabled_) {
+				start(&profiler, name);
+			}
+		}
+
+		~Scope() {
+			if (profiler_ != nullptr) {
+				stop();
+			}
+		}
+
+	private:
+		void start(FrameProfiler* profiler, const char* name);
+		void stop();
+
+		FrameProfiler* profiler_ = nullptr;
+		size_t index_ = 0;
+		uint32_t frame_serial_ = 0;
+
+		DISALLOW_COPY_AND_ASSIGN(Scope);
+	};
+
+	static FrameProfiler& instance();
+
+	bool enabled() const {
+		return enabled_;
+	}
+
+	// Enabling starts a fresh recording. Disabling keeps the recorded frames
+	// around, so that they can still be exported.
+	void set_enabled(bool enabled);
+
+	// Starts a new frame on the calling thread. If the previous frame has not
+	// ended yet, e.g. because a modal window runs its own main loop, it is ended
+	// here.
+	void begin_frame();
+	void end_frame();
+
+	// The completed frames, oldest first.
+	const std::deque<Frame>& frames() const {
+		return frames_;
+	}
+
+	// Returns all recorded frames as a JSON document in the Chrome trace event
+	// format.
+	std::string chrome_trace() const;
+
+private:
+	FrameProfiler() = default;
+
+	uint64_t now_us() const;
+
+	bool enabled_ = false;
+	bool in_frame_ = false;
+	// Incremented with every frame, so that scopes that outlive their frame
+	// can tell.
+	uint32_t frame_serial_ = 0;
+	uint32_t depth_ = 0;
+	std::thread::id thread_;
+	uint64_t epoch_us_ = 0;
+	Frame current_;
+	std::deque<Frame> frames_;
+
+	DISALLOW_COPY_AND_ASSIGN(FrameProfiler);
+};
+
+#endif  // end of include guard: WL_BASE_FRAME_PROFILER_H
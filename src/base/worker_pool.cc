@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2019 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include "base/worker_pool.h"
+
+#include <algorithm>
+
+namespace {
+
+// More threads do not help for preparing a frame - it is bound by memory
+// bandwidth long before that.
+constexpr unsigned kMaxDrawingThreads = 3;
+
+}  // namespace
+
+WorkerPool::WorkerPool(const unsigned nr_threads) {
+	threads_.reserve(nr_threads);
+	for (unsigned i = 0; i < nr_threads; ++i) {
+		threads_.push_back(std::thread(&WorkerPool::work, this));
+	}
+}
+
+WorkerPool::~WorkerPool() {
+	{
+		std::unique_lock<std::mutex> lock(mutex_);
+		quit_ = true;
+	}
+	work_available_.notify_all();
+	for (std::thread& thread : threads_) {
+		thread.join();
+	}
+}
+
+WorkerPool& WorkerPool::for_drawing() {
+	// hardware_concurrency() returns 0 if it does not know.
+	static WorkerPool pool(
+	   std::min(kMaxDrawingThreads, std::max(1U, std::thread::hardware_concurrency()) - 1));
+	return pool;
+}
+
+WorkerPool& WorkerPool::for_loading() {
+	static WorkerPool pool(std::max(1U, std::thread::hardware_concurrency()) - 1);
+	return pool;
+}
+
+void WorkerPool::run(const size_t nr_tasks, const std::function<void(size_t)>& task) {
+	if (threads_.empty() || nr_tasks < 2) {
+		for (size_t i = 0; i < nr_tasks; ++i) {
+			task(i);
+		}
+		return;
+	}
+
+	std::unique_lock<std::mutex> lock(mutex_);
+	task_ = &task;
+	nr_tasks_ = nr_tasks;
+	next_task_ = 0;
+	nr_finished_ = 0;
+	error_ = nullptr;
+	work_available_.notify_all();
+
+	process_tasks(&lock);
+	work_done_.wait(lock, [this] { return nr_finished_ == nr_tasks_; });
+
+	task_ = nullptr;
+	nr_tasks_ = 0;
+	next_task_ = 0;
+	if (error_) {
+		std::exception_ptr error = error_;
+		error_ = nullptr;
+		std::rethrow_exception(error);
+	}
+}
+
+void WorkerPool::work() {
+	std::unique_lock<std::mutex> lock(mutex_);
+	for (;;) {
+		work_available_.wait(lock, [this] { return quit_ || next_task_ < nr_tasks_; });
+		if (quit_) {
+			return;
+		}
+		process_tasks(&lock);
+	}
+}
+
+void WorkerPool::process_tasks(std::unique_lock<std::mutex>* lock) {
+	while (next_task_ < nr_tasks_) {
+		const size_t index = next_task_++;
+		const std::function<void(size_t)>& task = *task_;
+		lock->unlock();
+		std::exception_ptr error;
+		try {
+			task(index);
+		} catch (...) {
+			error = std::current_exception();
+		}
+		lock->lock();
+		if (error && !error_) {
+			error_ = error;
+		}
+		if (++nr_finished_ == nr_tasks_) {
+			work_done_.notify_one();
+		}
+	}
+}
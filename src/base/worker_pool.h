@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2019 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#ifndef WL_BASE_WORKER_POOL_H
+#define WL_BASE_WORKER_POOL_H
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "base/macros.h"
+
+/**
+ * A small set of threads that stay around to split up work that is done over
+ * and over again, like preparing the fields to draw for every frame.
+ *
+ * 'run' hands out task indices to the workers and to the calling thread and
+ * returns when all tasks have finished. The tasks must not depend on each other.
+ * Only one thread may call 'run' at a time.
+ */
+class WorkerPool {
+public:
+	// Starts 'nr_threads' worker threads. With 0 threads, all tasks are run by
+	// the calling thread.
+	explicit WorkerPool(unsigned nr_threads);
+	~WorkerPool();
+
+	// The number of threads that work on the tasks, including the calling thread.
+	unsigned concurrency() const {
+		return threads_.size() + 1;
+	}
+
+	// Calls 'task(i)' for every i in [0, 'nr_tasks') and waits until all calls
+	// have returned. If a task throws, the first exception is rethrown here after
+	// the other tasks have finished.
+	void run(size_t nr_tasks, const std::function<void(size_t)>& task);
+
+	// A pool with one thread less than the machine has cores, shared by
+	// everything that prepares a frame for drawing.
+	static WorkerPool& for_drawing();
+
+	// A pool with one thread less than the machine has cores for loading data,
+	// e.g. decoding images. Must only be used from the main thread.
+	static WorkerPool& for_loading();
+
+private:
+	void work();
+
+	// Runs tasks until all of them have been handed out. 'lock' must be held on
+	// entry and is held again on return.
+	void process_tasks(std::unique_lock<std::mutex>* lock);
+
+	std::vector<std::thread> threads_;
+
+	// Everything below is protected by 'mutex_'.
+	std::mutex mutex_;
+	std::condition_variable work_available_;
+	std::condition_variable work_done_;
+	const std::function<void(size_t)>* task_ = nullptr;
+	size_t nr_tasks_ = 0;
+	size_t next_task_ = 0;
+	size_t nr_finished_ = 0;
+	std::exception_ptr error_;
+	bool quit_ = false;
+
+	DISALLOW_COPY_AND_ASSIGN(WorkerPool);
+};
+
+#endif  // end of include guard: WL_BASE_WORKER_POOL_H
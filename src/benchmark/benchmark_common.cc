@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2019 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include "benchmark/benchmark_common.h"
+
+#include <SDL.h>
+
+#include "base/wexception.h"
+#include "graphic/graphic.h"
+#include "io/filesystem/filesystem.h"
+#include "io/filesystem/layered_filesystem.h"
+#include "logic/field.h"
+#include "logic/map_objects/immovable.h"
+#include "sound/sound_handler.h"
+
+void initialize_benchmark(const std::string& datadir,
+                          const int window_width,
+                          const int window_height) {
+	if (SDL_Init(SDL_INIT_VIDEO) != 0) {
+		throw wexception("Unable to initialize SDL: %s", SDL_GetError());
+	}
+
+	g_fs = new LayeredFileSystem();
+	g_fs->add_file_system(&FileSystem::create(datadir));
+	// The map objects need their images, even if nothing is drawn.
+	g_gr = new Graphic();
+	g_gr->initialize(Graphic::TraceGl::kNo, window_width, window_height, false);
+	SoundHandler::disable_backend();
+	g_sh = new SoundHandler();
+}
+
+void cleanup_benchmark() {
+	delete g_sh;
+	g_sh = nullptr;
+	delete g_gr;
+	g_gr = nullptr;
+	delete g_fs;
+	g_fs = nullptr;
+	SDL_Quit();
+}
+
+double ms_since(const std::chrono::steady_clock::time_point& start) {
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() -
+	                                                             start)
+	          .count() /
+	       1000.;
+}
+
+bool NodeState::operator==(const NodeState& other) const {
+	return height == other.height && brightness == other.brightness && border == other.border &&
+	       caps == other.caps && max_caps == other.max_caps && terrain_r == other.terrain_r &&
+	       terrain_d == other.terrain_d && resources == other.resources && amount == other.amount &&
+	       initial_amount == other.initial_amount && immovable == other.immovable;
+}
+
+std::vector<NodeState> node_states(const Widelands::Map& map) {
+	std::vector<NodeState> result;
+	result.reserve(map.max_index());
+	for (Widelands::MapIndex i = 0; i < map.max_index(); ++i) {
+		const Widelands::Field& field = map[i];
+		const Widelands::BaseImmovable* immovable = field.get_immovable();
+		result.push_back(NodeState{field.get_height(), field.get_brightness(), field.is_border(),
+		                           static_cast<uint8_t>(field.nodecaps()),
+		                           static_cast<uint8_t>(field.maxcaps()), field.terrain_r(),
+		                           field.terrain_d(), field.get_resources(),
+		                           field.get_resources_amount(), field.get_initial_res_amount(),
+		                           immovable ? immovable->descr().name() : ""});
+	}
+	return result;
+}
@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2019 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#ifndef WL_BENCHMARK_BENCHMARK_COMMON_H
+#define WL_BENCHMARK_BENCHMARK_COMMON_H
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <stdint.h>
+
+#include "logic/field.h"
+#include "logic/map.h"
+#include "logic/widelands.h"
+
+// Sets up what loading maps and map objects needs, even though the benchmarks
+// draw nothing or only to a window of 'window_width' x 'window_height': SDL,
+// 'datadir' in g_fs, g_gr and g_sh without a sound backend.
+void initialize_benchmark(const std::string& datadir, int window_width = 1, int window_height = 1);
+
+// Cleanup before program end
+void cleanup_benchmark();
+
+// The wall clock time since 'start' in ms.
+double ms_since(const std::chrono::steady_clock::time_point& start);
+
+// What is stored or calculated for a node, for checking that two ways of
+// getting a map give the same nodes.
+struct NodeState {
+	uint8_t height;
+	int8_t brightness;
+	bool border;
+	uint8_t caps;
+	uint8_t max_caps;
+	Widelands::DescriptionIndex terrain_r;
+	Widelands::DescriptionIndex terrain_d;
+	Widelands::DescriptionIndex resources;
+	Widelands::Field::ResourceAmount amount;
+	Widelands::Field::ResourceAmount initial_amount;
+	std::string immovable;
+
+	bool operator==(const NodeState& other) const;
+};
+
+std::vector<NodeState> node_states(const Widelands::Map& map);
+
+#endif  // end of include guard: WL_BENCHMARK_BENCHMARK_COMMON_H
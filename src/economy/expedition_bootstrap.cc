@@ -26,8 +26,8 @@
 #include "economy/portdock.h"
 #include "economy/wares_queue.h"
 #include "economy/workers_queue.h"
-#include "io/fileread.h"
 #include "io/filewrite.h"
+#include "io/streamread.h"
 #include "logic/map_objects/tribes/warehouse.h"
 #include "logic/player.h"
 #include "map_io/map_object_loader.h"
@@ -216,7 +216,7 @@ void ExpeditionBootstrap::save(FileWrite& fw, Game& game, MapObjectSaver& mos) {
 }
 
 void ExpeditionBootstrap::load(Warehouse& warehouse,
-                               FileRead& fr,
+                               StreamRead& fr,
                                Game& game,
                                MapObjectLoader& mol,
                                const TribesLegacyLookupTable& tribes_lookup_table,
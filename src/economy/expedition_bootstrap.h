@@ -88,7 +88,7 @@ public:
 	 * packet, and there in the warehouse data packet.
 	 */
 	void load(Warehouse& warehouse,
-	          FileRead& fr,
+	          StreamRead& fr,
 	          Game& game,
 	          MapObjectLoader& mol,
 	          const TribesLegacyLookupTable& tribes_lookup_table,
@@ -22,8 +22,8 @@
 #include "base/wexception.h"
 #include "economy/economy.h"
 #include "economy/request.h"
-#include "io/fileread.h"
 #include "io/filewrite.h"
+#include "io/streamread.h"
 #include "logic/editor_game_base.h"
 #include "logic/game.h"
 #include "logic/map_objects/tribes/tribe_descr.h"
@@ -130,7 +130,7 @@ uint32_t InputQueue::get_missing() const {
 
 constexpr uint16_t kCurrentPacketVersion = 3;
 
-void InputQueue::read(FileRead& fr,
+void InputQueue::read(StreamRead& fr,
                       Game& game,
                       MapObjectLoader& mol,
                       const TribesLegacyLookupTable& tribes_lookup_table) {
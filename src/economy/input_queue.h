@@ -184,7 +184,7 @@ public:
 	 * @param game The game this queue will be part of.
 	 * @param mol The game/map loader that handles the lading. Required to pass to Request::read().
 	 */
-	void read(FileRead& f,
+	void read(StreamRead& f,
 	          Game& g,
 	          MapObjectLoader& mol,
 	          const TribesLegacyLookupTable& tribes_lookup_table);
@@ -248,7 +248,7 @@ protected:
 	 * @param game The game this queue will be part of.
 	 * @param mol The game/map loader that handles the loading.
 	 */
-	virtual void read_child(FileRead& f, Game& g, MapObjectLoader& mol) = 0;
+	virtual void read_child(StreamRead& f, Game& g, MapObjectLoader& mol) = 0;
 
 	/**
 	 * Writes the state of the subclass.
@@ -24,8 +24,8 @@
 #include "economy/portdock.h"
 #include "economy/transfer.h"
 #include "economy/ware_instance.h"
-#include "io/fileread.h"
 #include "io/filewrite.h"
+#include "io/streamread.h"
 #include "logic/game.h"
 #include "logic/map_objects/tribes/constructionsite.h"
 #include "logic/map_objects/tribes/productionsite.h"
@@ -98,7 +98,7 @@ constexpr uint16_t kCurrentPacketVersion = 6;
  * might have been initialized. We have to kill them and replace
  * them through the data in the file
  */
-void Request::read(FileRead& fr,
+void Request::read(StreamRead& fr,
                    Game& game,
                    MapObjectLoader& mol,
                    const TribesLegacyLookupTable& tribes_lookup_table) {
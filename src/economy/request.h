@@ -26,8 +26,8 @@
 #include "logic/widelands.h"
 #include "map_io/tribes_legacy_lookup_table.h"
 
-class FileRead;
 class FileWrite;
+class StreamRead;
 
 namespace Widelands {
 
@@ -118,7 +118,7 @@ public:
 	void start_transfer(Game&, Supply&);
 
 	void
-	read(FileRead&, Game&, MapObjectLoader&, const TribesLegacyLookupTable& tribes_lookup_table);
+	read(StreamRead&, Game&, MapObjectLoader&, const TribesLegacyLookupTable& tribes_lookup_table);
 	void write(FileWrite&, Game&, MapObjectSaver&) const;
 	Worker* get_transfer_worker();
 
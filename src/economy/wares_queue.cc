@@ -22,8 +22,8 @@
 #include "base/wexception.h"
 #include "economy/economy.h"
 #include "economy/request.h"
-#include "io/fileread.h"
 #include "io/filewrite.h"
+#include "io/streamread.h"
 #include "logic/editor_game_base.h"
 #include "logic/game.h"
 #include "logic/map_objects/tribes/tribe_descr.h"
@@ -118,7 +118,7 @@ void WaresQueue::write_child(FileWrite& fw, Game&, MapObjectSaver&) {
 	fw.signed_32(filled_);
 }
 
-void WaresQueue::read_child(FileRead& fr, Game&, MapObjectLoader&) {
+void WaresQueue::read_child(StreamRead& fr, Game&, MapObjectLoader&) {
 	uint16_t const packet_version = fr.unsigned_16();
 	try {
 		if (packet_version == kCurrentPacketVersion) {
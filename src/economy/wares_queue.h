@@ -59,7 +59,7 @@ public:
 	void set_filled(Quantity) override;
 
 protected:
-	void read_child(FileRead&, Game&, MapObjectLoader&) override;
+	void read_child(StreamRead&, Game&, MapObjectLoader&) override;
 	void write_child(FileWrite&, Game&, MapObjectSaver&) override;
 
 	void entered(DescriptionIndex index, Worker* worker) override;
@@ -22,8 +22,8 @@
 #include "base/wexception.h"
 #include "economy/economy.h"
 #include "economy/request.h"
-#include "io/fileread.h"
 #include "io/filewrite.h"
+#include "io/streamread.h"
 #include "logic/editor_game_base.h"
 #include "logic/game.h"
 #include "logic/map_objects/tribes/tribe_descr.h"
@@ -192,7 +192,7 @@ void WorkersQueue::write_child(FileWrite& fw, Game&, MapObjectSaver& mos) {
 	}
 }
 
-void WorkersQueue::read_child(FileRead& fr, Game&, MapObjectLoader& mol) {
+void WorkersQueue::read_child(StreamRead& fr, Game&, MapObjectLoader& mol) {
 	uint16_t const packet_version = fr.unsigned_16();
 	try {
 		if (packet_version == kCurrentPacketVersion) {
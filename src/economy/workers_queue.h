@@ -70,7 +70,7 @@ public:
 	Worker* extract_worker();
 
 protected:
-	void read_child(FileRead&, Game&, MapObjectLoader&) override;
+	void read_child(StreamRead&, Game&, MapObjectLoader&) override;
 	void write_child(FileWrite&, Game&, MapObjectSaver&) override;
 
 	void entered(DescriptionIndex index, Worker* worker) override;
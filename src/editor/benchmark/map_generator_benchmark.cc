@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2019 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+// Measures how long generating random maps of the largest size takes, once
+// with everything on the calling thread and once with the worker pool for
+// loading. Also checks that both give the same nodes, since a map id must
+// always give the same map. The times are wall clock times.
+//
+// Usage: editor_map_generator_benchmark <data directory> [maps] [runs]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "base/log.h"
+#include "base/worker_pool.h"
+#include "benchmark/benchmark_common.h"
+#include "editor/map_generator.h"
+#include "logic/editor_game_base.h"
+#include "logic/map.h"
+
+namespace {
+
+constexpr uint32_t kMapSize = 512;
+
+Widelands::UniqueRandomMapInfo map_info(const uint32_t map_number) {
+	Widelands::UniqueRandomMapInfo result;
+	result.mapNumber = map_number;
+	result.w = kMapSize;
+	result.h = kMapSize;
+	result.resource_amount = Widelands::UniqueRandomMapInfo::raMedium;
+	result.world_name = "greenland";
+	result.waterRatio = 0.2;
+	result.landRatio = 0.6;
+	result.wastelandRatio = 0.1;
+	result.numPlayers = 4;
+	result.islandMode = false;
+	return result;
+}
+
+// Returns the fastest of 'nr_runs' runs in ms. The last generated map stays in
+// 'egbase'.
+double time_generator(const Widelands::UniqueRandomMapInfo& info,
+                      Widelands::EditorGameBase* egbase,
+                      WorkerPool* pool,
+                      const int nr_runs) {
+	double fastest = 0.;
+	for (int run = 0; run < nr_runs; ++run) {
+		egbase->cleanup_objects();
+		Widelands::Map* map = egbase->mutable_map();
+		Widelands::MapGenerator generator(*map, info, *egbase);
+		map->create_empty_map(*egbase, info.w, info.h, 0, "Benchmark", "Benchmark", "Benchmark");
+
+		const auto start = std::chrono::steady_clock::now();
+		generator.create_random_map(*pool);
+		const double duration = ms_since(start);
+		fastest = run == 0 ? duration : std::min(fastest, duration);
+	}
+	return fastest;
+}
+
+// Returns false if the worker pool gave a different map.
+bool benchmark_map(const uint32_t map_number, const int nr_runs) {
+	Widelands::EditorGameBase egbase(nullptr);
+	// The world is loaded on first use, which is not part of generating the map.
+	egbase.world();
+	egbase.tribes();
+
+	const Widelands::UniqueRandomMapInfo info = map_info(map_number);
+	std::string id;
+	Widelands::UniqueRandomMapInfo::generate_id_string(id, info);
+
+	WorkerPool serial(0);
+	const double serial_ms = time_generator(info, &egbase, &serial, nr_runs);
+	const std::vector<NodeState> serial_nodes = node_states(egbase.map());
+
+	WorkerPool& pool = WorkerPool::for_loading();
+	const double parallel_ms = time_generator(info, &egbase, &pool, nr_runs);
+	const bool identical = node_states(egbase.map()) == serial_nodes;
+
+	log("%s (%ux%u)\n", id.c_str(), info.w, info.h);
+	log("   create_random_map, 1 thread:   %8.2f ms\n", serial_ms);
+	log("   create_random_map, %2u threads: %8.2f ms (%.1fx)%s\n", pool.concurrency(), parallel_ms,
+	    parallel_ms > 0. ? serial_ms / parallel_ms : 0., identical ? "" : " DIFFERENT NODES");
+
+	egbase.cleanup_objects();
+	return identical;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+	if (!(2 <= argc && argc <= 4)) {
+		log("Usage: %s <data directory> [maps] [runs]\n", argv[0]);
+		return 1;
+	}
+	const int nr_maps = argc >= 3 ? std::max(1, atoi(argv[2])) : 3;
+	const int nr_runs = argc == 4 ? std::max(1, atoi(argv[3])) : 3;
+
+	bool all_identical = true;
+	try {
+		initialize_benchmark(argv[1]);
+
+		for (int i = 0; i < nr_maps; ++i) {
+			all_identical &= benchmark_map(1234567 * (i + 1), nr_runs);
+		}
+
+		cleanup_benchmark();
+	} catch (const std::exception& e) {
+		log("Exception: %s.\n", e.what());
+		return 1;
+	}
+	return all_identical ? 0 : 1;
+}
@@ -19,11 +19,15 @@
 
 #include "editor/map_generator.h"
 
+#include <algorithm>
+#include <functional>
 #include <memory>
+#include <vector>
 
 #include <stdint.h>
 
 #include "base/wexception.h"
+#include "base/worker_pool.h"
 #include "editor/tools/increase_resources_tool.h"
 #include "logic/editor_game_base.h"
 #include "logic/map.h"
@@ -40,8 +44,26 @@ constexpr int kMapIdDigits = 24;
 constexpr int kIslandBorder = 10;
 constexpr uint32_t kMaxElevationHalf = 0x80000000;
 
+// The random value maps that come before the ones for the bobs.
+constexpr size_t kNrTerrainValueMaps = 8;
+
 namespace Widelands {
 
+namespace {
+
+// Steps to the next, finer refinement of a random value map. Returns false
+// after the finest one.
+bool next_refinement(uint32_t* step_x, uint32_t* step_y) {
+	if (*step_x == 2 && *step_y == 2) {
+		return false;
+	}
+	*step_x = std::max(2U, *step_x / 2);
+	*step_y = std::max(2U, *step_y / 2);
+	return true;
+}
+
+}  // namespace
+
 MapGenerator::MapGenerator(Map& map, const UniqueRandomMapInfo& mapInfo, EditorGameBase& egbase)
    : map_(map), map_info_(mapInfo), egbase_(egbase) {
 	std::unique_ptr<LuaTable> map_gen_config(egbase.lua().run_script("world/map_generation.lua"));
@@ -277,9 +299,7 @@ uint32_t* MapGenerator::generate_random_value_map(uint32_t const w, uint32_t con
 		uint32_t max = kAverageElevation, min = kAverageElevation;
 		double ele_fac = 0.15;
 
-		bool end = false;
-
-		while (!end) {
+		do {
 			for (uint32_t x = 0; x < w; x += step_x) {
 				for (uint32_t y = 0; y < h; y += step_y) {
 					//  Calculate coordinates of left and bottom left neighbours of
@@ -335,17 +355,8 @@ uint32_t* MapGenerator::generate_random_value_map(uint32_t const w, uint32_t con
 				}
 			}
 
-			//  preparations for the next iteration
-			if (step_y == 2 && step_x == 2)
-				end = true;
-			step_x /= 2;
-			step_y /= 2;
-			if (step_x <= 1)
-				step_x = 2;
-			if (step_y <= 1)
-				step_y = 2;
 			ele_fac *= 0.9;
-		}
+		} while (next_refinement(&step_x, &step_y));
 
 		//  make a histogram of the heights
 
@@ -354,13 +365,13 @@ uint32_t* MapGenerator::generate_random_value_map(uint32_t const w, uint32_t con
 		for (uint32_t x = 0; x < 1024; ++x)
 			histo[x] = 0;
 
-		for (uint32_t x = 0; x < w; ++x)
-			for (uint32_t y = 0; y < h; ++y) {
-				values[x + y * w] =
-				   ((static_cast<double>(values[x + y * w] - min)) / static_cast<double>(max - min)) *
-				   kMaxElevation;
-				++histo[values[x + y * w] >> 22];
-			}
+		//  The order does not matter for the histogram, so go through the array
+		//  front to back.
+		const double range = static_cast<double>(max - min);
+		for (uint32_t ix = 0; ix < numFields; ++ix) {
+			values[ix] = ((static_cast<double>(values[ix] - min)) / range) * kMaxElevation;
+			++histo[values[ix] >> 22];
+		}
 
 		//  sort the histo out
 
@@ -375,10 +386,8 @@ uint32_t* MapGenerator::generate_random_value_map(uint32_t const w, uint32_t con
 
 		//  Adjust the heights so that all height values are equal of density.
 		//  This is done to have reliable water/land ratio later on.
-		for (uint32_t x = 0; x < w; ++x)
-			for (uint32_t y = 0; y < h; ++y)
-				values[x + y * w] =
-				   minVals[values[x + y * w] >> 22] * static_cast<double>(kMaxElevation);
+		for (uint32_t ix = 0; ix < numFields; ++ix)
+			values[ix] = minVals[values[ix] >> 22] * static_cast<double>(kMaxElevation);
 		return values;
 	} catch (...) {
 		delete[] values;
@@ -387,8 +396,42 @@ uint32_t* MapGenerator::generate_random_value_map(uint32_t const w, uint32_t con
 	NEVER_HERE();
 }
 
+std::vector<std::unique_ptr<uint32_t[]>> MapGenerator::generate_random_value_maps(
+   uint32_t const w, uint32_t const h, size_t const nr_maps, RNG* rng, WorkerPool& pool) {
+	//  Each map takes a fixed number of values from the rng, so we can start a
+	//  copy of the rng for each one where it would have started when creating
+	//  the maps one after the other, and create them all at once. This gives
+	//  the same map for a map number however many threads we have.
+	const uint32_t nr_values = nr_random_values(w, h);
+	std::vector<RNG> rngs;
+	rngs.reserve(nr_maps);
+	for (size_t ix = 0; ix < nr_maps; ++ix) {
+		rngs.push_back(*rng);
+		for (uint32_t value = 0; value < nr_values; ++value) {
+			rng->rand();
+		}
+	}
+
+	std::vector<std::unique_ptr<uint32_t[]>> result(nr_maps);
+	pool.run(nr_maps, [w, h, &result, &rngs](const size_t ix) {
+		result[ix].reset(generate_random_value_map(w, h, rngs[ix]));
+	});
+	return result;
+}
+
+uint32_t MapGenerator::nr_random_values(uint32_t const w, uint32_t const h) {
+	//  The starting values, then three values for every cell of every refinement.
+	uint32_t result = ((w + 15) / 16) * ((h + 15) / 16);
+	uint32_t step_x = std::min(16U, w), step_y = std::min(16U, h);
+	do {
+		result += 3 * ((w + step_x - 1) / step_x) * ((h + step_y - 1) / step_y);
+	} while (next_refinement(&step_x, &step_y));
+	return result;
+}
+
 /**
- * Figures out terrain info for a field in a random map.
+ * Figures out which area and terrain type a triangle in a random map belongs to.
+ * This only reads the map, so it can be called for many triangles at once.
  *
  * \param map_gen_info_  Map generator information used to translate
  *                     random values to height information (world-
@@ -404,22 +447,16 @@ uint32_t* MapGenerator::generate_random_value_map(uint32_t const w, uint32_t con
  * \param h1, h2, h3   Map height information for the three triangle coords.
  * \param mapInfo      Information about the random map currently
  *                     being created (map specific info).
- * \param rng          The random number generator to be used.
- *                     This will mostly be the current rng of the random map
- *                     currently being created.
- * \param terrType     Returns the terrain type for this triangle.
  */
-DescriptionIndex MapGenerator::figure_out_terrain(uint32_t* const random2,
-                                                  uint32_t* const random3,
-                                                  uint32_t* const random4,
-                                                  const Coords& c0,
-                                                  const Coords& c1,
-                                                  const Coords& c2,
-                                                  uint32_t const h1,
-                                                  uint32_t const h2,
-                                                  uint32_t const h3,
-                                                  RNG& rng,
-                                                  MapGenAreaInfo::MapGenTerrainType& terrType) {
+MapGenerator::TerrainArea MapGenerator::figure_out_terrain_area(uint32_t const* const random2,
+                                                                uint32_t const* const random3,
+                                                                uint32_t const* const random4,
+                                                                const Coords& c0,
+                                                                const Coords& c1,
+                                                                const Coords& c2,
+                                                                uint32_t const h1,
+                                                                uint32_t const h2,
+                                                                uint32_t const h3) const {
 	uint32_t numLandAreas = map_gen_info_->get_num_areas(MapGenAreaInfo::atLand);
 	uint32_t const numWasteLandAreas = map_gen_info_->get_num_areas(MapGenAreaInfo::atWasteland);
 
@@ -552,16 +589,27 @@ DescriptionIndex MapGenerator::figure_out_terrain(uint32_t* const random2,
 		                                                            MapGenAreaInfo::ttWastelandInner;
 	}
 
-	// Return terrain type
-	terrType = ttp;
+	return TerrainArea{atp, usedLandIndex, ttp};
+}
 
-	//  Figure out which terrain to use at this point in the map...
-	return map_gen_info_->get_area(atp, usedLandIndex)
-	   .get_terrain(
-	      ttp, rng.rand() % map_gen_info_->get_area(atp, usedLandIndex).get_num_terrains(ttp));
+/**
+ * Figures out which terrain to use for a triangle in 'area'.
+ *
+ * \param rng  The random number generator to be used.
+ *             This will mostly be the current rng of the random map
+ *             currently being created.
+ */
+DescriptionIndex MapGenerator::pick_terrain(const TerrainArea& area, RNG& rng) const {
+	const MapGenAreaInfo& area_info = map_gen_info_->get_area(area.area_type, area.area_index);
+	return area_info.get_terrain(
+	   area.terrain_type, rng.rand() % area_info.get_num_terrains(area.terrain_type));
 }
 
 void MapGenerator::create_random_map() {
+	create_random_map(WorkerPool::for_loading());
+}
+
+void MapGenerator::create_random_map(WorkerPool& pool) {
 	//  Init random number generator with map number
 
 	//  We will use our own random number generator here so we do not influence
@@ -570,45 +618,58 @@ void MapGenerator::create_random_map() {
 
 	rng.seed(map_info_.mapNumber);
 
-	//  Create a "raw" random elevation matrix.
-	//  We will transform this into reasonable elevations and terrains later on.
-
-	std::unique_ptr<uint32_t[]> elevations(generate_random_value_map(map_info_.w, map_info_.h, rng));
-
-	//  for land stuff
-	std::unique_ptr<uint32_t[]> random2(generate_random_value_map(map_info_.w, map_info_.h, rng));
-	std::unique_ptr<uint32_t[]> random3(generate_random_value_map(map_info_.w, map_info_.h, rng));
-
-	//  for desert/land
-	std::unique_ptr<uint32_t[]> random4(generate_random_value_map(map_info_.w, map_info_.h, rng));
-
-	// for resources
-	std::unique_ptr<uint32_t[]> random_rsrc_1(
-	   generate_random_value_map(map_info_.w, map_info_.h, rng));
-	std::unique_ptr<uint32_t[]> random_rsrc_2(
-	   generate_random_value_map(map_info_.w, map_info_.h, rng));
-	std::unique_ptr<uint32_t[]> random_rsrc_3(
-	   generate_random_value_map(map_info_.w, map_info_.h, rng));
-	std::unique_ptr<uint32_t[]> random_rsrc_4(
-	   generate_random_value_map(map_info_.w, map_info_.h, rng));
-
-	// for bobs
-	std::unique_ptr<std::unique_ptr<uint32_t[]>[]> random_bobs(
-	   new std::unique_ptr<uint32_t[]>[map_gen_info_->get_num_land_resources()]);
-
-	for (size_t ix = 0; ix < map_gen_info_->get_num_land_resources(); ++ix)
-		random_bobs[ix].reset(generate_random_value_map(map_info_.w, map_info_.h, rng));
+	//  Create "raw" random value matrices: the elevations, two for land
+	//  stuff, one for desert/land, four for resources and then one for every
+	//  kind of bobs. We will transform these into reasonable elevations and
+	//  terrains later on.
+	const std::vector<std::unique_ptr<uint32_t[]>> value_maps = generate_random_value_maps(
+	   map_info_.w, map_info_.h, kNrTerrainValueMaps + map_gen_info_->get_num_land_resources(),
+	   &rng, pool);
+
+	uint32_t const* const elevations = value_maps[0].get();
+	uint32_t const* const random2 = value_maps[1].get();
+	uint32_t const* const random3 = value_maps[2].get();
+	uint32_t const* const random4 = value_maps[3].get();
+	uint32_t const* const random_rsrc_1 = value_maps[4].get();
+	uint32_t const* const random_rsrc_2 = value_maps[5].get();
+	uint32_t const* const random_rsrc_3 = value_maps[6].get();
+	uint32_t const* const random_rsrc_4 = value_maps[7].get();
+	std::unique_ptr<uint32_t[]> const* const random_bobs = value_maps.data() + kNrTerrainValueMaps;
 
 	//  Now we have generated a lot of random data!!
 	//  Lets use it !!!
-	iterate_Map_FCoords(map_, map_info_, fc) fc.field->set_height(
-	   make_node_elevation(static_cast<double>(elevations[fc.x + map_info_.w * fc.y]) /
-	                          static_cast<double>(kMaxElevation),
-	                       fc));
+	//  Everything that does not need the rng is done by bands of rows in
+	//  parallel.
+	constexpr uint32_t kRowsPerBand = 8;
+	const size_t nr_bands = (map_info_.h + kRowsPerBand - 1) / kRowsPerBand;
+	const auto for_each_node = [this, &pool, nr_bands](
+	                              const std::function<void(const FCoords&)>& function) {
+		pool.run(nr_bands, [this, &function](const size_t band) {
+			const uint32_t end = std::min<uint32_t>(map_info_.h, (band + 1) * kRowsPerBand);
+			for (uint32_t y = band * kRowsPerBand; y < end; ++y) {
+				for (uint32_t x = 0; x < map_info_.w; ++x) {
+					function(map_.get_fcoords(Coords(x, y)));
+				}
+			}
+		});
+	};
 
-	//  Now lets set the terrain right according to the heights.
+	for_each_node([this, elevations](const FCoords& fc) {
+		fc.field->set_height(
+		   make_node_elevation(static_cast<double>(elevations[fc.x + map_info_.w * fc.y]) /
+		                          static_cast<double>(kMaxElevation),
+		                       fc));
+	});
 
-	iterate_Map_FCoords(map_, map_info_, fc) {
+	//  Now lets set the terrain right according to the heights. Which areas the
+	//  triangles belong to only depends on the heights, so that is figured out
+	//  for the d and r triangles of all nodes first.
+
+	// Filled lazily, which must not happen on the workers.
+	map_gen_info_->get_sum_land_weight();
+
+	std::vector<TerrainArea> terrain_areas(2 * map_.max_index());
+	for_each_node([this, random2, random3, random4, &terrain_areas](const FCoords& fc) {
 		//  Calculate coordinates of left and bottom left neighbours of the
 		//  current node.
 
@@ -638,26 +699,31 @@ void MapGenerator::create_random_map() {
 		uint8_t height_x0_y1 = map_[Coords(lower_x, lower_y)].get_height();
 		uint8_t height_x1_y1 = map_[Coords(lower_right_x, lower_y)].get_height();
 
-		MapGenAreaInfo::MapGenTerrainType terrType;
-
-		fc.field->set_terrain_d(figure_out_terrain(
-		   random2.get(), random3.get(), random4.get(), fc, Coords(lower_x, lower_y),
-		   Coords(lower_right_x, lower_y), height_x0_y0, height_x0_y1, height_x1_y1, rng, terrType));
-
-		fc.field->set_terrain_r(figure_out_terrain(
-		   random2.get(), random3.get(), random4.get(), fc, Coords(right_x, fc.y),
-		   Coords(lower_right_x, lower_y), height_x0_y0, height_x1_y0, height_x1_y1, rng, terrType));
+		const size_t ix = 2 * (fc.x + map_info_.w * fc.y);
+		terrain_areas[ix] = figure_out_terrain_area(
+		   random2, random3, random4, fc, Coords(lower_x, lower_y), Coords(lower_right_x, lower_y),
+		   height_x0_y0, height_x0_y1, height_x1_y1);
+		terrain_areas[ix + 1] = figure_out_terrain_area(
+		   random2, random3, random4, fc, Coords(right_x, fc.y), Coords(lower_right_x, lower_y),
+		   height_x0_y0, height_x1_y0, height_x1_y1);
+	});
+
+	//  The terrains, resources and bobs take values from the rng in the order of
+	//  the nodes, and the resources depend on the terrains set so far.
+	iterate_Map_FCoords(map_, map_info_, fc) {
+		const size_t ix = 2 * (fc.x + map_info_.w * fc.y);
+		fc.field->set_terrain_d(pick_terrain(terrain_areas[ix], rng));
+		fc.field->set_terrain_r(pick_terrain(terrain_areas[ix + 1], rng));
 
 		//  set resources for this field
-		generate_resources(
-		   random_rsrc_1.get(), random_rsrc_2.get(), random_rsrc_3.get(), random_rsrc_4.get(), fc);
+		generate_resources(random_rsrc_1, random_rsrc_2, random_rsrc_3, random_rsrc_4, fc);
 
 		// set bobs and immovables for this field
-		generate_bobs(random_bobs.get(), fc, rng, terrType);
+		generate_bobs(random_bobs, fc, rng, terrain_areas[ix + 1].terrain_type);
 	}
 
 	//  Aftermaths...
-	map_.recalc_whole_map(egbase_);
+	map_.recalc_whole_map(egbase_, pool);
 
 	// Care about players and place their start positions
 	map_.set_nrplayers(map_info_.numPlayers);
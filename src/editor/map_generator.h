@@ -21,11 +21,13 @@
 #define WL_EDITOR_MAP_GENERATOR_H
 
 #include <memory>
+#include <vector>
 
 #include "logic/map_objects/world/map_gen.h"
 #include "logic/widelands_geometry.h"
 
 struct RNG;
+class WorkerPool;
 
 namespace Widelands {
 
@@ -74,9 +76,32 @@ struct MapGenerator {
 
 	MapGenerator(Map& map, const UniqueRandomMapInfo& mapInfo, EditorGameBase& egbase);
 
+	/**
+	 * Generates the map. The random value maps, the heights and the areas of
+	 * the terrains are calculated by the threads of 'pool'. The map comes out
+	 * the same for any number of threads, so a map id always gives the same map.
+	 * The first version uses WorkerPool::for_loading(), so it must only be
+	 * called from the main thread.
+	 */
 	void create_random_map();
+	void create_random_map(WorkerPool& pool);
+
+	/**
+	 * Generates 'nr_maps' random value maps of 'w' x 'h' values on the threads
+	 * of 'pool'. The maps and the state that 'rng' is left in are the same as
+	 * when the maps are generated one after the other with 'rng'.
+	 */
+	static std::vector<std::unique_ptr<uint32_t[]>>
+	generate_random_value_maps(uint32_t w, uint32_t h, size_t nr_maps, RNG* rng, WorkerPool& pool);
 
 private:
+	// What the terrain of a triangle is chosen from.
+	struct TerrainArea {
+		MapGenAreaInfo::MapGenAreaType area_type;
+		uint32_t area_index;
+		MapGenAreaInfo::MapGenTerrainType terrain_type;
+	};
+
 	void generate_bobs(std::unique_ptr<uint32_t[]> const* random_bobs,
 	                   const Coords&,
 	                   RNG&,
@@ -92,17 +117,20 @@ private:
 
 	static uint32_t* generate_random_value_map(uint32_t w, uint32_t h, RNG& rng);
 
-	DescriptionIndex figure_out_terrain(uint32_t* const random2,
-	                                    uint32_t* const random3,
-	                                    uint32_t* const random4,
+	// How many values 'generate_random_value_map' draws from its 'rng'.
+	static uint32_t nr_random_values(uint32_t w, uint32_t h);
+
+	TerrainArea figure_out_terrain_area(uint32_t const* const random2,
+	                                    uint32_t const* const random3,
+	                                    uint32_t const* const random4,
 	                                    const Coords& c0,
 	                                    const Coords& c1,
 	                                    const Coords& c2,
 	                                    uint32_t const h1,
 	                                    uint32_t const h2,
-	                                    uint32_t const h3,
-	                                    RNG& rng,
-	                                    MapGenAreaInfo::MapGenTerrainType& terrType);
+	                                    uint32_t const h3) const;
+
+	DescriptionIndex pick_terrain(const TerrainArea& area, RNG& rng) const;
 
 	std::unique_ptr<const MapGenInfo> map_gen_info_;
 	Map& map_;
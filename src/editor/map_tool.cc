@@ -0,0 +1,392 @@
+/*
+ * Copyright (C) 2019 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+// Changes maps without the editor's user interface: loads each map, applies
+// the operations given on the command line in their order, recalculates and
+// checks the map and saves it to the output directory under the same name, so
+// the map files must have different names.
+// Each map is processed from scratch, so several maps are processed in
+// parallel processes with --jobs.
+//
+// Usage: wl_map_tool [options] <map file>...
+//
+//   --output=<directory>               Where to save the maps. Must exist.
+//   --resize=<width>x<height>          Resize the map like the editor's resize
+//                                      tool, keeping the top left corner.
+//   --set-resources=<resource>:<amount>
+//                                      Put 'amount' of 'resource' on every node
+//                                      that allows it, like the editor's set
+//                                      resources tool on the whole map.
+//   --script=<file>                    Run a Lua script with the editor's Lua
+//                                      interface, e.g. to use wl.Editor().map.
+//   --datadir=<directory>              Where the game data is.
+//   --jobs=<n>                         How many maps to process at once.
+//   --nozip                            Save the maps as directories.
+//
+// Returns 0 if all maps were processed and saved.
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include <SDL.h>
+#include <boost/algorithm/string/predicate.hpp>
+
+#include "base/i18n.h"
+#include "base/log.h"
+#include "base/macros.h"
+#include "base/wexception.h"
+#include "config.h"
+#include "graphic/graphic.h"
+#include "io/filesystem/filesystem.h"
+#include "io/filesystem/layered_filesystem.h"
+#include "logic/editor_game_base.h"
+#include "logic/field.h"
+#include "logic/generic_save_handler.h"
+#include "logic/map.h"
+#include "logic/map_objects/world/resource_description.h"
+#include "logic/map_objects/world/world.h"
+#include "logic/widelands.h"
+#include "logic/widelands_geometry.h"
+#include "map_io/map_loader.h"
+#include "map_io/map_saver.h"
+#include "scripting/lua_interface.h"
+#include "sound/sound_handler.h"
+
+namespace {
+
+struct Options {
+	std::string output_dir;
+	std::string datadir = INSTALL_DATADIR;
+	int jobs = 1;
+	bool zip = true;
+	// Option name and value, in the order they were given.
+	std::vector<std::pair<std::string, std::string>> operations;
+	std::vector<std::string> map_paths;
+};
+
+void print_usage(const char* program) {
+	log("Usage: %s [options] <map file>...\n"
+	    "\n"
+	    "   --output=<directory>                 Where to save the maps. Must exist.\n"
+	    "   --resize=<width>x<height>            Resize the map.\n"
+	    "   --set-resources=<resource>:<amount>  Set a resource on the whole map.\n"
+	    "   --script=<file>                      Run a Lua script on the map.\n"
+	    "   --datadir=<directory>                Where the game data is.\n"
+	    "   --jobs=<n>                           How many maps to process at once.\n"
+	    "   --nozip                              Save the maps as directories.\n"
+	    "\n"
+	    "The operations are applied in the order they are given.\n",
+	    program);
+}
+
+// Parses all of 'text' as a decimal number. Returns false if it is not one.
+bool parse_int(const std::string& text, int* result) {
+	char* end = nullptr;
+	errno = 0;
+	const long value = strtol(text.c_str(), &end, 10);
+	if (end == text.c_str() || *end != '\0' || errno != 0 || value < INT_MIN || value > INT_MAX) {
+		return false;
+	}
+	*result = value;
+	return true;
+}
+
+// Returns false if the command line is not valid.
+bool parse_command_line(int argc, char** argv, Options* options) {
+	for (int i = 1; i < argc; ++i) {
+		const std::string arg = argv[i];
+		if (!boost::starts_with(arg, "--")) {
+			options->map_paths.push_back(arg);
+			continue;
+		}
+		const std::string::size_type equals = arg.find('=');
+		const std::string name = arg.substr(2, equals == std::string::npos ? equals : equals - 2);
+		const std::string value = equals == std::string::npos ? "" : arg.substr(equals + 1);
+		if (name == "nozip") {
+			options->zip = false;
+		} else if (value.empty()) {
+			log("Option --%s needs a value.\n", name.c_str());
+			return false;
+		} else if (name == "output") {
+			options->output_dir = value;
+		} else if (name == "datadir") {
+			options->datadir = value;
+		} else if (name == "jobs") {
+			if (!parse_int(value, &options->jobs) || options->jobs < 1) {
+				log("--jobs needs a number of at least 1, got %s.\n", value.c_str());
+				return false;
+			}
+		} else if (name == "resize" || name == "set-resources" || name == "script") {
+			options->operations.push_back(std::make_pair(name, value));
+		} else {
+			log("Unknown option --%s.\n", name.c_str());
+			return false;
+		}
+	}
+	if (options->output_dir.empty() || options->map_paths.empty()) {
+		return false;
+	}
+	// All maps are saved directly in the output directory.
+	std::set<std::string> filenames;
+	for (const std::string& map_path : options->map_paths) {
+		if (!filenames.insert(FileSystem::fs_filename(map_path.c_str())).second) {
+			log("More than one map is called %s, they would overwrite each other.\n",
+			    FileSystem::fs_filename(map_path.c_str()));
+			return false;
+		}
+	}
+	return true;
+}
+
+void resize_map(const std::string& size, Widelands::EditorGameBase* egbase) {
+	const std::string::size_type x = size.find('x');
+	const int32_t w = atoi(size.substr(0, x).c_str());
+	const int32_t h = x == std::string::npos ? 0 : atoi(size.substr(x + 1).c_str());
+	const std::vector<int32_t>& dimensions = Widelands::kMapDimensions;
+	if (std::find(dimensions.begin(), dimensions.end(), w) == dimensions.end() ||
+	    std::find(dimensions.begin(), dimensions.end(), h) == dimensions.end()) {
+		throw wexception("%s is not a size that the editor offers", size.c_str());
+	}
+	egbase->mutable_map()->resize(*egbase, Widelands::Coords(0, 0), w, h);
+}
+
+void set_resources(const std::string& resource_and_amount, Widelands::EditorGameBase* egbase) {
+	const std::string::size_type colon = resource_and_amount.find(':');
+	if (colon == std::string::npos) {
+		throw wexception("expected <resource>:<amount>, got %s", resource_and_amount.c_str());
+	}
+	const Widelands::World& world = egbase->world();
+	const Widelands::DescriptionIndex resource =
+	   world.safe_resource_index(resource_and_amount.substr(0, colon).c_str());
+	const std::string amount_text = resource_and_amount.substr(colon + 1);
+	int amount = 0;
+	if (!parse_int(amount_text, &amount) || amount < 0) {
+		throw wexception("%s is not a resource amount", amount_text.c_str());
+	}
+	amount = std::min<int>(amount, world.get_resource(resource)->max_amount());
+
+	Widelands::Map* map = egbase->mutable_map();
+	for (Widelands::MapIndex i = 0; i < map->max_index(); ++i) {
+		const Widelands::FCoords fc = map->get_fcoords((*map)[i]);
+		if (map->is_resource_valid(world, fc, resource)) {
+			map->initialize_resources(fc, resource, amount);
+		}
+	}
+}
+
+void run_script(const std::string& script_path, Widelands::EditorGameBase* egbase) {
+	std::string script_dir = FileSystem::fs_dirname(script_path);
+	if (script_dir.empty()) {
+		script_dir = ".";
+	}
+	g_fs->add_file_system(&FileSystem::create(script_dir));
+	egbase->lua().run_script(FileSystem::fs_filename(script_path.c_str()));
+}
+
+// Returns what keeps the map from being played, if anything.
+std::vector<std::string> find_problems(const Widelands::Map& map) {
+	std::vector<std::string> problems;
+	if (map.get_nrplayers() == 0) {
+		problems.push_back("the map has no players");
+	}
+	for (Widelands::PlayerNumber p = 1; p <= map.get_nrplayers(); ++p) {
+		const Widelands::Coords start = map.get_starting_pos(p);
+		if (!start || start.x >= map.get_width() || start.y >= map.get_height()) {
+			problems.push_back("player " + std::to_string(static_cast<unsigned>(p)) +
+			                   " has no starting position on the map");
+		}
+	}
+	return problems;
+}
+
+// Returns false if the map could not be processed and saved.
+bool edit_map(const Options& options, const std::string& map_path) {
+	std::string map_dir = FileSystem::fs_dirname(map_path);
+	if (map_dir.empty()) {
+		map_dir = ".";
+	}
+	const std::string map_file = FileSystem::fs_filename(map_path.c_str());
+	g_fs->add_file_system(&FileSystem::create(map_dir));
+	g_fs->set_home_file_system(&FileSystem::create(options.output_dir));
+
+	Widelands::EditorGameBase egbase(nullptr);
+	Widelands::Map* map = egbase.mutable_map();
+	std::unique_ptr<Widelands::MapLoader> ml(map->get_correct_loader(map_file));
+	if (!ml) {
+		throw wexception("cannot load map file");
+	}
+	ml->preload_map(true);
+
+	// Like the editor does.
+	egbase.tribes();
+	iterate_player_numbers(p, map->get_nrplayers()) {
+		if (!map->get_scenario_player_tribe(p).empty()) {
+			egbase.add_player(
+			   p, 0, map->get_scenario_player_tribe(p), map->get_scenario_player_name(p));
+		}
+	}
+	ml->load_map_complete(egbase, Widelands::MapLoader::LoadType::kEditor);
+	egbase.postload();
+
+	for (const auto& operation : options.operations) {
+		if (operation.first == "resize") {
+			resize_map(operation.second, &egbase);
+		} else if (operation.first == "set-resources") {
+			set_resources(operation.second, &egbase);
+		} else {
+			run_script(operation.second, &egbase);
+		}
+	}
+	map->recalc_whole_map(egbase);
+
+	const std::vector<std::string> problems = find_problems(*map);
+	for (const std::string& problem : problems) {
+		log("%s: %s\n", map_path.c_str(), problem.c_str());
+	}
+	if (!problems.empty()) {
+		egbase.cleanup_objects();
+		return false;
+	}
+
+	map->recalc_tags(egbase);
+	GenericSaveHandler gsh(
+	   [&egbase](FileSystem& fs) {
+		   Widelands::MapSaver wms(fs, egbase);
+		   wms.save();
+	   },
+	   map_file, options.zip ? FileSystem::ZIP : FileSystem::DIR);
+	const GenericSaveHandler::Error error = gsh.save();
+	egbase.cleanup_objects();
+
+	// As in the editor, a backup that could not be deleted does not matter.
+	if (error != GenericSaveHandler::Error::kSuccess &&
+	    error != GenericSaveHandler::Error::kDeletingBackupFailed) {
+		log("%s: %s\n", map_path.c_str(), gsh.error_message().c_str());
+		return false;
+	}
+	return true;
+}
+
+// Sets up everything for one map and tears it down again, so that nothing is
+// left over for the next map.
+bool process_map(const Options& options, const std::string& map_path) {
+	log("Processing %s\n", map_path.c_str());
+	bool result = false;
+	try {
+		i18n::set_locale("en");
+		if (SDL_Init(SDL_INIT_VIDEO) != 0) {
+			throw wexception("Unable to initialize SDL: %s", SDL_GetError());
+		}
+		g_fs = new LayeredFileSystem();
+		g_fs->add_file_system(&FileSystem::create(options.datadir));
+		// The map objects need their images, even though nothing is drawn.
+		g_gr = new Graphic();
+		g_gr->initialize(Graphic::TraceGl::kNo, 1, 1, false);
+		SoundHandler::disable_backend();
+		g_sh = new SoundHandler();
+
+		result = edit_map(options, map_path);
+	} catch (const std::exception& e) {
+		log("%s: %s\n", map_path.c_str(), e.what());
+	}
+
+	delete g_sh;
+	g_sh = nullptr;
+	delete g_gr;
+	g_gr = nullptr;
+	delete g_fs;
+	g_fs = nullptr;
+	SDL_Quit();
+	return result;
+}
+
+// Returns the number of maps that failed.
+size_t process_maps(const Options& options) {
+	size_t nr_failed = 0;
+#ifndef _WIN32
+	if (options.jobs > 1) {
+		// Each map gets its own process, and no more than 'jobs' run at once.
+		int nr_running = 0;
+		const auto wait_for_child = [&nr_running, &nr_failed]() {
+			int status = 0;
+			if (wait(&status) > 0) {
+				--nr_running;
+				if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+					++nr_failed;
+				}
+			}
+		};
+		for (const std::string& map_path : options.map_paths) {
+			if (nr_running == options.jobs) {
+				wait_for_child();
+			}
+			const pid_t pid = fork();
+			if (pid == 0) {
+				_exit(process_map(options, map_path) ? 0 : 1);
+			}
+			if (pid < 0) {
+				log("%s: could not start a process\n", map_path.c_str());
+				++nr_failed;
+				continue;
+			}
+			++nr_running;
+		}
+		while (nr_running > 0) {
+			wait_for_child();
+		}
+		return nr_failed;
+	}
+#endif
+	for (const std::string& map_path : options.map_paths) {
+		if (!process_map(options, map_path)) {
+			++nr_failed;
+		}
+	}
+	return nr_failed;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+	Options options;
+	if (!parse_command_line(argc, argv, &options)) {
+		print_usage(argv[0]);
+		return 1;
+	}
+
+	const size_t nr_failed = process_maps(options);
+	if (nr_failed > 0) {
+		log("%" PRIuS " of %" PRIuS " maps failed.\n", nr_failed, options.map_paths.size());
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2019 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include <memory>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include "base/macros.h"
+#include "base/worker_pool.h"
+#include "editor/map_generator.h"
+#include "random/random.h"
+
+// Triggered by BOOST_AUTO_TEST_CASE
+CLANG_DIAG_OFF("-Wdisabled-macro-expansion")
+CLANG_DIAG_OFF("-Wused-but-marked-unused")
+
+namespace {
+
+constexpr uint32_t kWidth = 80;
+constexpr uint32_t kHeight = 64;
+constexpr size_t kNrMaps = 11;
+constexpr uint32_t kMapNumber = 1234567;
+
+// What the generator gave before the value maps were generated in parallel.
+constexpr uint64_t kChecksum = 0xe7021756ba0b14e2ULL;
+constexpr uint32_t kNextRandomValue = 1114180537U;
+
+// FNV-1a over the values of all maps.
+uint64_t checksum(const std::vector<std::unique_ptr<uint32_t[]>>& value_maps) {
+	uint64_t result = 14695981039346656037ULL;
+	for (const std::unique_ptr<uint32_t[]>& values : value_maps) {
+		for (uint32_t i = 0; i < kWidth * kHeight; ++i) {
+			result = (result ^ values[i]) * 1099511628211ULL;
+		}
+	}
+	return result;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(map_generator)
+
+BOOST_AUTO_TEST_CASE(value_maps_do_not_depend_on_threads) {
+	for (unsigned nr_threads : {0U, 1U, 4U}) {
+		WorkerPool pool(nr_threads);
+		RNG rng;
+		rng.seed(kMapNumber);
+		const std::vector<std::unique_ptr<uint32_t[]>> value_maps =
+		   Widelands::MapGenerator::generate_random_value_maps(kWidth, kHeight, kNrMaps, &rng, pool);
+		BOOST_REQUIRE_EQUAL(value_maps.size(), kNrMaps);
+		BOOST_CHECK_EQUAL(checksum(value_maps), kChecksum);
+		// The rest of the map is generated with the values that follow.
+		BOOST_CHECK_EQUAL(rng.rand(), kNextRandomValue);
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2019 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include "base/macros.h"
+#include "editor/tools/run_length_list.h"
+
+// Triggered by BOOST_AUTO_TEST_CASE
+CLANG_DIAG_OFF("-Wdisabled-macro-expansion")
+CLANG_DIAG_OFF("-Wused-but-marked-unused")
+
+namespace {
+
+template <typename T> std::vector<T> to_vector(const RunLengthList<T>& list) {
+	std::vector<T> result;
+	for (const T& value : list) {
+		result.push_back(value);
+	}
+	return result;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(run_length_list)
+
+BOOST_AUTO_TEST_CASE(empty_list) {
+	RunLengthList<int> list;
+	BOOST_CHECK(list.empty());
+	BOOST_CHECK_EQUAL(list.size(), 0u);
+	BOOST_CHECK(list.begin() == list.end());
+	BOOST_CHECK_EQUAL(list.memory_usage(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(keeps_values_in_order) {
+	const std::vector<int> values{7, 7, 7, 1, 2, 2, 7, 3, 3, 3, 3, 0};
+	RunLengthList<int> list;
+	for (int value : values) {
+		list.push_back(value);
+	}
+	BOOST_CHECK(!list.empty());
+	BOOST_CHECK_EQUAL(list.size(), values.size());
+	BOOST_CHECK(to_vector(list) == values);
+}
+
+BOOST_AUTO_TEST_CASE(single_value_and_single_run) {
+	RunLengthList<int> list;
+	list.push_back(5);
+	BOOST_CHECK(to_vector(list) == std::vector<int>{5});
+	for (int i = 0; i < 999; ++i) {
+		list.push_back(5);
+	}
+	BOOST_CHECK_EQUAL(list.size(), 1000u);
+	BOOST_CHECK(to_vector(list) == std::vector<int>(1000, 5));
+}
+
+BOOST_AUTO_TEST_CASE(iterator_access) {
+	RunLengthList<std::string> list;
+	list.push_back("meadow");
+	list.push_back("meadow");
+	list.push_back("water");
+	RunLengthList<std::string>::ConstIterator it = list.begin();
+	BOOST_CHECK_EQUAL(it->size(), 6u);
+	++it;
+	BOOST_CHECK_EQUAL(*it, "meadow");
+	++it;
+	BOOST_CHECK_EQUAL(*it, "water");
+	BOOST_CHECK(it != list.end());
+	++it;
+	BOOST_CHECK(it == list.end());
+}
+
+BOOST_AUTO_TEST_CASE(runs_take_less_memory) {
+	RunLengthList<int> runs;
+	RunLengthList<int> changing;
+	for (int i = 0; i < 1000; ++i) {
+		runs.push_back(i / 250);
+		changing.push_back(i);
+	}
+	BOOST_CHECK_LT(runs.memory_usage(), changing.memory_usage());
+	BOOST_CHECK_LT(runs.memory_usage(), 1000 * sizeof(int));
+}
+
+BOOST_AUTO_TEST_CASE(clear_frees_the_runs) {
+	RunLengthList<int> list;
+	for (int i = 0; i < 100; ++i) {
+		list.push_back(i);
+	}
+	list.clear();
+	BOOST_CHECK(list.empty());
+	BOOST_CHECK_EQUAL(list.size(), 0u);
+	BOOST_CHECK(list.begin() == list.end());
+	BOOST_CHECK_EQUAL(list.memory_usage(), 0u);
+
+	list.push_back(3);
+	list.push_back(3);
+	BOOST_CHECK(to_vector(list) == std::vector<int>(2, 3));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
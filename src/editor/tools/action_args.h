@@ -26,6 +26,7 @@
 #include <string>
 #include <vector>
 
+#include "editor/tools/run_length_list.h"
 #include "logic/field.h"
 #include "logic/map.h"
 #include "logic/widelands_geometry.h"
@@ -50,16 +51,20 @@ struct EditorActionArgs {
 
 	~EditorActionArgs();
 
+	/// Roughly how many bytes this takes up, including the actions of the
+	/// draw tool.
+	size_t memory_usage() const;
+
 	uint32_t sel_radius;
 
-	int32_t change_by;                                     // resources, change height tools
-	std::list<Widelands::Field::Height> original_heights;  // change height tool
+	int32_t change_by;                                        // resources, change height tools
+	RunLengthList<Widelands::Field::Height> original_heights;  // change height tool
 	Widelands::DescriptionIndex current_resource;          // resources change tools
 	Widelands::ResourceAmount set_to;                      // resources change tools
 	Widelands::Extent new_map_size;                        // resize tool
 
 	struct ResourceState {
-		Widelands::FCoords location;
+		Widelands::Coords location;
 		Widelands::DescriptionIndex idx;
 		Widelands::ResourceAmount amount;
 	};
@@ -70,13 +75,14 @@ struct EditorActionArgs {
 		std::vector<Widelands::Coords> starting_positions;
 	};
 
-	std::list<ResourceState> original_resource;                        // resources set tool
-	std::list<const Widelands::BobDescr*> old_bob_type, new_bob_type;  // bob change tools
-	std::list<std::string> old_immovable_types;                        // immovable change tools
-	std::list<Widelands::DescriptionIndex> new_immovable_types;        // immovable change tools
-	Widelands::HeightInterval interval;                                // noise height tool
-	std::list<Widelands::DescriptionIndex> terrain_type, original_terrain_type;  // set terrain tool
-	ResizeHistory resized;                                                       // resize tool
+	std::vector<ResourceState> original_resource;                          // resources set tool
+	RunLengthList<const Widelands::BobDescr*> old_bob_type, new_bob_type;  // bob change tools
+	RunLengthList<std::string> old_immovable_types;                        // immovable change tools
+	RunLengthList<Widelands::DescriptionIndex> new_immovable_types;        // immovable change tools
+	Widelands::HeightInterval interval;                                    // noise height tool
+	RunLengthList<Widelands::DescriptionIndex> terrain_type,
+	   original_terrain_type;  // set terrain tool
+	ResizeHistory resized;     // resize tool
 
 	std::list<EditorToolAction*> draw_actions;  // draw tool
 
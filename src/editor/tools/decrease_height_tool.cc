@@ -54,7 +54,7 @@ int32_t EditorDecreaseHeightTool::handle_undo_impl(const Widelands::NodeAndTrian
 	   *map, Widelands::Area<Widelands::FCoords>(
 	            map->get_fcoords(center.node),
 	            args->sel_radius + MAX_FIELD_HEIGHT / MAX_FIELD_HEIGHT_DIFF + 1));
-	std::list<Widelands::Field::Height>::iterator i = args->original_heights.begin();
+	RunLengthList<Widelands::Field::Height>::ConstIterator i = args->original_heights.begin();
 
 	do {
 		mr.location().field->set_height(*i);
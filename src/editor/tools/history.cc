@@ -19,16 +19,29 @@
 
 #include "editor/tools/history.h"
 
+#include <algorithm>
 #include <string>
+#include <utility>
+
+#include <SDL_timer.h>
 
 #include "editor/editorinteractive.h"
 #include "editor/tools/action_args.h"
 #include "editor/tools/tool_action.h"
+#include "wlapplication_options.h"
 
 // === EditorActionArgs === //
 
 constexpr size_t kMaximumUndoActions = 500;
 constexpr size_t kTooManyUndoActionsDeleteBatch = 50;
+constexpr uint32_t kDefaultUndoMemoryMiB = 64;
+// Strokes with the same tool that start within this many ms after the last
+// action are undone together with it.
+constexpr uint32_t kCoalesceStrokesMs = 500;
+// The nodes of maps, sets and lists need a few pointers besides their value.
+constexpr size_t kNodeOverhead = 4 * sizeof(void*);
+// What an action takes up in a draw group besides its arguments.
+constexpr size_t kDrawActionOverhead = sizeof(EditorToolAction) + kNodeOverhead;
 
 EditorActionArgs::EditorActionArgs(EditorInteractive& base)
    : sel_radius(base.get_sel_radius()),
@@ -55,15 +68,44 @@ EditorActionArgs::~EditorActionArgs() {
 	terrain_type.clear();
 }
 
+size_t EditorActionArgs::memory_usage() const {
+	size_t result = sizeof(EditorActionArgs) + original_heights.memory_usage() +
+	                original_resource.capacity() * sizeof(ResourceState) +
+	                old_bob_type.memory_usage() + new_bob_type.memory_usage() +
+	                old_immovable_types.memory_usage() + new_immovable_types.memory_usage() +
+	                terrain_type.memory_usage() + original_terrain_type.memory_usage();
+
+	result += resized.deleted_fields.size() *
+	          (sizeof(std::pair<const Widelands::Coords, Widelands::FieldData>) + kNodeOverhead);
+	result += resized.port_spaces.size() * (sizeof(Widelands::Coords) + kNodeOverhead);
+	result += resized.starting_positions.capacity() * sizeof(Widelands::Coords);
+	for (const EditorToolAction* action : draw_actions) {
+		result += kDrawActionOverhead + action->args->memory_usage();
+	}
+	return result;
+}
+
 // === EditorHistory === //
 
+EditorHistory::EditorHistory(UI::Button& undo, UI::Button& redo)
+   : undo_button_(undo),
+     redo_button_(redo),
+     memory_limit_(static_cast<size_t>(
+                      get_config_natural("editor_undo_memory", kDefaultUndoMemoryMiB)) *
+                   1024 * 1024),
+     last_action_time_(0),
+     undo_memory_usage_(0) {
+}
+
 uint32_t EditorHistory::undo_action() {
 	if (undo_stack_.empty())
 		return 0;
 
 	EditorToolAction uac = undo_stack_.front();
 	undo_stack_.pop_front();
+	undo_memory_usage_ -= uac.memory_usage;
 	redo_stack_.push_front(uac);
+	last_action_time_ = 0;
 
 	undo_button_.set_enabled(!undo_stack_.empty());
 	redo_button_.set_enabled(true);
@@ -79,6 +121,8 @@ uint32_t EditorHistory::redo_action() {
 	EditorToolAction rac = redo_stack_.front();
 	redo_stack_.pop_front();
 	undo_stack_.push_front(rac);
+	undo_memory_usage_ += rac.memory_usage;
+	last_action_time_ = 0;
 
 	undo_button_.set_enabled(true);
 	redo_button_.set_enabled(!redo_stack_.empty());
@@ -95,24 +139,31 @@ uint32_t EditorHistory::do_action(EditorTool& tool,
                                   bool draw) {
 	EditorToolAction ac(
 	   tool, static_cast<uint32_t>(ind), map, center, parent, tool.format_args(ind, parent));
-	if (draw && tool.is_undoable()) {
+	bool in_draw_group = false;
+	if ((draw || continues_last_stroke(tool, ind)) && tool.is_undoable()) {
 		if (undo_stack_.empty() ||
 		    undo_stack_.front().tool.get_sel_impl() != draw_tool_.get_sel_impl()) {
 			EditorToolAction da(draw_tool_, EditorTool::First, map, center, parent,
 			                    draw_tool_.format_args(EditorTool::First, parent));
+			da.memory_usage = da.args->memory_usage();
 
+			// The last action moves into the draw group together with its size.
 			if (!undo_stack_.empty()) {
 				draw_tool_.add_action(undo_stack_.front(), *da.args);
+				da.memory_usage += kDrawActionOverhead + undo_stack_.front().memory_usage;
+				undo_memory_usage_ -= undo_stack_.front().memory_usage;
 				undo_stack_.pop_front();
 			}
 
 			redo_stack_.clear();
 			undo_stack_.push_front(da);
+			undo_memory_usage_ += da.memory_usage;
 			undo_button_.set_enabled(true);
 			redo_button_.set_enabled(false);
 		}
 		dynamic_cast<EditorDrawTool*>(&(undo_stack_.front().tool))
 		   ->add_action(ac, *undo_stack_.front().args);
+		in_draw_group = true;
 	} else if (tool.is_undoable()) {
 		redo_stack_.clear();
 		undo_stack_.push_front(ac);
@@ -120,9 +171,51 @@ uint32_t EditorHistory::do_action(EditorTool& tool,
 		redo_button_.set_enabled(false);
 		if (undo_stack_.size() > kMaximumUndoActions) {
 			for (size_t i = 0; i < kTooManyUndoActionsDeleteBatch; ++i) {
-				undo_stack_.pop_back();
+				pop_oldest_action();
 			}
 		}
 	}
-	return tool.handle_click(ind, center, parent, ac.args, &map);
+
+	const uint32_t result = tool.handle_click(ind, center, parent, ac.args, &map);
+	if (tool.is_undoable()) {
+		// The tools only know what they change once they have been applied, so
+		// the action is counted now on the entry that holds it.
+		size_t memory_usage = ac.args->memory_usage();
+		if (in_draw_group) {
+			memory_usage += kDrawActionOverhead;
+		}
+		undo_stack_.front().memory_usage += memory_usage;
+		undo_memory_usage_ += memory_usage;
+		enforce_memory_limit();
+		last_action_time_ = std::max<uint32_t>(1, SDL_GetTicks());
+	}
+	return result;
+}
+
+bool EditorHistory::continues_last_stroke(const EditorTool& tool,
+                                          EditorTool::ToolIndex const ind) const {
+	if (last_action_time_ == 0 || undo_stack_.empty() ||
+	    SDL_GetTicks() - last_action_time_ > kCoalesceStrokesMs) {
+		return false;
+	}
+	const EditorToolAction* last = &undo_stack_.front();
+	if (&last->tool == &draw_tool_) {
+		if (last->args->draw_actions.empty()) {
+			return false;
+		}
+		last = last->args->draw_actions.back();
+	}
+	return &last->tool == &tool && last->i == static_cast<uint32_t>(ind);
+}
+
+void EditorHistory::pop_oldest_action() {
+	undo_memory_usage_ -= undo_stack_.back().memory_usage;
+	undo_stack_.pop_back();
+}
+
+void EditorHistory::enforce_memory_limit() {
+	// Always keep the newest action, however big it is.
+	while (undo_memory_usage_ > memory_limit_ && undo_stack_.size() > 1) {
+		pop_oldest_action();
+	}
 }
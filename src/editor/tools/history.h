@@ -34,10 +34,13 @@ struct Button;
  * The all actions done with an editor tool are saved on a stack to
  * provide undo / redo functionality.
  * Do all tool action you want to make "undoable" using this class.
+ *
+ * Strokes that follow each other quickly with the same tool are undone as
+ * one. When the actions on the undo stack take up more memory than the
+ * "editor_undo_memory" option allows (in MiB), the oldest ones are dropped.
  */
 struct EditorHistory {
-	EditorHistory(UI::Button& undo, UI::Button& redo) : undo_button_(undo), redo_button_(redo) {
-	}
+	EditorHistory(UI::Button& undo, UI::Button& redo);
 
 	uint32_t do_action(EditorTool& tool,
 	                   EditorTool::ToolIndex ind,
@@ -49,11 +52,27 @@ struct EditorHistory {
 	uint32_t redo_action();
 
 private:
+	// Whether an action with 'tool' continues the stroke on top of the undo stack.
+	bool continues_last_stroke(const EditorTool& tool, EditorTool::ToolIndex ind) const;
+
+	// Drops the oldest action from the undo stack.
+	void pop_oldest_action();
+
+	// Drops the oldest actions until the undo stack fits into 'memory_limit_'.
+	void enforce_memory_limit();
+
 	UI::Button& undo_button_;
 	UI::Button& redo_button_;
 
 	EditorDrawTool draw_tool_;
 
+	const size_t memory_limit_;
+	// When the action on top of the undo stack was done, or 0 if it must not be
+	// extended by the next stroke.
+	uint32_t last_action_time_;
+	// The sum of the memory usage of the actions on the undo stack.
+	size_t undo_memory_usage_;
+
 	std::deque<EditorToolAction> undo_stack_;
 	std::deque<EditorToolAction> redo_stack_;
 };
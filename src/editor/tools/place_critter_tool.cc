@@ -52,7 +52,7 @@ int32_t EditorPlaceCritterTool::handle_click_impl(const Widelands::NodeAndTriang
 		Widelands::MapRegion<Widelands::Area<Widelands::FCoords>> mr(
 		   *map,
 		   Widelands::Area<Widelands::FCoords>(map->get_fcoords(center.node), args->sel_radius));
-		std::list<const Widelands::BobDescr*>::iterator i = args->new_bob_type.begin();
+		RunLengthList<const Widelands::BobDescr*>::ConstIterator i = args->new_bob_type.begin();
 		do {
 			const Widelands::BobDescr& descr = *(*i);
 			if (mr.location().field->nodecaps() & descr.movecaps()) {
@@ -77,7 +77,7 @@ int32_t EditorPlaceCritterTool::handle_undo_impl(
 		Widelands::MapRegion<Widelands::Area<Widelands::FCoords>> mr(
 		   *map,
 		   Widelands::Area<Widelands::FCoords>(map->get_fcoords(center.node), args->sel_radius));
-		std::list<const Widelands::BobDescr*>::iterator i = args->old_bob_type.begin();
+		RunLengthList<const Widelands::BobDescr*>::ConstIterator i = args->old_bob_type.begin();
 		do {
 			if (*i) {
 				const Widelands::BobDescr& descr = *(*i);
@@ -53,7 +53,8 @@ int32_t EditorPlaceImmovableTool::handle_click_impl(const Widelands::NodeAndTria
 	if (!args->new_immovable_types.empty()) {
 		Widelands::MapRegion<Widelands::Area<Widelands::FCoords>> mr(
 		   *map, Widelands::Area<Widelands::FCoords>(map->get_fcoords(center.node), radius));
-		std::list<Widelands::DescriptionIndex>::iterator i = args->new_immovable_types.begin();
+		RunLengthList<Widelands::DescriptionIndex>::ConstIterator i =
+		   args->new_immovable_types.begin();
 		do {
 			if (!mr.location().field->get_immovable() &&
 			    (mr.location().field->nodecaps() & Widelands::MOVECAPS_WALK))
@@ -77,7 +78,7 @@ int32_t EditorPlaceImmovableTool::handle_undo_impl(
 	Widelands::EditorGameBase& egbase = eia.egbase();
 	Widelands::MapRegion<Widelands::Area<Widelands::FCoords>> mr(
 	   *map, Widelands::Area<Widelands::FCoords>(map->get_fcoords(center.node), radius));
-	std::list<std::string>::iterator i = args->old_immovable_types.begin();
+	RunLengthList<std::string>::ConstIterator i = args->old_immovable_types.begin();
 	do {
 		if (upcast(Widelands::Immovable, immovable, mr.location().field->get_immovable())) {
 			immovable->remove(egbase);
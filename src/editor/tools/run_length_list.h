@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2019 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#ifndef WL_EDITOR_TOOLS_RUN_LENGTH_LIST_H
+#define WL_EDITOR_TOOLS_RUN_LENGTH_LIST_H
+
+#include <cstddef>
+#include <vector>
+
+#include <stdint.h>
+
+/// A sequence that is only ever appended to and read front to back, stored as
+/// runs of equal values. The editor tools keep one value per node or triangle
+/// of their brush for undo, in the order of the map region, and neighbouring
+/// nodes mostly have the same terrain, immovable etc., so most brushes need
+/// only a few runs.
+template <typename T> class RunLengthList {
+	struct Run {
+		T value;
+		uint32_t count;
+	};
+
+public:
+	class ConstIterator {
+	public:
+		ConstIterator(const typename std::vector<Run>::const_iterator& run, uint32_t index)
+		   : run_(run), index_(index) {
+		}
+
+		const T& operator*() const {
+			return run_->value;
+		}
+
+		const T* operator->() const {
+			return &run_->value;
+		}
+
+		ConstIterator& operator++() {
+			if (++index_ == run_->count) {
+				++run_;
+				index_ = 0;
+			}
+			return *this;
+		}
+
+		bool operator==(const ConstIterator& other) const {
+			return run_ == other.run_ && index_ == other.index_;
+		}
+
+		bool operator!=(const ConstIterator& other) const {
+			return !(*this == other);
+		}
+
+	private:
+		typename std::vector<Run>::const_iterator run_;
+		// The position within the run.
+		uint32_t index_;
+	};
+
+	RunLengthList() : size_(0) {
+	}
+
+	void push_back(const T& value) {
+		if (!runs_.empty() && runs_.back().value == value) {
+			++runs_.back().count;
+		} else {
+			runs_.push_back(Run{value, 1});
+		}
+		++size_;
+	}
+
+	ConstIterator begin() const {
+		return ConstIterator(runs_.begin(), 0);
+	}
+
+	ConstIterator end() const {
+		return ConstIterator(runs_.end(), 0);
+	}
+
+	bool empty() const {
+		return size_ == 0;
+	}
+
+	size_t size() const {
+		return size_;
+	}
+
+	void clear() {
+		std::vector<Run>().swap(runs_);
+		size_ = 0;
+	}
+
+	/// The number of bytes that the runs take up, not counting memory owned by
+	/// the values themselves.
+	size_t memory_usage() const {
+		return runs_.capacity() * sizeof(Run);
+	}
+
+private:
+	std::vector<Run> runs_;
+	size_t size_;
+};
+
+#endif  // end of include guard: WL_EDITOR_TOOLS_RUN_LENGTH_LIST_H
@@ -69,7 +69,7 @@ int32_t EditorSetResourcesTool::handle_undo_impl(
 		if (amount > max_amount)
 			amount = max_amount;
 
-		map->initialize_resources(res.location, res.idx, amount);
+		map->initialize_resources(map->get_fcoords(res.location), res.idx, amount);
 	}
 
 	args->original_resource.clear();
@@ -53,7 +53,7 @@ int32_t EditorSetTerrainTool::handle_click_impl(const Widelands::NodeAndTriangle
 		            TCoords<Widelands::FCoords>(
 		               Widelands::FCoords(map->get_fcoords(center.triangle.node)), center.triangle.t),
 		            radius));
-		std::list<Widelands::DescriptionIndex>::iterator i = args->terrain_type.begin();
+		RunLengthList<Widelands::DescriptionIndex>::ConstIterator i = args->terrain_type.begin();
 		do {
 			max = std::max(max, map->change_terrain(eia.egbase(), mr.location(), *i));
 			++i;
@@ -78,7 +78,8 @@ EditorSetTerrainTool::handle_undo_impl(const Widelands::NodeAndTriangle<Wideland
 		               Widelands::FCoords(map->get_fcoords(center.triangle.node)), center.triangle.t),
 		            radius));
 
-		std::list<Widelands::DescriptionIndex>::iterator i = args->original_terrain_type.begin();
+		RunLengthList<Widelands::DescriptionIndex>::ConstIterator i =
+		   args->original_terrain_type.begin();
 		do {
 			max = std::max(max, map->change_terrain(eia.egbase(), mr.location(), *i));
 			++i;
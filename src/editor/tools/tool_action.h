@@ -41,13 +41,16 @@ struct EditorToolAction {
 
 	EditorActionArgs* args;
 
+	// The bytes that EditorHistory counted for this action on its undo stack.
+	size_t memory_usage;
+
 	EditorToolAction(EditorTool& t,
 	                 uint32_t ind,
 	                 Widelands::Map& m,
 	                 Widelands::NodeAndTriangle<> c,
 	                 EditorInteractive& p,
 	                 const EditorActionArgs& nargs)
-	   : tool(t), i(ind), map(m), center(c), parent(p) {
+	   : tool(t), i(ind), map(m), center(c), parent(p), memory_usage(0) {
 		args = new EditorActionArgs(parent);
 		*args = nargs;
 		args->refcount++;
@@ -61,7 +64,13 @@ struct EditorToolAction {
 	}
 
 	EditorToolAction(const EditorToolAction& b)
-	   : tool(b.tool), i(b.i), map(b.map), center(b.center), parent(b.parent), args(b.args) {
+	   : tool(b.tool),
+	     i(b.i),
+	     map(b.map),
+	     center(b.center),
+	     parent(b.parent),
+	     args(b.args),
+	     memory_usage(b.memory_usage) {
 		args->refcount++;
 	}
 };
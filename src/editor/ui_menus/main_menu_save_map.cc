@@ -315,24 +315,7 @@ bool MainMenuSaveMap::save_map(std::string filename, bool binary) {
 	Widelands::EditorGameBase& egbase = eia().egbase();
 	Widelands::Map* map = egbase.mutable_map();
 
-	// Recompute seafaring tag
-	map->cleanup_port_spaces(egbase);
-	if (map->allows_seafaring()) {
-		map->add_tag("seafaring");
-	} else {
-		map->delete_tag("seafaring");
-	}
-	if (map->get_waterway_max_length() >= 2) {
-		map->add_tag("ferries");
-	} else {
-		map->delete_tag("ferries");
-	}
-
-	if (map->has_artifacts()) {
-		map->add_tag("artifacts");
-	} else {
-		map->delete_tag("artifacts");
-	}
+	map->recalc_tags(egbase);
 
 	// Try saving the map.
 	GenericSaveHandler gsh(
@@ -49,6 +49,8 @@ struct GamePreloadPacket : public GameDataPacket {
 		return win_condition_;
 	}
 	std::string get_localized_win_condition() const;
+	/// Translates a win condition as returned by 'get_win_condition'.
+	static std::string localize_win_condition(const std::string& win_condition);
 	uint32_t get_gametime() const {
 		return gametime_;
 	}
@@ -86,6 +86,12 @@ void NonPackedAnimation::NonPackedMipMapEntry::load_graphics() {
 		   image_files.size(), playercolor_mask_image_files.size(), image_files.front().c_str());
 	}
 
+	// Decode all frames at once.
+	std::vector<std::string> all_files(image_files);
+	all_files.insert(
+	   all_files.end(), playercolor_mask_image_files.begin(), playercolor_mask_image_files.end());
+	g_gr->images().preload(all_files);
+
 	for (const std::string& filename : image_files) {
 		const Image* image = g_gr->images().get(filename);
 		if (frames.size() && (frames.front()->width() != image->width() ||
@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2019 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+// Measures how long it takes to decode all PNGs in a directory of the data
+// directory into the pixel layout that textures are created from: through
+// SDL_image and a conversion like before, with libpng directly, and with
+// libpng on all cores. No GL context is needed. The files are read into memory
+// first, so disk access is not measured.
+//
+// Usage: graphic_image_decode_benchmark <data directory> [directory, default tribes]
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <SDL.h>
+#include <boost/algorithm/string/predicate.hpp>
+
+#include "base/log.h"
+#include "base/worker_pool.h"
+#include "graphic/image_io.h"
+#include "graphic/sdl_utils.h"
+#include "io/fileread.h"
+#include "io/filesystem/layered_filesystem.h"
+
+namespace {
+
+struct File {
+	std::string filename;
+	std::unique_ptr<FileRead> contents;
+};
+
+void find_pngs(const std::string& directory, std::vector<File>* files) {
+	for (const std::string& filename : g_fs->list_directory(directory)) {
+		if (g_fs->is_directory(filename)) {
+			find_pngs(filename, files);
+		} else if (boost::ends_with(filename, ".png")) {
+			File file;
+			file.filename = filename;
+			file.contents.reset(new FileRead());
+			file.contents->open(*g_fs, filename);
+			files->push_back(std::move(file));
+		}
+	}
+}
+
+// Returns the wall clock time that 'function' takes in ms.
+double time_ms(const std::function<void()>& function) {
+	const auto start = std::chrono::steady_clock::now();
+	function();
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+	   .count();
+}
+
+// What loading an image did before there was DecodedImage: let SDL_image
+// decode it, then convert it to RGBA the way Texture did.
+void decode_with_sdl_image(const File& file) {
+	SDL_Surface* surface = decode_image_as_sdl_surface(
+	   file.filename, file.contents->data(0), file.contents->get_size());
+	SDL_Surface* converted = empty_sdl_surface(surface->w, surface->h);
+	SDL_SetSurfaceAlphaMod(surface, SDL_ALPHA_OPAQUE);
+	SDL_SetSurfaceBlendMode(surface, SDL_BLENDMODE_NONE);
+	SDL_BlitSurface(surface, nullptr, converted, nullptr);
+	SDL_FreeSurface(surface);
+	SDL_FreeSurface(converted);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+	if (!(2 <= argc && argc <= 3)) {
+		log("Usage: %s <data directory> [directory, default tribes]\n", argv[0]);
+		return 1;
+	}
+	const std::string directory = argc == 3 ? argv[2] : "tribes";
+
+	try {
+		g_fs = new LayeredFileSystem();
+		g_fs->add_file_system(&FileSystem::create(argv[1]));
+
+		std::vector<File> files;
+		find_pngs(directory, &files);
+		size_t file_bytes = 0;
+		for (const File& file : files) {
+			file_bytes += file.contents->get_size();
+		}
+
+		const double sdl_image_ms = time_ms([&files]() {
+			for (const File& file : files) {
+				decode_with_sdl_image(file);
+			}
+		});
+
+		size_t pixel_bytes = 0;
+		const double libpng_ms = time_ms([&files, &pixel_bytes]() {
+			for (const File& file : files) {
+				DecodedImage image;
+				decode_image(
+				   file.filename, file.contents->data(0), file.contents->get_size(), &image);
+				pixel_bytes += image.pixels.size();
+			}
+		});
+
+		WorkerPool& pool = WorkerPool::for_loading();
+		const double parallel_ms = time_ms([&files, &pool]() {
+			pool.run(files.size(), [&files](size_t i) {
+				DecodedImage image;
+				decode_image(files[i].filename, files[i].contents->data(0),
+				             files[i].contents->get_size(), &image);
+			});
+		});
+
+		log("%" PRIuS " PNGs in %s, %.1f MiB compressed, %.1f MiB decoded\n", files.size(),
+		    directory.c_str(), file_bytes / 1048576., pixel_bytes / 1048576.);
+		log("SDL_image + conversion: %8.1f ms\n", sdl_image_ms);
+		log("libpng:                 %8.1f ms\n", libpng_ms);
+		log("libpng on %u threads:    %8.1f ms\n", pool.concurrency(), parallel_ms);
+
+		delete g_fs;
+		g_fs = nullptr;
+	} catch (const std::exception& e) {
+		log("Exception: %s.\n", e.what());
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,193 @@
+/*
+ * Copyright (C) 2019 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+// Measures the CPU time per frame for drawing the map objects of a crowded
+// view at full zoom-out: every field has an immovable and two critters on it,
+// which is more than the busiest late-game savegames have. The frame is drawn
+// once with one RenderQueue item per sprite and once with sprite batching. Only
+// the time of the main thread is counted, so this also gives meaningful
+// numbers with a software GL driver.
+//
+// Usage: graphic_sprite_benchmark <data directory> [frames]
+
+#include <algorithm>
+#include <cstdlib>
+#include <ctime>
+#include <memory>
+#include <vector>
+
+#include <SDL.h>
+
+#include "base/log.h"
+#include "base/vector.h"
+#include "base/wexception.h"
+#include "graphic/gl/fields_to_draw.h"
+#include "graphic/graphic.h"
+#include "graphic/render_queue.h"
+#include "graphic/rendertarget.h"
+#include "io/filesystem/layered_filesystem.h"
+#include "logic/editor_game_base.h"
+#include "logic/field.h"
+#include "logic/map.h"
+#include "logic/map_objects/bob.h"
+#include "logic/map_objects/immovable.h"
+#include "logic/map_objects/world/world.h"
+#include "sound/sound_handler.h"
+#include "wui/mapviewpixelconstants.h"
+
+namespace {
+
+constexpr int kMapSize = 256;
+constexpr int kCrittersPerField = 2;
+
+// Same as kMaxZoom in wui/mapview.cc.
+constexpr float kZoom = 4.f;
+
+double thread_cpu_seconds() {
+	timespec ts;
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+void create_map(Widelands::EditorGameBase* egbase) {
+	Widelands::Map* map = egbase->mutable_map();
+	map->create_empty_map(*egbase, kMapSize, kMapSize, 0, "Benchmark", "Benchmark");
+	map->recalc_whole_map(*egbase);
+
+	// Immovables that occupy more than one field would replace their neighbors.
+	const Widelands::World& world = egbase->world();
+	std::vector<Widelands::DescriptionIndex> immovables;
+	for (Widelands::DescriptionIndex i = 0; i < world.get_nr_immovables(); ++i) {
+		if (world.get_immovable_descr(i)->get_size() <= Widelands::BaseImmovable::SMALL) {
+			immovables.push_back(i);
+		}
+	}
+	const size_t nr_critters = world.critters().size();
+	if (immovables.empty() || nr_critters == 0) {
+		throw wexception("The world has no small immovables or no critters.");
+	}
+
+	size_t index = 0;
+	for (int16_t y = 0; y < kMapSize; ++y) {
+		for (int16_t x = 0; x < kMapSize; ++x) {
+			const Widelands::Coords coords(x, y);
+			egbase->create_immovable(coords, immovables[index % immovables.size()],
+			                         Widelands::MapObjectDescr::OwnerType::kWorld, nullptr);
+			for (int i = 0; i < kCrittersPerField; ++i) {
+				egbase->create_critter(coords, (index + i) % nr_critters);
+			}
+			++index;
+		}
+	}
+}
+
+// Draws 'nr_frames' frames and returns the CPU time per frame in ms. Also
+// returns the number of map objects drawn in the last frame in 'nr_objects'.
+double run(const Widelands::EditorGameBase& egbase,
+           const int nr_frames,
+           const bool batch_sprites,
+           FieldsToDraw* fields_to_draw,
+           size_t* nr_objects) {
+	RenderTarget* dst = g_gr->get_render_target();
+	const Vector2f viewpoint(kMapSize * kTriangleWidth / 4.f, kMapSize * kTriangleHeight / 4.f);
+	const float scale = 1.f / kZoom;
+	double cpu_seconds = 0.;
+	for (int frame = 0; frame < nr_frames; ++frame) {
+		const double start = thread_cpu_seconds();
+		fields_to_draw->reset(egbase, nullptr, viewpoint, kZoom, dst);
+		*nr_objects = 0;
+		{
+			std::unique_ptr<RenderQueue::ScopedSpriteBatch> sprite_batch;
+			if (batch_sprites) {
+				sprite_batch.reset(new RenderQueue::ScopedSpriteBatch());
+			}
+			for (size_t idx = 0; idx < fields_to_draw->size(); ++idx) {
+				const FieldsToDraw::Field& field = fields_to_draw->at(idx);
+				Widelands::BaseImmovable* const imm = field.fcoords.field->get_immovable();
+				if (imm != nullptr) {
+					imm->draw(egbase.get_gametime(), TextToDraw::kNone, field.rendertarget_pixel,
+					          field.fcoords, scale, dst);
+					++*nr_objects;
+				}
+				for (Widelands::Bob* bob = field.fcoords.field->get_first_bob(); bob;
+				     bob = bob->get_next_bob()) {
+					bob->draw(egbase, TextToDraw::kNone, field.rendertarget_pixel, field.fcoords, scale,
+					          dst);
+					++*nr_objects;
+				}
+			}
+		}
+		g_gr->refresh();
+		cpu_seconds += thread_cpu_seconds() - start;
+	}
+	return cpu_seconds * 1000. / nr_frames;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+	if (!(2 <= argc && argc <= 3)) {
+		log("Usage: %s <data directory> [frames]\n", argv[0]);
+		return 1;
+	}
+	const int nr_frames = argc == 3 ? std::max(1, atoi(argv[2])) : 100;
+
+	if (SDL_Init(SDL_INIT_VIDEO) < 0) {
+		log("SDL_Init did not succeed: %s\n", SDL_GetError());
+		return 1;
+	}
+
+	try {
+		g_fs = new LayeredFileSystem();
+		g_fs->add_file_system(&FileSystem::create(argv[1]));
+		g_gr = new Graphic();
+		g_gr->initialize(Graphic::TraceGl::kNo, 1280, 800, false);
+		SoundHandler::disable_backend();
+		g_sh = new SoundHandler();
+
+		{
+			Widelands::EditorGameBase egbase(nullptr);
+			create_map(&egbase);
+
+			FieldsToDraw fields_to_draw;
+			size_t nr_objects = 0;
+			// Warm up, so that all animations are loaded and the driver has seen everything.
+			run(egbase, 3, true, &fields_to_draw, &nr_objects);
+
+			const double items = run(egbase, nr_frames, false, &fields_to_draw, &nr_objects);
+			const double batched = run(egbase, nr_frames, true, &fields_to_draw, &nr_objects);
+			log("%dx%d map, zoom %.0f, %d frames, %" PRIuS " map objects in view\n", kMapSize,
+			    kMapSize, kZoom, nr_frames, nr_objects);
+			log("one item per sprite: %8.3f ms CPU per frame\n", items);
+			log("sprite batches:      %8.3f ms CPU per frame\n", batched);
+		}
+
+		delete g_sh;
+		g_sh = nullptr;
+		delete g_gr;
+		g_gr = nullptr;
+		delete g_fs;
+		g_fs = nullptr;
+	} catch (const std::exception& e) {
+		log("Exception: %s.\n", e.what());
+		return 1;
+	}
+	SDL_Quit();
+	return 0;
+}
@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2019 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+// Measures the CPU time per frame for drawing the terrain of a 512x512 map at
+// full zoom-out, once with the terrain mesh rebuilt every frame and once with
+// the retained chunks. Only the time of the main thread is counted, so this
+// also gives meaningful numbers with a software GL driver.
+//
+// Usage: graphic_terrain_benchmark <data directory> [frames]
+
+#include <algorithm>
+#include <cstdlib>
+#include <ctime>
+#include <memory>
+#include <random>
+
+#include <SDL.h>
+
+#include "base/log.h"
+#include "base/vector.h"
+#include "base/wexception.h"
+#include "graphic/game_renderer.h"
+#include "graphic/gl/fields_to_draw.h"
+#include "graphic/gl/terrain_mesh.h"
+#include "graphic/graphic.h"
+#include "graphic/rendertarget.h"
+#include "io/filesystem/layered_filesystem.h"
+#include "logic/editor_game_base.h"
+#include "logic/field.h"
+#include "logic/map.h"
+#include "logic/map_objects/world/world.h"
+#include "sound/sound_handler.h"
+#include "wui/mapviewpixelconstants.h"
+
+namespace {
+
+constexpr int kMapSize = 512;
+
+// Same as kMaxZoom in wui/mapview.cc.
+constexpr float kZoom = 4.f;
+
+double thread_cpu_seconds() {
+	timespec ts;
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+void create_map(Widelands::EditorGameBase* egbase) {
+	Widelands::Map* map = egbase->mutable_map();
+	map->create_empty_map(*egbase, kMapSize, kMapSize, 0, "Benchmark", "Benchmark");
+
+	// Random terrains make sure that there is plenty of dithering.
+	const int nr_terrains = egbase->world().terrains().size();
+	std::minstd_rand rng(1);
+	for (int16_t y = 0; y < kMapSize; ++y) {
+		for (int16_t x = 0; x < kMapSize; ++x) {
+			Widelands::Field* field = map->get_fcoords(Widelands::Coords(x, y)).field;
+			Widelands::Field::Terrains terrains;
+			terrains.d = rng() % nr_terrains;
+			terrains.r = rng() % nr_terrains;
+			field->set_terrains(terrains);
+			field->set_height(rng() % (MAX_FIELD_HEIGHT / 2));
+		}
+	}
+	map->recalc_whole_map(*egbase);
+}
+
+// Draws 'nr_frames' frames and returns the CPU time per frame in ms.
+double run(const Widelands::EditorGameBase& egbase,
+           const int nr_frames,
+           const bool rebuild_every_frame,
+           FieldsToDraw* fields_to_draw,
+           TerrainMesh* terrain_mesh) {
+	RenderTarget* dst = g_gr->get_render_target();
+	const Vector2f viewpoint(kMapSize * kTriangleWidth / 4.f, kMapSize * kTriangleHeight / 4.f);
+	double cpu_seconds = 0.;
+	for (int frame = 0; frame < nr_frames; ++frame) {
+		const double start = thread_cpu_seconds();
+		if (rebuild_every_frame) {
+			terrain_mesh->invalidate();
+		}
+		fields_to_draw->reset(egbase, nullptr, viewpoint, kZoom, dst);
+		terrain_mesh->update(egbase, nullptr, viewpoint, kZoom, *dst);
+		draw_terrain(egbase, *fields_to_draw, terrain_mesh, 1.f / kZoom, Workareas(), false, dst);
+		g_gr->refresh();
+		cpu_seconds += thread_cpu_seconds() - start;
+	}
+	return cpu_seconds * 1000. / nr_frames;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+	if (!(2 <= argc && argc <= 3)) {
+		log("Usage: %s <data directory> [frames]\n", argv[0]);
+		return 1;
+	}
+	const int nr_frames = argc == 3 ? std::max(1, atoi(argv[2])) : 100;
+
+	if (SDL_Init(SDL_INIT_VIDEO) < 0) {
+		log("SDL_Init did not succeed: %s\n", SDL_GetError());
+		return 1;
+	}
+
+	try {
+		g_fs = new LayeredFileSystem();
+		g_fs->add_file_system(&FileSystem::create(argv[1]));
+		g_gr = new Graphic();
+		g_gr->initialize(Graphic::TraceGl::kNo, 1280, 800, false);
+		SoundHandler::disable_backend();
+		g_sh = new SoundHandler();
+
+		{
+			Widelands::EditorGameBase egbase(nullptr);
+			create_map(&egbase);
+
+			FieldsToDraw fields_to_draw;
+			TerrainMesh terrain_mesh;
+			// Warm up, so that all chunks exist and the driver has seen everything.
+			run(egbase, 3, false, &fields_to_draw, &terrain_mesh);
+
+			const double rebuilt = run(egbase, nr_frames, true, &fields_to_draw, &terrain_mesh);
+			const double retained = run(egbase, nr_frames, false, &fields_to_draw, &terrain_mesh);
+			log("%dx%d map, zoom %.0f, %d frames, %" PRIuS " visible chunks\n", kMapSize, kMapSize,
+			    kZoom, nr_frames, terrain_mesh.visible_chunks().size());
+			log("rebuilt every frame: %8.3f ms CPU per frame\n", rebuilt);
+			log("retained chunks:     %8.3f ms CPU per frame\n", retained);
+		}
+
+		delete g_sh;
+		g_sh = nullptr;
+		delete g_gr;
+		g_gr = nullptr;
+		delete g_fs;
+		g_fs = nullptr;
+	} catch (const std::exception& e) {
+		log("Exception: %s.\n", e.what());
+		return 1;
+	}
+	SDL_Quit();
+	return 0;
+}
@@ -19,6 +19,7 @@
 
 #include "graphic/build_texture_atlas.h"
 
+#include <algorithm>
 #include <map>
 #include <memory>
 #include <string>
@@ -26,12 +27,19 @@
 #include <vector>
 
 #include <boost/algorithm/string/predicate.hpp>
+#include <boost/format.hpp>
 
+#include "base/log.h"
+#include "base/md5.h"
+#include "base/worker_pool.h"
 #include "graphic/graphic.h"
 #include "graphic/image_io.h"
 #include "graphic/texture_atlas.h"
+#include "io/fileread.h"
 #include "io/filesystem/filesystem.h"
 #include "io/filesystem/layered_filesystem.h"
+#include "io/filewrite.h"
+#include "logic/filesystem_constants.h"
 
 namespace {
 
@@ -39,6 +47,23 @@ namespace {
 // threshold, but not background pictures.
 constexpr int kMaxAreaForTextureAtlas = 240 * 240;
 
+// Increase this whenever the layout of the cached texture atlas changes.
+constexpr uint32_t kCacheVersion = 1;
+
+// The cached texture atlas is the index file plus one PNG per page.
+const std::string kCacheIndex = kCacheDir + "/texture_atlas.idx";
+std::string cached_page_filename(size_t page) {
+	return (boost::format("%s/texture_atlas_%u.png") % kCacheDir % page).str();
+}
+
+// An image that might end up in the texture atlas, with the contents of its file.
+struct Candidate {
+	std::string filename;
+	std::unique_ptr<FileRead> file;
+	// Only set while the texture atlas is built.
+	DecodedImage image;
+};
+
 // Returns true if 'filename' ends with an image extension.
 bool is_image(const std::string& filename) {
 	return boost::ends_with(filename, ".png") || boost::ends_with(filename, ".jpg");
@@ -64,31 +89,140 @@ void find_images(const std::string& directory,
 	}
 }
 
-// If 'filename' should end up in the texture atlas, will load it into 'image'
-// and return true.
-bool should_be_packed(const std::string& filename, std::unique_ptr<Texture>* image) {
-	if (boost::ends_with(filename, ".jpg")) {
-		return false;
+// Reads the files of all images in 'filenames' that could be packed. JPEGs are
+// never packed.
+std::vector<Candidate> read_candidates(const std::vector<std::string>& filenames) {
+	std::vector<Candidate> candidates;
+	for (const std::string& filename : filenames) {
+		if (boost::ends_with(filename, ".jpg")) {
+			continue;
+		}
+		Candidate candidate;
+		candidate.filename = filename;
+		candidate.file.reset(new FileRead());
+		candidate.file->open(*g_fs, filename);
+		candidates.push_back(std::move(candidate));
 	}
-	*image = load_image(filename, g_fs);
-	const auto area = (*image)->width() * (*image)->height();
-	if (area > kMaxAreaForTextureAtlas) {
-		return false;
+	return candidates;
+}
+
+// Identifies the candidates and everything else that the packing depends on.
+std::string data_hash(const std::vector<Candidate>& candidates, const int max_size) {
+	SimpleMD5Checksum md5sum;
+	md5sum.data(&kCacheVersion, sizeof(kCacheVersion));
+	md5sum.data(&max_size, sizeof(max_size));
+	for (const Candidate& candidate : candidates) {
+		md5sum.data(candidate.filename.c_str(), candidate.filename.size() + 1);
+		const size_t size = candidate.file->get_size();
+		md5sum.data(&size, sizeof(size));
+		md5sum.data(candidate.file->data(0), size);
 	}
-	return true;
+	md5sum.finish_checksum();
+	return md5sum.get_checksum().str();
 }
 
-// Pack the images in 'filenames' into texture atlases.
+// Loads the texture atlas that 'write_cache' has written for the same 'hash'.
+// Returns an empty vector if there is none or it does not fit.
 std::vector<std::unique_ptr<Texture>>
-pack_images(const std::vector<std::string>& filenames,
+read_cache(const std::string& hash,
+           std::map<std::string, std::unique_ptr<Texture>>* textures_in_atlas) {
+	std::vector<std::unique_ptr<Texture>> texture_atlases;
+	FileRead fr;
+	if (!fr.try_open(*g_fs, kCacheIndex)) {
+		return texture_atlases;
+	}
+	try {
+		if (fr.unsigned_32() != kCacheVersion || fr.string() != hash) {
+			return texture_atlases;
+		}
+		const uint32_t nr_pages = fr.unsigned_32();
+		for (uint32_t page = 0; page < nr_pages; ++page) {
+			texture_atlases.push_back(load_image(cached_page_filename(page), g_fs));
+		}
+		std::map<std::string, std::unique_ptr<Texture>> textures;
+		for (uint32_t i = fr.unsigned_32(); i > 0; --i) {
+			const std::string filename = fr.string();
+			const uint32_t page = fr.unsigned_32();
+			const int x = fr.signed_32();
+			const int y = fr.signed_32();
+			const int w = fr.signed_32();
+			const int h = fr.signed_32();
+			if (page >= texture_atlases.size()) {
+				throw wexception("Page %u of %s does not exist", page, filename.c_str());
+			}
+			const Texture& parent = *texture_atlases[page];
+			textures.insert(std::make_pair(
+			   filename, std::unique_ptr<Texture>(new Texture(parent.blit_data().texture_id,
+			                                                  Recti(x, y, w, h), parent.width(),
+			                                                  parent.height()))));
+		}
+		*textures_in_atlas = std::move(textures);
+	} catch (const std::exception& e) {
+		log("Cached texture atlas is unusable, rebuilding it: %s\n", e.what());
+		texture_atlases.clear();
+	}
+	return texture_atlases;
+}
+
+// Writes the texture atlas to the cache for the next start. Failing to do so is
+// not an error.
+void write_cache(const std::string& hash,
+                 const std::vector<std::unique_ptr<Texture>>& texture_atlases,
+                 const std::map<std::string, std::unique_ptr<Texture>>& textures_in_atlas) {
+	try {
+		g_fs->ensure_directory_exists(kCacheDir);
+		for (size_t page = 0; page < texture_atlases.size(); ++page) {
+			FileWrite fw;
+			save_to_png(texture_atlases[page].get(), &fw, ColorType::RGBA);
+			fw.write(*g_fs, cached_page_filename(page));
+		}
+
+		FileWrite fw;
+		fw.unsigned_32(kCacheVersion);
+		fw.string(hash);
+		fw.unsigned_32(texture_atlases.size());
+		fw.unsigned_32(textures_in_atlas.size());
+		for (const auto& entry : textures_in_atlas) {
+			const BlitData& blit_data = entry.second->blit_data();
+			const auto page = std::find_if(
+			   texture_atlases.begin(), texture_atlases.end(),
+			   [&blit_data](const std::unique_ptr<Texture>& texture) {
+				   return texture->blit_data().texture_id == blit_data.texture_id;
+			   });
+			fw.string(entry.first);
+			fw.unsigned_32(page - texture_atlases.begin());
+			fw.signed_32(blit_data.rect.x);
+			fw.signed_32(blit_data.rect.y);
+			fw.signed_32(blit_data.rect.w);
+			fw.signed_32(blit_data.rect.h);
+		}
+		// Written last, so that an interrupted write leaves no valid index behind.
+		fw.write(*g_fs, kCacheIndex);
+	} catch (const std::exception& e) {
+		log("Could not cache the texture atlas: %s\n", e.what());
+	}
+}
+
+// Pack the images in 'candidates' into texture atlases.
+std::vector<std::unique_ptr<Texture>>
+pack_images(std::vector<Candidate>* candidates,
             const int max_size,
             std::map<std::string, std::unique_ptr<Texture>>* textures_in_atlas) {
+	// Decoding the PNGs is most of the work, so it is spread over all cores.
+	// The textures have to be created on this thread, which owns the GL context.
+	WorkerPool::for_loading().run(candidates->size(), [candidates](size_t i) {
+		Candidate& candidate = (*candidates)[i];
+		decode_image(candidate.filename, candidate.file->data(0), candidate.file->get_size(),
+		             &candidate.image);
+	});
+
 	std::vector<std::pair<std::string, std::unique_ptr<Texture>>> to_be_packed;
-	for (const auto& filename : filenames) {
-		std::unique_ptr<Texture> image;
-		if (should_be_packed(filename, &image)) {
-			to_be_packed.push_back(std::make_pair(filename, std::move(image)));
+	for (Candidate& candidate : *candidates) {
+		if (candidate.image.width * candidate.image.height <= kMaxAreaForTextureAtlas) {
+			to_be_packed.push_back(
+			   std::make_pair(candidate.filename, create_texture(candidate.image)));
 		}
+		candidate.image = DecodedImage();
 	}
 
 	TextureAtlas atlas;
@@ -126,10 +260,18 @@ build_texture_atlas(const int max_size,
 	// For UI elements mostly, but we get more than we need really.
 	find_images("images", &all_images, &first_atlas_images);
 
-	auto first_texture_atlas = pack_images(first_atlas_images, max_size, textures_in_atlas);
+	std::vector<Candidate> candidates = read_candidates(first_atlas_images);
+	const std::string hash = data_hash(candidates, max_size);
+	auto first_texture_atlas = read_cache(hash, textures_in_atlas);
+	if (!first_texture_atlas.empty()) {
+		return first_texture_atlas;
+	}
+
+	first_texture_atlas = pack_images(&candidates, max_size, textures_in_atlas);
 	if (first_texture_atlas.size() != 1) {
 		throw wexception("Not all images that should fit in the first texture atlas did actually "
 		                 "fit. Widelands has now more images than before.");
 	}
+	write_cache(hash, first_texture_atlas, *textures_in_atlas);
 	return first_texture_atlas;
 }
@@ -19,10 +19,12 @@
 
 #include "graphic/font_handler.h"
 
+#include <cinttypes>
 #include <memory>
 
-#include <boost/lexical_cast.hpp>
-
+#include "base/frame_profiler.h"
+#include "base/log.h"
+#include "graphic/text/glyph_atlas.h"
 #include "graphic/text/rt_render.h"
 #include "graphic/text/texture_cache.h"
 
@@ -42,10 +44,29 @@ namespace {
 // The size of the richtext surface cache in bytes.
 constexpr uint32_t kTextureCacheSize = 3 << 20;  // shifting by 20 converts to MB
 
-// The maximum number of RenderedRects. It's all pointers or combinations of basic data types, so
-// the size requirement is pretty constant. Therefore, simply counting them is sufficient.
-// We estimate that the member variables of each RenderedRect take up ca. 13 * 32 bytes.
-constexpr uint32_t kRenderCacheSize = 8 * 1024;
+// The size of the rendered text cache in bytes. It only holds the layout, i.e. the RenderedRects
+// and the positions of the glyphs, so this is enough for several thousand texts.
+constexpr uint32_t kRenderCacheSize = 4 << 20;
+
+// The bytes that 'text' takes up, not counting the textures that it shares with other texts.
+uint32_t rendered_text_size(const UI::RenderedText& text) {
+	uint32_t result = sizeof(UI::RenderedText);
+	for (const auto& rect : text.rects) {
+		result += sizeof(UI::RenderedRect);
+		if (rect->glyphs() != nullptr) {
+			result += sizeof(UI::GlyphRun) +
+			          rect->glyphs()->glyphs.size() * sizeof(UI::GlyphRun::Glyph);
+		}
+	}
+	return result;
+}
+
+template <typename T> void log_stats(const char* name, const TransientCache<T>& cache) {
+	const typename TransientCache<T>::Stats& stats = cache.stats();
+	log("%s: %" PRIu64 " hits, %" PRIu64 " misses, %" PRIu64 " evictions, %u entries in %u KiB\n",
+	    name, stats.hits, stats.misses, stats.evictions, cache.nr_entries(),
+	    cache.size_in_bytes() >> 10);
+}
 }  // namespace
 
 namespace UI {
@@ -58,35 +79,40 @@ private:
 	// A transient cache for the generated rendered texts
 	class RenderCache : public TransientCache<RenderedText> {
 	public:
-		explicit RenderCache(uint32_t max_number_of_rects)
-		   : TransientCache<RenderedText>(max_number_of_rects) {
+		explicit RenderCache(uint32_t max_size_in_bytes)
+		   : TransientCache<RenderedText>(max_size_in_bytes) {
 		}
 
 		std::shared_ptr<const RenderedText>
-		insert(const std::string& hash, std::shared_ptr<const RenderedText> entry) override {
-			return TransientCache<RenderedText>::insert(hash, entry, entry->rects.size());
+		insert(uint64_t key, std::shared_ptr<const RenderedText> entry) override {
+			return TransientCache<RenderedText>::insert(key, entry, rendered_text_size(*entry));
 		}
 	};
 
 public:
 	FontHandler(ImageCache* image_cache, const std::string& locale)
 	   : texture_cache_(new TextureCache(kTextureCacheSize)),
+	     glyph_atlas_(new RT::GlyphAtlas()),
 	     render_cache_(new RenderCache(kRenderCacheSize)),
 	     fontsets_(),
 	     fontset_(fontsets_.get_fontset(locale)),
-	     rt_renderer_(new RT::Renderer(image_cache, texture_cache_.get(), fontsets_)),
+	     rt_renderer_(new RT::Renderer(
+	        image_cache, texture_cache_.get(), glyph_atlas_.get(), fontsets_)),
 	     image_cache_(image_cache) {
 	}
 	~FontHandler() override {
+		log_stats("Rendered text cache", *render_cache_);
+		log_stats("Text texture cache", *texture_cache_);
 	}
 
 	// This will render the 'text' with a width restriction of 'w'. If 'w' == 0, no restriction is
 	// applied.
 	std::shared_ptr<const UI::RenderedText> render(const std::string& text,
 	                                               uint16_t w = 0) override {
-		const std::string hash = boost::lexical_cast<std::string>(w) + text;
+		const uint64_t hash = TransientCacheKey().add(w).add(text).get();
 		std::shared_ptr<const RenderedText> rendered_text = render_cache_->get(hash);
 		if (rendered_text == nullptr) {
+			FrameProfiler::Scope profile("RT::Renderer::render");
 			rendered_text =
 			   render_cache_->insert(hash, rt_renderer_->render(text, w, fontset()->is_rtl()));
 		}
@@ -101,11 +127,14 @@ public:
 		fontset_ = fontsets_.get_fontset(locale);
 		texture_cache_->flush();
 		render_cache_->flush();
-		rt_renderer_.reset(new RT::Renderer(image_cache_, texture_cache_.get(), fontsets_));
+		// The glyphs are keyed by font file and size, so the atlas stays valid.
+		rt_renderer_.reset(
+		   new RT::Renderer(image_cache_, texture_cache_.get(), glyph_atlas_.get(), fontsets_));
 	}
 
 private:
 	std::unique_ptr<TextureCache> texture_cache_;
+	std::unique_ptr<RT::GlyphAtlas> glyph_atlas_;
 	std::unique_ptr<RenderCache> render_cache_;
 	UI::FontSets fontsets_;       // All fontsets
 	UI::FontSet const* fontset_;  // The currently active FontSet
@@ -59,6 +59,7 @@ void draw_border_markers(const FieldsToDraw::Field& field,
 
 void draw_terrain(const Widelands::EditorGameBase& egbase,
                   const FieldsToDraw& fields_to_draw,
+                  TerrainMesh* terrain_mesh,
                   const float scale,
                   Workareas workarea,
                   bool grid,
@@ -80,6 +81,7 @@ void draw_terrain(const Widelands::EditorGameBase& egbase,
 	i.terrain_arguments.renderbuffer_height = surface_height;
 	i.terrain_arguments.terrains = &egbase.world().terrains();
 	i.terrain_arguments.fields_to_draw = &fields_to_draw;
+	i.terrain_arguments.terrain_mesh = terrain_mesh;
 	i.terrain_arguments.scale = scale;
 	RenderQueue::instance().enqueue(i);
 
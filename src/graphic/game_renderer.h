@@ -26,12 +26,16 @@
 #include "base/macros.h"
 #include "base/vector.h"
 #include "graphic/gl/fields_to_draw.h"
+#include "graphic/gl/terrain_mesh.h"
 #include "logic/editor_game_base.h"
 #include "logic/player.h"
 
-// Draw the terrain only.
+// Draw the terrain only. The terrain and its dithering come from
+// 'terrain_mesh', which has to be updated for this view already. Roads, grid
+// and workareas are drawn from 'fields_to_draw'.
 void draw_terrain(const Widelands::EditorGameBase& egbase,
                   const FieldsToDraw& fields_to_draw,
+                  TerrainMesh* terrain_mesh,
                   const float scale,
                   Workareas workarea,
                   bool grid,
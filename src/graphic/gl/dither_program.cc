@@ -21,7 +21,6 @@
 
 #include "base/wexception.h"
 #include "graphic/gl/coordinate_conversion.h"
-#include "graphic/gl/fields_to_draw.h"
 #include "graphic/gl/utils.h"
 #include "graphic/image_io.h"
 #include "graphic/texture.h"
@@ -34,12 +33,15 @@ DitherProgram::DitherProgram() {
 	attr_dither_texture_position_ =
 	   glGetAttribLocation(gl_program_.object(), "attr_dither_texture_position");
 	attr_position_ = glGetAttribLocation(gl_program_.object(), "attr_position");
-	attr_texture_offset_ = glGetAttribLocation(gl_program_.object(), "attr_texture_offset");
+	attr_terrain_ = glGetAttribLocation(gl_program_.object(), "attr_terrain");
 	attr_texture_position_ = glGetAttribLocation(gl_program_.object(), "attr_texture_position");
 
 	u_dither_texture_ = glGetUniformLocation(gl_program_.object(), "u_dither_texture");
+	u_position_offset_ = glGetUniformLocation(gl_program_.object(), "u_position_offset");
+	u_position_scale_ = glGetUniformLocation(gl_program_.object(), "u_position_scale");
 	u_terrain_texture_ = glGetUniformLocation(gl_program_.object(), "u_terrain_texture");
 	u_texture_dimensions_ = glGetUniformLocation(gl_program_.object(), "u_texture_dimensions");
+	u_texture_offsets_ = glGetUniformLocation(gl_program_.object(), "u_texture_offsets");
 	u_z_value_ = glGetUniformLocation(gl_program_.object(), "u_z_value");
 
 	dither_mask_.reset(new Texture(load_image_as_sdl_surface("world/pics/edge.png", g_fs), true));
@@ -54,152 +56,51 @@ DitherProgram::DitherProgram() {
 DitherProgram::~DitherProgram() {
 }
 
-void DitherProgram::add_vertex(const FieldsToDraw::Field& field,
-                               const TrianglePoint triangle_point,
-                               const Vector2f& texture_offset) {
-	vertices_.emplace_back();
-	PerVertexData& back = vertices_.back();
-
-	back.gl_x = field.gl_position.x;
-	back.gl_y = field.gl_position.y;
-	back.texture_x = field.texture_coords.x;
-	back.texture_y = field.texture_coords.y;
-	back.brightness = field.brightness;
-	back.texture_offset_x = texture_offset.x;
-	back.texture_offset_y = texture_offset.y;
-
-	switch (triangle_point) {
-	case TrianglePoint::kTopRight:
-		back.dither_texture_x = 1.;
-		back.dither_texture_y = 1.;
-		break;
-	case TrianglePoint::kTopLeft:
-		back.dither_texture_x = 0.;
-		back.dither_texture_y = 1.;
-		break;
-	case TrianglePoint::kBottomMiddle:
-		back.dither_texture_x = 0.5;
-		back.dither_texture_y = 0.;
-		break;
-	}
-}
-
-void DitherProgram::maybe_add_dithering_triangle(
+void DitherProgram::draw(
    const uint32_t gametime,
    const Widelands::DescriptionMaintainer<Widelands::TerrainDescription>& terrains,
-   const FieldsToDraw& fields_to_draw,
-   const int idx1,
-   const int idx2,
-   const int idx3,
-   const int my_terrain,
-   const int other_terrain) {
-	if (my_terrain == other_terrain) {
-		return;
-	}
-	const Widelands::TerrainDescription& other_terrain_description = terrains.get(other_terrain);
-	if (terrains.get(my_terrain).dither_layer() < other_terrain_description.dither_layer()) {
-		const Vector2f texture_offset =
-		   to_gl_texture(other_terrain_description.get_texture(gametime).blit_data()).origin();
-		add_vertex(fields_to_draw.at(idx1), TrianglePoint::kTopRight, texture_offset);
-		add_vertex(fields_to_draw.at(idx2), TrianglePoint::kTopLeft, texture_offset);
-		add_vertex(fields_to_draw.at(idx3), TrianglePoint::kBottomMiddle, texture_offset);
-	}
-}
+   TerrainMesh* terrain_mesh,
+   const float z_value) {
+	// This method expects that all terrains have the same dimensions and that
+	// all are packed into the same texture atlas, i.e. all are in the same GL
+	// texture. It does not check for this invariance for speeds sake.
+	const BlitData& blit_data = terrains.get(0).get_texture(0).blit_data();
+	const Rectf texture_coordinates = to_gl_texture(blit_data);
+	TerrainMesh::texture_offsets(gametime, terrains, &texture_offsets_);
 
-void DitherProgram::gl_draw(int gl_texture, float texture_w, float texture_h, const float z_value) {
 	glUseProgram(gl_program_.object());
 
 	auto& gl_state = Gl::State::instance();
 	gl_state.enable_vertex_attrib_array({attr_brightness_, attr_dither_texture_position_,
-	                                     attr_position_, attr_texture_offset_,
-	                                     attr_texture_position_});
-
-	gl_array_buffer_.bind();
-	gl_array_buffer_.update(vertices_);
-
-	Gl::vertex_attrib_pointer(
-	   attr_brightness_, 1, sizeof(PerVertexData), offsetof(PerVertexData, brightness));
-	Gl::vertex_attrib_pointer(attr_dither_texture_position_, 2, sizeof(PerVertexData),
-	                          offsetof(PerVertexData, dither_texture_x));
-	Gl::vertex_attrib_pointer(
-	   attr_position_, 2, sizeof(PerVertexData), offsetof(PerVertexData, gl_x));
-	Gl::vertex_attrib_pointer(
-	   attr_texture_offset_, 2, sizeof(PerVertexData), offsetof(PerVertexData, texture_offset_x));
-	Gl::vertex_attrib_pointer(
-	   attr_texture_position_, 2, sizeof(PerVertexData), offsetof(PerVertexData, texture_x));
-
+	                                     attr_position_, attr_terrain_, attr_texture_position_});
 	gl_state.bind(GL_TEXTURE0, dither_mask_->blit_data().texture_id);
-	gl_state.bind(GL_TEXTURE1, gl_texture);
+	gl_state.bind(GL_TEXTURE1, blit_data.texture_id);
 
 	glUniform1f(u_z_value_, z_value);
 	glUniform1i(u_dither_texture_, 0);
 	glUniform1i(u_terrain_texture_, 1);
-	glUniform2f(u_texture_dimensions_, texture_w, texture_h);
-
-	glDrawArrays(GL_TRIANGLES, 0, vertices_.size());
-}
-
-void DitherProgram::draw(
-   const uint32_t gametime,
-   const Widelands::DescriptionMaintainer<Widelands::TerrainDescription>& terrains,
-   const FieldsToDraw& fields_to_draw,
-   const float z_value) {
-	// This method expects that all terrains have the same dimensions and that
-	// all are packed into the same texture atlas, i.e. all are in the same GL
-	// texture. It does not check for this invariance for speeds sake.
-
-	vertices_.clear();
-	vertices_.reserve(fields_to_draw.size() * 3);
-
-	for (size_t current_index = 0; current_index < fields_to_draw.size(); ++current_index) {
-		const FieldsToDraw::Field& field = fields_to_draw.at(current_index);
-
-		// The bottom right neighbor fields_to_draw is needed for both triangles
-		// associated with this field. If it is not in fields_to_draw, there is no need to
-		// draw any triangles.
-		if (field.brn_index == FieldsToDraw::kInvalidIndex) {
+	glUniform2f(u_texture_dimensions_, texture_coordinates.w, texture_coordinates.h);
+	glUniform4fv(u_texture_offsets_, texture_offsets_.size() / 4, texture_offsets_.data());
+	glUniform2f(u_position_scale_, terrain_mesh->gl_scale().x, terrain_mesh->gl_scale().y);
+
+	using PerVertexData = TerrainMesh::PerVertexData;
+	for (const TerrainMesh::VisibleChunk& visible : terrain_mesh->visible_chunks()) {
+		TerrainMesh::Layer& layer = visible.chunk->dither;
+		if (layer.empty()) {
 			continue;
 		}
-
-		// Dithering triangles for Down triangle.
-		if (field.bln_index != FieldsToDraw::kInvalidIndex) {
-			maybe_add_dithering_triangle(
-			   gametime, terrains, fields_to_draw, field.brn_index, current_index, field.bln_index,
-			   field.fcoords.field->terrain_d(), field.fcoords.field->terrain_r());
-
-			const int terrain_dd = fields_to_draw.at(field.bln_index).fcoords.field->terrain_r();
-			maybe_add_dithering_triangle(gametime, terrains, fields_to_draw, field.bln_index,
-			                             field.brn_index, current_index,
-			                             field.fcoords.field->terrain_d(), terrain_dd);
-
-			if (field.ln_index != FieldsToDraw::kInvalidIndex) {
-				const int terrain_l = fields_to_draw.at(field.ln_index).fcoords.field->terrain_r();
-				maybe_add_dithering_triangle(gametime, terrains, fields_to_draw, current_index,
-				                             field.bln_index, field.brn_index,
-				                             field.fcoords.field->terrain_d(), terrain_l);
-			}
-		}
-
-		// Dithering for right triangle.
-		if (field.rn_index != FieldsToDraw::kInvalidIndex) {
-			maybe_add_dithering_triangle(
-			   gametime, terrains, fields_to_draw, current_index, field.brn_index, field.rn_index,
-			   field.fcoords.field->terrain_r(), field.fcoords.field->terrain_d());
-			int terrain_rr = fields_to_draw.at(field.rn_index).fcoords.field->terrain_d();
-			maybe_add_dithering_triangle(gametime, terrains, fields_to_draw, field.brn_index,
-			                             field.rn_index, current_index,
-			                             field.fcoords.field->terrain_r(), terrain_rr);
-
-			if (field.trn_index != FieldsToDraw::kInvalidIndex) {
-				const int terrain_u = fields_to_draw.at(field.trn_index).fcoords.field->terrain_d();
-				maybe_add_dithering_triangle(gametime, terrains, fields_to_draw, field.rn_index,
-				                             current_index, field.brn_index,
-				                             field.fcoords.field->terrain_r(), terrain_u);
-			}
-		}
+		layer.bind();
+		Gl::vertex_attrib_pointer(
+		   attr_brightness_, 1, sizeof(PerVertexData), offsetof(PerVertexData, brightness));
+		Gl::vertex_attrib_pointer(attr_dither_texture_position_, 2, sizeof(PerVertexData),
+		                          offsetof(PerVertexData, dither_texture_x));
+		Gl::vertex_attrib_pointer(attr_position_, 2, sizeof(PerVertexData), offsetof(PerVertexData, x));
+		Gl::vertex_attrib_pointer(
+		   attr_terrain_, 1, sizeof(PerVertexData), offsetof(PerVertexData, terrain));
+		Gl::vertex_attrib_pointer(
+		   attr_texture_position_, 2, sizeof(PerVertexData), offsetof(PerVertexData, texture_x));
+
+		glUniform2f(u_position_offset_, visible.gl_offset.x, visible.gl_offset.y);
+		glDrawArrays(GL_TRIANGLES, 0, layer.size());
 	}
-
-	const BlitData& blit_data = terrains.get(0).get_texture(0).blit_data();
-	const Rectf texture_coordinates = to_gl_texture(blit_data);
-	gl_draw(blit_data.texture_id, texture_coordinates.w, texture_coordinates.h, z_value);
 }
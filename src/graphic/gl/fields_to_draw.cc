@@ -19,6 +19,10 @@
 
 #include "graphic/gl/fields_to_draw.h"
 
+#include <algorithm>
+
+#include "base/frame_profiler.h"
+#include "base/worker_pool.h"
 #include "graphic/gl/coordinate_conversion.h"
 #include "logic/map_objects/world/terrain_description.h"
 #include "logic/roadtype.h"
@@ -59,19 +63,49 @@
 
 namespace {
 
-// Returns the brightness value in [0, 1.] for 'fcoords'.
-float field_brightness(const Widelands::FCoords& fcoords) {
-	uint32_t brightness = 144 + fcoords.field->get_brightness();
-	brightness = std::min<uint32_t>(255, (brightness * 255) / 160);
-	return brightness / 255.;
+// Views with fewer fields than this per band are filled by one thread.
+constexpr int kMinFieldsPerBand = 2048;
+
+// More bands than threads even out bands that take longer, e.g. because their
+// fields are not in the cache yet.
+constexpr int kBandsPerThread = 4;
+
+uint32_t map_brightness(const Widelands::FCoords& fcoords) {
+	const uint32_t brightness = 144 + fcoords.field->get_brightness();
+	return std::min<uint32_t>(255, (brightness * 255) / 160);
 }
 
 }  // namespace
 
+float field_brightness(const Widelands::FCoords& fcoords) {
+	return map_brightness(fcoords) / 255.;
+}
+
+float field_brightness(const Widelands::FCoords& fcoords,
+                       const uint32_t gametime,
+                       const Widelands::Player::Field& player_field) {
+	if (player_field.vision == 0) {
+		return 0.;
+	}
+
+	uint32_t brightness = map_brightness(fcoords);
+	if (player_field.vision == 1) {
+		const Widelands::Duration time_ago = gametime - player_field.time_node_last_unseen;
+		if (time_ago < kFogFadeTimeInMs) {
+			brightness = (brightness * (2 * kFogFadeTimeInMs - time_ago)) / (2 * kFogFadeTimeInMs);
+		} else {
+			brightness = brightness / 2;
+		}
+	}
+	return brightness / 255.;
+}
+
 void FieldsToDraw::reset(const Widelands::EditorGameBase& egbase,
+                         const Widelands::Player* player,
                          const Vector2f& viewpoint,
                          const float zoom,
                          RenderTarget* dst) {
+	FrameProfiler::Scope profile("FieldsToDraw::reset");
 	assert(viewpoint.x >= 0);  // divisions involving negative numbers are bad
 	assert(viewpoint.y >= 0);
 	assert(dst->get_offset().x <= 0);
@@ -103,8 +137,6 @@ void FieldsToDraw::reset(const Widelands::EditorGameBase& egbase,
 	const int surface_width = surface.width();
 	const int surface_height = surface.height();
 
-	const Widelands::Map& map = egbase.map();
-
 	w_ = max_fx_ - min_fx_ + 1;
 	h_ = max_fy_ - min_fy_ + 1;
 	assert(w_ > 0);
@@ -123,49 +155,97 @@ void FieldsToDraw::reset(const Widelands::EditorGameBase& egbase,
 		fields_.resize(dimension);
 	}
 
-	for (int32_t fy = min_fy_; fy <= max_fy_; ++fy) {
-		for (int32_t fx = min_fx_; fx <= max_fx_; ++fx) {
-			FieldsToDraw::Field& f = fields_[calculate_index(fx, fy)];
-
-			f.geometric_coords = Widelands::Coords(fx, fy);
-
-			f.ln_index = calculate_index(fx - 1, fy);
-			f.rn_index = calculate_index(fx + 1, fy);
-			f.trn_index = calculate_index(fx + (fy & 1), fy - 1);
-			f.bln_index = calculate_index(fx + (fy & 1) - 1, fy + 1);
-			f.brn_index = calculate_index(fx + (fy & 1), fy + 1);
-
-			// Texture coordinates for pseudo random tiling of terrain and road
-			// graphics. Since screen space X increases top-to-bottom and OpenGL
-			// increases bottom-to-top we flip the y coordinate to not have
-			// terrains and road graphics vertically mirrorerd.
-			Vector2f map_pixel =
-			   MapviewPixelFunctions::to_map_pixel_ignoring_height(f.geometric_coords);
-			f.texture_coords.x = map_pixel.x / Widelands::kTextureSideLength;
-			f.texture_coords.y = -map_pixel.y / Widelands::kTextureSideLength;
-
-			Widelands::Coords normalized = f.geometric_coords;
-			map.normalize_coords(normalized);
-			f.fcoords = map.get_fcoords(normalized);
-
-			map_pixel.y -= f.fcoords.field->get_height() * kHeightFactor;
-
-			f.rendertarget_pixel = MapviewPixelFunctions::map_to_panel(viewpoint, zoom, map_pixel);
-			f.gl_position = f.surface_pixel = f.rendertarget_pixel +
-			                                  dst->get_rect().origin().cast<float>() +
-			                                  dst->get_offset().cast<float>();
-			pixel_to_gl_renderbuffer(
-			   surface_width, surface_height, &f.gl_position.x, &f.gl_position.y);
-
-			f.brightness = field_brightness(f.fcoords);
-
-			const Widelands::PlayerNumber owned_by = f.fcoords.field->get_owned_by();
-			f.owner = owned_by != 0 ? egbase.get_player(owned_by) : nullptr;
-			f.is_border = f.fcoords.field->is_border();
-			f.vision = 2;
-			f.road_e = f.fcoords.field->get_road(Widelands::WALK_E);
-			f.road_se = f.fcoords.field->get_road(Widelands::WALK_SE);
-			f.road_sw = f.fcoords.field->get_road(Widelands::WALK_SW);
+	const int surface_offset_x = dst->get_rect().x + dst->get_offset().x;
+	const int surface_offset_y = dst->get_rect().y + dst->get_offset().y;
+	const Widelands::Player* const fog_player =
+	   player != nullptr && !player->see_all() ? player : nullptr;
+	const uint32_t gametime = egbase.get_gametime();
+
+	// Every field only depends on the map and the player's vision, so the rows
+	// are split into bands that are filled in parallel. Small views are not worth
+	// the synchronization.
+	WorkerPool& pool = WorkerPool::for_drawing();
+	const int nr_bands = w_ * h_ < kMinFieldsPerBand * 2 ?
+	                        1 :
+	                        std::min<int>(h_, std::min<int>(pool.concurrency() * kBandsPerThread,
+	                                                        w_ * h_ / kMinFieldsPerBand));
+	pool.run(nr_bands, [&](size_t task) {
+		const int band = task;
+		const int32_t first_fy = min_fy_ + h_ * band / nr_bands;
+		const int32_t last_fy = min_fy_ + h_ * (band + 1) / nr_bands - 1;
+		for (int32_t fy = first_fy; fy <= last_fy; ++fy) {
+			for (int32_t fx = min_fx_; fx <= max_fx_; ++fx) {
+				fill_field(egbase, fog_player, gametime, viewpoint, zoom, surface_offset_x,
+				           surface_offset_y, surface_width, surface_height, fx, fy);
+			}
 		}
+	});
+}
+
+void FieldsToDraw::fill_field(const Widelands::EditorGameBase& egbase,
+                              const Widelands::Player* fog_player,
+                              const uint32_t gametime,
+                              const Vector2f& viewpoint,
+                              const float zoom,
+                              const int surface_offset_x,
+                              const int surface_offset_y,
+                              const int surface_width,
+                              const int surface_height,
+                              const int fx,
+                              const int fy) {
+	const Widelands::Map& map = egbase.map();
+	FieldsToDraw::Field& f = fields_[calculate_index(fx, fy)];
+
+	f.geometric_coords = Widelands::Coords(fx, fy);
+
+	f.ln_index = calculate_index(fx - 1, fy);
+	f.rn_index = calculate_index(fx + 1, fy);
+	f.trn_index = calculate_index(fx + (fy & 1), fy - 1);
+	f.bln_index = calculate_index(fx + (fy & 1) - 1, fy + 1);
+	f.brn_index = calculate_index(fx + (fy & 1), fy + 1);
+
+	// Texture coordinates for pseudo random tiling of terrain and road
+	// graphics. Since screen space X increases top-to-bottom and OpenGL
+	// increases bottom-to-top we flip the y coordinate to not have
+	// terrains and road graphics vertically mirrorerd.
+	Vector2f map_pixel = MapviewPixelFunctions::to_map_pixel_ignoring_height(f.geometric_coords);
+	f.texture_coords.x = map_pixel.x / Widelands::kTextureSideLength;
+	f.texture_coords.y = -map_pixel.y / Widelands::kTextureSideLength;
+
+	Widelands::Coords normalized = f.geometric_coords;
+	map.normalize_coords(normalized);
+	f.fcoords = map.get_fcoords(normalized);
+
+	map_pixel.y -= f.fcoords.field->get_height() * kHeightFactor;
+
+	f.rendertarget_pixel = MapviewPixelFunctions::map_to_panel(viewpoint, zoom, map_pixel);
+	f.gl_position = f.surface_pixel =
+	   f.rendertarget_pixel + Vector2f(surface_offset_x, surface_offset_y);
+	pixel_to_gl_renderbuffer(surface_width, surface_height, &f.gl_position.x, &f.gl_position.y);
+
+	const Widelands::PlayerNumber owned_by = f.fcoords.field->get_owned_by();
+	f.owner = owned_by != 0 ? egbase.get_player(owned_by) : nullptr;
+	f.is_border = f.fcoords.field->is_border();
+
+	if (fog_player == nullptr) {
+		f.brightness = field_brightness(f.fcoords);
+		f.vision = 2;
+		f.road_e = f.fcoords.field->get_road(Widelands::WALK_E);
+		f.road_se = f.fcoords.field->get_road(Widelands::WALK_SE);
+		f.road_sw = f.fcoords.field->get_road(Widelands::WALK_SW);
+		return;
+	}
+
+	// Show what the player knows about this field.
+	const Widelands::Player::Field& player_field =
+	   fog_player->fields()[map.get_index(f.fcoords, map.get_width())];
+	f.brightness = field_brightness(f.fcoords, gametime, player_field);
+	f.vision = player_field.vision;
+	f.road_e = player_field.r_e;
+	f.road_se = player_field.r_se;
+	f.road_sw = player_field.r_sw;
+	if (player_field.vision == 1) {
+		f.owner = player_field.owner != 0 ? egbase.get_player(player_field.owner) : nullptr;
+		f.is_border = player_field.border;
 	}
 }
@@ -30,8 +30,20 @@
 #include "base/vector.h"
 #include "graphic/rendertarget.h"
 #include "logic/editor_game_base.h"
+#include "logic/player.h"
 #include "logic/widelands_geometry.h"
 
+// Returns the brightness value in [0, 1.] for 'fcoords'.
+float field_brightness(const Widelands::FCoords& fcoords);
+
+// Returns the brightness value in [0, 1.] for 'fcoords' at 'gametime' as seen
+// by a player with the knowledge 'player_field'. Fields that the player does
+// not see any more fade to half their brightness over 'kFogFadeTimeInMs'.
+constexpr uint32_t kFogFadeTimeInMs = 20000;
+float field_brightness(const Widelands::FCoords& fcoords,
+                       uint32_t gametime,
+                       const Widelands::Player::Field& player_field);
+
 // Helper struct that contains the data needed for drawing all fields.
 class FieldsToDraw {
 public:
@@ -77,8 +89,11 @@ public:
 		}
 	};
 
-	// Reinitialize for the given view parameters.
+	// Reinitialize for the given view parameters. Brightness, roads, vision and
+	// ownership are what 'player' knows about the fields. Pass nullptr to see
+	// everything. Large views are filled in parallel.
 	void reset(const Widelands::EditorGameBase& egbase,
+	           const Widelands::Player* player,
 	           const Vector2f& viewpoint,
 	           const float zoom,
 	           RenderTarget* dst);
@@ -109,6 +124,20 @@ public:
 	}
 
 private:
+	// Fills the field at the geometric coordinates ('fx', 'fy'). Only writes to
+	// that field, so it can be called for different fields in parallel.
+	void fill_field(const Widelands::EditorGameBase& egbase,
+	                const Widelands::Player* fog_player,
+	                uint32_t gametime,
+	                const Vector2f& viewpoint,
+	                float zoom,
+	                int surface_offset_x,
+	                int surface_offset_y,
+	                int surface_width,
+	                int surface_height,
+	                int fx,
+	                int fy);
+
 	// Minimum and maximum field coordinates (geometric) to render. Can be negative.
 	int min_fx_ = 0;
 	int max_fx_ = 0;
@@ -0,0 +1,392 @@
+/*
+ * Copyright (C) 2019 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include "graphic/gl/terrain_mesh.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+#include "base/frame_profiler.h"
+#include "base/wexception.h"
+#include "graphic/gl/coordinate_conversion.h"
+#include "graphic/gl/fields_to_draw.h"
+#include "graphic/texture.h"
+#include "logic/map_objects/world/world.h"
+#include "wui/mapviewpixelconstants.h"
+#include "wui/mapviewpixelfunctions.h"
+
+/*
+ * The triangles of a chunk are the same as the ones that TerrainProgram and
+ * DitherProgram used to create from FieldsToDraw each frame, see the
+ * explanation in fields_to_draw.cc. Each field owns its (r)ight and (d)own
+ * triangle, so a chunk also needs the vertices of the fields right of and
+ * below it, and the terrains of the fields left of and above it for the
+ * dithering. These can be on the other side of the map.
+ */
+
+namespace {
+
+inline int floor_div(int a, int b) {
+	return a >= 0 ? a / b : -((-a + b - 1) / b);
+}
+
+// A field at the given geometric coordinates, i.e. with coordinates that can
+// be out of bounds of the map, and its vertex data.
+struct MeshNode {
+	Widelands::FCoords fcoords;
+	TerrainMesh::PerVertexData vertex;
+};
+
+enum class TrianglePoint {
+	kTopLeft,
+	kTopRight,
+	kBottomMiddle,
+};
+
+void add_vertex(const MeshNode& node,
+                float terrain,
+                std::vector<TerrainMesh::PerVertexData>* vertices) {
+	vertices->push_back(node.vertex);
+	vertices->back().terrain = terrain;
+}
+
+void add_dither_vertex(const MeshNode& node,
+                       TrianglePoint triangle_point,
+                       float terrain,
+                       std::vector<TerrainMesh::PerVertexData>* vertices) {
+	add_vertex(node, terrain, vertices);
+	TerrainMesh::PerVertexData& back = vertices->back();
+	switch (triangle_point) {
+	case TrianglePoint::kTopRight:
+		back.dither_texture_x = 1.;
+		back.dither_texture_y = 1.;
+		break;
+	case TrianglePoint::kTopLeft:
+		back.dither_texture_x = 0.;
+		back.dither_texture_y = 1.;
+		break;
+	case TrianglePoint::kBottomMiddle:
+		back.dither_texture_x = 0.5;
+		back.dither_texture_y = 0.;
+		break;
+	}
+}
+
+// Adds the dithering triangle between the nodes if my_terrain != other_terrain
+// and the dither_layer() agree.
+void maybe_add_dithering_triangle(
+   const Widelands::DescriptionMaintainer<Widelands::TerrainDescription>& terrains,
+   const MeshNode& node1,
+   const MeshNode& node2,
+   const MeshNode& node3,
+   int my_terrain,
+   int other_terrain,
+   std::vector<TerrainMesh::PerVertexData>* vertices) {
+	if (my_terrain == other_terrain) {
+		return;
+	}
+	if (terrains.get(my_terrain).dither_layer() < terrains.get(other_terrain).dither_layer()) {
+		add_dither_vertex(node1, TrianglePoint::kTopRight, other_terrain, vertices);
+		add_dither_vertex(node2, TrianglePoint::kTopLeft, other_terrain, vertices);
+		add_dither_vertex(node3, TrianglePoint::kBottomMiddle, other_terrain, vertices);
+	}
+}
+
+}  // namespace
+
+constexpr int TerrainMesh::kChunkSize;
+constexpr size_t TerrainMesh::kMaxTerrains;
+
+void TerrainMesh::Layer::bind() {
+	if (gl_buffer_ == nullptr) {
+		gl_buffer_.reset(new Gl::Buffer<PerVertexData>());
+	}
+	gl_buffer_->bind();
+	if (needs_upload_) {
+		gl_buffer_->update(vertices_);
+		needs_upload_ = false;
+		std::vector<PerVertexData>().swap(vertices_);
+	}
+}
+
+TerrainMesh::TerrainMesh() {
+	field_terrain_changed_subscriber_ =
+	   Notifications::subscribe<Widelands::NoteFieldTerrainChanged>(
+	      [this](const Widelands::NoteFieldTerrainChanged& note) { mark_dirty(note.fc, 0); });
+	fields_recalculated_subscriber_ = Notifications::subscribe<Widelands::NoteFieldsRecalculated>(
+	   [this](const Widelands::NoteFieldsRecalculated& note) {
+		   mark_dirty(note.area, note.area.radius);
+	   });
+	field_vision_changed_subscriber_ = Notifications::subscribe<Widelands::NoteFieldVisionChanged>(
+	   [this](const Widelands::NoteFieldVisionChanged& note) {
+		   if (player_ != nullptr && map_width_ > 0 &&
+		       note.player_number == player_->player_number()) {
+			   mark_dirty(Widelands::Coords(note.map_index % map_width_, note.map_index / map_width_),
+			              0);
+		   }
+	   });
+}
+
+void TerrainMesh::invalidate() {
+	for (auto& chunk : chunks_) {
+		chunk->dirty = true;
+	}
+}
+
+void TerrainMesh::mark_dirty(const Widelands::Coords& center, const uint32_t radius) {
+	if (chunks_.empty()) {
+		return;
+	}
+	// Neighbouring fields draw triangles and dithering with this field too.
+	const int r = radius + 2;
+	if (2 * r + 1 >= std::min(map_width_, map_height_)) {
+		invalidate();
+		return;
+	}
+	int last_chunk_x = -1;
+	std::vector<int> chunk_xs;
+	for (int x = center.x - r; x <= center.x + r; ++x) {
+		const int chunk_x = (x - floor_div(x, map_width_) * map_width_) / kChunkSize;
+		if (chunk_x != last_chunk_x) {
+			chunk_xs.push_back(chunk_x);
+			last_chunk_x = chunk_x;
+		}
+	}
+	int last_chunk_y = -1;
+	for (int y = center.y - r; y <= center.y + r; ++y) {
+		const int chunk_y = (y - floor_div(y, map_height_) * map_height_) / kChunkSize;
+		if (chunk_y == last_chunk_y) {
+			continue;
+		}
+		last_chunk_y = chunk_y;
+		for (int chunk_x : chunk_xs) {
+			chunks_[chunk_y * chunks_w_ + chunk_x]->dirty = true;
+		}
+	}
+}
+
+void TerrainMesh::build_chunk(const Widelands::EditorGameBase& egbase,
+                              const Widelands::Player* player,
+                              const int chunk_x,
+                              const int chunk_y,
+                              Chunk* chunk) {
+	const Widelands::Map& map = egbase.map();
+	const auto& terrains = egbase.world().terrains();
+	const uint32_t gametime = egbase.get_gametime();
+
+	const int x0 = chunk_x * kChunkSize;
+	const int y0 = chunk_y * kChunkSize;
+	const int w = std::min(kChunkSize, map_width_ - x0);
+	const int h = std::min(kChunkSize, map_height_ - y0);
+
+	// The nodes of the chunk, with one more row and column on each side.
+	const int nodes_w = w + 2;
+	std::vector<MeshNode> nodes(nodes_w * (h + 2));
+	chunk->fading_until = 0;
+	for (int ny = 0; ny < h + 2; ++ny) {
+		for (int nx = 0; nx < nodes_w; ++nx) {
+			MeshNode& node = nodes[ny * nodes_w + nx];
+			const Widelands::Coords geometric(x0 + nx - 1, y0 + ny - 1);
+			Widelands::Coords normalized = geometric;
+			map.normalize_coords(normalized);
+			node.fcoords = map.get_fcoords(normalized);
+
+			// Texture coordinates for pseudo random tiling of terrain graphics,
+			// flipped like in FieldsToDraw.
+			Vector2f map_pixel = MapviewPixelFunctions::to_map_pixel_ignoring_height(geometric);
+			PerVertexData& vertex = node.vertex;
+			vertex.texture_x = map_pixel.x / Widelands::kTextureSideLength;
+			vertex.texture_y = -map_pixel.y / Widelands::kTextureSideLength;
+			map_pixel.y -= node.fcoords.field->get_height() * kHeightFactor;
+			vertex.x = map_pixel.x;
+			vertex.y = map_pixel.y;
+			vertex.terrain = 0.f;
+			vertex.dither_texture_x = 0.f;
+			vertex.dither_texture_y = 0.f;
+
+			if (player == nullptr) {
+				vertex.brightness = field_brightness(node.fcoords);
+			} else {
+				const Widelands::Player::Field& player_field =
+				   player->fields()[map.get_index(node.fcoords, map_width_)];
+				vertex.brightness = field_brightness(node.fcoords, gametime, player_field);
+				if (player_field.vision == 1 &&
+				    gametime - player_field.time_node_last_unseen < kFogFadeTimeInMs) {
+					chunk->fading_until = std::max(
+					   chunk->fading_until, player_field.time_node_last_unseen + kFogFadeTimeInMs);
+				}
+			}
+		}
+	}
+
+	std::vector<PerVertexData>& terrain_vertices = chunk->terrain.vertices_;
+	std::vector<PerVertexData>& dither_vertices = chunk->dither.vertices_;
+	terrain_vertices.clear();
+	terrain_vertices.reserve(w * h * 6);
+	dither_vertices.clear();
+
+	for (int y = y0; y < y0 + h; ++y) {
+		const int ny = y - y0 + 1;
+		const int odd = y & 1;
+		for (int x = x0; x < x0 + w; ++x) {
+			const int nx = x - x0 + 1;
+			const MeshNode& f = nodes[ny * nodes_w + nx];
+			const MeshNode& l = nodes[ny * nodes_w + nx - 1];
+			const MeshNode& r = nodes[ny * nodes_w + nx + 1];
+			const MeshNode& tr = nodes[(ny - 1) * nodes_w + nx + odd];
+			const MeshNode& bl = nodes[(ny + 1) * nodes_w + nx + odd - 1];
+			const MeshNode& br = nodes[(ny + 1) * nodes_w + nx + odd];
+			const int terrain_d = f.fcoords.field->terrain_d();
+			const int terrain_r = f.fcoords.field->terrain_r();
+
+			// Down triangle.
+			add_vertex(f, terrain_d, &terrain_vertices);
+			add_vertex(bl, terrain_d, &terrain_vertices);
+			add_vertex(br, terrain_d, &terrain_vertices);
+
+			// Right triangle.
+			add_vertex(f, terrain_r, &terrain_vertices);
+			add_vertex(br, terrain_r, &terrain_vertices);
+			add_vertex(r, terrain_r, &terrain_vertices);
+
+			// Dithering triangles for Down triangle.
+			maybe_add_dithering_triangle(
+			   terrains, br, f, bl, terrain_d, terrain_r, &dither_vertices);
+			maybe_add_dithering_triangle(terrains, bl, br, f, terrain_d,
+			                             bl.fcoords.field->terrain_r(), &dither_vertices);
+			maybe_add_dithering_triangle(
+			   terrains, f, bl, br, terrain_d, l.fcoords.field->terrain_r(), &dither_vertices);
+
+			// Dithering for right triangle.
+			maybe_add_dithering_triangle(
+			   terrains, f, br, r, terrain_r, terrain_d, &dither_vertices);
+			maybe_add_dithering_triangle(
+			   terrains, br, r, f, terrain_r, r.fcoords.field->terrain_d(), &dither_vertices);
+			maybe_add_dithering_triangle(
+			   terrains, r, f, br, terrain_r, tr.fcoords.field->terrain_d(), &dither_vertices);
+		}
+	}
+
+	chunk->terrain.nr_vertices_ = terrain_vertices.size();
+	chunk->terrain.needs_upload_ = true;
+	chunk->dither.nr_vertices_ = dither_vertices.size();
+	chunk->dither.needs_upload_ = true;
+	chunk->dirty = false;
+}
+
+void TerrainMesh::update(const Widelands::EditorGameBase& egbase,
+                         const Widelands::Player* player,
+                         const Vector2f& viewpoint,
+                         const float zoom,
+                         const RenderTarget& dst) {
+	FrameProfiler::Scope profile("TerrainMesh::update");
+	assert(viewpoint.x >= 0);  // divisions involving negative numbers are bad
+	assert(viewpoint.y >= 0);
+
+	const Widelands::Map& map = egbase.map();
+	if (map.get_width() != map_width_ || map.get_height() != map_height_) {
+		map_width_ = map.get_width();
+		map_height_ = map.get_height();
+		chunks_w_ = (map_width_ + kChunkSize - 1) / kChunkSize;
+		const int chunks_h = (map_height_ + kChunkSize - 1) / kChunkSize;
+		chunks_.clear();
+		for (int i = 0; i < chunks_w_ * chunks_h; ++i) {
+			chunks_.push_back(std::unique_ptr<Chunk>(new Chunk()));
+		}
+	}
+
+	const Widelands::Player* perspective =
+	   (player != nullptr && !player->see_all()) ? player : nullptr;
+	if (perspective != player_) {
+		player_ = perspective;
+		invalidate();
+	}
+
+	// The same field range as in FieldsToDraw::reset().
+	const Recti& rect = dst.get_rect();
+	const Vector2i& offset = dst.get_offset();
+	const Vector2f br_map = MapviewPixelFunctions::panel_to_map(
+	   viewpoint, zoom, Vector2f(rect.w + std::abs(offset.x), rect.h + std::abs(offset.y)));
+	const int min_fx = std::floor(viewpoint.x / kTriangleWidth) - 2;
+	const int min_fy = std::floor(viewpoint.y / kTriangleHeight) - 2;
+	const int max_fx = std::ceil(br_map.x / kTriangleWidth) + 2;
+	const int max_fy = std::ceil(br_map.y / kTriangleHeight) + 10;
+
+	const float surface_width = dst.get_surface().width();
+	const float surface_height = dst.get_surface().height();
+	const Vector2f origin = rect.origin().cast<float>() + offset.cast<float>();
+	gl_scale_ = Vector2f(2.f / (zoom * surface_width), -2.f / (zoom * surface_height));
+
+	// Chunk columns and rows that are visible, together with the map pixel
+	// offset of the copy of the map they are in.
+	struct Span {
+		int index;
+		float map_offset;
+	};
+	auto visible_spans = [](int min_f, int max_f, int map_size,
+	                        float pixels_per_field) -> std::vector<Span> {
+		std::vector<Span> result;
+		int f = min_f;
+		while (f <= max_f) {
+			const int copy = floor_div(f, map_size);
+			const int local = f - copy * map_size;
+			const int index = local / kChunkSize;
+			result.push_back(Span{index, copy * map_size * pixels_per_field});
+			f += std::min((index + 1) * kChunkSize, map_size) - local;
+		}
+		return result;
+	};
+	const std::vector<Span> columns = visible_spans(min_fx, max_fx, map_width_, kTriangleWidth);
+	const std::vector<Span> rows = visible_spans(min_fy, max_fy, map_height_, kTriangleHeight);
+
+	visible_chunks_.clear();
+	nr_rebuilt_chunks_ = 0;
+	for (const Span& row : rows) {
+		for (const Span& column : columns) {
+			Chunk* chunk = chunks_[row.index * chunks_w_ + column.index].get();
+			if (chunk->dirty || chunk->fading_until != 0) {
+				build_chunk(egbase, player_, column.index, row.index, chunk);
+				++nr_rebuilt_chunks_;
+			}
+			const Vector2f panel = MapviewPixelFunctions::map_to_panel(
+			   viewpoint, zoom, Vector2f(column.map_offset, row.map_offset));
+			visible_chunks_.push_back(
+			   VisibleChunk{chunk, Vector2f((panel.x + origin.x) * 2.f / surface_width - 1.f,
+			                                1.f - (panel.y + origin.y) * 2.f / surface_height)});
+		}
+	}
+}
+
+void TerrainMesh::texture_offsets(
+   const uint32_t gametime,
+   const Widelands::DescriptionMaintainer<Widelands::TerrainDescription>& terrains,
+   std::vector<float>* offsets) {
+	if (terrains.size() > kMaxTerrains) {
+		throw wexception("The terrain shaders support only %" PRIuS " terrains, but there are %" PRIuS,
+		                 kMaxTerrains, static_cast<size_t>(terrains.size()));
+	}
+	offsets->assign(2 * kMaxTerrains, 0.f);
+	for (size_t i = 0; i < terrains.size(); ++i) {
+		const Vector2f origin =
+		   to_gl_texture(terrains.get(i).get_texture(gametime).blit_data()).origin();
+		(*offsets)[2 * i] = origin.x;
+		(*offsets)[2 * i + 1] = origin.y;
+	}
+}
@@ -0,0 +1,188 @@
+/*
+ * Copyright (C) 2019 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#ifndef WL_GRAPHIC_GL_TERRAIN_MESH_H
+#define WL_GRAPHIC_GL_TERRAIN_MESH_H
+
+#include <memory>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/vector.h"
+#include "graphic/gl/utils.h"
+#include "graphic/rendertarget.h"
+#include "logic/editor_game_base.h"
+#include "logic/map.h"
+#include "logic/map_objects/description_maintainer.h"
+#include "logic/map_objects/world/terrain_description.h"
+#include "logic/player.h"
+#include "notifications/notifications.h"
+
+// The vertices of the terrain and dither layers, retained between frames.
+//
+// The map is split into chunks of kChunkSize x kChunkSize fields. The vertices
+// of a chunk are in map pixels and do not depend on the view, so a chunk is
+// only rebuilt when a note tells us that terrain, height or vision of one of its
+// fields changed, and while fields in it fade into the fog. Each frame, 'update'
+// only figures out which chunks are visible and where they go on the screen.
+//
+// Terrain textures are referenced by index, and the shaders look up the current
+// animation frame in the texture atlas, so animated terrains do not need a
+// rebuild either.
+class TerrainMesh {
+public:
+	// Side length of a chunk in fields.
+	static constexpr int kChunkSize = 16;
+
+	// The shaders can look up the textures of this many terrains.
+	static constexpr size_t kMaxTerrains = 128;
+
+	struct PerVertexData {
+		// Position in map pixels.
+		float x;
+		float y;
+		float brightness;
+		float texture_x;
+		float texture_y;
+		// Index of the terrain whose texture is drawn.
+		float terrain;
+		// Only used by the dither layer.
+		float dither_texture_x;
+		float dither_texture_y;
+	};
+	static_assert(sizeof(PerVertexData) == 32, "Wrong padding.");
+
+	// The vertices of one layer of a chunk.
+	class Layer {
+	public:
+		Layer() = default;
+
+		size_t size() const {
+			return nr_vertices_;
+		}
+
+		bool empty() const {
+			return nr_vertices_ == 0;
+		}
+
+		// Binds the GL buffer of this layer. Uploads the vertices first if they
+		// have been rebuilt since the last upload. Needs a GL context.
+		void bind();
+
+	private:
+		friend class TerrainMesh;
+
+		// Only kept until they have been uploaded.
+		std::vector<PerVertexData> vertices_;
+		size_t nr_vertices_ = 0;
+		bool needs_upload_ = false;
+		std::unique_ptr<Gl::Buffer<PerVertexData>> gl_buffer_;
+
+		DISALLOW_COPY_AND_ASSIGN(Layer);
+	};
+
+	struct Chunk {
+		Layer terrain;
+		Layer dither;
+
+		// True if the vertices have to be rebuilt before the next draw.
+		bool dirty = true;
+
+		// Gametime until which fields in this chunk fade into the fog. The chunk
+		// is rebuilt every frame until then.
+		uint32_t fading_until = 0;
+	};
+
+	// A chunk on the screen. The GL position of its vertices is
+	// 'PerVertexData::x/y * gl_scale() + gl_offset'. A chunk can be visible
+	// more than once if the map wraps around in the view.
+	struct VisibleChunk {
+		Chunk* chunk;
+		Vector2f gl_offset;
+	};
+
+	TerrainMesh();
+
+	// Rebuilds visible chunks that have changed and calculates which chunks
+	// are visible in 'dst' for the given view. The brightness is the one that
+	// 'player' sees. Pass nullptr to see everything.
+	void update(const Widelands::EditorGameBase& egbase,
+	            const Widelands::Player* player,
+	            const Vector2f& viewpoint,
+	            float zoom,
+	            const RenderTarget& dst);
+
+	// Marks all chunks to be rebuilt with the next 'update'.
+	void invalidate();
+
+	const std::vector<VisibleChunk>& visible_chunks() const {
+		return visible_chunks_;
+	}
+
+	const Vector2f& gl_scale() const {
+		return gl_scale_;
+	}
+
+	// The number of chunks that have been rebuilt in the last 'update'.
+	size_t nr_rebuilt_chunks() const {
+		return nr_rebuilt_chunks_;
+	}
+
+	// Fills 'offsets' with the origins of the current textures of all
+	// 'terrains' in the texture atlas, in the layout of the 'u_texture_offsets'
+	// uniform of the terrain and dither shaders.
+	static void
+	texture_offsets(uint32_t gametime,
+	                const Widelands::DescriptionMaintainer<Widelands::TerrainDescription>& terrains,
+	                std::vector<float>* offsets);
+
+private:
+	// Marks all chunks that draw fields within 'radius' of 'center' as dirty.
+	void mark_dirty(const Widelands::Coords& center, uint32_t radius);
+
+	void build_chunk(const Widelands::EditorGameBase& egbase,
+	                 const Widelands::Player* player,
+	                 int chunk_x,
+	                 int chunk_y,
+	                 Chunk* chunk);
+
+	// Map dimensions the chunks have been created for.
+	int map_width_ = 0;
+	int map_height_ = 0;
+	int chunks_w_ = 0;
+	std::vector<std::unique_ptr<Chunk>> chunks_;
+
+	// The player whose view is in the chunks, nullptr if they show everything.
+	const Widelands::Player* player_ = nullptr;
+
+	std::vector<VisibleChunk> visible_chunks_;
+	Vector2f gl_scale_ = Vector2f::zero();
+	size_t nr_rebuilt_chunks_ = 0;
+
+	std::unique_ptr<Notifications::Subscriber<Widelands::NoteFieldTerrainChanged>>
+	   field_terrain_changed_subscriber_;
+	std::unique_ptr<Notifications::Subscriber<Widelands::NoteFieldsRecalculated>>
+	   fields_recalculated_subscriber_;
+	std::unique_ptr<Notifications::Subscriber<Widelands::NoteFieldVisionChanged>>
+	   field_vision_changed_subscriber_;
+
+	DISALLOW_COPY_AND_ASSIGN(TerrainMesh);
+};
+
+#endif  // end of include guard: WL_GRAPHIC_GL_TERRAIN_MESH_H
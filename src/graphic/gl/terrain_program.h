@@ -22,8 +22,7 @@
 
 #include <vector>
 
-#include "base/vector.h"
-#include "graphic/gl/fields_to_draw.h"
+#include "graphic/gl/terrain_mesh.h"
 #include "graphic/gl/utils.h"
 #include "logic/map_objects/description_maintainer.h"
 #include "logic/map_objects/world/terrain_description.h"
@@ -33,49 +32,32 @@ public:
 	// Compiles the program. Throws on errors.
 	TerrainProgram();
 
-	// Draws the terrain.
+	// Draws the visible chunks of the terrain.
 	void draw(uint32_t gametime,
 	          const Widelands::DescriptionMaintainer<Widelands::TerrainDescription>& terrains,
-	          const FieldsToDraw& fields_to_draw,
+	          TerrainMesh* terrain_mesh,
 	          float z_value);
 
 private:
-	struct PerVertexData {
-		float gl_x;
-		float gl_y;
-		float brightness;
-		float texture_x;
-		float texture_y;
-		float texture_offset_x;
-		float texture_offset_y;
-	};
-	static_assert(sizeof(PerVertexData) == 28, "Wrong padding.");
-
-	void gl_draw(int gl_texture, float texture_w, float texture_h, float z_value);
-
-	// Adds a vertex to the end of vertices with data from 'field' and 'texture_coordinates'.
-	void add_vertex(const FieldsToDraw::Field& field, const Vector2f& texture_coordinates);
-
 	// The program used for drawing the terrain.
 	Gl::Program gl_program_;
 
-	// The buffer that will contain 'vertices_' for rendering.
-	Gl::Buffer<PerVertexData> gl_array_buffer_;
-
 	// Attributes.
 	GLint attr_brightness_;
 	GLint attr_position_;
-	GLint attr_texture_offset_;
+	GLint attr_terrain_;
 	GLint attr_texture_position_;
 
 	// Uniforms.
+	GLint u_position_offset_;
+	GLint u_position_scale_;
 	GLint u_terrain_texture_;
 	GLint u_texture_dimensions_;
+	GLint u_texture_offsets_;
 	GLint u_z_value_;
 
-	// Objects below are kept around to avoid memory allocations on each frame.
-	// They could theoretically also be recreated.
-	std::vector<PerVertexData> vertices_;
+	// Kept around to avoid memory allocations on each frame.
+	std::vector<float> texture_offsets_;
 
 	DISALLOW_COPY_AND_ASSIGN(TerrainProgram);
 };
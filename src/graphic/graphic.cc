@@ -21,6 +21,7 @@
 
 #include <memory>
 
+#include "base/frame_profiler.h"
 #include "base/i18n.h"
 #include "base/log.h"
 #include "base/wexception.h"
@@ -231,7 +232,10 @@ void Graphic::set_fullscreen(const bool value) {
  * Bring the screen uptodate.
  */
 void Graphic::refresh() {
-	RenderQueue::instance().draw(screen_->width(), screen_->height());
+	{
+		FrameProfiler::Scope profile("RenderQueue::draw");
+		RenderQueue::instance().draw(screen_->width(), screen_->height());
+	}
 
 	// Setting the window size immediately after going out of fullscreen does
 	// not work properly. We work around this issue by resizing the window in
@@ -254,6 +258,7 @@ void Graphic::refresh() {
 		screenshot_filename_.clear();
 	}
 
+	FrameProfiler::Scope profile("SDL_GL_SwapWindow");
 	SDL_GL_SwapWindow(sdl_window_);
 }
 
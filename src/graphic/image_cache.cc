@@ -19,6 +19,7 @@
 
 #include "graphic/image_cache.h"
 
+#include <algorithm>
 #include <cassert>
 #include <memory>
 #include <set>
@@ -67,3 +68,16 @@ const Image* ImageCache::get(const std::string& hash) {
 	}
 	return it->second.get();
 }
+
+void ImageCache::preload(const std::vector<std::string>& hashes) {
+	std::vector<std::string> missing;
+	for (const std::string& hash : hashes) {
+		if (!has(hash) && std::find(missing.begin(), missing.end(), hash) == missing.end()) {
+			missing.push_back(hash);
+		}
+	}
+	std::vector<DecodedImage> decoded = decode_images(missing);
+	for (size_t i = 0; i < missing.size(); ++i) {
+		images_.insert(std::make_pair(missing[i], create_texture(decoded[i])));
+	}
+}
@@ -19,17 +19,25 @@
 
 #include "graphic/image_io.h"
 
+#include <algorithm>
+#include <cassert>
+#include <cstring>
 #include <memory>
+#include <vector>
 
 #include <SDL.h>
 #include <SDL_image.h>
 #include <png.h>
 
 #include "base/log.h"
+#include "base/md5.h"
 #include "base/wexception.h"
+#include "base/worker_pool.h"
+#include "graphic/sdl_utils.h"
 #include "graphic/texture.h"
 #include "io/fileread.h"
 #include "io/filesystem/layered_filesystem.h"
+#include "io/filewrite.h"
 #include "io/streamwrite.h"
 
 namespace {
@@ -46,23 +54,283 @@ void png_flush_function(png_structp png_ptr) {
 	static_cast<StreamWrite*>(png_get_io_ptr(png_ptr))->flush();
 }
 
-inline void ensure_sdl_image_is_initialized() {
-	static bool is_initialized = false;
-	if (!is_initialized) {
-		IMG_Init(IMG_INIT_JPG | IMG_INIT_PNG);
-		is_initialized = true;
+// Where decode_images() keeps decoded pixels. Empty if it does not.
+std::string decoded_image_cache;
+
+// Marks the files in the decoded image cache, and increased whenever their layout changes.
+constexpr uint32_t kDecodedImageMagic = 0x57494d31;  // "WIM1"
+
+// Reads the PNG for decode_png from memory.
+struct PngSource {
+	const uint8_t* data;
+	size_t size;
+	size_t position;
+};
+
+void png_read_function(png_structp png_ptr, png_bytep png_data, png_size_t length) {
+	PngSource* source = static_cast<PngSource*>(png_get_io_ptr(png_ptr));
+	if (source->size - source->position < length) {
+		png_error(png_ptr, "unexpected end of file");
+	}
+	memcpy(png_data, source->data + source->position, length);
+	source->position += length;
+}
+
+void png_error_function(png_structp png_ptr, png_const_charp message) {
+	// There is no way to hand the message to the caller through the longjmp().
+	log("libpng: %s\n", message);
+	png_longjmp(png_ptr, 1);
+}
+
+void png_warning_function(png_structp, png_const_charp) {
+}
+
+// Decodes the PNG in 'data' with libpng. libpng undoes the row filters itself,
+// with SIMD where it was built with support for it, and writes each row right
+// where it ends up in 'image'.
+void decode_png(const std::string& fname, const void* data, size_t size, DecodedImage* image) {
+	PngSource source{static_cast<const uint8_t*>(data), size, 0};
+	png_structp png_ptr = png_create_read_struct(
+	   PNG_LIBPNG_VER_STRING, nullptr, &png_error_function, &png_warning_function);
+	if (!png_ptr) {
+		throw ImageLoadingError(fname, "could not create png struct");
+	}
+	png_infop info_ptr = png_create_info_struct(png_ptr);
+	if (!info_ptr) {
+		png_destroy_read_struct(&png_ptr, nullptr, nullptr);
+		throw ImageLoadingError(fname, "could not create png info struct");
+	}
+	std::vector<png_bytep> rows;
+
+	// Set jump for error
+	if (setjmp(png_jmpbuf(png_ptr))) {  // NOLINT
+		png_destroy_read_struct(&png_ptr, &info_ptr, nullptr);
+		throw ImageLoadingError(fname, "invalid PNG");
+	}
+	png_set_read_fn(png_ptr, &source, &png_read_function);
+	png_read_info(png_ptr, info_ptr);
+
+	png_uint_32 width, height;
+	int bit_depth, color_type;
+	png_get_IHDR(
+	   png_ptr, info_ptr, &width, &height, &bit_depth, &color_type, nullptr, nullptr, nullptr);
+
+	// Ask libpng for 8 bit RGBA, whatever is in the file.
+	if (bit_depth == 16) {
+		png_set_strip_16(png_ptr);
+	}
+	if (color_type == PNG_COLOR_TYPE_PALETTE) {
+		png_set_palette_to_rgb(png_ptr);
+	}
+	if (color_type == PNG_COLOR_TYPE_GRAY && bit_depth < 8) {
+		png_set_expand_gray_1_2_4_to_8(png_ptr);
+	}
+	const bool has_transparency = png_get_valid(png_ptr, info_ptr, PNG_INFO_tRNS);
+	if (has_transparency) {
+		png_set_tRNS_to_alpha(png_ptr);
+	}
+	if (color_type == PNG_COLOR_TYPE_GRAY || color_type == PNG_COLOR_TYPE_GRAY_ALPHA) {
+		png_set_gray_to_rgb(png_ptr);
+	}
+	if (!(color_type & PNG_COLOR_MASK_ALPHA) && !has_transparency) {
+		png_set_filler(png_ptr, 0xff, PNG_FILLER_AFTER);
+	}
+	png_set_interlace_handling(png_ptr);
+	png_read_update_info(png_ptr, info_ptr);
+	if (png_get_rowbytes(png_ptr, info_ptr) != 4 * width) {
+		png_error(png_ptr, "unsupported pixel format");
+	}
+
+	image->width = width;
+	image->height = height;
+	image->pixels.resize(4 * width * height);
+	rows.resize(height);
+	for (png_uint_32 y = 0; y < height; ++y) {
+		rows[y] = image->pixels.data() + 4 * width * (height - 1 - y);
+	}
+	png_read_image(png_ptr, rows.data());
+	png_read_end(png_ptr, nullptr);
+	png_destroy_read_struct(&png_ptr, &info_ptr, nullptr);
+}
+
+// Converts 'surface' into 'image' and frees it.
+void surface_to_decoded_image(SDL_Surface* surface, DecodedImage* image) {
+	SDL_Surface* converted = empty_sdl_surface(surface->w, surface->h);
+	SDL_SetSurfaceAlphaMod(surface, SDL_ALPHA_OPAQUE);
+	SDL_SetSurfaceBlendMode(surface, SDL_BLENDMODE_NONE);
+	SDL_BlitSurface(surface, nullptr, converted, nullptr);
+	SDL_FreeSurface(surface);
+
+	image->width = converted->w;
+	image->height = converted->h;
+	image->pixels.resize(4 * converted->w * converted->h);
+	SDL_LockSurface(converted);
+	const size_t row_size = 4 * converted->w;
+	for (int y = 0; y < converted->h; ++y) {
+		memcpy(image->pixels.data() + row_size * (converted->h - 1 - y),
+		       static_cast<const uint8_t*>(converted->pixels) + converted->pitch * y, row_size);
+	}
+	SDL_UnlockSurface(converted);
+	SDL_FreeSurface(converted);
+}
+
+std::string decoded_image_cache_filename(const Md5Checksum& checksum) {
+	return decoded_image_cache + "/" + checksum.str();
+}
+
+// Returns false if the decoded image cache has no usable entry for 'checksum'.
+bool read_decoded_image(const Md5Checksum& checksum, DecodedImage* image) {
+	FileRead fr;
+	if (!fr.try_open(*g_fs, decoded_image_cache_filename(checksum))) {
+		return false;
+	}
+	try {
+		if (fr.unsigned_32() != kDecodedImageMagic) {
+			return false;
+		}
+		const uint32_t width = fr.unsigned_32();
+		const uint32_t height = fr.unsigned_32();
+		if (fr.get_size() != 12 + 4ULL * width * height) {
+			return false;
+		}
+		image->width = width;
+		image->height = height;
+		image->pixels.resize(4 * width * height);
+		fr.data_complete(image->pixels.data(), image->pixels.size());
+	} catch (const std::exception&) {
+		return false;
+	}
+	return true;
+}
+
+void write_decoded_image(const Md5Checksum& checksum, const DecodedImage& image) {
+	try {
+		FileWrite fw;
+		fw.unsigned_32(kDecodedImageMagic);
+		fw.unsigned_32(image.width);
+		fw.unsigned_32(image.height);
+		fw.data(image.pixels.data(), image.pixels.size());
+		fw.write(*g_fs, decoded_image_cache_filename(checksum));
+	} catch (const std::exception& e) {
+		log("Could not cache a decoded image: %s\n", e.what());
+	}
+}
+
+// Deletes the oldest files in 'directory' until the rest take at most 'max_size' bytes. Images
+// that are still in use are written again when they are decoded the next time.
+void prune_decoded_image_cache(const std::string& directory, uint64_t max_size) {
+	std::vector<std::pair<FileStamp, std::string>> files;
+	uint64_t total_size = 0;
+	for (const std::string& filename : g_fs->list_directory(directory)) {
+		const FileStamp stamp = g_fs->file_stamp(filename);
+		files.push_back(std::make_pair(stamp, filename));
+		total_size += stamp.size;
 	}
+	if (total_size <= max_size) {
+		return;
+	}
+	std::sort(files.begin(), files.end(), [](const std::pair<FileStamp, std::string>& a,
+	                                         const std::pair<FileStamp, std::string>& b) {
+		return a.first.modified < b.first.modified;
+	});
+	for (const auto& file : files) {
+		if (total_size <= max_size) {
+			break;
+		}
+		try {
+			g_fs->fs_unlink(file.second);
+			total_size -= file.first.size;
+		} catch (const std::exception& e) {
+			log("Could not delete %s from the decoded image cache: %s\n", file.second.c_str(),
+			    e.what());
+		}
+	}
+}
+
+inline void ensure_sdl_image_is_initialized() {
+	// Initialization of function statics is thread safe.
+	static const bool is_initialized = (IMG_Init(IMG_INIT_JPG | IMG_INIT_PNG), true);
+	assert(is_initialized);
 }
 
 }  // namespace
 
 std::unique_ptr<Texture> load_image(const std::string& fname, FileSystem* fs) {
-	return std::unique_ptr<Texture>(new Texture(load_image_as_sdl_surface(fname, fs)));
+	return create_texture(decode_images(std::vector<std::string>{fname}, fs).front());
 }
 
-SDL_Surface* load_image_as_sdl_surface(const std::string& fname, FileSystem* fs) {
-	ensure_sdl_image_is_initialized();
+std::vector<DecodedImage> decode_images(const std::vector<std::string>& filenames,
+                                        FileSystem* fs) {
+	if (fs == nullptr) {
+		fs = g_fs;
+	}
+	const bool use_cache = !decoded_image_cache.empty();
+	std::vector<DecodedImage> images(filenames.size());
+	std::vector<std::unique_ptr<FileRead>> files(filenames.size());
+	std::vector<Md5Checksum> checksums(use_cache ? filenames.size() : 0);
+	std::vector<bool> decoded(filenames.size(), false);
 
+	for (size_t i = 0; i < filenames.size(); ++i) {
+		files[i].reset(new FileRead());
+		if (!files[i]->try_open(*fs, filenames[i])) {
+			throw ImageNotFound(filenames[i]);
+		}
+	}
+
+	if (use_cache) {
+		WorkerPool::for_loading().run(filenames.size(), [&files, &checksums](size_t i) {
+			SimpleMD5Checksum md5sum;
+			md5sum.data(files[i]->data(0), files[i]->get_size());
+			md5sum.finish_checksum();
+			checksums[i] = md5sum.get_checksum();
+		});
+		for (size_t i = 0; i < filenames.size(); ++i) {
+			if (read_decoded_image(checksums[i], &images[i])) {
+				decoded[i] = true;
+				files[i].reset();
+			}
+		}
+	}
+
+	WorkerPool::for_loading().run(
+	   filenames.size(), [&filenames, &files, &decoded, &images](size_t i) {
+		   if (!decoded[i]) {
+			   decode_image(filenames[i], files[i]->data(0), files[i]->get_size(), &images[i]);
+		   }
+	   });
+
+	if (use_cache) {
+		for (size_t i = 0; i < filenames.size(); ++i) {
+			if (!decoded[i]) {
+				write_decoded_image(checksums[i], images[i]);
+			}
+		}
+	}
+	return images;
+}
+
+void decode_image(const std::string& fname, const void* data, size_t size, DecodedImage* image) {
+	static const uint8_t kPngSignature[] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+	if (size >= sizeof(kPngSignature) && memcmp(data, kPngSignature, sizeof(kPngSignature)) == 0) {
+		decode_png(fname, data, size, image);
+	} else {
+		surface_to_decoded_image(decode_image_as_sdl_surface(fname, data, size), image);
+	}
+}
+
+std::unique_ptr<Texture> create_texture(const DecodedImage& image) {
+	return std::unique_ptr<Texture>(new Texture(image.width, image.height, image.pixels.data()));
+}
+
+void set_decoded_image_cache(const std::string& directory, uint64_t max_size) {
+	decoded_image_cache = directory;
+	if (!directory.empty()) {
+		g_fs->ensure_directory_exists(directory);
+		prune_decoded_image_cache(directory, max_size);
+	}
+}
+
+SDL_Surface* load_image_as_sdl_surface(const std::string& fname, FileSystem* fs) {
 	FileRead fr;
 	bool found;
 	if (fs) {
@@ -75,7 +343,13 @@ SDL_Surface* load_image_as_sdl_surface(const std::string& fname, FileSystem* fs)
 		throw ImageNotFound(fname);
 	}
 
-	SDL_Surface* sdlsurf = IMG_Load_RW(SDL_RWFromMem(fr.data(0), fr.get_size()), 1);
+	return decode_image_as_sdl_surface(fname, fr.data(0), fr.get_size());
+}
+
+SDL_Surface* decode_image_as_sdl_surface(const std::string& fname, const void* data, size_t size) {
+	ensure_sdl_image_is_initialized();
+
+	SDL_Surface* sdlsurf = IMG_Load_RW(SDL_RWFromConstMem(data, size), 1);
 	if (!sdlsurf) {
 		throw ImageLoadingError(fname, IMG_GetError());
 	}
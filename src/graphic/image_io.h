@@ -22,6 +22,9 @@
 
 #include <memory>
 #include <string>
+#include <vector>
+
+#include <stdint.h>
 
 #include "base/wexception.h"
 
@@ -43,13 +46,44 @@ public:
 	}
 };
 
+/// The pixels of a decoded image in the layout that Texture uploads: RGBA with 8 bits per
+/// channel and the rows from bottom to top.
+struct DecodedImage {
+	int width = 0;
+	int height = 0;
+	std::vector<uint8_t> pixels;
+};
+
 /// Loads the image 'fn' from 'fs'.
 std::unique_ptr<Texture> load_image(const std::string& fn, FileSystem* fs = nullptr);
 
+/// Loads the images 'filenames' from 'fs'. The files are read on this thread, which must be the
+/// main thread, and decoded on WorkerPool::for_loading().
+std::vector<DecodedImage> decode_images(const std::vector<std::string>& filenames,
+                                        FileSystem* fs = nullptr);
+
+/// Decodes the contents 'data' of the image file 'fn'. PNGs are decoded by libpng directly into
+/// the final layout, everything else goes through SDL_image. This can be called from several
+/// threads at once.
+void decode_image(const std::string& fn, const void* data, size_t size, DecodedImage* image);
+
+/// Uploads 'image' into a new texture. Needs the GL context.
+std::unique_ptr<Texture> create_texture(const DecodedImage& image);
+
+/// Keeps the pixels of all images that decode_images() decodes in 'directory' of g_fs, keyed by
+/// the MD5 of the image file, so that they do not have to be decoded again on the next start.
+/// An empty 'directory' disables this, which is the default. Nothing is removed while the game
+/// runs; this deletes the oldest files until the cache takes at most 'max_size' bytes.
+void set_decoded_image_cache(const std::string& directory, uint64_t max_size);
+
 /// Loads the image 'fn' from 'fs' into an SDL_Surface. Caller must SDL_FreeSurface() the returned
 /// value.
 SDL_Surface* load_image_as_sdl_surface(const std::string& fn, FileSystem* fs = nullptr);
 
+/// Decodes the contents 'data' of the image file 'fn' into an SDL_Surface. Caller must
+/// SDL_FreeSurface() the returned value. This can be called from several threads at once.
+SDL_Surface* decode_image_as_sdl_surface(const std::string& fn, const void* data, size_t size);
+
 /// Saves the 'texture' to 'sw' as a PNG.
 enum class ColorType { RGB, RGBA };
 bool save_to_png(Texture* texture, StreamWrite* sw, ColorType color_type);
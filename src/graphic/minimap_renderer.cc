@@ -19,6 +19,7 @@
 
 #include "graphic/minimap_renderer.h"
 
+#include <algorithm>
 #include <memory>
 
 #include "base/macros.h"
@@ -85,11 +86,27 @@ inline RGBColor calc_minimap_color(const Widelands::EditorGameBase& egbase,
 	return color;
 }
 
+inline bool same_rect(const Rectf& a, const Rectf& b) {
+	return a.x == b.x && a.y == b.y && a.w == b.w && a.h == b.h;
+}
+
+// Sets the pixel at ('x', 'y') in 'pixels', which are 'width' x 'height'
+// pixels, bottom row first.
+inline void set_pixel(int x, int y, int width, int height, const RGBColor& color, uint8_t* pixels) {
+	uint8_t* pixel = &pixels[4 * ((height - y - 1) * width + x)];
+	pixel[0] = color.r;
+	pixel[1] = color.g;
+	pixel[2] = color.b;
+	pixel[3] = 255;
+}
+
 void draw_view_window(const Map& map,
                       const Rectf& view_area,
                       const MiniMapType minimap_type,
                       const bool zoom,
-                      Texture* texture) {
+                      const int width,
+                      const int height,
+                      uint8_t* pixels) {
 	const float multiplier = scale_map(map, zoom);
 	const int half_width =
 	   round_up_to_nearest_even(std::ceil(view_area.w / kTriangleWidth * multiplier / 2.f));
@@ -99,7 +116,7 @@ void draw_view_window(const Map& map,
 	Vector2i center_pixel = Vector2i::zero();
 	switch (minimap_type) {
 	case MiniMapType::kStaticViewWindow:
-		center_pixel = Vector2i(texture->width() / 2, texture->height() / 2);
+		center_pixel = Vector2i(width / 2, height / 2);
 		break;
 
 	case MiniMapType::kStaticMap: {
@@ -111,9 +128,7 @@ void draw_view_window(const Map& map,
 	}
 	}
 
-	const int width = map.get_width() * scale_map(map, zoom);
-	const int height = map.get_height() * scale_map(map, zoom);
-	const auto make_red = [width, height, &texture](int x, int y) {
+	const auto make_red = [width, height, pixels](int x, int y) {
 		if (x < 0) {
 			x += width;
 		}
@@ -126,7 +141,7 @@ void draw_view_window(const Map& map,
 		if (y >= height) {
 			y -= height;
 		}
-		texture->set_pixel(x, y, kRed);
+		set_pixel(x, y, width, height, kRed, pixels);
 	};
 
 	bool draw = true;
@@ -148,52 +163,6 @@ void draw_view_window(const Map& map,
 	}
 }
 
-// Does the actual work of drawing the minimap.
-void do_draw_minimap(Texture* texture,
-                     const Widelands::EditorGameBase& egbase,
-                     const Widelands::Player* player,
-                     const Vector2i& top_left,
-                     MiniMapLayer layers) {
-	const Widelands::Map& map = egbase.map();
-	const uint16_t surface_h = texture->height();
-	const uint16_t surface_w = texture->width();
-	const int32_t mapwidth = map.get_width();
-
-	for (uint32_t y = 0; y < surface_h; ++y) {
-		for (uint32_t x = 0; x < surface_w; ++x) {
-			Widelands::Coords coords(
-			   Widelands::Coords(top_left.x + x / scale_map(map, layers & MiniMapLayer::Zoom2),
-			                     top_left.y + y / scale_map(map, layers & MiniMapLayer::Zoom2)));
-			map.normalize_coords(coords);
-			Widelands::FCoords f = map.get_fcoords(coords);
-			Widelands::MapIndex i = Widelands::Map::get_index(f, mapwidth);
-			move_r(mapwidth, f, i);
-
-			uint16_t vision = 0;  // See Player::Field::Vision: 1 if seen once, > 1 if seen right now.
-			Widelands::PlayerNumber owner = 0;
-			if (player == nullptr || player->see_all()) {
-				// This player has omnivision - show the field like it is in reality.
-				vision = 2;  // Seen right now.
-				owner = f.field->get_owned_by();
-			} else if (player != nullptr) {
-				// This player might be affected by fog of war - instead of the
-				// reality, we show her what she last saw on this field. If she has
-				// vision of this field, this will be the same as reality -
-				// otherwise this shows reality as it was the last time she had
-				// vision on the field.
-				// If she never had vision, field.vision will be 0.
-				const auto& field = player->fields()[i];
-				vision = field.vision;
-				owner = field.owner;
-			}
-
-			if (vision > 0) {
-				texture->set_pixel(x, y, calc_minimap_color(egbase, f, layers, owner, vision > 1));
-			}
-		}
-	}
-}
-
 }  // namespace
 
 Vector2f minimap_pixel_to_mappixel(const Widelands::Map& map,
@@ -221,39 +190,210 @@ Vector2f minimap_pixel_to_mappixel(const Widelands::Map& map,
 	return map_pixel;
 }
 
-std::unique_ptr<Texture> draw_minimap(const EditorGameBase& egbase,
-                                      const Player* player,
-                                      const Rectf& view_area,
-                                      const MiniMapType& minimap_type,
-                                      MiniMapLayer layers) {
-	// TODO(sirver): Currently the minimap is redrawn every frame. That is not really
-	//       necessary. The created texture could be cached and only redrawn two
-	//       or three times per second
-	const Map& map = egbase.map();
-	const int16_t map_w = map.get_width() * scale_map(map, layers & MiniMapLayer::Zoom2);
-	const int16_t map_h = map.get_height() * scale_map(map, layers & MiniMapLayer::Zoom2);
+constexpr int MiniMapRenderer::kColorLayers;
+
+MiniMapRenderer::MiniMapRenderer(const EditorGameBase& egbase) : egbase_(egbase) {
+	field_possession_subscriber_ = Notifications::subscribe<NoteFieldPossession>(
+	   [this](const NoteFieldPossession& note) { mark_dirty(note.fc); });
+	field_player_immovable_changed_subscriber_ =
+	   Notifications::subscribe<NoteFieldPlayerImmovableChanged>(
+	      [this](const NoteFieldPlayerImmovableChanged& note) { mark_dirty(note.fc); });
+	field_terrain_changed_subscriber_ = Notifications::subscribe<NoteFieldTerrainChanged>(
+	   [this](const NoteFieldTerrainChanged& note) { mark_dirty(note.fc); });
+	fields_recalculated_subscriber_ = Notifications::subscribe<NoteFieldsRecalculated>(
+	   [this](const NoteFieldsRecalculated& note) { mark_dirty(note.area); });
+	field_vision_changed_subscriber_ =
+	   Notifications::subscribe<NoteFieldVisionChanged>([this](const NoteFieldVisionChanged& note) {
+		   if (player_ != nullptr && note.player_number == player_->player_number()) {
+			   const Map& map = egbase_.map();
+			   mark_dirty(map.get_fcoords(map[note.map_index]));
+		   }
+	   });
+}
 
-	std::unique_ptr<Texture> texture(new Texture(map_w, map_h));
+void MiniMapRenderer::mark_dirty(const FCoords& f) {
+	const Map& map = egbase_.map();
+	if (map.get_width() != map_width_ || map.get_height() != map_height_) {
+		return;
+	}
+	// The pixel of a node shows its right neighbour, see 'update'.
+	const MapIndex index = Map::get_index(map.l_n(f), map_width_);
+	for (auto& colors : node_colors_) {
+		NodeColors* node_colors = colors.second.get();
+		if (node_colors->all_dirty || node_colors->is_dirty[index]) {
+			continue;
+		}
+		node_colors->is_dirty[index] = true;
+		node_colors->dirty.push_back(index);
+	}
+}
 
-	texture->fill_rect(
-	   Rectf(0.f, 0.f, texture->width(), texture->height()), RGBAColor(0, 0, 0, 255));
+void MiniMapRenderer::mark_dirty(const Area<FCoords>& area) {
+	if (2 * area.radius + 2 >= std::min(map_width_, map_height_)) {
+		mark_all_dirty();
+		return;
+	}
+	// Marking the bounding rectangle is cheaper than walking the hexagon.
+	const Map& map = egbase_.map();
+	const int radius = area.radius;
+	for (int y = area.y - radius; y <= area.y + radius; ++y) {
+		for (int x = area.x - radius; x <= area.x + radius + 1; ++x) {
+			Coords coords(x, y);
+			map.normalize_coords(coords);
+			mark_dirty(map.get_fcoords(coords));
+		}
+	}
+}
+
+void MiniMapRenderer::mark_all_dirty() {
+	for (auto& colors : node_colors_) {
+		colors.second->all_dirty = true;
+	}
+}
+
+bool MiniMapRenderer::update(const Player* player, MiniMapLayer layers, NodeColors* colors) {
+	if (!colors->all_dirty && colors->dirty.empty()) {
+		return false;
+	}
+
+	const Map& map = egbase_.map();
+	const auto update_node = [this, player, layers, &map, colors](MapIndex index) {
+		// Like the terrain, the pixel of a node shows the triangles to its right.
+		FCoords f = map.get_fcoords(map[index]);
+		MapIndex i = index;
+		move_r(map_width_, f, i);
+
+		uint16_t vision = 0;  // See Player::Field::Vision: 1 if seen once, > 1 if seen right now.
+		PlayerNumber owner = 0;
+		if (player == nullptr || player->see_all()) {
+			// This player has omnivision - show the field like it is in reality.
+			vision = 2;  // Seen right now.
+			owner = f.field->get_owned_by();
+		} else {
+			// This player might be affected by fog of war - instead of the
+			// reality, we show them what they last saw on this field. If they have
+			// vision of this field, this will be the same as reality -
+			// otherwise this shows reality as it was the last time they had
+			// vision on the field.
+			// If they never had vision, field.vision will be 0.
+			const auto& field = player->fields()[i];
+			vision = field.vision;
+			owner = field.owner;
+		}
+
+		const RGBColor color =
+		   vision > 0 ? calc_minimap_color(egbase_, f, layers, owner, vision > 1) : RGBColor();
+		uint8_t* pixel = &colors->pixels[4 * index];
+		pixel[0] = color.r;
+		pixel[1] = color.g;
+		pixel[2] = color.b;
+		pixel[3] = 255;
+	};
+
+	if (colors->all_dirty) {
+		const MapIndex max_index = map.max_index();
+		for (MapIndex index = 0; index < max_index; ++index) {
+			update_node(index);
+		}
+		colors->all_dirty = false;
+		std::fill(colors->is_dirty.begin(), colors->is_dirty.end(), false);
+	} else {
+		for (MapIndex index : colors->dirty) {
+			update_node(index);
+			colors->is_dirty[index] = false;
+		}
+	}
+	colors->dirty.clear();
+	return true;
+}
+
+const Texture* MiniMapRenderer::draw(const Player* player,
+                                     const Rectf& view_area,
+                                     const MiniMapType minimap_type,
+                                     const MiniMapLayer layers) {
+	const Map& map = egbase_.map();
+	if (map.get_width() != map_width_ || map.get_height() != map_height_) {
+		map_width_ = map.get_width();
+		map_height_ = map.get_height();
+		node_colors_.clear();
+		texture_.reset();
+	}
+	const bool see_all = player == nullptr || player->see_all();
+	if (player != player_ || see_all != see_all_) {
+		player_ = player;
+		see_all_ = see_all;
+		mark_all_dirty();
+	}
+
+	std::unique_ptr<NodeColors>& colors = node_colors_[static_cast<int>(layers) & kColorLayers];
+	if (colors == nullptr) {
+		colors.reset(new NodeColors());
+		colors->pixels.resize(4 * map.max_index());
+		colors->is_dirty.resize(map.max_index());
+	}
+	const bool colors_changed = update(player, layers, colors.get());
 
-	// Center the view on the middle of the 'view_area'.
 	const bool zoom = layers & MiniMapLayer::Zoom2;
-	Vector2f top_left =
-	   minimap_pixel_to_mappixel(map, Vector2i::zero(), view_area, minimap_type, zoom);
-	const Coords node =
-	   MapviewPixelFunctions::calc_node_and_triangle(map, top_left.x, top_left.y).node;
+	const int scale = scale_map(map, zoom);
+	const int width = map_width_ * scale;
+	const int height = map_height_ * scale;
 
-	texture->lock();
-	do_draw_minimap(texture.get(), egbase, player, Vector2i(node.x, node.y), layers);
+	// Center the view on the middle of the 'view_area'.
+	const Vector2f top_left_pixel =
+	   minimap_pixel_to_mappixel(map, Vector2i::zero(), view_area, minimap_type, zoom);
+	const Coords top_left =
+	   MapviewPixelFunctions::calc_node_and_triangle(map, top_left_pixel.x, top_left_pixel.y).node;
+
+	const bool show_view_window = layers & MiniMapLayer::ViewWindow;
+	if (texture_ != nullptr && texture_->width() == width && texture_->height() == height &&
+	    !colors_changed && top_left == top_left_ && layers == layers_ &&
+	    minimap_type == minimap_type_ && (!show_view_window || same_rect(view_area, view_area_))) {
+		return texture_.get();
+	}
+	if (texture_ == nullptr || texture_->width() != width || texture_->height() != height) {
+		texture_.reset(new Texture(width, height));
+	}
+	top_left_ = top_left;
+	layers_ = layers;
+	minimap_type_ = minimap_type;
+	view_area_ = view_area;
+
+	// Copy the node colors into the texture, rotated so that 'top_left' is at
+	// (0, 0), and scaled up.
+	texture_pixels_.resize(4 * width * height);
+	const uint8_t* node_pixels = colors->pixels.data();
+	for (int y = 0; y < height; ++y) {
+		const int node_y = (top_left.y + y / scale) % map_height_;
+		const uint8_t* node_row = &node_pixels[4 * node_y * map_width_];
+		uint8_t* row = &texture_pixels_[4 * (height - y - 1) * width];
+		if (scale == 1) {
+			const int first_part = map_width_ - top_left.x;
+			std::copy(node_row + 4 * top_left.x, node_row + 4 * map_width_, row);
+			std::copy(node_row, node_row + 4 * top_left.x, row + 4 * first_part);
+			continue;
+		}
+		for (int x = 0; x < width; ++x) {
+			const int node_x = (top_left.x + x / scale) % map_width_;
+			std::copy(node_row + 4 * node_x, node_row + 4 * node_x + 4, row + 4 * x);
+		}
+	}
 
-	if (layers & MiniMapLayer::ViewWindow) {
-		draw_view_window(map, view_area, minimap_type, zoom, texture.get());
+	if (show_view_window) {
+		draw_view_window(
+		   map, view_area, minimap_type, zoom, width, height, texture_pixels_.data());
 	}
-	texture->unlock(Texture::Unlock_Update);
+	texture_->set_pixels(texture_pixels_.data());
+	return texture_.get();
+}
 
-	return texture;
+std::unique_ptr<Texture> draw_minimap(const EditorGameBase& egbase,
+                                      const Player* player,
+                                      const Rectf& view_area,
+                                      const MiniMapType& minimap_type,
+                                      MiniMapLayer layers) {
+	MiniMapRenderer renderer(egbase);
+	renderer.draw(player, view_area, minimap_type, layers);
+	return renderer.release_texture();
 }
 
 int scale_map(const Widelands::Map& map, bool zoom) {
@@ -20,14 +20,19 @@
 #ifndef WL_GRAPHIC_MINIMAP_RENDERER_H
 #define WL_GRAPHIC_MINIMAP_RENDERER_H
 
+#include <map>
 #include <memory>
+#include <vector>
 
+#include "base/macros.h"
 #include "base/rect.h"
 #include "base/vector.h"
 #include "graphic/texture.h"
 #include "logic/editor_game_base.h"
 #include "logic/map.h"
+#include "logic/map_objects/immovable.h"
 #include "logic/player.h"
+#include "notifications/notifications.h"
 
 // Layers for selecting what do display on the minimap.
 enum class MiniMapLayer {
@@ -41,7 +46,7 @@ enum class MiniMapLayer {
 };
 
 // A bunch of operators that turn MiniMapLayer into a bitwise combinable flag class.
-inline MiniMapLayer operator|(MiniMapLayer left, MiniMapLayer right) {
+constexpr MiniMapLayer operator|(MiniMapLayer left, MiniMapLayer right) {
 	return MiniMapLayer(static_cast<int>(left) | static_cast<int>(right));
 }
 inline int operator&(MiniMapLayer left, MiniMapLayer right) {
@@ -67,11 +72,90 @@ Vector2f minimap_pixel_to_mappixel(const Widelands::Map& map,
                                    MiniMapType minimap_type,
                                    const bool zoom);
 
+// Keeps the colors of all nodes of the minimap between frames, one buffer per
+// combination of layers. Notes about changed ownership, player immovables,
+// terrains, heights and vision mark nodes as dirty, and only those are
+// recalculated when the minimap is drawn the next time. The texture is only
+// uploaded when something on it has changed, and then in one go.
+class MiniMapRenderer {
+public:
+	explicit MiniMapRenderer(const Widelands::EditorGameBase& egbase);
+
+	// Brings the minimap texture up to date and returns it. The arguments are
+	// the same as for 'draw_minimap' below. The texture is owned by this and
+	// stays valid until the next call.
+	const Texture* draw(const Widelands::Player* player,
+	                    const Rectf& view_area,
+	                    MiniMapType minimap_type,
+	                    MiniMapLayer layers);
+
+	// Hands the texture of the last 'draw' over to the caller.
+	std::unique_ptr<Texture> release_texture() {
+		return std::move(texture_);
+	}
+
+private:
+	// The colors of all nodes for one combination of layers.
+	struct NodeColors {
+		// 4 bytes (R, G, B, A) per node, in the order of the map indices.
+		std::vector<uint8_t> pixels;
+		// Nodes that need to be recalculated.
+		std::vector<Widelands::MapIndex> dirty;
+		std::vector<bool> is_dirty;
+		bool all_dirty = true;
+	};
+
+	// The layers that change the colors of the nodes.
+	static constexpr int kColorLayers = static_cast<int>(
+	   MiniMapLayer::Terrain | MiniMapLayer::Owner | MiniMapLayer::Flag | MiniMapLayer::Road |
+	   MiniMapLayer::Building);
+
+	// Marks the pixel that shows 'f'.
+	void mark_dirty(const Widelands::FCoords& f);
+	void mark_dirty(const Widelands::Area<Widelands::FCoords>& area);
+	void mark_all_dirty();
+
+	// Recalculates the dirty nodes in 'colors'. Returns true if there were any.
+	bool update(const Widelands::Player* player, MiniMapLayer layers, NodeColors* colors);
+
+	const Widelands::EditorGameBase& egbase_;
+
+	// What the buffers have been calculated for.
+	int16_t map_width_ = 0;
+	int16_t map_height_ = 0;
+	const Widelands::Player* player_ = nullptr;
+	bool see_all_ = false;
+	std::map<int, std::unique_ptr<NodeColors>> node_colors_;
+
+	// What the texture shows right now.
+	std::unique_ptr<Texture> texture_;
+	Widelands::Coords top_left_ = Widelands::Coords::null();
+	MiniMapLayer layers_ = MiniMapLayer::Terrain;
+	Rectf view_area_;
+	MiniMapType minimap_type_ = MiniMapType::kStaticMap;
+	// The pixels that are uploaded to 'texture_', bottom row first.
+	std::vector<uint8_t> texture_pixels_;
+
+	std::unique_ptr<Notifications::Subscriber<Widelands::NoteFieldPossession>>
+	   field_possession_subscriber_;
+	std::unique_ptr<Notifications::Subscriber<Widelands::NoteFieldPlayerImmovableChanged>>
+	   field_player_immovable_changed_subscriber_;
+	std::unique_ptr<Notifications::Subscriber<Widelands::NoteFieldTerrainChanged>>
+	   field_terrain_changed_subscriber_;
+	std::unique_ptr<Notifications::Subscriber<Widelands::NoteFieldsRecalculated>>
+	   fields_recalculated_subscriber_;
+	std::unique_ptr<Notifications::Subscriber<Widelands::NoteFieldVisionChanged>>
+	   field_vision_changed_subscriber_;
+
+	DISALLOW_COPY_AND_ASSIGN(MiniMapRenderer);
+};
+
 // Render the minimap. If player is not nullptr, it renders from that player's
 // point of view. The 'view_area' designates the currently visible area in the
 // main view in map pixel coordinates and is used to draw the wire frame view
 // window. The 'view_point' is map pixel that will be drawn as the top-left
-// point in the resulting minimap.
+// point in the resulting minimap. This draws everything from scratch, use a
+// MiniMapRenderer to draw the minimap repeatedly.
 std::unique_ptr<Texture> draw_minimap(const Widelands::EditorGameBase& egbase,
                                       const Widelands::Player* player,
                                       const Rectf& view_area,
@@ -49,7 +49,7 @@ inline float to_opengl_z(const int z) {
 //   - we batch up by program to have maximal batching.
 //   - and we want to render frontmost objects first, so that we do not render
 //     any pixel more than once.
-static_assert(RenderQueue::Program::kHighestProgramId <= 8,
+static_assert(RenderQueue::Program::kHighestProgramId <= 16,
               "Need to change sorting keys.");  // 4 bits.
 
 uint64_t
@@ -142,6 +142,9 @@ ScopedScissor::~ScopedScissor() {
 
 RenderQueue::RenderQueue()
    : next_z_(1),
+     sprite_batching_(false),
+     open_sprite_batch_(-1),
+     nr_sprite_batches_(0),
      terrain_program_(new TerrainProgram()),
      dither_program_(new DitherProgram()),
      workarea_program_(new WorkareaProgram()),
@@ -155,10 +158,27 @@ RenderQueue& RenderQueue::instance() {
 	return render_queue;
 }
 
+RenderQueue::ScopedSpriteBatch::ScopedSpriteBatch() {
+	RenderQueue& queue = RenderQueue::instance();
+	assert(!queue.sprite_batching_);
+	queue.sprite_batching_ = true;
+	queue.open_sprite_batch_ = -1;
+}
+
+RenderQueue::ScopedSpriteBatch::~ScopedSpriteBatch() {
+	RenderQueue& queue = RenderQueue::instance();
+	queue.sprite_batching_ = false;
+	queue.open_sprite_batch_ = -1;
+}
+
 void RenderQueue::enqueue(const Item& given_item) {
 	Item* item;
 	uint32_t extra_value = 0;
 
+	// Whatever comes after this item has to be drawn on top of it, so the next
+	// blit cannot go into a batch that was opened before.
+	open_sprite_batch_ = -1;
+
 	switch (given_item.program_id) {
 	case Program::kBlit:
 		extra_value = given_item.blit_arguments.texture.texture_id;
@@ -166,6 +186,7 @@ void RenderQueue::enqueue(const Item& given_item) {
 
 	case Program::kLine:
 	case Program::kRect:
+	case Program::kSpriteBatch:
 	case Program::kTerrainBase:
 	case Program::kTerrainDither:
 	case Program::kTerrainWorkarea:
@@ -192,6 +213,40 @@ void RenderQueue::enqueue(const Item& given_item) {
 	++next_z_;
 }
 
+void RenderQueue::enqueue_blit(const BlendMode blend_mode, const BlitArguments& arguments) {
+	if (!sprite_batching_) {
+		Item i;
+		i.program_id = Program::kBlit;
+		i.blend_mode = blend_mode;
+		i.blit_arguments = arguments;
+		enqueue(i);
+		return;
+	}
+
+	if (open_sprite_batch_ < 0) {
+		if (nr_sprite_batches_ == sprite_batches_.size()) {
+			sprite_batches_.emplace_back();
+		}
+		// Sprites can be partially transparent, so the batch is drawn with the
+		// blended items. Opaque sprites still overwrite what is below them,
+		// because BlitProgram honors the blend mode of each sprite.
+		Item i;
+		i.program_id = Program::kSpriteBatch;
+		i.blend_mode = BlendMode::UseAlpha;
+		i.sprite_batch_arguments.index = nr_sprite_batches_;
+		enqueue(i);
+		open_sprite_batch_ = nr_sprite_batches_++;
+	}
+
+	std::vector<BlitProgram::Arguments>& sprites = sprite_batches_[open_sprite_batch_];
+	// All sprites of a batch share the z-layer of its item, the one that was
+	// enqueued last.
+	sprites.push_back(BlitProgram::Arguments{arguments.destination_rect,
+	                                         blended_items_.back().z_value, arguments.texture,
+	                                         arguments.mask, arguments.blend, blend_mode,
+	                                         arguments.mode});
+}
+
 void RenderQueue::draw(const int screen_width, const int screen_height) {
 	// TODO(sirver): If next_z >= kMaximumZValue here, we ran out of z-layers to
 	// correctly order the drawing of our objects (see
@@ -219,6 +274,12 @@ void RenderQueue::draw(const int screen_width, const int screen_height) {
 	draw_items(blended_items_);
 	blended_items_.clear();
 
+	for (size_t i = 0; i < nr_sprite_batches_; ++i) {
+		sprite_batches_[i].clear();
+	}
+	nr_sprite_batches_ = 0;
+	open_sprite_batch_ = -1;
+
 	glDisable(GL_DEPTH_TEST);
 	next_z_ = 1;
 }
@@ -242,18 +303,22 @@ void RenderQueue::draw_items(const std::vector<Item>& items) {
 			   batch_up<FillRectProgram::Arguments>(Program::kRect, items, &i));
 			break;
 
+		case Program::kSpriteBatch:
+			BlitProgram::instance().draw(sprite_batches_[item.sprite_batch_arguments.index]);
+			++i;
+			break;
+
 		case Program::kTerrainBase: {
 			ScopedScissor scoped_scissor(item.terrain_arguments.destination_rect);
 			terrain_program_->draw(item.terrain_arguments.gametime, *item.terrain_arguments.terrains,
-			                       *item.terrain_arguments.fields_to_draw, item.z_value);
+			                       item.terrain_arguments.terrain_mesh, item.z_value);
 			++i;
 		} break;
 
 		case Program::kTerrainDither: {
 			ScopedScissor scoped_scissor(item.terrain_arguments.destination_rect);
 			dither_program_->draw(item.terrain_arguments.gametime, *item.terrain_arguments.terrains,
-			                      *item.terrain_arguments.fields_to_draw,
-			                      item.z_value + kOpenGlZDelta);
+			                      item.terrain_arguments.terrain_mesh, item.z_value + kOpenGlZDelta);
 			++i;
 		} break;
 
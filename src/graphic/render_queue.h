@@ -30,8 +30,10 @@
 #include "graphic/blend_mode.h"
 #include "graphic/blit_mode.h"
 #include "graphic/color.h"
+#include "graphic/gl/blit_program.h"
 #include "graphic/gl/draw_line_program.h"
 #include "graphic/gl/fields_to_draw.h"
+#include "graphic/gl/terrain_mesh.h"
 #include "logic/map_objects/description_maintainer.h"
 #include "logic/map_objects/world/terrain_description.h"
 
@@ -73,6 +75,13 @@ class WorkareaProgram;
 // but are still immediately executed. The RenderQueue is only used for
 // rendering onto the screen.
 //
+// Crowded map views blit tens of thousands of sprites per frame. To avoid
+// paying for an Item, a z-layer and a sort key per sprite, the map views open a
+// ScopedSpriteBatch while they draw the objects on the fields. All blits in
+// this scope are appended to a flat array of BlitProgram::Arguments that shares
+// one Item and one z-layer, in the order they were made. Anything else that is
+// enqueued in between closes the batch, so the drawing order does not change.
+//
 // TODO(sirver): we could (even) better performance by being z-layer aware
 // while drawing. For example the UI could draw non-overlapping windows and
 // sibling children with the same z-value for better batching. Also for example
@@ -90,6 +99,7 @@ public:
 		kBlit,
 		kRect,
 		kLine,
+		kSpriteBatch,
 		kHighestProgramId,
 	};
 
@@ -123,11 +133,27 @@ public:
 		int renderbuffer_height = 0;
 		const Widelands::DescriptionMaintainer<Widelands::TerrainDescription>* terrains = nullptr;
 		const FieldsToDraw* fields_to_draw = nullptr;
+		TerrainMesh* terrain_mesh = nullptr;
 		Workareas workareas;
 		float scale = 1.f;
 		Rectf destination_rect = Rectf(0.f, 0.f, 0.f, 0.f);
 	};
 
+	struct SpriteBatchArguments {
+		// Index into the sprite batches of this frame.
+		size_t index = 0;
+	};
+
+	// Enables sprite batching for its lifetime, see the class comment.
+	class ScopedSpriteBatch {
+	public:
+		ScopedSpriteBatch();
+		~ScopedSpriteBatch();
+
+	private:
+		DISALLOW_COPY_AND_ASSIGN(ScopedSpriteBatch);
+	};
+
 	// The union of all possible program arguments represents an Item that is
 	// enqueued in the Queue. This is on purpose not done with OOP so that the
 	// queue is more cache friendly.
@@ -159,6 +185,7 @@ public:
 		TerrainArguments terrain_arguments;
 		RectArguments rect_arguments;
 		LineArguments line_arguments;
+		SpriteBatchArguments sprite_batch_arguments;
 	};
 
 	static RenderQueue& instance();
@@ -166,6 +193,10 @@ public:
 	// Enqueues 'item' in the queue with a higher 'z' value than the last enqueued item.
 	void enqueue(const Item& item);
 
+	// Enqueues a blit. While a ScopedSpriteBatch exists, the blit is appended
+	// to the current sprite batch instead of getting an Item of its own.
+	void enqueue_blit(BlendMode blend_mode, const BlitArguments& arguments);
+
 	// Draws all items in the queue in an optimal ordering and as much batching
 	// as possible. This will draw one complete frame onto the screen and this
 	// function is the only one that actually triggers draws to the screen
@@ -181,6 +212,18 @@ private:
 	// of everything before.
 	int next_z_;
 
+	// True while a ScopedSpriteBatch exists.
+	bool sprite_batching_;
+
+	// Index of the sprite batch that blits are appended to, or -1 if the next
+	// blit starts a new batch.
+	int open_sprite_batch_;
+
+	// The sprite batches of this frame are the first 'nr_sprite_batches_'
+	// entries. The others are kept around so that their memory can be reused.
+	size_t nr_sprite_batches_;
+	std::vector<std::vector<BlitProgram::Arguments>> sprite_batches_;
+
 	std::unique_ptr<TerrainProgram> terrain_program_;
 	std::unique_ptr<DitherProgram> dither_program_;
 	std::unique_ptr<WorkareaProgram> workarea_program_;
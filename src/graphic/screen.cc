@@ -57,44 +57,26 @@ void Screen::do_blit(const Rectf& dst_rect,
                      const BlitData& texture,
                      float opacity,
                      BlendMode blend_mode) {
-	RenderQueue::Item i;
-	i.program_id = RenderQueue::Program::kBlit;
-	i.blend_mode = blend_mode;
-	i.blit_arguments.blend = RGBAColor(0, 0, 0, 255 * opacity);
-	i.blit_arguments.destination_rect = dst_rect;
-	i.blit_arguments.mask.texture_id = 0;
-	i.blit_arguments.mode = BlitMode::kDirect;
-	i.blit_arguments.texture = texture;
-	RenderQueue::instance().enqueue(i);
+	RenderQueue::instance().enqueue_blit(
+	   blend_mode, RenderQueue::BlitArguments{BlitMode::kDirect, texture, BlitData{0, 0, 0, Rectf()},
+	                                          RGBAColor(0, 0, 0, 255 * opacity), dst_rect});
 }
 
 void Screen::do_blit_blended(const Rectf& dst_rect,
                              const BlitData& texture,
                              const BlitData& mask,
                              const RGBColor& blend) {
-	RenderQueue::Item i;
-	i.program_id = RenderQueue::Program::kBlit;
-	i.blend_mode = BlendMode::UseAlpha;
-	i.blit_arguments.blend = blend;
-	i.blit_arguments.destination_rect = dst_rect;
-	i.blit_arguments.mask = mask;
-	i.blit_arguments.mode = BlitMode::kBlendedWithMask;
-	i.blit_arguments.texture = texture;
-	RenderQueue::instance().enqueue(i);
+	RenderQueue::instance().enqueue_blit(
+	   BlendMode::UseAlpha,
+	   RenderQueue::BlitArguments{BlitMode::kBlendedWithMask, texture, mask, blend, dst_rect});
 }
 
 void Screen::do_blit_monochrome(const Rectf& dst_rect,
                                 const BlitData& texture,
                                 const RGBAColor& blend) {
-	RenderQueue::Item i;
-	i.program_id = RenderQueue::Program::kBlit;
-	i.blend_mode = BlendMode::UseAlpha;
-	i.blit_arguments.blend = blend;
-	i.blit_arguments.destination_rect = dst_rect;
-	i.blit_arguments.mask.texture_id = 0;
-	i.blit_arguments.mode = BlitMode::kMonochrome;
-	i.blit_arguments.texture = texture;
-	RenderQueue::instance().enqueue(i);
+	RenderQueue::instance().enqueue_blit(
+	   BlendMode::UseAlpha, RenderQueue::BlitArguments{BlitMode::kMonochrome, texture,
+	                                                   BlitData{0, 0, 0, Rectf()}, blend, dst_rect});
 }
 
 void Screen::do_draw_line_strip(std::vector<DrawLineProgram::PerVertexData> vertices) {
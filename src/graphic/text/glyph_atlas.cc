@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2019 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include "graphic/text/glyph_atlas.h"
+
+#include <algorithm>
+#include <memory>
+
+#include <SDL.h>
+
+namespace RT {
+
+namespace {
+
+// Side length of the atlas textures. Glyphs of the font sizes that we use are
+// far smaller, so a page holds hundreds of them.
+constexpr int kPageSize = 512;
+
+// Transparent pixels between the glyphs, so that linear filtering never picks
+// up a neighbor.
+constexpr int kPadding = 1;
+
+// Keeps the page texture alive as long as a glyph on it is used.
+struct GlyphImage {
+	std::shared_ptr<Texture> page;
+	std::unique_ptr<Texture> texture;
+};
+
+}  // namespace
+
+const GlyphAtlas::Glyph*
+GlyphAtlas::get(TTF_Font* font, const std::string& font_key, const uint16_t codepoint) {
+	std::unique_ptr<Glyph>& glyph = glyphs_[font_key][codepoint];
+	if (glyph != nullptr) {
+		return glyph.get();
+	}
+
+	int minx, maxx, miny, maxy, advance;
+	if (codepoint == 0 || TTF_GlyphMetrics(font, codepoint, &minx, &maxx, &miny, &maxy, &advance)) {
+		return nullptr;
+	}
+
+	std::shared_ptr<const Image> image;
+	if (maxx > minx) {
+		// Rendering the glyph as a string of its own puts it exactly where it
+		// would be at the start of a string. SDL_ttf shifts glyphs that
+		// reach left of the pen position to the right.
+		const uint16_t text[] = {codepoint, 0};
+		const SDL_Color white = {255, 255, 255, SDL_ALPHA_OPAQUE};
+		SDL_Surface* surface = TTF_RenderUNICODE_Blended(font, text, white);
+		if (surface == nullptr) {
+			return nullptr;
+		}
+		image = add_to_page(surface);
+		if (image == nullptr) {
+			return nullptr;
+		}
+	}
+
+	glyph.reset(new Glyph());
+	glyph->image = image;
+	glyph->offset_x = std::min(minx, 0);
+	glyph->advance = advance;
+	return glyph.get();
+}
+
+std::shared_ptr<const Image> GlyphAtlas::add_to_page(SDL_Surface* surface) {
+	const int w = surface->w;
+	const int h = surface->h;
+	if (w + kPadding > kPageSize || h + kPadding > kPageSize) {
+		SDL_FreeSurface(surface);
+		return nullptr;
+	}
+
+	if (!pages_.empty()) {
+		Page& page = pages_.back();
+		if (page.shelf_x + w + kPadding > kPageSize) {
+			page.shelf_x = 0;
+			page.shelf_y += page.shelf_height;
+			page.shelf_height = 0;
+		}
+	}
+	if (pages_.empty() || pages_.back().shelf_y + h + kPadding > kPageSize) {
+		Page page;
+		page.texture.reset(new Texture(kPageSize, kPageSize));
+		page.texture->fill_rect(Rectf(0.f, 0.f, kPageSize, kPageSize), RGBAColor(0, 0, 0, 0));
+		pages_.push_back(page);
+	}
+
+	Page& page = pages_.back();
+	const Recti rect(page.shelf_x, page.shelf_y, w, h);
+	{
+		// Takes ownership of 'surface'.
+		Texture glyph_texture(surface);
+		page.texture->blit(Rectf(rect.x, rect.y, w, h), glyph_texture, Rectf(0.f, 0.f, w, h), 1.,
+		                   BlendMode::Copy);
+	}
+	page.shelf_x += w + kPadding;
+	page.shelf_height = std::max(page.shelf_height, h + kPadding);
+
+	std::shared_ptr<GlyphImage> glyph_image(new GlyphImage());
+	glyph_image->page = page.texture;
+	glyph_image->texture.reset(
+	   new Texture(page.texture->blit_data().texture_id, rect, kPageSize, kPageSize));
+	return std::shared_ptr<const Image>(glyph_image, glyph_image->texture.get());
+}
+
+}  // namespace RT
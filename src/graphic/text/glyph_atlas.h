@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2019 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#ifndef WL_GRAPHIC_TEXT_GLYPH_ATLAS_H
+#define WL_GRAPHIC_TEXT_GLYPH_ATLAS_H
+
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <SDL_ttf.h>
+
+#include "base/macros.h"
+#include "graphic/image.h"
+#include "graphic/texture.h"
+
+namespace RT {
+
+/**
+ * Every glyph that has been needed for text so far, rendered once in white and
+ * packed into a few big textures. Text is drawn by blitting the glyphs in the
+ * text color, so the memory needed grows with the number of different glyphs
+ * instead of with the number of different strings, and all glyphs on a page
+ * are drawn in one batch by the RenderQueue.
+ *
+ * The pages are never freed while any glyph image on them is still referenced.
+ */
+class GlyphAtlas {
+public:
+	struct Glyph {
+		// The glyph in white. nullptr for glyphs without any pixels, e.g. spaces.
+		std::shared_ptr<const Image> image;
+		// Where the left edge of 'image' goes relative to the pen position.
+		int offset_x;
+		// How far the pen moves after this glyph.
+		int advance;
+	};
+
+	GlyphAtlas() = default;
+
+	// Returns the glyph for 'codepoint' in 'font', rendering it into the atlas
+	// the first time. 'font_key' has to identify the font's face and size.
+	// Returns nullptr if the glyph can not be put into the atlas.
+	const Glyph* get(TTF_Font* font, const std::string& font_key, uint16_t codepoint);
+
+private:
+	struct Page {
+		std::shared_ptr<Texture> texture;
+		// The shelf that glyphs are currently added to.
+		int shelf_x = 0;
+		int shelf_y = 0;
+		int shelf_height = 0;
+	};
+
+	// Copies 'surface' into a page and returns its image there, or nullptr if
+	// it does not fit into a page. Takes ownership of 'surface'.
+	std::shared_ptr<const Image> add_to_page(SDL_Surface* surface);
+
+	std::map<std::string, std::unordered_map<uint16_t, std::unique_ptr<Glyph>>> glyphs_;
+	std::vector<Page> pages_;
+
+	DISALLOW_COPY_AND_ASSIGN(GlyphAtlas);
+};
+
+}  // namespace RT
+
+#endif  // end of include guard: WL_GRAPHIC_TEXT_GLYPH_ATLAS_H
@@ -19,11 +19,46 @@
 
 #include "graphic/text/rendered_text.h"
 
+#include <algorithm>
 #include <memory>
 
 #include "graphic/graphic.h"
 
 namespace UI {
+
+namespace {
+
+// Draws the part 'source_rect' of 'glyphs' at 'destination', like
+// RenderTarget::blitrect() does for images.
+void blit_glyphs(RenderTarget& dst,
+                 const Vector2i& destination,
+                 const GlyphRun& glyphs,
+                 const Recti& source_rect) {
+	for (const GlyphRun::Glyph& glyph : glyphs.glyphs) {
+		const int left = std::max(glyph.position.x, source_rect.x);
+		const int top = std::max(glyph.position.y, source_rect.y);
+		const int right =
+		   std::min(glyph.position.x + glyph.image->width(), source_rect.x + source_rect.w);
+		const int bottom =
+		   std::min(glyph.position.y + glyph.image->height(), source_rect.y + source_rect.h);
+		if (left >= right || top >= bottom) {
+			continue;
+		}
+		const Vector2i glyph_destination =
+		   destination + Vector2i(left - source_rect.x, top - source_rect.y);
+		if (right - left == glyph.image->width() && bottom - top == glyph.image->height()) {
+			dst.blit_monochrome(glyph_destination, glyph.image.get(), glyph.color);
+		} else {
+			dst.blitrect_scale_monochrome(
+			   Rectf(glyph_destination.cast<float>(), right - left, bottom - top), glyph.image.get(),
+			   Recti(left - glyph.position.x, top - glyph.position.y, right - left, bottom - top),
+			   glyph.color);
+		}
+	}
+}
+
+}  // namespace
+
 // RenderedRect
 RenderedRect::RenderedRect(const Recti& init_rect,
                            std::shared_ptr<const Image> init_image,
@@ -77,11 +112,25 @@ RenderedRect::RenderedRect(const Image* init_image)
                   DrawMode::kBlit) {
 }
 
+RenderedRect::RenderedRect(std::shared_ptr<const GlyphRun> init_glyphs)
+   : RenderedRect(Recti(0, 0, init_glyphs->width, init_glyphs->height),
+                  nullptr,
+                  false,
+                  RGBColor(0, 0, 0),
+                  false,
+                  DrawMode::kBlit) {
+	glyphs_ = init_glyphs;
+}
+
 const Image* RenderedRect::image() const {
 	assert(permanent_image_ == nullptr || transient_image_ == nullptr);
 	return permanent_image_ == nullptr ? transient_image_.get() : permanent_image_;
 }
 
+const GlyphRun* RenderedRect::glyphs() const {
+	return glyphs_.get();
+}
+
 int RenderedRect::x() const {
 	return rect_.x;
 }
@@ -209,6 +258,14 @@ void RenderedText::blit_rect(RenderTarget& dst,
 			dst.tile(Recti(blit_point, rect.width(), rect.height()), rect.image(), Vector2i::zero());
 			break;
 		}
+	} else if (rect.glyphs() != nullptr) {
+		switch (cropmode) {
+		case CropMode::kRenderTarget:
+			blit_glyphs(dst, blit_point, *rect.glyphs(), Recti(0, 0, rect.width(), rect.height()));
+			break;
+		case CropMode::kSelf:
+			blit_cropped(dst, offset_x, aligned_position, blit_point, rect, region, align);
+		}
 	}
 }
 
@@ -250,12 +307,17 @@ void RenderedText::blit_cropped(RenderTarget& dst,
 		return;
 	}
 
-	dst.blitrect(
-	   Vector2i(cropped_left > 0 ?
-	               position.x + region.x - (align == UI::Align::kRight ? region.w : region.w / 2) :
-	               blit_point.x,
-	            blit_point.y),
-	   rect.image(), Recti(cropped_left > 0 ? cropped_left : 0, region.y, blit_width, region.h));
+	const Vector2i destination(
+	   cropped_left > 0 ?
+	      position.x + region.x - (align == UI::Align::kRight ? region.w : region.w / 2) :
+	      blit_point.x,
+	   blit_point.y);
+	const Recti source_rect(cropped_left > 0 ? cropped_left : 0, region.y, blit_width, region.h);
+	if (rect.glyphs() != nullptr) {
+		blit_glyphs(dst, destination, *rect.glyphs(), source_rect);
+	} else {
+		dst.blitrect(destination, rect.image(), source_rect);
+	}
 }
 
 }  // namespace UI
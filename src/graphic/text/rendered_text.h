@@ -31,6 +31,20 @@
 
 namespace UI {
 
+/// The glyphs that show a word, positioned relative to its top left corner. The
+/// glyph images are white and drawn in 'color'. They come from the few shared
+/// textures of the glyph atlas, so the RenderQueue draws them in batches.
+struct GlyphRun {
+	struct Glyph {
+		std::shared_ptr<const Image> image;
+		Vector2i position;
+		RGBAColor color;
+	};
+	std::vector<Glyph> glyphs;
+	int width = 0;
+	int height = 0;
+};
+
 /// A rectangle that contains blitting information for rendered text.
 class RenderedRect {
 public:
@@ -70,12 +84,18 @@ public:
 	/// RenderedRect will contain a normal image that is managed by a permanent cache.
 	/// Use this if the image is managed by g_gr->images().
 	explicit RenderedRect(const Image* init_image);
+
+	/// RenderedRect will contain glyphs from the glyph atlas.
+	explicit RenderedRect(std::shared_ptr<const GlyphRun> init_glyphs);
 	~RenderedRect() {
 	}
 
 	/// An image to be blitted. Can be nullptr.
 	const Image* image() const;
 
+	/// Glyphs to be blitted instead of an image. Can be nullptr.
+	const GlyphRun* glyphs() const;
+
 	/// The x position of the rectangle
 	int x() const;
 	/// The y position of the rectangle
@@ -108,6 +128,7 @@ private:
 	// time.
 	std::shared_ptr<const Image> transient_image_;  // Shared ownership, managed by a transient cache
 	const Image* permanent_image_;                  // Not owned, managed by a permanent cache
+	std::shared_ptr<const GlyphRun> glyphs_;
 	bool visited_;
 	const RGBColor background_color_;
 	const bool is_background_color_set_;
@@ -115,11 +115,17 @@ struct NodeStyle {
  */
 class FontCache {
 public:
-	FontCache() = default;
+	// 'glyph_atlas' can be nullptr and is not owned.
+	explicit FontCache(GlyphAtlas* glyph_atlas) : glyph_atlas_(glyph_atlas) {
+	}
 	~FontCache();
 
 	IFont& get_font(NodeStyle* style);
 
+	GlyphAtlas* glyph_atlas() const {
+		return glyph_atlas_;
+	}
+
 private:
 	struct FontDescr {
 		std::string face;
@@ -133,6 +139,7 @@ private:
 	using FontMapPair = std::pair<const FontDescr, std::unique_ptr<IFont>>;
 
 	FontMap fontmap_;
+	GlyphAtlas* const glyph_atlas_;
 
 	DISALLOW_COPY_AND_ASSIGN(FontCache);
 };
@@ -640,10 +647,18 @@ uint16_t TextNode::hotspot_y() const {
 }
 
 std::shared_ptr<UI::RenderedText> TextNode::render(TextureCache* texture_cache) {
+	std::shared_ptr<UI::RenderedText> rendered_text(new UI::RenderedText());
+	std::shared_ptr<const UI::GlyphRun> glyphs = font_.render_glyphs(
+	   txt_, nodestyle_.font_color, nodestyle_.font_style, fontcache_.glyph_atlas());
+	if (glyphs != nullptr) {
+		rendered_text->rects.push_back(
+		   std::unique_ptr<UI::RenderedRect>(new UI::RenderedRect(glyphs)));
+		return rendered_text;
+	}
+
 	auto rendered_image =
 	   font_.render(txt_, nodestyle_.font_color, nodestyle_.font_style, texture_cache);
 	assert(rendered_image != nullptr);
-	std::shared_ptr<UI::RenderedText> rendered_text(new UI::RenderedText());
 	rendered_text->rects.push_back(
 	   std::unique_ptr<UI::RenderedRect>(new UI::RenderedRect(rendered_image)));
 	return rendered_text;
@@ -682,10 +697,16 @@ private:
 };
 std::shared_ptr<UI::RenderedText> FillingTextNode::render(TextureCache* texture_cache) {
 	std::shared_ptr<UI::RenderedText> rendered_text(new UI::RenderedText());
-	const std::string hash =
-	   (boost::format("rt:fill:%s:%s:%i:%i:%i:%s") % txt_ % nodestyle_.font_color.hex_value() %
-	    nodestyle_.font_style % width() % height() % (is_expanding_ ? "e" : "f"))
-	      .str();
+	const uint64_t hash = TransientCacheKey()
+	                         .add("rt:fill")
+	                         .add(txt_)
+	                         .add((nodestyle_.font_color.r << 16) |
+	                              (nodestyle_.font_color.g << 8) | nodestyle_.font_color.b)
+	                         .add(nodestyle_.font_style)
+	                         .add(width())
+	                         .add(height())
+	                         .add(is_expanding_)
+	                         .get();
 
 	std::shared_ptr<const Image> rendered_image = texture_cache->get(hash);
 	if (rendered_image == nullptr) {
@@ -725,7 +746,7 @@ public:
 	std::shared_ptr<UI::RenderedText> render(TextureCache* texture_cache) override {
 		if (show_spaces_) {
 			std::shared_ptr<UI::RenderedText> rendered_text(new UI::RenderedText());
-			const std::string hash = (boost::format("rt:wsp:%i:%i") % width() % height()).str();
+			const uint64_t hash = TransientCacheKey().add("rt:wsp").add(width()).add(height()).get();
 			std::shared_ptr<const Image> rendered_image = texture_cache->get(hash);
 			if (rendered_image == nullptr) {
 				auto texture = std::make_shared<Texture>(width(), height());
@@ -803,9 +824,13 @@ public:
 	}
 	std::shared_ptr<UI::RenderedText> render(TextureCache* texture_cache) override {
 		std::shared_ptr<UI::RenderedText> rendered_text(new UI::RenderedText());
-		const std::string hash = (boost::format("rt:sp:%s:%i:%i:%s") % filename_ % width() %
-		                          height() % (is_expanding_ ? "e" : "f"))
-		                            .str();
+		const uint64_t hash = TransientCacheKey()
+		                         .add("rt:sp")
+		                         .add(filename_)
+		                         .add(width())
+		                         .add(height())
+		                         .add(is_expanding_)
+		                         .get();
 
 		std::shared_ptr<const Image> rendered_image = texture_cache->get(hash);
 		if (rendered_image == nullptr) {
@@ -1027,9 +1052,15 @@ std::shared_ptr<UI::RenderedText> ImgRenderNode::render(TextureCache* texture_ca
 		rendered_text->rects.push_back(
 		   std::unique_ptr<UI::RenderedRect>(new UI::RenderedRect(image_)));
 	} else {
-		const std::string hash = (boost::format("rt:img:%s:%s:%i:%i") % filename_ %
-		                          (use_playercolor_ ? color_.hex_value() : "") % width() % height())
-		                            .str();
+		const uint64_t hash = TransientCacheKey()
+		                         .add("rt:img")
+		                         .add(filename_)
+		                         .add(use_playercolor_ ?
+		                                 (1 << 24) | (color_.r << 16) | (color_.g << 8) | color_.b :
+		                                 0)
+		                         .add(width())
+		                         .add(height())
+		                         .get();
 		std::shared_ptr<const Image> rendered_image = texture_cache->get(hash);
 		if (rendered_image == nullptr) {
 			auto texture = std::make_shared<Texture>(width(), height());
@@ -1715,8 +1746,9 @@ TagHandler* create_taghandler(Tag& tag,
 
 Renderer::Renderer(ImageCache* image_cache,
                    TextureCache* texture_cache,
+                   GlyphAtlas* glyph_atlas,
                    const UI::FontSets& fontsets)
-   : font_cache_(new FontCache()),
+   : font_cache_(new FontCache(glyph_atlas)),
      parser_(new Parser()),
      image_cache_(image_cache),
      texture_cache_(texture_cache),
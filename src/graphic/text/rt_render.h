@@ -36,6 +36,7 @@
 namespace RT {
 
 class FontCache;
+class GlyphAtlas;
 class Parser;
 class RenderNode;
 
@@ -63,8 +64,12 @@ struct RendererStyle {
 using TagSet = std::set<std::string>;
 class Renderer {
 public:
-	// Ownership is not taken.
-	Renderer(ImageCache* image_cache, TextureCache* texture_cache, const UI::FontSets& fontsets);
+	// Ownership is not taken. Words are drawn with glyphs from 'glyph_atlas'
+	// where possible. Pass nullptr to render each word into a texture instead.
+	Renderer(ImageCache* image_cache,
+	         TextureCache* texture_cache,
+	         GlyphAtlas* glyph_atlas,
+	         const UI::FontSets& fontsets);
 	~Renderer();
 
 	// Render the given string in the given width. Restricts the allowed tags to
@@ -20,6 +20,7 @@
 #include "graphic/text/sdl_ttf_font.h"
 
 #include <memory>
+#include <vector>
 
 #include <SDL.h>
 #include <SDL_ttf.h>
@@ -31,6 +32,46 @@
 static const int SHADOW_OFFSET = 1;
 static const SDL_Color SHADOW_CLR = {0, 0, 0, SDL_ALPHA_OPAQUE};
 
+namespace {
+
+// Decodes 'txt' into 'codepoints'. Returns false if 'txt' is not valid UTF-8
+// or contains characters outside of the Basic Multilingual Plane, which the
+// UCS-2 functions of SDL_ttf can not handle.
+bool decode_utf8(const std::string& txt, std::vector<uint16_t>* codepoints) {
+	for (size_t i = 0; i < txt.size();) {
+		const uint8_t lead = txt[i];
+		uint32_t codepoint;
+		size_t length;
+		if (lead < 0x80) {
+			codepoint = lead;
+			length = 1;
+		} else if ((lead & 0xe0) == 0xc0) {
+			codepoint = lead & 0x1f;
+			length = 2;
+		} else if ((lead & 0xf0) == 0xe0) {
+			codepoint = lead & 0x0f;
+			length = 3;
+		} else {
+			return false;
+		}
+		if (i + length > txt.size()) {
+			return false;
+		}
+		for (size_t j = 1; j < length; ++j) {
+			const uint8_t continuation = txt[i + j];
+			if ((continuation & 0xc0) != 0x80) {
+				return false;
+			}
+			codepoint = (codepoint << 6) | (continuation & 0x3f);
+		}
+		codepoints->push_back(codepoint);
+		i += length;
+	}
+	return true;
+}
+
+}  // namespace
+
 namespace RT {
 
 SdlTtfFont::SdlTtfFont(TTF_Font* font,
@@ -41,6 +82,7 @@ SdlTtfFont::SdlTtfFont(TTF_Font* font,
      style_(TTF_STYLE_NORMAL),
      font_name_(face),
      ptsize_(ptsize),
+     font_key_((boost::format("%s:%i") % face % ptsize).str()),
      ttf_file_memory_block_(ttf_memory_block) {
 }
 
@@ -67,10 +109,13 @@ std::shared_ptr<const Image> SdlTtfFont::render(const std::string& txt,
                                                 const RGBColor& clr,
                                                 int style,
                                                 TextureCache* texture_cache) {
-	const std::string hash =
-	   (boost::format("ttf:%s:%s:%i:%02x%02x%02x:%i") % font_name_ % ptsize_ % txt %
-	    static_cast<int>(clr.r) % static_cast<int>(clr.g) % static_cast<int>(clr.b) % style)
-	      .str();
+	const uint64_t hash = TransientCacheKey()
+	                         .add("ttf")
+	                         .add(font_key_)
+	                         .add(txt)
+	                         .add((clr.r << 16) | (clr.g << 8) | clr.b)
+	                         .add(style)
+	                         .get();
 	std::shared_ptr<const Image> rv = texture_cache->get(hash);
 	if (rv != nullptr) {
 		return rv;
@@ -136,6 +181,69 @@ std::shared_ptr<const Image> SdlTtfFont::render(const std::string& txt,
 	return texture_cache->insert(hash, std::make_shared<Texture>(text_surface));
 }
 
+std::shared_ptr<const UI::GlyphRun> SdlTtfFont::render_glyphs(const std::string& txt,
+                                                              const RGBColor& clr,
+                                                              int style,
+                                                              GlyphAtlas* glyph_atlas) {
+	// The atlas has no underlined glyphs.
+	if (glyph_atlas == nullptr || (style & UNDERLINE)) {
+		return nullptr;
+	}
+	std::vector<uint16_t> codepoints;
+	if (!decode_utf8(txt, &codepoints) || codepoints.empty()) {
+		return nullptr;
+	}
+	set_style(style);
+
+	std::vector<std::pair<const GlyphAtlas::Glyph*, int>> placed;
+	placed.reserve(codepoints.size());
+	int pen = 0;
+	for (size_t i = 0; i < codepoints.size(); ++i) {
+		const GlyphAtlas::Glyph* glyph = glyph_atlas->get(font_, font_key_, codepoints[i]);
+		if (glyph == nullptr) {
+			return nullptr;
+		}
+		if (i == 0) {
+			// Like SDL_ttf, start far enough right for the first glyph to fit.
+			pen = -glyph->offset_x;
+		}
+#if SDL_VERSIONNUM(SDL_TTF_MAJOR_VERSION, SDL_TTF_MINOR_VERSION, SDL_TTF_PATCHLEVEL) >=            \
+   SDL_VERSIONNUM(2, 0, 14)
+		else if (TTF_GetFontKerning(font_)) {
+			pen += TTF_GetFontKerningSizeGlyphs(font_, codepoints[i - 1], codepoints[i]);
+		}
+#endif
+		placed.push_back(std::make_pair(glyph, pen + glyph->offset_x));
+		pen += glyph->advance;
+	}
+
+	std::shared_ptr<UI::GlyphRun> result(new UI::GlyphRun());
+	result->glyphs.reserve(style & SHADOW ? 2 * placed.size() : placed.size());
+	if (style & SHADOW) {
+		const RGBAColor shadow_color(SHADOW_CLR.r, SHADOW_CLR.g, SHADOW_CLR.b, SHADOW_CLR.a);
+		for (const auto& glyph : placed) {
+			if (glyph.first->image != nullptr) {
+				result->glyphs.push_back(
+				   UI::GlyphRun::Glyph{glyph.first->image, Vector2i(glyph.second, 0), shadow_color});
+			}
+		}
+	}
+	const int offset = style & SHADOW ? SHADOW_OFFSET : 0;
+	const RGBAColor color(clr.r, clr.g, clr.b, SDL_ALPHA_OPAQUE);
+	for (const auto& glyph : placed) {
+		if (glyph.first->image != nullptr) {
+			result->glyphs.push_back(UI::GlyphRun::Glyph{
+			   glyph.first->image, Vector2i(glyph.second + offset, offset), color});
+		}
+	}
+
+	uint16_t w, h;
+	dimensions(txt, style, &w, &h);
+	result->width = w;
+	result->height = h;
+	return result;
+}
+
 uint16_t SdlTtfFont::ascent(int style) const {
 	uint16_t rv = TTF_FontAscent(font_);
 	if (style & SHADOW)
@@ -25,6 +25,8 @@
 
 #include <SDL_ttf.h>
 
+#include "graphic/text/glyph_atlas.h"
+#include "graphic/text/rendered_text.h"
 #include "graphic/text/texture_cache.h"
 #include "graphic/texture.h"
 
@@ -53,6 +55,10 @@ public:
 	virtual void dimensions(const std::string&, int, uint16_t*, uint16_t*) = 0;
 	virtual std::shared_ptr<const Image>
 	render(const std::string&, const RGBColor& clr, int, TextureCache*) = 0;
+	// Lays out the text with glyphs from the atlas instead of rendering it into
+	// a texture of its own. Returns nullptr if this is not possible for the text.
+	virtual std::shared_ptr<const UI::GlyphRun>
+	render_glyphs(const std::string&, const RGBColor& clr, int, GlyphAtlas*) = 0;
 
 	virtual uint16_t ascent(int) const = 0;
 	virtual TTF_Font* get_ttf_font() const = 0;
@@ -67,6 +73,8 @@ public:
 	void dimensions(const std::string&, int, uint16_t* w, uint16_t* h) override;
 	std::shared_ptr<const Image>
 	render(const std::string&, const RGBColor& clr, int, TextureCache*) override;
+	std::shared_ptr<const UI::GlyphRun>
+	render_glyphs(const std::string&, const RGBColor& clr, int, GlyphAtlas*) override;
 	uint16_t ascent(int) const override;
 	TTF_Font* get_ttf_font() const override {
 		return font_;
@@ -79,6 +87,8 @@ private:
 	int style_;
 	const std::string font_name_;
 	const int ptsize_;
+	// Identifies this font's glyphs in the glyph atlas.
+	const std::string font_key_;
 	// Old version of SDLTtf seem to need to keep this around.
 	std::unique_ptr<std::string> ttf_file_memory_block_;
 };
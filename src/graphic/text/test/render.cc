@@ -40,7 +40,9 @@ StandaloneRenderer::StandaloneRenderer() {
 
 	texture_cache_.reset(new TextureCache(500 << 20));  // 500 MB
 	image_cache_.reset(new ImageCache());
-	renderer_.reset(new RT::Renderer(image_cache_.get(), texture_cache_.get(), fontsets));
+	// No glyph atlas, so that the words are rendered like in the reference images.
+	renderer_.reset(
+	   new RT::Renderer(image_cache_.get(), texture_cache_.get(), nullptr, fontsets));
 }
 
 StandaloneRenderer::~StandaloneRenderer() {
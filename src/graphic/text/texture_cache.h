@@ -30,9 +30,8 @@ public:
 	explicit TextureCache(uint32_t max_size_in_bytes) : TransientCache<Image>(max_size_in_bytes) {
 	}
 
-	std::shared_ptr<const Image> insert(const std::string& hash,
-	                                    std::shared_ptr<const Image> entry) override {
-		return TransientCache<Image>::insert(hash, entry, entry->width() * entry->height() * 4);
+	std::shared_ptr<const Image> insert(uint64_t key, std::shared_ptr<const Image> entry) override {
+		return TransientCache<Image>::insert(key, entry, entry->width() * entry->height() * 4);
 	}
 };
 
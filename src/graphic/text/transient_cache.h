@@ -20,137 +20,308 @@
 #ifndef WL_GRAPHIC_TEXT_TRANSIENT_CACHE_H
 #define WL_GRAPHIC_TEXT_TRANSIENT_CACHE_H
 
+#include <algorithm>
 #include <cassert>
-#include <list>
-#include <map>
+#include <cstdint>
+#include <cstring>
+#include <limits>
 #include <memory>
 #include <string>
-
-#include <SDL.h>
-#include <boost/utility.hpp>
+#include <vector>
 
 #include "base/macros.h"
 
-// The implementation took inspiration from
-// https://timday.bitbucket.io/lru.html, but our use case here is a little
-// different.
+/// Builds the 64 bit keys for a TransientCache without allocating memory. Add
+/// everything that the cached entry depends on. Two different inputs get the
+/// same key only by chance, which is unlikely enough for the few thousand
+/// entries of a cache.
+class TransientCacheKey {
+public:
+	TransientCacheKey& add(const std::string& value) {
+		add_bytes(value.data(), value.size());
+		// Keeps "ab" + "c" and "a" + "bc" apart.
+		return add(static_cast<uint64_t>(value.size()));
+	}
+
+	TransientCacheKey& add(const char* value) {
+		const size_t size = strlen(value);
+		add_bytes(value, size);
+		return add(static_cast<uint64_t>(size));
+	}
+
+	TransientCacheKey& add(uint64_t value) {
+		add_bytes(&value, sizeof(value));
+		return *this;
+	}
+
+	uint64_t get() const {
+		// FNV-1a is weak in the low bits, which the cache uses as the table
+		// index, so mix all bits down (the finalizer of MurmurHash3).
+		uint64_t result = hash_;
+		result ^= result >> 33;
+		result *= 0xff51afd7ed558ccdULL;
+		result ^= result >> 33;
+		result *= 0xc4ceb9fe1a85ec53ULL;
+		result ^= result >> 33;
+		return result;
+	}
+
+private:
+	void add_bytes(const void* data, size_t size) {
+		const uint8_t* bytes = static_cast<const uint8_t*>(data);
+		for (size_t i = 0; i < size; ++i) {
+			hash_ = (hash_ ^ bytes[i]) * 0x100000001b3ULL;
+		}
+	}
+
+	uint64_t hash_ = 0xcbf29ce484222325ULL;
+};
 
 /// Caches transient rendered text. The entries will be kept until the memory limit is reached,
 /// then the stalest entries will be deleted to make room for new entries.
 ///
+/// Entries are found by a 64 bit key (see TransientCacheKey) in an open addressing hash table
+/// with linear probing. The entries themselves live in a pool and are linked into a list in the
+/// order of their last access, so neither a lookup nor an insertion allocates memory once the
+/// cache has grown to its working size.
+///
 /// We use shared_ptr so that other objects can hold on to the textures if they need them more
 /// permanently.
 template <typename T> class TransientCache {
 public:
+	struct Stats {
+		uint64_t hits = 0;
+		uint64_t misses = 0;
+		uint64_t evictions = 0;
+	};
+
 	/// Create a new cache in which the combined data size for all transient entries is always below
-	/// the 'max_size_in_arbitrary_unit'.
-	explicit TransientCache(uint32_t max_size_in_arbitrary_unit);
+	/// 'max_size_in_bytes'.
+	explicit TransientCache(uint32_t max_size_in_bytes);
 	virtual ~TransientCache();
 
-	/// Deletes all entries in the cache, leaving it as if it were just created.
+	/// Deletes all entries in the cache, leaving it as if it were just created. Keeps the counters.
 	void flush();
 
 	/// Returns an entry if it is cached, nullptr otherwise.
-	std::shared_ptr<const T> get(const std::string& hash);
+	std::shared_ptr<const T> get(uint64_t key);
 
 	/// Inserts this entry of type T into the cache. Returns the given T for convenience.
 	/// When overriding this function, calculate the size of 'entry' and then call
-	/// insert(hash, entry, entry_size_in_size_unit).
-	virtual std::shared_ptr<const T> insert(const std::string& hash,
-	                                        std::shared_ptr<const T> entry) = 0;
+	/// insert(key, entry, entry_size_in_bytes).
+	virtual std::shared_ptr<const T> insert(uint64_t key, std::shared_ptr<const T> entry) = 0;
+
+	const Stats& stats() const {
+		return stats_;
+	}
+	uint32_t size_in_bytes() const {
+		return size_in_bytes_;
+	}
+	uint32_t nr_entries() const {
+		return nr_entries_;
+	}
 
 protected:
-	/// Inserts this entry of type T into the cache. asserts() that there is no entry with this hash
+	/// Inserts this entry of type T into the cache. asserts() that there is no entry with this key
 	/// already cached. Returns the given T for convenience.
-	std::shared_ptr<const T> insert(const std::string& hash,
-	                                std::shared_ptr<const T> entry,
-	                                uint32_t entry_size_in_size_unit);
+	std::shared_ptr<const T>
+	insert(uint64_t key, std::shared_ptr<const T> entry, uint32_t entry_size_in_bytes);
 
 private:
-	/// Drop the oldest entry
-	void drop();
+	static constexpr uint32_t kNone = std::numeric_limits<uint32_t>::max();
 
-	using AccessHistory = std::list<std::string>;
-	struct Entry {
+	struct Node {
+		uint64_t key = 0;
 		std::shared_ptr<const T> entry;
-		uint32_t size;
-		uint32_t last_access;  // Mainly for debugging and analysis.
-		const AccessHistory::iterator list_iterator;
+		uint32_t size = 0;
+		// Neighbors in the access order, or the next free node for unused nodes.
+		uint32_t older = kNone;
+		uint32_t newer = kNone;
+	};
+
+	// A slot of the hash table. Empty slots have node == kNone.
+	struct Slot {
+		uint64_t key;
+		uint32_t node;
 	};
 
-	uint32_t max_size_in_size_unit_;
-	uint32_t size_in_size_unit_;
-	std::map<std::string, Entry> entries_;
-	AccessHistory access_history_;
+	/// Returns the slot that holds 'key', or the empty slot where it would go.
+	uint32_t find_slot(uint64_t key) const;
+
+	/// Removes the node in 'slot' from the hash table.
+	void erase_slot(uint32_t slot);
+
+	/// Doubles the size of the hash table.
+	void grow();
+
+	void unlink(uint32_t node);
+	void link_as_newest(uint32_t node);
+
+	/// Drop the oldest entry
+	void drop();
+
+	const uint32_t max_size_in_bytes_;
+	uint32_t size_in_bytes_;
+	uint32_t nr_entries_;
+
+	std::vector<Slot> slots_;
+	std::vector<Node> nodes_;
+	uint32_t free_nodes_;
+	uint32_t oldest_;
+	uint32_t newest_;
+
+	Stats stats_;
 
 	DISALLOW_COPY_AND_ASSIGN(TransientCache);
 };
 
 // Implementation
 
+template <typename T> constexpr uint32_t TransientCache<T>::kNone;
+
 template <typename T>
-TransientCache<T>::TransientCache(uint32_t max_size_in_arbitrary_unit)
-   : max_size_in_size_unit_(max_size_in_arbitrary_unit), size_in_size_unit_(0) {
+TransientCache<T>::TransientCache(uint32_t max_size_in_bytes)
+   : max_size_in_bytes_(max_size_in_bytes),
+     size_in_bytes_(0),
+     nr_entries_(0),
+     slots_(64, Slot{0, kNone}),
+     free_nodes_(kNone),
+     oldest_(kNone),
+     newest_(kNone) {
 }
 template <typename T> TransientCache<T>::~TransientCache() {
 	flush();
 }
 
 template <typename T> void TransientCache<T>::flush() {
-	access_history_.clear();
-	size_in_size_unit_ = 0;
-	entries_.clear();
+	std::fill(slots_.begin(), slots_.end(), Slot{0, kNone});
+	nodes_.clear();
+	free_nodes_ = oldest_ = newest_ = kNone;
+	size_in_bytes_ = 0;
+	nr_entries_ = 0;
+}
+
+template <typename T> uint32_t TransientCache<T>::find_slot(const uint64_t key) const {
+	const uint32_t mask = slots_.size() - 1;
+	uint32_t slot = key & mask;
+	while (slots_[slot].node != kNone && slots_[slot].key != key) {
+		slot = (slot + 1) & mask;
+	}
+	return slot;
+}
+
+template <typename T> void TransientCache<T>::erase_slot(uint32_t slot) {
+	// Shift the following entries of the probe sequence back, so that no
+	// tombstones are needed.
+	const uint32_t mask = slots_.size() - 1;
+	uint32_t next = slot;
+	for (;;) {
+		slots_[slot].node = kNone;
+		for (;;) {
+			next = (next + 1) & mask;
+			if (slots_[next].node == kNone) {
+				return;
+			}
+			// Entries whose home slot is cyclically in (slot, next] have to stay.
+			const uint32_t home = slots_[next].key & mask;
+			if (slot <= next ? (slot < home && home <= next) : (slot < home || home <= next)) {
+				continue;
+			}
+			break;
+		}
+		slots_[slot] = slots_[next];
+		slot = next;
+	}
+}
+
+template <typename T> void TransientCache<T>::grow() {
+	std::vector<Slot> old_slots(slots_.size() * 2, Slot{0, kNone});
+	old_slots.swap(slots_);
+	for (const Slot& old_slot : old_slots) {
+		if (old_slot.node != kNone) {
+			slots_[find_slot(old_slot.key)] = old_slot;
+		}
+	}
+}
+
+template <typename T> void TransientCache<T>::unlink(const uint32_t node) {
+	Node& n = nodes_[node];
+	(n.older == kNone ? oldest_ : nodes_[n.older].newer) = n.newer;
+	(n.newer == kNone ? newest_ : nodes_[n.newer].older) = n.older;
+	n.older = n.newer = kNone;
+}
+
+template <typename T> void TransientCache<T>::link_as_newest(const uint32_t node) {
+	nodes_[node].older = newest_;
+	nodes_[node].newer = kNone;
+	(newest_ == kNone ? oldest_ : nodes_[newest_].newer) = node;
+	newest_ = node;
 }
 
 /// Returns an entry if it is cached, nullptr otherwise.
-template <typename T> std::shared_ptr<const T> TransientCache<T>::get(const std::string& hash) {
-	const auto it = entries_.find(hash);
-	if (it == entries_.end()) {
+template <typename T> std::shared_ptr<const T> TransientCache<T>::get(const uint64_t key) {
+	const uint32_t node = slots_[find_slot(key)].node;
+	if (node == kNone) {
+		++stats_.misses;
 		return std::shared_ptr<const T>(nullptr);
 	}
+	++stats_.hits;
 
-	// Move this to the back of the access list to signal that we have used this
-	// recently and update last access time.
-	access_history_.splice(access_history_.end(), access_history_, it->second.list_iterator);
-	it->second.last_access = SDL_GetTicks();
-	return it->second.entry;
+	// Signal that we have used this recently.
+	if (node != newest_) {
+		unlink(node);
+		link_as_newest(node);
+	}
+	return nodes_[node].entry;
 }
 
 template <typename T>
-std::shared_ptr<const T> TransientCache<T>::insert(const std::string& hash,
+std::shared_ptr<const T> TransientCache<T>::insert(const uint64_t key,
                                                    std::shared_ptr<const T> entry,
-                                                   uint32_t entry_size_in_size_unit) {
-	assert(entries_.find(hash) == entries_.end());
+                                                   uint32_t entry_size_in_bytes) {
+	assert(slots_[find_slot(key)].node == kNone);
 
-	while (!entries_.empty() &&
-	       size_in_size_unit_ + entry_size_in_size_unit > max_size_in_size_unit_) {
+	while (nr_entries_ > 0 && size_in_bytes_ + entry_size_in_bytes > max_size_in_bytes_) {
 		drop();
 	}
+	// Keep the load factor at or below 1/2.
+	if (2 * (nr_entries_ + 1) > slots_.size()) {
+		grow();
+	}
 
-	// Record hash as most-recently-used.
-	AccessHistory::iterator it = access_history_.insert(access_history_.end(), hash);
-	size_in_size_unit_ += entry_size_in_size_unit;
-	return entries_
-	   .insert(make_pair(hash, Entry{std::move(entry), entry_size_in_size_unit, SDL_GetTicks(), it}))
-	   .first->second.entry;
+	uint32_t node = free_nodes_;
+	if (node != kNone) {
+		free_nodes_ = nodes_[node].newer;
+	} else {
+		node = nodes_.size();
+		nodes_.push_back(Node());
+	}
+	Node& n = nodes_[node];
+	n.key = key;
+	n.entry = std::move(entry);
+	n.size = entry_size_in_bytes;
+	link_as_newest(node);
+
+	slots_[find_slot(key)] = Slot{key, node};
+	size_in_bytes_ += entry_size_in_bytes;
+	++nr_entries_;
+	return n.entry;
 }
 
 template <typename T> void TransientCache<T>::drop() {
-	assert(!access_history_.empty());
-
-	// Identify least recently used key
-	const auto it = entries_.find(access_history_.front());
-	assert(it != entries_.end());
+	assert(oldest_ != kNone);
 
-	size_in_size_unit_ -= it->second.size;
-	// TODO(GunChleoc): Remove the following line once everything is converted to the new font
-	// renderer and all testing has been done.
-	// log("TransientCache: Dropping %d bytes, new size %d. Hash: %s\n", it->second.size,
-	//    size_in_size_unit_, it->first.c_str());
+	const uint32_t node = oldest_;
+	Node& n = nodes_[node];
+	erase_slot(find_slot(n.key));
+	unlink(node);
 
-	// Erase both elements to completely purge record
-	entries_.erase(it);
-	access_history_.pop_front();
+	size_in_bytes_ -= n.size;
+	--nr_entries_;
+	++stats_.evictions;
+	n.entry.reset();
+	n.newer = free_nodes_;
+	free_nodes_ = node;
 }
 
 #endif  // end of include guard: WL_GRAPHIC_TEXT_TRANSIENT_CACHE_H
@@ -106,6 +106,17 @@ Texture::Texture(int w, int h) : owns_texture_(false) {
 	             GL_UNSIGNED_BYTE, nullptr);
 }
 
+Texture::Texture(int w, int h, const uint8_t* pixels) : owns_texture_(false) {
+	init(w, h);
+
+	if (blit_data_.texture_id == 0) {
+		return;
+	}
+
+	glTexImage2D(GL_TEXTURE_2D, 0, static_cast<GLint>(GL_RGBA), width(), height(), 0, GL_RGBA,
+	             GL_UNSIGNED_BYTE, pixels);
+}
+
 Texture::Texture(SDL_Surface* surface, bool intensity) : owns_texture_(false) {
 	init(surface->w, surface->h);
 
@@ -248,6 +259,19 @@ void Texture::set_pixel(uint16_t x, uint16_t y, const RGBAColor& color) {
 	*(reinterpret_cast<uint32_t*>(data)) = packed_color;
 }
 
+void Texture::set_pixels(const uint8_t* pixels) {
+	assert(!pixels_);
+	if (blit_data_.texture_id == 0) {
+		return;
+	}
+	if (!owns_texture_) {
+		throw wexception("A surface that does not own its pixels can not be changed.");
+	}
+	Gl::State::instance().bind(GL_TEXTURE0, blit_data_.texture_id);
+	glTexSubImage2D(
+	   GL_TEXTURE_2D, 0, 0, 0, width(), height(), GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+}
+
 void Texture::setup_gl() {
 	assert(blit_data_.texture_id != 0);
 	Gl::State::instance().bind_framebuffer(GlFramebuffer::instance().id(), blit_data_.texture_id);
@@ -37,6 +37,10 @@ public:
 	// dimensions.
 	Texture(int w, int h);
 
+	// Create a new texture with the given dimensions from 'pixels', which are
+	// RGBA with the bottom row first, like OpenGL expects them.
+	Texture(int w, int h, const uint8_t* pixels);
+
 	// Create a logical texture that is a 'subrect' (in Pixel) in
 	// another texture. Ownership of 'texture' is not taken.
 	Texture(const GLuint texture, const Recti& subrect, int parent_w, int parent_h);
@@ -77,6 +81,11 @@ public:
 	// Sets the pixel to the 'clr'.
 	void set_pixel(uint16_t x, uint16_t y, const RGBAColor& color);
 
+	// Replaces all pixels in one go. 'pixels' holds width() * height() pixels
+	// with 4 bytes in the order R, G, B, A, starting with the bottom row like
+	// OpenGL expects them. The texture must not be locked.
+	void set_pixels(const uint8_t* pixels);
+
 private:
 	// Configures OpenGL to draw to this surface.
 	void setup_gl();
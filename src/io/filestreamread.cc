@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2019 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include "io/filestreamread.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace {
+
+// Big enough that reading a file takes few calls into the file system or zlib.
+constexpr size_t kBufferSize = 64 * 1024;
+
+}  // namespace
+
+FileStreamRead::FileStreamRead() : buffer_pos_(0), buffer_end_(0), pos_(0) {
+}
+
+void FileStreamRead::open(FileSystem& fs, const std::string& filename) {
+	assert(!stream_);
+	stream_.reset(fs.open_stream_read(filename));
+	buffer_.resize(kBufferSize);
+	buffer_pos_ = buffer_end_ = 0;
+	pos_ = 0;
+}
+
+bool FileStreamRead::try_open(FileSystem& fs, const std::string& filename) {
+	try {
+		open(fs, filename);
+	} catch (const std::exception&) {
+		return false;
+	}
+	return true;
+}
+
+void FileStreamRead::close() {
+	assert(stream_);
+	stream_.reset();
+	std::vector<char>().swap(buffer_);
+	buffer_pos_ = buffer_end_ = 0;
+}
+
+size_t FileStreamRead::get_pos() const {
+	return pos_;
+}
+
+bool FileStreamRead::fill_buffer() const {
+	assert(stream_);
+	buffer_pos_ = 0;
+	buffer_end_ = stream_->data(buffer_.data(), buffer_.size());
+	return buffer_end_ > 0;
+}
+
+bool FileStreamRead::end_of_file() const {
+	// Like FileRead, there is nothing to read from a file that is not open.
+	return !stream_ || (buffer_pos_ == buffer_end_ && !fill_buffer());
+}
+
+size_t FileStreamRead::data(void* dst, size_t bufsize) {
+	size_t read = 0;
+	while (read < bufsize && (buffer_pos_ < buffer_end_ || fill_buffer())) {
+		const size_t chunk = std::min(bufsize - read, buffer_end_ - buffer_pos_);
+		memcpy(static_cast<char*>(dst) + read, buffer_.data() + buffer_pos_, chunk);
+		buffer_pos_ += chunk;
+		read += chunk;
+	}
+	pos_ += read;
+	return read;
+}
+
+char const* FileStreamRead::c_string() {
+	if (end_of_file()) {
+		throw data_error("Stream ended unexpectedly while reading a string");
+	}
+	string_.clear();
+	// Like FileRead, the end of the file also ends the string.
+	for (;;) {
+		if (buffer_pos_ == buffer_end_ && !fill_buffer()) {
+			break;
+		}
+		const char* const begin = buffer_.data() + buffer_pos_;
+		const char* const end = buffer_.data() + buffer_end_;
+		const char* const nul = std::find(begin, end, '\0');
+		string_.append(begin, nul);
+		buffer_pos_ += nul - begin;
+		pos_ += nul - begin;
+		if (nul != end) {
+			++buffer_pos_;
+			++pos_;
+			break;
+		}
+	}
+	return string_.c_str();
+}
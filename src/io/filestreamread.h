@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2019 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#ifndef WL_IO_FILESTREAMREAD_H
+#define WL_IO_FILESTREAMREAD_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "io/filesystem/filesystem.h"
+#include "io/streamread.h"
+
+/// Reads a file front to back like \ref FileRead, but through a buffer of a
+/// fixed size instead of loading the whole file into memory first. Files in
+/// zip files are decompressed as they are read. Use this for big files that
+/// are read only once, like the packets of savegames of large maps.
+class FileStreamRead : public StreamRead {
+public:
+	/// Create the object with nothing to read.
+	FileStreamRead();
+
+	// See base class.
+	size_t data(void* dst, size_t bufsize) override;
+	bool end_of_file() const override;
+
+	/// The returned string stays valid until the next call.
+	char const* c_string() override;
+
+	/// Opens a file for reading.
+	/// \throws an exception if the file couldn't be opened.
+	void open(FileSystem& fs, const std::string& filename);
+
+	/// Works just like open, but returns false when the file can't be opened.
+	bool try_open(FileSystem& fs, const std::string& filename);
+
+	/// Frees the buffer and closes the file.
+	void close();
+
+	/// The number of bytes that have been read so far.
+	size_t get_pos() const;
+
+private:
+	// Reads the next part of the file into the buffer. Returns false at the
+	// end of the file.
+	bool fill_buffer() const;
+
+	// Filling the buffer does not change what is left to read, so it may happen
+	// in 'end_of_file' as well.
+	mutable std::unique_ptr<StreamRead> stream_;
+	mutable std::vector<char> buffer_;
+	mutable size_t buffer_pos_;
+	mutable size_t buffer_end_;
+	size_t pos_;
+	std::string string_;
+};
+
+#endif  // end of include guard: WL_IO_FILESTREAMREAD_H
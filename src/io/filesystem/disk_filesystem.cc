@@ -19,6 +19,7 @@
 
 #include "io/filesystem/disk_filesystem.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cerrno>
 
@@ -156,6 +157,26 @@ bool RealFSImpl::file_exists(const std::string& path) const {
 	return FileSystemPath(canonicalize_name(path)).exists_;
 }
 
+FileStamp RealFSImpl::file_stamp(const std::string& path) const {
+	FileStamp result{0, 0};
+	struct stat st;
+	if (stat(canonicalize_name(path).c_str(), &st) == -1) {
+		return result;
+	}
+	result.modified = st.st_mtime;
+	if (!S_ISDIR(st.st_mode)) {
+		result.size = st.st_size;
+		return result;
+	}
+	// Uncompressed maps and savegames are directories.
+	for (const std::string& entry : list_directory(path)) {
+		const FileStamp entry_stamp = file_stamp(entry);
+		result.size += entry_stamp.size;
+		result.modified = std::max(result.modified, entry_stamp.modified);
+	}
+	return result;
+}
+
 /**
  * Returns true if the given file is a directory, and false if it isn't.
  * Also returns false if the pathname is invalid (obviously, because the file
@@ -34,6 +34,7 @@ public:
 
 	bool is_writable() const override;
 	bool file_exists(const std::string& path) const override;
+	FileStamp file_stamp(const std::string& path) const override;
 	bool is_directory(const std::string& path) override;
 	void ensure_directory_exists(const std::string& fs_dirname) override;
 	void make_directory(const std::string& fs_dirname) override;
@@ -36,6 +36,20 @@ using FilenameSet = std::set<std::string>;
 class StreamRead;
 class StreamWrite;
 
+/// Tells versions of a file apart: if the file changes, so does its stamp.
+struct FileStamp {
+	uint64_t size;
+	// Time of the last modification in seconds since the epoch.
+	int64_t modified;
+
+	bool operator==(const FileStamp& other) const {
+		return size == other.size && modified == other.modified;
+	}
+	bool operator!=(const FileStamp& other) const {
+		return !(*this == other);
+	}
+};
+
 /**
  * FileSystem is an abstract base class representing certain filesystem
  * operations.
@@ -55,6 +69,10 @@ public:
 	virtual bool is_writable() const = 0;
 	virtual bool is_directory(const std::string& path) = 0;
 	virtual bool file_exists(const std::string& path) const = 0;
+	// Returns the size and modification time of 'path'. For directories, the
+	// sizes of all files in them are added up and the latest modification wins.
+	// Both are 0 if 'path' does not exist.
+	virtual FileStamp file_stamp(const std::string& path) const = 0;
 
 	virtual void* load(const std::string& fname, size_t& length) = 0;
 
@@ -91,6 +91,16 @@ bool LayeredFileSystem::file_exists(const std::string& path) const {
 	return false;
 }
 
+FileStamp LayeredFileSystem::file_stamp(const std::string& path) const {
+	if (home_ && home_->file_exists(path))
+		return home_->file_stamp(path);
+	for (auto it = filesystems_.rbegin(); it != filesystems_.rend(); ++it)
+		if ((*it)->file_exists(path))
+			return (*it)->file_stamp(path);
+
+	return FileStamp{0, 0};
+}
+
 /**
  * Returns true if path is a directory in at least one of the directories
  */
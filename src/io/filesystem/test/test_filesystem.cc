@@ -18,6 +18,8 @@
  */
 
 #include <exception>
+#include <memory>
+#include <string>
 #ifdef _WIN32
 #include <sstream>
 #endif
@@ -25,7 +27,10 @@
 #include <boost/test/unit_test.hpp>
 
 #include "base/macros.h"
+#include "io/fileread.h"
+#include "io/filestreamread.h"
 #include "io/filesystem/disk_filesystem.h"
+#include "io/filewrite.h"
 
 #ifdef _WIN32
 static std::string Win32Path(std::string s) {
@@ -190,4 +195,54 @@ BOOST_AUTO_TEST_CASE(test_canonicalize_name_home_expansion) {
 	TEST_CANONICALIZE_NAME("/opt", "a/path~/here", "/opt/a/path~/here")
 }
 #endif
+
+// Reads a file that is bigger than the buffer of FileStreamRead, from a
+// directory and from a zip file, and compares it with what FileRead reads.
+BOOST_AUTO_TEST_CASE(test_file_stream_read) {
+	const std::string directory = "test_file_stream_read.tmp";
+	RealFSImpl working_directory(FileSystem::get_working_directory());
+	working_directory.ensure_directory_exists(directory);
+	std::unique_ptr<FileSystem> directory_fs(working_directory.make_sub_file_system(directory));
+	std::unique_ptr<FileSystem> zip_fs(
+	   working_directory.create_sub_file_system(directory + "/test.zip", FileSystem::ZIP));
+
+	constexpr uint32_t kNrRecords = 50000;
+	for (FileSystem* fs : {directory_fs.get(), zip_fs.get()}) {
+		FileWrite fw;
+		for (uint32_t i = 0; i < kNrRecords; ++i) {
+			fw.unsigned_32(i);
+			fw.string(std::string(i % 7, 'a' + i % 26));
+		}
+		fw.write(*fs, "data");
+		// Zip files with only one file in them are not supported.
+		fw.unsigned_8(0);
+		fw.write(*fs, "other");
+	}
+
+	for (FileSystem* fs : {directory_fs.get(), zip_fs.get()}) {
+		FileRead fr;
+		fr.open(*fs, "data");
+		FileStreamRead stream;
+		stream.open(*fs, "data");
+		// Streams of the same file system are independent of each other.
+		FileStreamRead other;
+		other.open(*fs, "data");
+		for (uint32_t i = 0; i < kNrRecords; ++i) {
+			BOOST_CHECK_EQUAL(stream.unsigned_32(), fr.unsigned_32());
+			BOOST_CHECK_EQUAL(other.unsigned_32(), i);
+			const std::string expected = fr.c_string();
+			BOOST_CHECK_EQUAL(stream.c_string(), expected);
+			BOOST_CHECK_EQUAL(other.c_string(), expected);
+		}
+		BOOST_CHECK_EQUAL(stream.get_pos(), fr.get_size());
+		BOOST_CHECK(stream.end_of_file());
+		char byte;
+		BOOST_CHECK_EQUAL(stream.data(&byte, 1), 0u);
+	}
+
+	zip_fs.reset();
+	directory_fs.reset();
+	working_directory.fs_unlink(directory);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -28,6 +28,7 @@
 #include <string>
 
 #include <boost/format.hpp>
+#include <sys/stat.h>
 
 #include "base/wexception.h"
 #include "io/filesystem/filesystem_exceptions.h"
@@ -198,14 +199,24 @@ FilenameSet ZipFilesystem::list_directory(const std::string& path_in) const {
  * Also returns false if the pathname is invalid
  */
 bool ZipFilesystem::file_exists(const std::string& path) const {
+	unzFile handle;
 	try {
-		unzGoToFirstFile(zip_file_->read_handle());
+		handle = zip_file_->read_handle();
 	} catch (...) {
 		// The zip file could not be opened. I guess this means 'path' does not
 		// exist.
 		return false;
 	}
 	unz_file_info file_info;
+	return locate_file(handle, path, &file_info);
+}
+
+bool ZipFilesystem::locate_file(unzFile handle,
+                                const std::string& path,
+                                unz_file_info* file_info) const {
+	if (unzGoToFirstFile(handle) != UNZ_OK) {
+		return false;
+	}
 	char filename_inzip[256];
 	memset(filename_inzip, ' ', 256);
 
@@ -217,9 +228,8 @@ bool ZipFilesystem::file_exists(const std::string& path) const {
 	assert(path_in.size());
 
 	for (;;) {
-		const int32_t success =
-		   unzGetCurrentFileInfo(zip_file_->read_handle(), &file_info, filename_inzip,
-		                         sizeof(filename_inzip), nullptr, 0, nullptr, 0);
+		const int32_t success = unzGetCurrentFileInfo(
+		   handle, file_info, filename_inzip, sizeof(filename_inzip), nullptr, 0, nullptr, 0);
 
 		// Handle corrupt files
 		if (success != UNZ_OK) {
@@ -234,12 +244,23 @@ bool ZipFilesystem::file_exists(const std::string& path) const {
 		if (path_in == complete_filename)
 			return true;
 
-		if (unzGoToNextFile(zip_file_->read_handle()) == UNZ_END_OF_LIST_OF_FILE)
+		if (unzGoToNextFile(handle) == UNZ_END_OF_LIST_OF_FILE)
 			break;
 	}
 	return false;
 }
 
+// Changes inside a zip file change the zip file.
+FileStamp ZipFilesystem::file_stamp(const std::string& path) const {
+	FileStamp result{0, 0};
+	struct stat st;
+	if (file_exists(path) && stat(zip_file_->path().c_str(), &st) != -1) {
+		result.size = st.st_size;
+		result.modified = st.st_mtime;
+	}
+	return result;
+}
+
 /**
  * Returns true if the given file is a directory, and false if it doesn't.
  * Also returns false if the pathname is invalid
@@ -378,30 +399,25 @@ void* ZipFilesystem::load(const std::string& fname, size_t& length) {
 		throw ZipOperationError(
 		   "ZipFilesystem::load", fname, zip_file_->path(), "could not open file from zipfile");
 
-	char buffer[1024];
-	size_t totallen = 0;
-	unzOpenCurrentFile(zip_file_->read_handle());
-	for (;;) {
-		const int32_t len = unzReadCurrentFile(zip_file_->read_handle(), buffer, sizeof(buffer));
-		if (len == 0)
-			break;
-		if (len < 0) {
-			unzCloseCurrentFile(zip_file_->read_handle());
-			const std::string errormessage = (boost::format("read error %i") % len).str();
-			throw ZipOperationError(
-			   "ZipFilesystem::load", fname, zip_file_->path(), errormessage.c_str());
-		}
-
-		totallen += len;
-	}
-	unzCloseCurrentFile(zip_file_->read_handle());
-
+	// The size is known from the directory of the zip file, so the file only
+	// needs to be decompressed once.
+	unz_file_info file_info;
+	unzGetCurrentFileInfo(
+	   zip_file_->read_handle(), &file_info, nullptr, 0, nullptr, 0, nullptr, 0);
+	const size_t totallen = file_info.uncompressed_size;
 	void* const result = malloc(totallen + 1);
 	if (!result)
 		throw std::bad_alloc();
+
 	unzOpenCurrentFile(zip_file_->read_handle());
-	unzReadCurrentFile(zip_file_->read_handle(), result, totallen);
+	const int32_t len = unzReadCurrentFile(zip_file_->read_handle(), result, totallen);
 	unzCloseCurrentFile(zip_file_->read_handle());
+	if (len < 0 || static_cast<size_t>(len) != totallen) {
+		free(result);
+		const std::string errormessage = (boost::format("read error %i") % len).str();
+		throw ZipOperationError(
+		   "ZipFilesystem::load", fname, zip_file_->path(), errormessage.c_str());
+	}
 
 	static_cast<uint8_t*>(result)[totallen] = 0;
 	length = totallen;
@@ -456,16 +472,17 @@ StreamRead* ZipFilesystem::open_stream_read(const std::string& fname) {
 		throw ZipOperationError(
 		   "ZipFilesystem::load", fname, zip_file_->path(), "could not open file from zipfile");
 
-	int32_t method;
-	int result = unzOpenCurrentFile3(zip_file_->read_handle(), &method, nullptr, 1, nullptr);
-	switch (result) {
-	case ZIP_OK:
-		break;
-	default:
+	unzFile handle = unzOpen(zip_file_->path().c_str());
+	unz_file_info file_info;
+	if (!handle || !locate_file(handle, fname, &file_info) ||
+	    unzOpenCurrentFile(handle) != UNZ_OK) {
+		if (handle) {
+			unzClose(handle);
+		}
 		throw ZipOperationError(
-		   "ZipFilesystem: Failed to open streamwrite", fname, zip_file_->path());
+		   "ZipFilesystem: Failed to open streamread", fname, zip_file_->path());
 	}
-	return new ZipStreamRead(zip_file_);
+	return new ZipStreamRead(handle, zip_file_->path(), file_info.uncompressed_size);
 }
 
 StreamWrite* ZipFilesystem::open_stream_write(const std::string& fname) {
@@ -503,26 +520,32 @@ std::string ZipFilesystem::get_basename() {
 	return zip_file_->path();
 }
 
-ZipFilesystem::ZipStreamRead::ZipStreamRead(const std::shared_ptr<ZipFile>& shared_data)
-   : zip_file_(shared_data) {
+ZipFilesystem::ZipStreamRead::ZipStreamRead(unzFile handle,
+                                            const std::string& path,
+                                            const size_t size)
+   : handle_(handle), path_(path), size_(size), read_(0) {
 }
 
 ZipFilesystem::ZipStreamRead::~ZipStreamRead() {
+	unzCloseCurrentFile(handle_);
+	unzClose(handle_);
 }
 
 size_t ZipFilesystem::ZipStreamRead::data(void* read_data, size_t bufsize) {
-	int copied = unzReadCurrentFile(zip_file_->read_handle(), read_data, bufsize);
-	if (copied < 0) {
-		throw DataError("Failed to read from zip file %s", zip_file_->path().c_str());
+	bufsize = std::min(bufsize, size_ - read_);
+	if (bufsize == 0) {
+		return 0;
 	}
-	if (copied == 0) {
-		throw DataError("End of file reached while reading zip %s", zip_file_->path().c_str());
+	int copied = unzReadCurrentFile(handle_, read_data, bufsize);
+	if (copied <= 0) {
+		throw DataError("Failed to read from zip file %s", path_.c_str());
 	}
+	read_ += copied;
 	return copied;
 }
 
 bool ZipFilesystem::ZipStreamRead::end_of_file() const {
-	return unzReadCurrentFile(zip_file_->read_handle(), nullptr, 1) == 0;
+	return read_ == size_;
 }
 
 ZipFilesystem::ZipStreamWrite::ZipStreamWrite(const std::shared_ptr<ZipFile>& shared_data)
@@ -42,6 +42,7 @@ public:
 
 	bool is_directory(const std::string& path) override;
 	bool file_exists(const std::string& path) const override;
+	FileStamp file_stamp(const std::string& path) const override;
 
 	void* load(const std::string& fname, size_t& length) override;
 
@@ -120,14 +121,22 @@ private:
 		unzFile read_handle_;
 	};
 
+	// Reads one file of the zip file through a minizip handle of its own, so
+	// that any number of files can be streamed at the same time and the shared
+	// handle stays free for everything else.
 	struct ZipStreamRead : StreamRead {
-		explicit ZipStreamRead(const std::shared_ptr<ZipFile>& shared_data);
+		// Takes over 'handle', which must have its current file open.
+		ZipStreamRead(unzFile handle, const std::string& path, size_t size);
 		~ZipStreamRead() override;
 		size_t data(void* data, size_t bufsize) override;
 		bool end_of_file() const override;
 
 	private:
-		std::shared_ptr<ZipFile> zip_file_;
+		unzFile handle_;
+		std::string path_;
+		// The uncompressed size of the file and how much of it has been read.
+		size_t size_;
+		size_t read_;
 	};
 
 	struct ZipStreamWrite : StreamWrite {
@@ -139,6 +148,10 @@ private:
 		std::shared_ptr<ZipFile> zip_file_;
 	};
 
+	// Makes the file 'path' the current file of 'handle' and puts its
+	// information into 'file_info'. Returns false if there is no such file.
+	bool locate_file(unzFile handle, const std::string& path, unz_file_info* file_info) const;
+
 	// Used for creating sub filesystems.
 	ZipFilesystem(const std::shared_ptr<ZipFile>& shared_data,
 	              const std::string& basedir_in_zip_file);
@@ -90,6 +90,21 @@ uint32_t StreamRead::unsigned_32() {
 	return little_32(x);
 }
 
+/**
+ * Read a number written by \ref StreamWrite::unsigned_varint.
+ */
+uint32_t StreamRead::unsigned_varint() {
+	uint32_t x = 0;
+	for (uint8_t shift = 0; shift < 35; shift += 7) {
+		const uint8_t byte = unsigned_8();
+		x |= static_cast<uint32_t>(byte & 0x7f) << shift;
+		if (!(byte & 0x80)) {
+			return x;
+		}
+	}
+	throw data_error("Variable-length integer is longer than 5 bytes");
+}
+
 float StreamRead::float_32() {
 	uint32_t x;
 	data_complete(&x, 4);
@@ -88,6 +88,18 @@ public:
 		y = little_32(y);
 		data(&y, 4);
 	}
+	/// Writes \p x in 7-bit groups, least significant first. Small values take
+	/// a single byte, the full range takes at most five.
+	void unsigned_varint(uint32_t x) {
+		uint8_t buf[5];
+		size_t size = 0;
+		while (x >= 0x80) {
+			buf[size++] = static_cast<uint8_t>(x | 0x80);
+			x >>= 7;
+		}
+		buf[size++] = static_cast<uint8_t>(x);
+		data(buf, size);
+	}
 	void string(const std::string& str) {
 		data(str.c_str(), str.size() + 1);
 	}
@@ -81,6 +81,7 @@ public:
 	friend class InteractiveBase;
 	friend class FullscreenMenuLaunchGame;
 	friend struct GameClassPacket;
+	friend struct RecalcWholeMapFixture;  // Sets a world that has no graphics.
 
 	explicit EditorGameBase(LuaInterface* lua);
 	virtual ~EditorGameBase();
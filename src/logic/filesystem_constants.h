@@ -75,6 +75,13 @@ const std::string kCampaignDataExtension = ".wcd";
 /// Filesystem names for screenshots
 const std::string kScreenshotsDir = "screenshots";
 
+/// Filesystem names for frame profiler traces
+const std::string kTracesDir = "traces";
+
+/// Filesystem names for data that is derived from the data directory to speed up startup. It
+/// can be deleted at any time.
+const std::string kCacheDir = "cache";
+
 /// Filesystem names for config
 const std::string kConfigFile = "config";
 
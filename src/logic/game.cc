@@ -32,6 +32,7 @@
 #include <windows.h>
 #endif
 
+#include "base/frame_profiler.h"
 #include "base/i18n.h"
 #include "base/log.h"
 #include "base/macros.h"
@@ -595,6 +596,7 @@ bool Game::run(StartGameType const start_game_type,
  * running the cmd queue etc.
  */
 void Game::think() {
+	FrameProfiler::Scope profile("Game::think");
 	assert(ctrl_);
 
 	ctrl_->think();
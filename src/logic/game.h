@@ -64,7 +64,7 @@ enum {
 
 // The entry types that are written to the syncstream
 // The IDs are a number in the higher 4 bits and the length in bytes in the lower 4 bits
-// Keep this synchronized with utils/syncstream/syncexcerpt-to-text.py
+// Keep this synchronized with utils/syncstream/syncexcerpt-to-text.py and bisect-desync.py
 enum SyncEntry : uint8_t {
 	// Used in:
 	// game.cc Game::report_desync()
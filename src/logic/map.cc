@@ -20,6 +20,7 @@
 #include "logic/map.h"
 
 #include <algorithm>
+#include <functional>
 #include <memory>
 
 #include <boost/algorithm/string.hpp>
@@ -30,6 +31,7 @@
 #include "base/macros.h"
 #include "base/scoped_timer.h"
 #include "base/wexception.h"
+#include "base/worker_pool.h"
 #include "build_info.h"
 #include "economy/flag.h"
 #include "economy/roadbase.h"
@@ -97,7 +99,7 @@ Map::~Map() {
 	cleanup();
 }
 
-void Map::recalc_border(const FCoords& fc) {
+bool Map::calc_border(const FCoords& fc) const {
 	if (const PlayerNumber owner = fc.field->get_owned_by()) {
 		//  A node that is owned by a player and has a neighbour that is not owned
 		//  by that player is a border node.
@@ -105,12 +107,15 @@ void Map::recalc_border(const FCoords& fc) {
 			FCoords neighbour;
 			get_neighbour(fc, i, &neighbour);
 			if (neighbour.field->get_owned_by() != owner) {
-				fc.field->set_border(true);
-				return;  //  Do not calculate further if there is a border.
+				return true;  //  Do not calculate further if there is a border.
 			}
 		}
 	}
-	fc.field->set_border(false);
+	return false;
+}
+
+void Map::recalc_border(const FCoords& fc) {
+	fc.field->set_border(calc_border(fc));
 }
 
 /*
@@ -146,6 +151,8 @@ void Map::recalc_for_field_area(const EditorGameBase& egbase, const Area<FCoords
 			recalc_nodecaps_pass2(egbase, mr.location());
 		while (mr.advance(*this));
 	}
+
+	Notifications::publish(NoteFieldsRecalculated{area});
 }
 
 /*
@@ -158,26 +165,83 @@ the overlays have completely changed.
 ===========
 */
 void Map::recalc_whole_map(const EditorGameBase& egbase) {
+	recalc_whole_map(egbase, WorkerPool::for_loading());
+}
+
+void Map::recalc_whole_map(const EditorGameBase& egbase, WorkerPool& pool) {
 	//  Post process the map in the necessary two passes to calculate
-	//  brightness and building caps
-	FCoords f;
+	//  brightness and building caps. Nodes only read their neighbours within a
+	//  pass, so each pass is done by bands of rows in parallel. Nothing that is
+	//  read by other nodes is written before the end of the pass.
+	constexpr int16_t kRowsPerBand = 8;
+	const size_t nr_bands = (height_ + kRowsPerBand - 1) / kRowsPerBand;
+	const auto for_each_node = [this, &pool, nr_bands](
+	                              const std::function<void(const FCoords&, MapIndex)>& function) {
+		pool.run(nr_bands, [this, &function](const size_t band) {
+			const int16_t end = std::min<int>(height_, (band + 1) * kRowsPerBand);
+			for (int16_t y = band * kRowsPerBand; y < end; ++y) {
+				for (int16_t x = 0; x < width_; ++x) {
+					const FCoords f = get_fcoords(Coords(x, y));
+					function(f, f.field - fields_.get());
+				}
+			}
+		});
+	};
 
-	for (int16_t y = 0; y < height_; ++y)
+	// The world is loaded lazily, which must not happen on the workers.
+	egbase.world();
+
+	// A fixed height can spread over the whole map, so the heights are checked
+	// one node after the other. The brightness of the nodes before a fix is
+	// calculated with the heights that they saw, so that it comes out the same
+	// as in a single pass.
+	MapIndex brightness_start = 0;
+	for (int16_t y = 0; y < height_; ++y) {
 		for (int16_t x = 0; x < width_; ++x) {
-			f = get_fcoords(Coords(x, y));
+			const FCoords f = get_fcoords(Coords(x, y));
+			if (!needs_height_check(f)) {
+				continue;
+			}
+			const MapIndex index = f.field - fields_.get();
+			for (MapIndex i = brightness_start; i < index; ++i) {
+				recalc_brightness(get_fcoords(fields_[i]));
+			}
 			uint32_t radius = 0;
 			check_neighbour_heights(f, radius);
-			recalc_brightness(f);
-			recalc_border(f);
-			recalc_nodecaps_pass1(egbase, f);
+			brightness_start = index;
 		}
+	}
 
-	for (int16_t y = 0; y < height_; ++y)
-		for (int16_t x = 0; x < width_; ++x) {
-			f = get_fcoords(Coords(x, y));
-			recalc_nodecaps_pass2(egbase, f);
+	// The borders are read by the second pass, so they are set after this one.
+	std::vector<uint8_t> borders(max_index());
+	for_each_node([this, &egbase, &borders, brightness_start](const FCoords& f, MapIndex index) {
+		if (index >= brightness_start) {
+			recalc_brightness(f);
 		}
+		borders[index] = calc_border(f);
+		recalc_nodecaps_pass1(egbase, f);
+	});
+	for_each_node([&borders](const FCoords& f, MapIndex index) {
+		f.field->set_border(borders[index]);
+	});
+
+	// The second pass reads the caps of the neighbours, but only the bits that
+	// the first pass has set.
+	std::vector<uint8_t> caps(max_index());
+	std::vector<uint8_t> max_caps(max_index());
+	for_each_node([this, &egbase, &caps, &max_caps](const FCoords& f, MapIndex index) {
+		caps[index] = calc_nodecaps_pass2(egbase, f, true);
+		max_caps[index] =
+		   calc_nodecaps_pass2(egbase, f, false, static_cast<NodeCaps>(f.field->max_caps));
+	});
+	for_each_node([&caps, &max_caps](const FCoords& f, MapIndex index) {
+		f.field->caps = caps[index];
+		f.field->max_caps = max_caps[index];
+	});
+
 	recalculate_allows_seafaring();
+	Notifications::publish(NoteFieldsRecalculated{
+	   Area<FCoords>(get_fcoords(Coords(0, 0)), std::max<uint16_t>(width_, height_))});
 }
 
 void Map::recalc_default_resources(const World& world) {
@@ -2340,6 +2404,25 @@ void Map::check_neighbour_heights(FCoords coords, uint32_t& area) {
 			check_neighbour_heights(n[i], area);
 }
 
+/*
+===========
+Map::needs_height_check()
+
+Returns whether check_neighbour_heights() would change any heights around
+this field.
+=============
+*/
+bool Map::needs_height_check(const FCoords& coords) const {
+	const int32_t height = coords.field->get_height();
+	for (const FCoords& n : {tl_n(coords), tr_n(coords), l_n(coords), r_n(coords), bl_n(coords),
+	                         br_n(coords)}) {
+		if (std::abs(height - n.field->get_height()) > MAX_FIELD_HEIGHT_DIFF) {
+			return true;
+		}
+	}
+	return false;
+}
+
 bool Map::allows_seafaring() const {
 	return allows_seafaring_;
 }
@@ -2427,6 +2510,26 @@ bool Map::has_artifacts() {
 	return false;
 }
 
+void Map::recalc_tags(const EditorGameBase& egbase) {
+	cleanup_port_spaces(egbase);
+	if (allows_seafaring()) {
+		add_tag("seafaring");
+	} else {
+		delete_tag("seafaring");
+	}
+	if (get_waterway_max_length() >= 2) {
+		add_tag("ferries");
+	} else {
+		delete_tag("ferries");
+	}
+
+	if (has_artifacts()) {
+		add_tag("artifacts");
+	} else {
+		delete_tag("artifacts");
+	}
+}
+
 #define MAX_RADIUS 32
 MilitaryInfluence Map::calc_influence(Coords const a, Area<> const area) const {
 	const int16_t w = get_width();
@@ -42,6 +42,7 @@
 
 class FileSystem;
 class Image;
+class WorkerPool;
 struct S2MapLoader;
 
 namespace Widelands {
@@ -68,6 +69,15 @@ struct NoteFieldTerrainChanged {
 	MapIndex map_index;
 };
 
+// Sent by Map::recalc_for_field_area() and Map::recalc_whole_map(). The
+// height and brightness of the fields in 'area' might have changed. For the
+// whole map, 'area' is centered at (0, 0) and its radius covers the map.
+struct NoteFieldsRecalculated {
+	CAN_BE_SENT_AS_NOTE(NoteId::FieldsRecalculated)
+
+	Area<FCoords> area;
+};
+
 struct ImmovableFound {
 	BaseImmovable* object;
 	Coords coords;
@@ -140,6 +150,7 @@ public:
 	friend struct MapGenerator;
 	friend struct MapElementalPacket;
 	friend struct WidelandsMapLoader;
+	friend struct RecalcWholeMapFixture;  // Compares with the serial recalc_whole_map().
 
 	using PortSpacesSet = std::set<Coords>;
 	using Objectives = std::map<std::string, std::unique_ptr<Objective>>;
@@ -172,7 +183,15 @@ public:
 	    const std::string& author = pgettext("author_name", "Unknown"),
 	    const std::string& description = _("No description defined"));
 
+	/**
+	 * Recalculates the heights, brightness, borders and caps of all nodes. The
+	 * passes are split up into bands of rows that the threads of 'pool' work on,
+	 * with the same results as working through the nodes one after the other.
+	 * The first version uses WorkerPool::for_loading(), so it must only be
+	 * called from the main thread.
+	 */
 	void recalc_whole_map(const EditorGameBase&);
+	void recalc_whole_map(const EditorGameBase&, WorkerPool& pool);
 	void recalc_for_field_area(const EditorGameBase&, Area<FCoords>);
 
 	/**
@@ -480,6 +499,9 @@ public:
 		return &objectives_;
 	}
 
+	const std::set<FCoords>& valuable_fields() const {
+		return valuable_fields_;
+	}
 	std::set<FCoords>* mutable_valuable_fields() {
 		return &valuable_fields_;
 	}
@@ -522,6 +544,11 @@ public:
 	/// Checks whether there are any artifacts on the map
 	bool has_artifacts();
 
+	/// Removes the port spaces that are not valid and sets the tags that follow
+	/// from the map itself: "seafaring", "ferries" and "artifacts". Call this
+	/// before saving a map that has been edited.
+	void recalc_tags(const EditorGameBase&);
+
 	// Visible for testing.
 	void set_size(uint32_t w, uint32_t h);
 
@@ -539,6 +566,7 @@ protected:
 	void calculate_needs_widelands_version_after(bool is_post_one_world);
 
 private:
+	bool calc_border(const FCoords&) const;
 	void recalc_border(const FCoords&);
 	void recalc_brightness(const FCoords&);
 	void recalc_nodecaps_pass1(const EditorGameBase&, const FCoords&);
@@ -550,6 +578,7 @@ private:
 	                             bool consider_mobs = true,
 	                             NodeCaps initcaps = CAPS_NONE) const;
 	void check_neighbour_heights(FCoords, uint32_t& radius);
+	bool needs_height_check(const FCoords&) const;
 	int calc_buildsize(const EditorGameBase&,
 	                   const FCoords& f,
 	                   bool avoidnature,
@@ -110,6 +110,9 @@ void BaseImmovable::set_position(EditorGameBase& egbase, const Coords& c) {
 	if (get_size() >= SMALL) {
 		map->recalc_for_field_area(egbase, Area<FCoords>(f, 2));
 	}
+	if (descr().type() >= MapObjectType::FLAG) {
+		Notifications::publish(NoteFieldPlayerImmovableChanged{f});
+	}
 }
 
 /**
@@ -136,6 +139,9 @@ void BaseImmovable::unset_position(EditorGameBase& egbase, const Coords& c) {
 	if (get_size() >= SMALL) {
 		map->recalc_for_field_area(egbase, Area<FCoords>(f, 2));
 	}
+	if (descr().type() >= MapObjectType::FLAG) {
+		Notifications::publish(NoteFieldPlayerImmovableChanged{f});
+	}
 }
 
 /*
@@ -62,6 +62,14 @@ struct NoteImmovable {
 	}
 };
 
+// Sent when a player immovable (flag, road, building...) has been placed on or
+// removed from the field at 'fc'.
+struct NoteFieldPlayerImmovableChanged {
+	CAN_BE_SENT_AS_NOTE(NoteId::FieldPlayerImmovableChanged)
+
+	FCoords fc;
+};
+
 /**
  * BaseImmovable is the base for all non-moving objects (immovables such as
  * trees, buildings, flags, roads).
@@ -19,8 +19,8 @@
 
 #include "logic/map_objects/tribes/building_settings.h"
 
-#include "io/fileread.h"
 #include "io/filewrite.h"
+#include "io/streamread.h"
 #include "logic/game.h"
 #include "logic/game_data_error.h"
 #include "logic/map_objects/tribes/militarysite.h"
@@ -139,7 +139,8 @@ constexpr uint8_t kCurrentPacketVersionTrainingsite = 1;
 constexpr uint8_t kCurrentPacketVersionWarehouse = 1;
 
 // static
-BuildingSettings* BuildingSettings::load(const Game& game, const TribeDescr& tribe, FileRead& fr) {
+BuildingSettings*
+BuildingSettings::load(const Game& game, const TribeDescr& tribe, StreamRead& fr) {
 	try {
 		const uint8_t packet_version = fr.unsigned_8();
 		if (packet_version == kCurrentPacketVersion) {
@@ -186,7 +187,7 @@ BuildingSettings* BuildingSettings::load(const Game& game, const TribeDescr& tri
 	NEVER_HERE();
 }
 
-void BuildingSettings::read(const Game&, FileRead&) {
+void BuildingSettings::read(const Game&, StreamRead&) {
 	// Header was peeled away by load()
 }
 
@@ -196,7 +197,7 @@ void BuildingSettings::save(const Game&, FileWrite& fw) const {
 	fw.unsigned_8(static_cast<uint8_t>(type()));
 }
 
-void MilitarysiteSettings::read(const Game& game, FileRead& fr) {
+void MilitarysiteSettings::read(const Game& game, StreamRead& fr) {
 	BuildingSettings::read(game, fr);
 	try {
 		const uint8_t packet_version = fr.unsigned_8();
@@ -220,7 +221,7 @@ void MilitarysiteSettings::save(const Game& game, FileWrite& fw) const {
 	fw.unsigned_8(prefer_heroes ? 1 : 0);
 }
 
-void ProductionsiteSettings::read(const Game& game, FileRead& fr) {
+void ProductionsiteSettings::read(const Game& game, StreamRead& fr) {
 	BuildingSettings::read(game, fr);
 	try {
 		const uint8_t packet_version = fr.unsigned_8();
@@ -272,7 +273,7 @@ void ProductionsiteSettings::save(const Game& game, FileWrite& fw) const {
 	}
 }
 
-void TrainingsiteSettings::read(const Game& game, FileRead& fr) {
+void TrainingsiteSettings::read(const Game& game, StreamRead& fr) {
 	ProductionsiteSettings::read(game, fr);
 	try {
 		const uint8_t packet_version = fr.unsigned_8();
@@ -293,7 +294,7 @@ void TrainingsiteSettings::save(const Game& game, FileWrite& fw) const {
 	fw.unsigned_32(desired_capacity);
 }
 
-void WarehouseSettings::read(const Game& game, FileRead& fr) {
+void WarehouseSettings::read(const Game& game, StreamRead& fr) {
 	BuildingSettings::read(game, fr);
 	try {
 		const uint8_t packet_version = fr.unsigned_8();
@@ -26,8 +26,8 @@
 
 #include "logic/widelands.h"
 
-class FileRead;
 class FileWrite;
+class StreamRead;
 
 namespace Widelands {
 
@@ -45,10 +45,10 @@ struct BuildingSettings {
 	virtual ~BuildingSettings() {
 	}
 
-	static BuildingSettings* load(const Game&, const TribeDescr&, FileRead&);
+	static BuildingSettings* load(const Game&, const TribeDescr&, StreamRead&);
 
 	virtual void save(const Game&, FileWrite&) const;
-	virtual void read(const Game&, FileRead&);
+	virtual void read(const Game&, StreamRead&);
 
 	virtual void apply(const BuildingSettings&) {
 	}
@@ -73,7 +73,7 @@ struct ProductionsiteSettings : public BuildingSettings {
 	void apply(const BuildingSettings&) override;
 
 	void save(const Game&, FileWrite&) const override;
-	void read(const Game&, FileRead&) override;
+	void read(const Game&, StreamRead&) override;
 
 	struct InputQueueSetting {
 		const uint32_t max_fill;
@@ -97,7 +97,7 @@ struct MilitarysiteSettings : public BuildingSettings {
 	void apply(const BuildingSettings&) override;
 
 	void save(const Game&, FileWrite&) const override;
-	void read(const Game&, FileRead&) override;
+	void read(const Game&, StreamRead&) override;
 
 	const uint32_t max_capacity;
 	uint32_t desired_capacity;
@@ -116,7 +116,7 @@ struct TrainingsiteSettings : public ProductionsiteSettings {
 	void apply(const BuildingSettings&) override;
 
 	void save(const Game&, FileWrite&) const override;
-	void read(const Game&, FileRead&) override;
+	void read(const Game&, StreamRead&) override;
 
 	const uint32_t max_capacity;
 	uint32_t desired_capacity;
@@ -134,7 +134,7 @@ struct WarehouseSettings : public BuildingSettings {
 	void apply(const BuildingSettings&) override;
 
 	void save(const Game&, FileWrite&) const override;
-	void read(const Game&, FileRead&) override;
+	void read(const Game&, StreamRead&) override;
 
 	std::map<DescriptionIndex, StockPolicy> ware_preferences;
 	std::map<DescriptionIndex, StockPolicy> worker_preferences;
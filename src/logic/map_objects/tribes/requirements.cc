@@ -20,8 +20,8 @@
 #include "logic/map_objects/tribes/requirements.h"
 
 #include "base/i18n.h"
-#include "io/fileread.h"
 #include "io/filewrite.h"
+#include "io/streamread.h"
 #include "logic/game_data_error.h"
 #include "logic/map_objects/map_object.h"
 
@@ -36,7 +36,7 @@ constexpr uint16_t kCurrentPacketVersion = 4;
 /**
  * Read this requirement from a file
  */
-void Requirements::read(FileRead& fr, EditorGameBase& egbase, MapObjectLoader& mol) {
+void Requirements::read(StreamRead& fr, EditorGameBase& egbase, MapObjectLoader& mol) {
 	try {
 		uint16_t const packet_version = fr.unsigned_16();
 		if (packet_version == kCurrentPacketVersion) {
@@ -75,7 +75,8 @@ uint32_t RequirementsStorage::id() const {
 	return id_;
 }
 
-Requirements RequirementsStorage::read(FileRead& fr, EditorGameBase& egbase, MapObjectLoader& mol) {
+Requirements
+RequirementsStorage::read(StreamRead& fr, EditorGameBase& egbase, MapObjectLoader& mol) {
 	uint32_t const id = fr.unsigned_16();
 
 	if (id == 0)
@@ -118,7 +119,7 @@ void RequireOr::write(FileWrite& fw, EditorGameBase& egbase, MapObjectSaver& mos
 	}
 }
 
-static Requirements read_or(FileRead& fr, EditorGameBase& egbase, MapObjectLoader& mol) {
+static Requirements read_or(StreamRead& fr, EditorGameBase& egbase, MapObjectLoader& mol) {
 	uint32_t const count = fr.unsigned_16();
 	RequireOr req;
 
@@ -155,7 +156,7 @@ void RequireAnd::write(FileWrite& fw, EditorGameBase& egbase, MapObjectSaver& mo
 	}
 }
 
-static Requirements read_and(FileRead& fr, EditorGameBase& egbase, MapObjectLoader& mol) {
+static Requirements read_and(StreamRead& fr, EditorGameBase& egbase, MapObjectLoader& mol) {
 	uint32_t const count = fr.unsigned_16();
 	RequireAnd req;
 
@@ -191,7 +192,7 @@ void RequireAttribute::write(FileWrite& fw, EditorGameBase&, MapObjectSaver&) co
 	fw.signed_32(max);
 }
 
-static Requirements read_attribute(FileRead& fr, EditorGameBase&, MapObjectLoader&) {
+static Requirements read_attribute(StreamRead& fr, EditorGameBase&, MapObjectLoader&) {
 	// Get the training attribute and check if it is a valid enum member
 	// We use a temp value, because the static_cast to the enum might be undefined.
 	uint8_t temp_at = fr.unsigned_8();
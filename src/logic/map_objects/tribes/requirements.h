@@ -28,8 +28,8 @@
 
 #include "logic/map_objects/tribes/training_attribute.h"
 
-class FileRead;
 class FileWrite;
+class StreamRead;
 
 namespace Widelands {
 
@@ -89,7 +89,7 @@ public:
 	bool check(const MapObject&) const;
 
 	// For Save/Load Games
-	void read(FileRead&, EditorGameBase&, MapObjectLoader&);
+	void read(StreamRead&, EditorGameBase&, MapObjectLoader&);
 	void write(FileWrite&, EditorGameBase&, MapObjectSaver&) const;
 
 private:
@@ -111,12 +111,12 @@ enum {
  * Factory-like system for requirement loading from files.
  */
 struct RequirementsStorage {
-	using Reader = Requirements (*)(FileRead&, EditorGameBase&, MapObjectLoader&);
+	using Reader = Requirements (*)(StreamRead&, EditorGameBase&, MapObjectLoader&);
 
 	RequirementsStorage(uint32_t id, Reader reader);
 	uint32_t id() const;
 
-	static Requirements read(FileRead&, EditorGameBase&, MapObjectLoader&);
+	static Requirements read(StreamRead&, EditorGameBase&, MapObjectLoader&);
 
 private:
 	using StorageMap = std::map<uint32_t, RequirementsStorage*>;
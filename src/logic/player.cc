@@ -1214,6 +1214,8 @@ Vision Player::see_node(const Map& map, const FCoords& f, Time const gametime, b
 	}
 	if (field.vision == 1) {
 		rediscover_node(map, f);
+		Notifications::publish(NoteFieldVisionChanged{
+		   player_number(), static_cast<MapIndex>(f.field - &first_map_field)});
 	}
 	return ++field.vision;
 }
@@ -1248,6 +1250,7 @@ Vision Player::unsee_node(MapIndex const i,
 	}
 	if (field.vision < 2) {
 		field.time_node_last_unseen = gametime;
+		Notifications::publish(NoteFieldVisionChanged{player_number(), i});
 	}
 	return original_vision;
 }
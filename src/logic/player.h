@@ -53,6 +53,15 @@ struct Road;
 struct Waterway;
 struct AttackController;
 
+// Sent when a node becomes visible to a player or when the player stops seeing
+// it, i.e. when the node's vision crosses 2 or drops to 0.
+struct NoteFieldVisionChanged {
+	CAN_BE_SENT_AS_NOTE(NoteId::FieldVisionChanged)
+
+	PlayerNumber player_number;
+	MapIndex map_index;
+};
+
 /**
  * Manage in-game aspects of players, such as tribe, team, fog-of-war, statistics,
  * messages (notification when a resource has been found etc.) and so on.
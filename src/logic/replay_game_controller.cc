@@ -29,7 +29,8 @@ ReplayGameController::ReplayGameController(Widelands::Game& game, const std::str
      lastframe_(SDL_GetTicks()),
      time_(game_.get_gametime()),
      speed_(1000),
-     paused_(false) {
+     paused_(false),
+     exit_at_end_(false) {
 	game_.set_game_controller(this);
 	replayreader_.reset(new Widelands::ReplayReader(game_, filename));
 }
@@ -55,7 +56,7 @@ void ReplayGameController::think() {
 
 		if (replayreader_->end_of_replay()) {
 			replayreader_.reset(nullptr);
-			game_.enqueue_command(new CmdReplayEnd(time_ = game_.get_gametime()));
+			game_.enqueue_command(new CmdReplayEnd(time_ = game_.get_gametime(), exit_at_end_));
 		}
 	}
 }
@@ -94,6 +95,10 @@ void ReplayGameController::set_paused(bool const paused) {
 
 void ReplayGameController::CmdReplayEnd::execute(Widelands::Game& game) {
 	game.game_controller()->set_desired_speed(0);
+	if (exit_game_) {
+		game.get_ibase()->end_modal<UI::Panel::Returncodes>(UI::Panel::Returncodes::kBack);
+		return;
+	}
 	UI::WLMessageBox mmb(game.get_ibase(), _("End of Replay"),
 	                     _("The end of the replay has been reached and the game has "
 	                       "been paused. You may unpause the game and continue watching "
@@ -44,12 +44,21 @@ public:
 	bool is_paused() override;
 	void set_paused(bool const paused) override;
 
+	/// Leave the game instead of pausing it when the end of the replay is reached.
+	void set_exit_at_end(bool exit_at_end) {
+		exit_at_end_ = exit_at_end;
+	}
+
 private:
 	struct CmdReplayEnd : public Widelands::Command {
-		explicit CmdReplayEnd(uint32_t const init_duetime) : Widelands::Command(init_duetime) {
+		CmdReplayEnd(uint32_t const init_duetime, bool exit_game)
+		   : Widelands::Command(init_duetime), exit_game_(exit_game) {
 		}
 		virtual void execute(Widelands::Game& game);
 		virtual Widelands::QueueCommandTypes id() const;
+
+	private:
+		bool exit_game_;
 	};
 
 	Widelands::Game& game_;
@@ -58,6 +67,7 @@ private:
 	int32_t time_;
 	uint32_t speed_;
 	bool paused_;
+	bool exit_at_end_;
 };
 
 #endif  // end of include guard: WL_LOGIC_REPLAY_GAME_CONTROLLER_H
@@ -0,0 +1,184 @@
+/*
+ * Copyright (C) 2019 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+#include <boost/test/unit_test.hpp>
+
+#include "base/macros.h"
+#include "base/worker_pool.h"
+#include "io/filesystem/layered_filesystem.h"
+#include "io/filewrite.h"
+#include "logic/editor_game_base.h"
+#include "logic/field.h"
+#include "logic/map.h"
+#include "logic/map_objects/world/world.h"
+#include "scripting/lua.h"
+#include "scripting/lua_table.h"
+
+// Triggered by BOOST_AUTO_TEST_CASE
+CLANG_DIAG_OFF("-Wdisabled-macro-expansion")
+CLANG_DIAG_OFF("-Wused-but-marked-unused")
+
+namespace Widelands {
+
+namespace {
+
+constexpr const char* kPicture = "test_recalc_whole_map.tmp";
+
+// One terrain of every kind that makes a difference for the node caps.
+constexpr const char* kTerrainTypes[] = {"arable", "walkable", "water", "unreachable",
+                                         "mineable", "unwalkable"};
+
+struct LuaCloser {
+	void operator()(lua_State* L) {
+		lua_close(L);
+	}
+};
+
+}  // namespace
+
+/// Maps with random heights and terrains, so that many neighbouring nodes are
+/// too steep and get fixed. The world is made from Lua tables, because the
+/// world of the data directory needs graphics.
+struct RecalcWholeMapFixture {
+	RecalcWholeMapFixture() : L(luaL_newstate()) {
+		// Editor categories need a picture that exists.
+		g_fs = new LayeredFileSystem();
+		g_fs->add_file_system(&FileSystem::create(FileSystem::get_working_directory()));
+		FileWrite fw;
+		fw.unsigned_8(0);
+		fw.write(*g_fs, kPicture);
+	}
+	~RecalcWholeMapFixture() {
+		g_fs->fs_unlink(kPicture);
+		delete g_fs;
+		g_fs = nullptr;
+	}
+
+	std::unique_ptr<LuaTable> table(const std::string& code) {
+		if (luaL_dostring(L.get(), ("return " + code).c_str()) != 0) {
+			throw std::runtime_error(lua_tostring(L.get(), -1));
+		}
+		std::unique_ptr<LuaTable> result(new LuaTable(L.get()));
+		lua_pop(L.get(), 1);
+		return result;
+	}
+
+	void set_world(EditorGameBase* egbase) {
+		egbase->world_.reset(new World());
+		World* world = egbase->world_.get();
+		world->add_editor_terrain_category(*table(
+		   std::string("{name = 'all', descname = 'All', picture = '") + kPicture +
+		   "', items_per_row = 1}"));
+		for (const char* is : kTerrainTypes) {
+			world->add_terrain_type(*table(
+			   std::string("{name = '") + is + "', descname = '" + is + "', is = '" + is +
+			   "', editor_category = 'all', default_resource = '', default_resource_amount = 0, "
+			   "valid_resources = {}, textures = {'" +
+			   kPicture + "'}, dither_layer = 1, temperature = 100, fertility = 500, "
+			              "humidity = 500}"));
+		}
+	}
+
+	static void fill_map(uint32_t seed, EditorGameBase* egbase) {
+		Map* map = egbase->mutable_map();
+		map->set_size(48, 32);
+		std::minstd_rand random(seed);
+		const uint32_t nr_terrains = sizeof(kTerrainTypes) / sizeof(kTerrainTypes[0]);
+		for (MapIndex i = 0; i < map->max_index(); ++i) {
+			Field& field = (*map)[i];
+			field.set_height(random() % (MAX_FIELD_HEIGHT + 1));
+			// Mostly the same terrain, so that there is something to build on.
+			const auto terrain = [&random, nr_terrains]() {
+				return static_cast<DescriptionIndex>(random() % 4 == 0 ? random() % nr_terrains : 0);
+			};
+			field.set_terrain_d(terrain());
+			field.set_terrain_r(terrain());
+		}
+	}
+
+	// Map::recalc_whole_map() as it was before its passes were run in parallel.
+	static void serial_recalc_whole_map(const EditorGameBase& egbase, Map* map) {
+		FCoords f;
+
+		for (int16_t y = 0; y < map->height_; ++y)
+			for (int16_t x = 0; x < map->width_; ++x) {
+				f = map->get_fcoords(Coords(x, y));
+				uint32_t radius = 0;
+				map->check_neighbour_heights(f, radius);
+				map->recalc_brightness(f);
+				map->recalc_border(f);
+				map->recalc_nodecaps_pass1(egbase, f);
+			}
+
+		for (int16_t y = 0; y < map->height_; ++y)
+			for (int16_t x = 0; x < map->width_; ++x) {
+				f = map->get_fcoords(Coords(x, y));
+				map->recalc_nodecaps_pass2(egbase, f);
+			}
+	}
+
+	std::unique_ptr<lua_State, LuaCloser> L;
+};
+
+BOOST_FIXTURE_TEST_SUITE(recalc_whole_map, RecalcWholeMapFixture)
+
+BOOST_AUTO_TEST_CASE(parallel_is_like_serial) {
+	for (uint32_t seed = 1; seed <= 4; ++seed) {
+		EditorGameBase serial(nullptr);
+		set_world(&serial);
+		fill_map(seed, &serial);
+		EditorGameBase parallel(nullptr);
+		set_world(&parallel);
+		fill_map(seed, &parallel);
+
+		serial_recalc_whole_map(serial, serial.mutable_map());
+		WorkerPool pool(4);
+		parallel.mutable_map()->recalc_whole_map(parallel, pool);
+
+		const Map& expected = serial.map();
+		const Map& map = parallel.map();
+		for (MapIndex i = 0; i < map.max_index(); ++i) {
+			const Field& want = expected[i];
+			const Field& got = map[i];
+			BOOST_REQUIRE_MESSAGE(got.get_height() == want.get_height(), "height of node " << i);
+			BOOST_REQUIRE_MESSAGE(
+			   got.get_brightness() == want.get_brightness(), "brightness of node " << i);
+			BOOST_REQUIRE_MESSAGE(got.is_border() == want.is_border(), "border of node " << i);
+			BOOST_REQUIRE_MESSAGE(got.nodecaps() == want.nodecaps(), "caps of node " << i);
+			BOOST_REQUIRE_MESSAGE(got.maxcaps() == want.maxcaps(), "max caps of node " << i);
+		}
+		// The random heights must have been fixed, else the test shows nothing.
+		EditorGameBase unfixed(nullptr);
+		fill_map(seed, &unfixed);
+		uint32_t nr_fixed_heights = 0;
+		for (MapIndex i = 0; i < map.max_index(); ++i) {
+			nr_fixed_heights += map[i].get_height() != unfixed.map()[i].get_height();
+		}
+		BOOST_CHECK_GT(nr_fixed_heights, 0u);
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}  // namespace Widelands
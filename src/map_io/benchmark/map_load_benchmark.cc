@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2019 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+// Measures how long loading the largest maps that come with the game takes,
+// and how long Map::recalc_whole_map() takes on them, once with all passes on
+// the calling thread and once with the worker pool for loading. Also checks
+// that both give the same nodes. The times are wall clock times, because the
+// point is to make use of the other cores.
+//
+// Usage: map_io_map_load_benchmark <data directory> [maps] [runs]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/algorithm/string/predicate.hpp>
+
+#include "base/log.h"
+#include "base/wexception.h"
+#include "base/worker_pool.h"
+#include "benchmark/benchmark_common.h"
+#include "io/filesystem/layered_filesystem.h"
+#include "logic/editor_game_base.h"
+#include "logic/filesystem_constants.h"
+#include "logic/map.h"
+#include "map_io/map_loader.h"
+
+namespace {
+
+struct MapFile {
+	std::string filename;
+	std::string name;
+	int width;
+	int height;
+};
+
+// The maps in the data directory, largest first.
+std::vector<MapFile> find_maps() {
+	std::vector<MapFile> maps;
+	for (const std::string& filename : g_fs->list_directory(kMapsDir)) {
+		if (!boost::algorithm::ends_with(filename, kWidelandsMapExtension)) {
+			continue;
+		}
+		Widelands::Map map;
+		std::unique_ptr<Widelands::MapLoader> loader(map.get_correct_loader(filename));
+		if (!loader) {
+			continue;
+		}
+		loader->preload_map(true);
+		maps.push_back(MapFile{filename, map.get_name(), map.get_width(), map.get_height()});
+	}
+	std::stable_sort(maps.begin(), maps.end(), [](const MapFile& a, const MapFile& b) {
+		return a.width * a.height > b.width * b.height;
+	});
+	return maps;
+}
+
+// Returns the fastest of 'nr_runs' runs in ms.
+double time_recalc(Widelands::EditorGameBase* egbase, WorkerPool* pool, const int nr_runs) {
+	double fastest = 0.;
+	for (int run = 0; run < nr_runs; ++run) {
+		const auto start = std::chrono::steady_clock::now();
+		egbase->mutable_map()->recalc_whole_map(*egbase, *pool);
+		const double duration = ms_since(start);
+		fastest = run == 0 ? duration : std::min(fastest, duration);
+	}
+	return fastest;
+}
+
+// Returns false if the passes on the worker pool gave different nodes.
+bool benchmark_map(const MapFile& map_file, const int nr_runs) {
+	Widelands::EditorGameBase egbase(nullptr);
+	// The world and tribes are loaded on first use, which is not part of the map.
+	egbase.world();
+	egbase.tribes();
+
+	Widelands::Map* map = egbase.mutable_map();
+	std::unique_ptr<Widelands::MapLoader> loader(map->get_correct_loader(map_file.filename));
+	if (!loader) {
+		throw wexception("Cannot load %s", map_file.filename.c_str());
+	}
+	const auto start = std::chrono::steady_clock::now();
+	loader->preload_map(true);
+	loader->load_map_complete(egbase, Widelands::MapLoader::LoadType::kScenario);
+	const double load_ms = ms_since(start);
+
+	WorkerPool serial(0);
+	const double serial_ms = time_recalc(&egbase, &serial, nr_runs);
+	const std::vector<NodeState> serial_nodes = node_states(*map);
+
+	WorkerPool& pool = WorkerPool::for_loading();
+	const double parallel_ms = time_recalc(&egbase, &pool, nr_runs);
+	const bool identical = node_states(*map) == serial_nodes;
+
+	log("%s (%dx%d)\n", map_file.name.c_str(), map_file.width, map_file.height);
+	log("   loading the map:              %8.1f ms\n", load_ms);
+	log("   recalc_whole_map, 1 thread:   %8.2f ms\n", serial_ms);
+	log("   recalc_whole_map, %2u threads: %8.2f ms (%.1fx)%s\n", pool.concurrency(), parallel_ms,
+	    parallel_ms > 0. ? serial_ms / parallel_ms : 0., identical ? "" : " DIFFERENT NODES");
+
+	egbase.cleanup_objects();
+	return identical;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+	if (!(2 <= argc && argc <= 4)) {
+		log("Usage: %s <data directory> [maps] [runs]\n", argv[0]);
+		return 1;
+	}
+	const size_t nr_maps = argc >= 3 ? std::max(1, atoi(argv[2])) : 3;
+	const int nr_runs = argc == 4 ? std::max(1, atoi(argv[3])) : 5;
+
+	bool all_identical = true;
+	try {
+		initialize_benchmark(argv[1]);
+
+		const std::vector<MapFile> maps = find_maps();
+		for (size_t i = 0; i < maps.size() && i < nr_maps; ++i) {
+			all_identical &= benchmark_map(maps[i], nr_runs);
+		}
+
+		cleanup_benchmark();
+	} catch (const std::exception& e) {
+		log("Exception: %s.\n", e.what());
+		return 1;
+	}
+	return all_identical ? 0 : 1;
+}
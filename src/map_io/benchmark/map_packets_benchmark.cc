@@ -0,0 +1,180 @@
+/*
+ * Copyright (C) 2019 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+// Compares the per-node packets (heights, terrains and resources) of the maps
+// in test/maps, which are still in their old format, with the same packets in
+// the run-length coded columns that the map saver writes now: the size of the
+// files and how long reading them takes. Also checks that the new packets give
+// the same nodes. The new packets are written to a scratch directory in the
+// working directory, which is removed again.
+//
+// Usage: map_io_map_packets_benchmark <data directory> <directory for testing> [runs]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/algorithm/string/predicate.hpp>
+
+#include "base/log.h"
+#include "base/wexception.h"
+#include "benchmark/benchmark_common.h"
+#include "io/fileread.h"
+#include "io/filesystem/layered_filesystem.h"
+#include "logic/editor_game_base.h"
+#include "logic/filesystem_constants.h"
+#include "logic/map.h"
+#include "map_io/map_heights_packet.h"
+#include "map_io/map_loader.h"
+#include "map_io/map_object_loader.h"
+#include "map_io/map_object_saver.h"
+#include "map_io/map_resources_packet.h"
+#include "map_io/map_terrain_packet.h"
+#include "map_io/world_legacy_lookup_table.h"
+
+namespace {
+
+constexpr const char* kScratchDir = "map_packets_benchmark.tmp";
+
+// Returns the fastest of 'nr_runs' runs in ms.
+double fastest_of(const int nr_runs, const std::function<void()>& run) {
+	double fastest = 0.;
+	for (int i = 0; i < nr_runs; ++i) {
+		const auto start = std::chrono::steady_clock::now();
+		run();
+		const double duration = ms_since(start);
+		fastest = i == 0 ? duration : std::min(fastest, duration);
+	}
+	return fastest;
+}
+
+size_t packets_size(FileSystem& fs) {
+	size_t result = 0;
+	for (const char* filename : {"binary/heights", "binary/terrain", "binary/resource"}) {
+		FileRead fr;
+		fr.open(fs, filename);
+		result += fr.get_size();
+	}
+	return result;
+}
+
+// Sets all that the packets store to values that they do not contain, so that
+// comparing the nodes after reading shows whether the packets gave all of it.
+void reset_nodes(Widelands::Map* map) {
+	for (Widelands::MapIndex i = 0; i < map->max_index(); ++i) {
+		const Widelands::FCoords fcoords = map->get_fcoords((*map)[i]);
+		fcoords.field->set_height(MAX_FIELD_HEIGHT);
+		fcoords.field->set_terrains(
+		   Widelands::Field::Terrains{Widelands::INVALID_INDEX, Widelands::INVALID_INDEX});
+		map->clear_resources(fcoords);
+	}
+}
+
+void read_packets(FileSystem& fs,
+                  Widelands::EditorGameBase* egbase,
+                  const WorldLegacyLookupTable& lookup_table) {
+	Widelands::MapObjectLoader mol;
+	Widelands::MapHeightsPacket().read(fs, *egbase, false, mol);
+	Widelands::MapTerrainPacket().read(fs, *egbase, lookup_table);
+	Widelands::MapResourcesPacket().read(fs, *egbase, lookup_table);
+}
+
+void write_packets(FileSystem& fs, Widelands::EditorGameBase* egbase) {
+	Widelands::MapObjectSaver mos;
+	Widelands::MapHeightsPacket().write(fs, *egbase, mos);
+	Widelands::MapTerrainPacket().write(fs, *egbase);
+	Widelands::MapResourcesPacket().write(fs, *egbase);
+}
+
+// Returns false if the new packets gave different nodes.
+bool benchmark_map(const std::string& filename, FileSystem* scratch, const int nr_runs) {
+	Widelands::EditorGameBase egbase(nullptr);
+	egbase.world();
+	egbase.tribes();
+
+	Widelands::Map* map = egbase.mutable_map();
+	std::unique_ptr<Widelands::MapLoader> loader(map->get_correct_loader(filename));
+	if (!loader) {
+		throw wexception("Cannot load %s", filename.c_str());
+	}
+	loader->preload_map(true);
+	loader->load_map_complete(egbase, Widelands::MapLoader::LoadType::kScenario);
+
+	std::unique_ptr<FileSystem> map_fs(g_fs->make_sub_file_system(filename));
+	const std::unique_ptr<WorldLegacyLookupTable> lookup_table(
+	   create_world_legacy_lookup_table(""));
+
+	const double old_read_ms =
+	   fastest_of(nr_runs, [&]() { read_packets(*map_fs, &egbase, *lookup_table); });
+	const std::vector<NodeState> old_nodes = node_states(*map);
+
+	const double write_ms = fastest_of(nr_runs, [&]() { write_packets(*scratch, &egbase); });
+	reset_nodes(map);
+	const double new_read_ms =
+	   fastest_of(nr_runs, [&]() { read_packets(*scratch, &egbase, *lookup_table); });
+	const bool identical = node_states(*map) == old_nodes;
+
+	const size_t old_size = packets_size(*map_fs);
+	const size_t new_size = packets_size(*scratch);
+	log("%s (%dx%d)\n", map->get_name().c_str(), map->get_width(), map->get_height());
+	log("   old packets: %8" PRIuS " bytes, reading %8.2f ms\n", old_size, old_read_ms);
+	log("   new packets: %8" PRIuS " bytes, reading %8.2f ms, writing %8.2f ms%s\n", new_size,
+	    new_read_ms, write_ms, identical ? "" : " DIFFERENT NODES");
+
+	egbase.cleanup_objects();
+	return identical;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+	if (!(3 <= argc && argc <= 4)) {
+		log("Usage: %s <data directory> <directory for testing> [runs]\n", argv[0]);
+		return 1;
+	}
+	const int nr_runs = argc == 4 ? std::max(1, atoi(argv[3])) : 5;
+
+	bool all_identical = true;
+	try {
+		initialize_benchmark(argv[1]);
+		g_fs->add_file_system(&FileSystem::create(argv[2]));
+
+		std::unique_ptr<FileSystem> working_directory(
+		   &FileSystem::create(FileSystem::get_working_directory()));
+		std::unique_ptr<FileSystem> scratch(
+		   working_directory->create_sub_file_system(kScratchDir, FileSystem::DIR));
+		for (const std::string& filename : g_fs->list_directory("test/maps")) {
+			if (boost::algorithm::ends_with(filename, kWidelandsMapExtension)) {
+				all_identical &= benchmark_map(filename, scratch.get(), nr_runs);
+			}
+		}
+		scratch.reset();
+		working_directory->fs_unlink(kScratchDir);
+
+		cleanup_benchmark();
+	} catch (const std::exception& e) {
+		log("Exception: %s.\n", e.what());
+		return 1;
+	}
+	return all_identical ? 0 : 1;
+}
@@ -32,7 +32,7 @@
 #include "economy/warehousesupply.h"
 #include "economy/wares_queue.h"
 #include "economy/workers_queue.h"
-#include "io/fileread.h"
+#include "io/filestreamread.h"
 #include "io/filewrite.h"
 #include "logic/editor_game_base.h"
 #include "logic/game.h"
@@ -76,7 +76,7 @@ void MapBuildingdataPacket::read(FileSystem& fs,
 	if (skip)
 		return;
 
-	FileRead fr;
+	FileStreamRead fr;
 	try {
 		fr.open(fs, "binary/building_data");
 	} catch (...) {
@@ -225,7 +225,7 @@ void MapBuildingdataPacket::read(FileSystem& fs,
 
 void MapBuildingdataPacket::read_partially_finished_building(
    PartiallyFinishedBuilding& pfb,
-   FileRead& fr,
+   StreamRead& fr,
    Game& game,
    MapObjectLoader& mol,
    const TribesLegacyLookupTable& tribes_lookup_table) {
@@ -278,7 +278,7 @@ void MapBuildingdataPacket::read_partially_finished_building(
 
 void MapBuildingdataPacket::read_constructionsite(
    ConstructionSite& constructionsite,
-   FileRead& fr,
+   StreamRead& fr,
    Game& game,
    MapObjectLoader& mol,
    const TribesLegacyLookupTable& tribes_lookup_table) {
@@ -316,7 +316,7 @@ void MapBuildingdataPacket::read_constructionsite(
 }
 
 void MapBuildingdataPacket::read_dismantlesite(DismantleSite& dms,
-                                               FileRead& fr,
+                                               StreamRead& fr,
                                                Game& game,
                                                MapObjectLoader& mol,
                                                const TribesLegacyLookupTable& tribes_lookup_table) {
@@ -336,7 +336,7 @@ void MapBuildingdataPacket::read_dismantlesite(DismantleSite& dms,
 }
 
 void MapBuildingdataPacket::read_warehouse(Warehouse& warehouse,
-                                           FileRead& fr,
+                                           StreamRead& fr,
                                            Game& game,
                                            MapObjectLoader& mol,
                                            const TribesLegacyLookupTable& tribes_lookup_table) {
@@ -494,7 +494,7 @@ void MapBuildingdataPacket::read_warehouse(Warehouse& warehouse,
 }
 
 void MapBuildingdataPacket::read_militarysite(MilitarySite& militarysite,
-                                              FileRead& fr,
+                                              StreamRead& fr,
                                               Game& game,
                                               MapObjectLoader& mol,
                                               const TribesLegacyLookupTable& tribes_lookup_table) {
@@ -584,7 +584,7 @@ void MapBuildingdataPacket::read_militarysite(MilitarySite& militarysite,
 
 void MapBuildingdataPacket::read_productionsite(
    ProductionSite& productionsite,
-   FileRead& fr,
+   StreamRead& fr,
    Game& game,
    MapObjectLoader& mol,
    const TribesLegacyLookupTable& tribes_lookup_table) {
@@ -769,7 +769,7 @@ void MapBuildingdataPacket::read_productionsite(
 }
 
 void MapBuildingdataPacket::read_trainingsite(TrainingSite& trainingsite,
-                                              FileRead& fr,
+                                              StreamRead& fr,
                                               Game& game,
                                               MapObjectLoader& mol,
                                               const TribesLegacyLookupTable& tribes_lookup_table) {
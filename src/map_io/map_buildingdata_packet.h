@@ -23,8 +23,8 @@
 #include "map_io/map_data_packet.h"
 #include "map_io/tribes_legacy_lookup_table.h"
 
-class FileRead;
 class FileWrite;
+class StreamRead;
 
 namespace Widelands {
 
@@ -52,37 +52,37 @@ public:
 
 private:
 	void read_constructionsite(ConstructionSite&,
-	                           FileRead&,
+	                           StreamRead&,
 	                           Game&,
 	                           MapObjectLoader&,
 	                           const TribesLegacyLookupTable& tribes_lookup_table);
 	void read_dismantlesite(DismantleSite&,
-	                        FileRead&,
+	                        StreamRead&,
 	                        Game&,
 	                        MapObjectLoader&,
 	                        const TribesLegacyLookupTable& tribes_lookup_table);
 	void read_partially_finished_building(PartiallyFinishedBuilding&,
-	                                      FileRead&,
+	                                      StreamRead&,
 	                                      Game&,
 	                                      MapObjectLoader&,
 	                                      const TribesLegacyLookupTable& tribes_lookup_table);
 	void read_warehouse(Warehouse&,
-	                    FileRead&,
+	                    StreamRead&,
 	                    Game&,
 	                    MapObjectLoader&,
 	                    const TribesLegacyLookupTable& tribes_lookup_table);
 	void read_militarysite(MilitarySite&,
-	                       FileRead&,
+	                       StreamRead&,
 	                       Game&,
 	                       MapObjectLoader&,
 	                       const TribesLegacyLookupTable& tribes_lookup_table);
 	void read_trainingsite(TrainingSite&,
-	                       FileRead&,
+	                       StreamRead&,
 	                       Game&,
 	                       MapObjectLoader&,
 	                       const TribesLegacyLookupTable& tribes_lookup_table);
 	void read_productionsite(ProductionSite&,
-	                         FileRead&,
+	                         StreamRead&,
 	                         Game&,
 	                         MapObjectLoader&,
 	                         const TribesLegacyLookupTable& tribes_lookup_table);
@@ -26,10 +26,13 @@
 #include "logic/game_data_error.h"
 #include "logic/map.h"
 #include "logic/player.h"
+#include "map_io/node_columns.h"
 
 namespace Widelands {
 
-constexpr uint16_t kCurrentPacketVersion = 2;
+// Since version 3, each player slot has a node column of whether the player has
+// seen the node.
+constexpr uint16_t kCurrentPacketVersion = 3;
 
 void MapExplorationPacket::read(FileSystem& fs,
                                 EditorGameBase& egbase,
@@ -56,6 +59,20 @@ void MapExplorationPacket::read(FileSystem& fs,
 	try {
 		uint16_t const packet_version = fr.unsigned_16();
 		if (packet_version == kCurrentPacketVersion) {
+			for (uint8_t j = 0; j < nr_players; ++j) {
+				const std::vector<uint8_t> seen =
+				   read_node_column(&fr, max_index, NodeColumnCoding::kRunLength);
+				Player* const player = egbase.get_player(j + 1);
+				for (MapIndex i = 0; i < max_index; ++i) {
+					if (player)
+						player->fields_[i].vision = seen[i] ? 1 : 0;
+					else if (seen[i])
+						log("MapExplorationPacket::read: WARNING: Player %u, "
+						    "which does not exist, sees field %u.\n",
+						    j + 1, i);
+				}
+			}
+		} else if (packet_version == 2) {
 			for (MapIndex i = 0; i < max_index; ++i) {
 				uint32_t const data = fr.unsigned_32();
 				for (uint8_t j = 0; j < nr_players; ++j) {
@@ -85,14 +102,14 @@ void MapExplorationPacket::write(FileSystem& fs, EditorGameBase& egbase, MapObje
 	const Map& map = egbase.map();
 	PlayerNumber const nr_players = map.get_nrplayers();
 	MapIndex const max_index = map.max_index();
-	for (MapIndex i = 0; i < max_index; ++i) {
-		uint32_t data = 0;
-		for (uint8_t j = 0; j < nr_players; ++j) {
-			uint8_t const player_index = j + 1;
-			if (Player const* const player = egbase.get_player(player_index))
-				data |= ((0 < player->vision(i)) << j);
+	std::vector<uint8_t> seen(max_index);
+	for (uint8_t j = 0; j < nr_players; ++j) {
+		uint8_t const player_index = j + 1;
+		Player const* const player = egbase.get_player(player_index);
+		for (MapIndex i = 0; i < max_index; ++i) {
+			seen[i] = player && 0 < player->vision(i);
 		}
-		fw.unsigned_32(data);
+		write_node_column(seen, NodeColumnCoding::kRunLength, &fw);
 	}
 
 	fw.write(fs, "binary/exploration");
@@ -25,10 +25,12 @@
 #include "logic/game_data_error.h"
 #include "logic/map.h"
 #include "logic/map_objects/world/world.h"
+#include "map_io/node_columns.h"
 
 namespace Widelands {
 
-constexpr uint16_t kCurrentPacketVersion = 1;
+// Since version 2, the heights are a node column.
+constexpr uint16_t kCurrentPacketVersion = 2;
 
 void MapHeightsPacket::read(FileSystem& fs, EditorGameBase& egbase, bool, MapObjectLoader&) {
 
@@ -37,9 +39,14 @@ void MapHeightsPacket::read(FileSystem& fs, EditorGameBase& egbase, bool, MapObj
 
 	try {
 		uint16_t const packet_version = fr.unsigned_16();
+		const Map& map = egbase.map();
+		MapIndex const max_index = map.max_index();
 		if (packet_version == kCurrentPacketVersion) {
-			const Map& map = egbase.map();
-			MapIndex const max_index = map.max_index();
+			const std::vector<uint8_t> heights =
+			   read_node_column(&fr, max_index, NodeColumnCoding::kDeltaRunLength);
+			for (MapIndex i = 0; i < max_index; ++i)
+				map[i].set_height(heights[i]);
+		} else if (packet_version == 1) {
 			for (MapIndex i = 0; i < max_index; ++i)
 				map[i].set_height(fr.unsigned_8());
 		} else {
@@ -62,8 +69,10 @@ void MapHeightsPacket::write(FileSystem& fs, EditorGameBase& egbase, MapObjectSa
 
 	const Map& map = egbase.map();
 	MapIndex const max_index = map.max_index();
+	std::vector<uint8_t> heights(max_index);
 	for (MapIndex i = 0; i < max_index; ++i)
-		fw.unsigned_8(map[i].get_height());
+		heights[i] = map[i].get_height();
+	write_node_column(heights, NodeColumnCoding::kDeltaRunLength, &fw);
 
 	fw.write(fs, "binary/heights");
 }
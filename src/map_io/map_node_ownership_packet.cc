@@ -25,10 +25,12 @@
 #include "logic/game_data_error.h"
 #include "logic/map.h"
 #include "logic/map_objects/world/world.h"
+#include "map_io/node_columns.h"
 
 namespace Widelands {
 
-constexpr uint16_t kCurrentPacketVersion = 1;
+// Since version 2, the owners are a node column.
+constexpr uint16_t kCurrentPacketVersion = 2;
 
 void MapNodeOwnershipPacket::read(FileSystem& fs,
                                   EditorGameBase& egbase,
@@ -50,9 +52,14 @@ void MapNodeOwnershipPacket::read(FileSystem& fs,
 	}
 	try {
 		uint16_t const packet_version = fr.unsigned_16();
+		const Map& map = egbase.map();
+		MapIndex const max_index = map.max_index();
 		if (packet_version == kCurrentPacketVersion) {
-			const Map& map = egbase.map();
-			MapIndex const max_index = map.max_index();
+			const std::vector<uint8_t> owners =
+			   read_node_column(&fr, max_index, NodeColumnCoding::kRunLength);
+			for (MapIndex i = 0; i < max_index; ++i)
+				map[i].set_owned_by(owners[i]);
+		} else if (packet_version == 1) {
 			for (MapIndex i = 0; i < max_index; ++i)
 				map[i].set_owned_by(fr.unsigned_8());
 		} else {
@@ -71,8 +78,10 @@ void MapNodeOwnershipPacket::write(FileSystem& fs, EditorGameBase& egbase, MapOb
 
 	const Map& map = egbase.map();
 	MapIndex const max_index = map.max_index();
+	std::vector<uint8_t> owners(max_index);
 	for (MapIndex i = 0; i < max_index; ++i)
-		fw.unsigned_8(map[i].get_owned_by());
+		owners[i] = map[i].get_owned_by();
+	write_node_column(owners, NodeColumnCoding::kRunLength, &fw);
 
 	fw.write(fs, "binary/node_ownership");
 }
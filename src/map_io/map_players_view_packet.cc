@@ -30,7 +30,7 @@
 #include "economy/flag.h"
 #include "economy/road.h"
 #include "economy/waterway.h"
-#include "io/fileread.h"
+#include "io/filestreamread.h"
 #include "io/filewrite.h"
 #include "logic/editor_game_base.h"
 #include "logic/field.h"
@@ -167,11 +167,11 @@ namespace {
 	if (!(file).end_of_file())                                                                      \
 		throw GameDataError(                                                                         \
 		   "MapPlayersViewPacket::read: player %u:"                                                  \
-		   "Found %lu trailing bytes in \"%s\"",                                                     \
-		   plnum, static_cast<long unsigned int>((file).get_size() - (file).get_pos()), filename);
+		   "Found trailing bytes in \"%s\" after %lu bytes",                                         \
+		   plnum, filename, static_cast<long unsigned int>((file).get_pos()));
 
 // Errors for the Read* functions.
-struct TribeImmovableNonexistent : public FileRead::DataError {
+struct TribeImmovableNonexistent : public StreamRead::DataError {
 	explicit TribeImmovableNonexistent(const std::string& Name)
 	   : DataError("immovable type \"%s\" does not seem to be a tribe immovable", Name.c_str()),
 	     name(Name) {
@@ -179,13 +179,13 @@ struct TribeImmovableNonexistent : public FileRead::DataError {
 
 	std::string name;
 };
-struct WorldImmovableNonexistent : public FileRead::DataError {
+struct WorldImmovableNonexistent : public StreamRead::DataError {
 	explicit WorldImmovableNonexistent(char const* const Name)
 	   : DataError("world does not define immovable type \"%s\"", Name), name(Name) {
 	}
 	char const* const name;
 };
-struct BuildingNonexistent : public FileRead::DataError {
+struct BuildingNonexistent : public StreamRead::DataError {
 	explicit BuildingNonexistent(char const* const Name)
 	   : DataError("tribes do not define building type \"%s\"", Name), name(Name) {
 	}
@@ -245,7 +245,7 @@ void write_building_type(StreamWrite* wr, const BuildingDescr& building) {
 inline static MapObjectData
 read_unseen_immovable(const EditorGameBase& egbase,
                       uint8_t& immovable_kind,
-                      FileRead& immovables_file,
+                      StreamRead& immovables_file,
                       const TribesLegacyLookupTable& tribes_lookup_table,
                       const WorldLegacyLookupTable& world_lookup_table,
                       uint8_t& version) {
@@ -314,7 +314,7 @@ void MapPlayersViewPacket::read(FileSystem& fs,
 		char unseen_times_filename[FILENAME_SIZE];
 		snprintf(unseen_times_filename, sizeof(unseen_times_filename), UNSEEN_TIMES_FILENAME_TEMPLATE,
 		         plnum, kCurrentPacketVersionUnseenTimes);
-		FileRead unseen_times_file;
+		FileStreamRead unseen_times_file;
 		struct NotFound {};
 
 		if (!unseen_times_file.try_open(fs, unseen_times_filename)) {
@@ -404,7 +404,7 @@ void MapPlayersViewPacket::read(FileSystem& fs,
 		}
 
 		// Verify the vision values
-		FileRead vision_file;
+		FileStreamRead vision_file;
 		bool have_vision = false;
 
 		try {
@@ -442,48 +442,51 @@ void MapPlayersViewPacket::read(FileSystem& fs,
 		}
 
 		// Read the player's knowledge about all fields
-		OPEN_INPUT_FILE_NEW_VERSION(FileRead, node_immovable_kinds_file,
+		OPEN_INPUT_FILE_NEW_VERSION(FileStreamRead, node_immovable_kinds_file,
 		                            node_immovable_kinds_filename, node_immovable_kinds_file_version,
 		                            NODE_IMMOVABLE_KINDS_FILENAME_TEMPLATE,
 		                            kCurrentPacketVersionImmovableKinds)
 
-		OPEN_INPUT_FILE_NEW_VERSION(FileRead, node_immovables_file, node_immovables_filename,
+		OPEN_INPUT_FILE_NEW_VERSION(FileStreamRead, node_immovables_file, node_immovables_filename,
 		                            node_immovables_file_version, NODE_IMMOVABLES_FILENAME_TEMPLATE,
 		                            kCurrentPacketVersionImmovables)
 
-		OPEN_INPUT_FILE_NEW_VERSION(FileRead, roads_file, roads_filename, road_file_version,
+		OPEN_INPUT_FILE_NEW_VERSION(FileStreamRead, roads_file, roads_filename, road_file_version,
 		                            ROADS_FILENAME_TEMPLATE, kCurrentPacketVersionRoads)
 
-		OPEN_INPUT_FILE_NEW_VERSION(FileRead, terrains_file, terrains_filename, terrains_file_version,
-		                            TERRAINS_FILENAME_TEMPLATE, kCurrentPacketVersionTerrains)
+		OPEN_INPUT_FILE_NEW_VERSION(FileStreamRead, terrains_file, terrains_filename,
+		                            terrains_file_version, TERRAINS_FILENAME_TEMPLATE,
+		                            kCurrentPacketVersionTerrains)
 
 		OPEN_INPUT_FILE_NEW_VERSION(
-		   FileRead, triangle_immovable_kinds_file, triangle_immovable_kinds_filename,
+		   FileStreamRead, triangle_immovable_kinds_file, triangle_immovable_kinds_filename,
 		   triangle_immovable_kinds_file_version, TRIANGLE_IMMOVABLE_KINDS_FILENAME_TEMPLATE,
 		   kCurrentPacketVersionImmovableKinds)
 
-		OPEN_INPUT_FILE_NEW_VERSION(FileRead, triangle_immovables_file, triangle_immovables_filename,
-		                            triangle_immovables_file_version,
-		                            TRIANGLE_IMMOVABLES_FILENAME_TEMPLATE,
-		                            kCurrentPacketVersionImmovables)
+		OPEN_INPUT_FILE_NEW_VERSION(
+		   FileStreamRead, triangle_immovables_file, triangle_immovables_filename,
+		   triangle_immovables_file_version, TRIANGLE_IMMOVABLES_FILENAME_TEMPLATE,
+		   kCurrentPacketVersionImmovables)
 
-		OPEN_INPUT_FILE(FileRead, owners_file, owners_filename, OWNERS_FILENAME_TEMPLATE,
+		OPEN_INPUT_FILE(FileStreamRead, owners_file, owners_filename, OWNERS_FILENAME_TEMPLATE,
 		                kCurrentPacketVersionOwners)
 
-		OPEN_INPUT_FILE_NEW_VERSION(FileRead, surveys_file, surveys_filename, surveys_file_version,
-		                            SURVEYS_FILENAME_TEMPLATE, kCurrentPacketVersionSurveys)
+		OPEN_INPUT_FILE_NEW_VERSION(FileStreamRead, surveys_file, surveys_filename,
+		                            surveys_file_version, SURVEYS_FILENAME_TEMPLATE,
+		                            kCurrentPacketVersionSurveys)
 
-		OPEN_INPUT_FILE_NEW_VERSION(FileRead, survey_amounts_file, survey_amounts_filename,
+		OPEN_INPUT_FILE_NEW_VERSION(FileStreamRead, survey_amounts_file, survey_amounts_filename,
 		                            survey_amounts_file_version, SURVEY_AMOUNTS_FILENAME_TEMPLATE,
 		                            kCurrentPacketVersionSurveyAmounts)
 
-		OPEN_INPUT_FILE(FileRead, survey_times_file, survey_times_filename,
+		OPEN_INPUT_FILE(FileStreamRead, survey_times_file, survey_times_filename,
 		                SURVEY_TIMES_FILENAME_TEMPLATE, kCurrentPacketVersionSurveyTimes)
 
-		OPEN_INPUT_FILE_NEW_VERSION(FileRead, border_file, border_filename, border_file_version,
-		                            BORDER_FILENAME_TEMPLATE, kCurrentPacketVersionBorder)
+		OPEN_INPUT_FILE_NEW_VERSION(FileStreamRead, border_file, border_filename,
+		                            border_file_version, BORDER_FILENAME_TEMPLATE,
+		                            kCurrentPacketVersionBorder)
 
-		OPEN_INPUT_FILE_NEW_VERSION_SILENT(FileRead, hidden_file, hidden_filename,
+		OPEN_INPUT_FILE_NEW_VERSION_SILENT(FileStreamRead, hidden_file, hidden_filename,
 		                                   hidden_file_version, HIDDEN_FILENAME_TEMPLATE,
 		                                   kCurrentPacketVersionHidden)
 
@@ -532,7 +535,7 @@ void MapPlayersViewPacket::read(FileSystem& fs,
 					//  his information about the node from file.
 					try {
 						f_player_field.time_node_last_unseen = unseen_times_file.unsigned_32();
-					} catch (const FileRead::FileBoundaryExceeded&) {
+					} catch (const StreamRead::DataError&) {
 						throw GameDataError(
 						   "MapPlayersViewPacket::read: player %u: in "
 						   "\"%s\":%lu: node (%i, %i): unexpected end of file "
@@ -543,7 +546,7 @@ void MapPlayersViewPacket::read(FileSystem& fs,
 
 					try {
 						owner = owners_file.unsigned_8();
-					} catch (const FileRead::FileBoundaryExceeded&) {
+					} catch (const StreamRead::DataError&) {
 						throw GameDataError(
 						   "MapPlayersViewPacket::read: player %u: in "
 						   "\"%s\":%lu: node (%i, %i): unexpected end of file "
@@ -740,7 +743,7 @@ void MapPlayersViewPacket::read(FileSystem& fs,
 							f_player_field
 							   .time_triangle_last_surveyed[static_cast<int>(TriangleIndex::D)] =
 							   survey_times_file.unsigned_32();
-						} catch (const FileRead::FileBoundaryExceeded&) {
+						} catch (const StreamRead::DataError&) {
 							throw GameDataError(
 							   "MapPlayersViewPacket::read: player %u: in "
 							   "\"%s\":%lu: node (%i, %i) t = D: unexpected end of "
@@ -749,7 +752,7 @@ void MapPlayersViewPacket::read(FileSystem& fs,
 							   static_cast<long unsigned int>(survey_times_file.get_pos() - 4), f.x, f.y);
 						}
 					}
-				} catch (const FileRead::FileBoundaryExceeded&) {
+				} catch (const StreamRead::DataError&) {
 					throw GameDataError("MapPlayersViewPacket::read: player %u: in \"%s\": "
 					                    "node (%i, %i) t = D: unexpected end of file while reading "
 					                    "survey bit",
@@ -775,7 +778,7 @@ void MapPlayersViewPacket::read(FileSystem& fs,
 							f_player_field
 							   .time_triangle_last_surveyed[static_cast<int>(TriangleIndex::R)] =
 							   survey_times_file.unsigned_32();
-						} catch (const FileRead::FileBoundaryExceeded&) {
+						} catch (const StreamRead::DataError&) {
 							throw GameDataError(
 							   "MapPlayersViewPacket::read: player %u: in "
 							   "\"%s\":%lu: node (%i, %i) t = R: unexpected end of "
@@ -784,7 +787,7 @@ void MapPlayersViewPacket::read(FileSystem& fs,
 							   static_cast<long unsigned int>(survey_times_file.get_pos() - 4), f.x, f.y);
 						}
 					}
-				} catch (const FileRead::FileBoundaryExceeded&) {
+				} catch (const StreamRead::DataError&) {
 					throw GameDataError("MapPlayersViewPacket::read: player %u: in \"%s\": "
 					                    "node (%i, %i) t = R: unexpected end of file while reading "
 					                    "survey bit",
@@ -27,11 +27,14 @@
 #include "logic/map.h"
 #include "logic/map_objects/world/resource_description.h"
 #include "logic/map_objects/world/world.h"
+#include "map_io/node_columns.h"
 #include "map_io/world_legacy_lookup_table.h"
 
 namespace Widelands {
 
-constexpr uint16_t kCurrentPacketVersion = 1;
+// Since version 2, the resources, their amounts and their starting amounts are
+// three node columns.
+constexpr uint16_t kCurrentPacketVersion = 2;
 
 void MapResourcesPacket::read(FileSystem& fs,
                               EditorGameBase& egbase,
@@ -44,7 +47,7 @@ void MapResourcesPacket::read(FileSystem& fs,
 
 	try {
 		const uint16_t packet_version = fr.unsigned_16();
-		if (packet_version == kCurrentPacketVersion) {
+		if (packet_version == kCurrentPacketVersion || packet_version == 1) {
 			int32_t const nr_res = fr.unsigned_16();
 			if (world.get_nr_resources() < nr_res)
 				log("WARNING: Number of resources in map (%i) is bigger than in world "
@@ -63,14 +66,29 @@ void MapResourcesPacket::read(FileSystem& fs,
 				smap[id] = res;
 			}
 
-			for (uint16_t y = 0; y < map->get_height(); ++y) {
-				for (uint16_t x = 0; x < map->get_width(); ++x) {
-					DescriptionIndex const id = fr.unsigned_8();
-					ResourceAmount const amount = fr.unsigned_8();
-					ResourceAmount const start_amount = fr.unsigned_8();
-					const auto fcoords = map->get_fcoords(Coords(x, y));
-					map->initialize_resources(fcoords, smap[id], start_amount);
-					map->set_resources(fcoords, amount);
+			if (packet_version == kCurrentPacketVersion) {
+				MapIndex const max_index = map->max_index();
+				const std::vector<uint8_t> ids =
+				   read_node_column(&fr, max_index, NodeColumnCoding::kRunLength);
+				const std::vector<uint8_t> amounts =
+				   read_node_column(&fr, max_index, NodeColumnCoding::kRunLength);
+				const std::vector<uint8_t> start_amounts =
+				   read_node_column(&fr, max_index, NodeColumnCoding::kRunLength);
+				for (MapIndex i = 0; i < max_index; ++i) {
+					const auto fcoords = map->get_fcoords((*map)[i]);
+					map->initialize_resources(fcoords, smap[ids[i]], start_amounts[i]);
+					map->set_resources(fcoords, amounts[i]);
+				}
+			} else {
+				for (uint16_t y = 0; y < map->get_height(); ++y) {
+					for (uint16_t x = 0; x < map->get_width(); ++x) {
+						DescriptionIndex const id = fr.unsigned_8();
+						ResourceAmount const amount = fr.unsigned_8();
+						ResourceAmount const start_amount = fr.unsigned_8();
+						const auto fcoords = map->get_fcoords(Coords(x, y));
+						map->initialize_resources(fcoords, smap[id], start_amount);
+						map->set_resources(fcoords, amount);
+					}
 				}
 			}
 		} else {
@@ -109,20 +127,23 @@ void MapResourcesPacket::write(FileSystem& fs, EditorGameBase& egbase) {
 		fw.c_string(res.name().c_str());
 	}
 
-	//  Now, all resouces as uint8_ts in order
+	//  Now, all resources as node columns of uint8_ts
 	//  - resource id
 	//  - amount
-	for (uint16_t y = 0; y < map.get_height(); ++y) {
-		for (uint16_t x = 0; x < map.get_width(); ++x) {
-			const Field& f = map[Coords(x, y)];
-			DescriptionIndex res = f.get_resources();
-			ResourceAmount const amount = f.get_resources_amount();
-			ResourceAmount const start_amount = f.get_initial_res_amount();
-			fw.unsigned_8(res);
-			fw.unsigned_8(amount);
-			fw.unsigned_8(start_amount);
-		}
+	//  - starting amount
+	MapIndex const max_index = map.max_index();
+	std::vector<uint8_t> ids(max_index);
+	std::vector<uint8_t> amounts(max_index);
+	std::vector<uint8_t> start_amounts(max_index);
+	for (MapIndex i = 0; i < max_index; ++i) {
+		const Field& f = map[i];
+		ids[i] = f.get_resources();
+		amounts[i] = f.get_resources_amount();
+		start_amounts[i] = f.get_initial_res_amount();
 	}
+	write_node_column(ids, NodeColumnCoding::kRunLength, &fw);
+	write_node_column(amounts, NodeColumnCoding::kRunLength, &fw);
+	write_node_column(start_amounts, NodeColumnCoding::kRunLength, &fw);
 
 	fw.write(fs, "binary/resource");
 }
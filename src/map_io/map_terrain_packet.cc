@@ -20,6 +20,7 @@
 #include "map_io/map_terrain_packet.h"
 
 #include <map>
+#include <vector>
 
 #include "base/log.h"
 #include "io/fileread.h"
@@ -29,11 +30,13 @@
 #include "logic/map.h"
 #include "logic/map_objects/world/terrain_description.h"
 #include "logic/map_objects/world/world.h"
+#include "map_io/node_columns.h"
 #include "map_io/world_legacy_lookup_table.h"
 
 namespace Widelands {
 
-constexpr uint16_t kCurrentPacketVersion = 1;
+// Since version 2, the terrains of the nodes are two node columns.
+constexpr uint16_t kCurrentPacketVersion = 2;
 
 void MapTerrainPacket::read(FileSystem& fs,
                             EditorGameBase& egbase,
@@ -46,7 +49,7 @@ void MapTerrainPacket::read(FileSystem& fs,
 
 	try {
 		uint16_t const packet_version = fr.unsigned_16();
-		if (packet_version == kCurrentPacketVersion) {
+		if (packet_version == kCurrentPacketVersion || packet_version == 1) {
 			uint16_t const nr_terrains = fr.unsigned_16();
 
 			using TerrainIdMap = std::map<const uint16_t, DescriptionIndex>;
@@ -67,10 +70,29 @@ void MapTerrainPacket::read(FileSystem& fs,
 			}
 
 			MapIndex const max_index = map.max_index();
-			for (MapIndex i = 0; i < max_index; ++i) {
-				Field& f = map[i];
-				f.set_terrain_r(smap[fr.unsigned_8()]);
-				f.set_terrain_d(smap[fr.unsigned_8()]);
+			if (packet_version == kCurrentPacketVersion) {
+				// Unknown ids become the first terrain, like with 'smap' below.
+				std::vector<DescriptionIndex> terrains(256, 0);
+				for (const auto& id : smap) {
+					if (id.first < terrains.size()) {
+						terrains[id.first] = id.second;
+					}
+				}
+				const std::vector<uint8_t> terrains_r =
+				   read_node_column(&fr, max_index, NodeColumnCoding::kRunLength);
+				const std::vector<uint8_t> terrains_d =
+				   read_node_column(&fr, max_index, NodeColumnCoding::kRunLength);
+				for (MapIndex i = 0; i < max_index; ++i) {
+					Field& f = map[i];
+					f.set_terrain_r(terrains[terrains_r[i]]);
+					f.set_terrain_d(terrains[terrains_d[i]]);
+				}
+			} else {
+				for (MapIndex i = 0; i < max_index; ++i) {
+					Field& f = map[i];
+					f.set_terrain_r(smap[fr.unsigned_8()]);
+					f.set_terrain_d(smap[fr.unsigned_8()]);
+				}
 			}
 		} else {
 			throw UnhandledVersionError("MapTerrainPacket", packet_version, kCurrentPacketVersion);
@@ -86,27 +108,29 @@ void MapTerrainPacket::write(FileSystem& fs, EditorGameBase& egbase) {
 
 	fw.unsigned_16(kCurrentPacketVersion);
 
-	//  This is a bit more complicated saved so that the order of loading of the
-	//  terrains at run time does not matter. This is slow like hell.
+	//  The names of the terrains are saved with their ids, so that the order of
+	//  loading of the terrains at run time does not matter. The ids are the
+	//  indices of the terrains in the world.
 	const Map& map = egbase.map();
 	const World& world = egbase.world();
 	DescriptionIndex const nr_terrains = world.terrains().size();
 	fw.unsigned_16(nr_terrains);
 
-	std::map<const char* const, DescriptionIndex> smap;
 	for (DescriptionIndex i = 0; i < nr_terrains; ++i) {
-		const char* const name = world.terrain_descr(i).name().c_str();
-		smap[name] = i;
 		fw.unsigned_16(i);
-		fw.c_string(name);
+		fw.c_string(world.terrain_descr(i).name().c_str());
 	}
 
 	MapIndex const max_index = map.max_index();
+	std::vector<uint8_t> terrains_r(max_index);
+	std::vector<uint8_t> terrains_d(max_index);
 	for (MapIndex i = 0; i < max_index; ++i) {
-		Field& f = map[i];
-		fw.unsigned_8(smap[world.terrain_descr(f.terrain_r()).name().c_str()]);
-		fw.unsigned_8(smap[world.terrain_descr(f.terrain_d()).name().c_str()]);
+		const Field& f = map[i];
+		terrains_r[i] = f.terrain_r();
+		terrains_d[i] = f.terrain_d();
 	}
+	write_node_column(terrains_r, NodeColumnCoding::kRunLength, &fw);
+	write_node_column(terrains_d, NodeColumnCoding::kRunLength, &fw);
 
 	fw.write(fs, "binary/terrain");
 }
@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2019 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include "map_io/node_columns.h"
+
+#include "base/wexception.h"
+#include "io/fileread.h"
+#include "io/filewrite.h"
+
+namespace Widelands {
+
+namespace {
+
+// Shorter runs take less space as part of a literal block.
+constexpr size_t kMinRunLength = 3;
+
+// Like StreamWrite::unsigned_varint.
+void append_varint(uint32_t x, std::vector<uint8_t>* coded) {
+	while (x >= 0x80) {
+		coded->push_back(static_cast<uint8_t>(x | 0x80));
+		x >>= 7;
+	}
+	coded->push_back(static_cast<uint8_t>(x));
+}
+
+uint32_t read_varint(const uint8_t** pos, const uint8_t* const end) {
+	uint32_t x = 0;
+	for (uint8_t shift = 0; shift < 35; shift += 7) {
+		if (*pos == end) {
+			throw wexception("node column ends in the middle of a block header");
+		}
+		const uint8_t byte = *(*pos)++;
+		x |= static_cast<uint32_t>(byte & 0x7f) << shift;
+		if (!(byte & 0x80)) {
+			return x;
+		}
+	}
+	throw wexception("node column has a block header that is longer than 5 bytes");
+}
+
+}  // namespace
+
+void write_node_column(const std::vector<uint8_t>& column,
+                       const NodeColumnCoding coding,
+                       FileWrite* fw) {
+	std::vector<uint8_t> values(column);
+	if (coding == NodeColumnCoding::kDeltaRunLength) {
+		for (size_t i = values.size(); i > 1; --i) {
+			values[i - 1] -= values[i - 2];
+		}
+	}
+
+	std::vector<uint8_t> coded;
+	coded.reserve(values.size() / 4 + 16);
+	const size_t nr_values = values.size();
+	size_t literals_start = 0;
+	const auto add_literals = [&values, &coded, &literals_start](const size_t literals_end) {
+		if (literals_end > literals_start) {
+			append_varint((literals_end - literals_start) << 1, &coded);
+			coded.insert(coded.end(), values.begin() + literals_start, values.begin() + literals_end);
+		}
+	};
+	for (size_t i = 0; i < nr_values;) {
+		size_t run_end = i + 1;
+		while (run_end < nr_values && values[run_end] == values[i]) {
+			++run_end;
+		}
+		if (run_end - i >= kMinRunLength) {
+			add_literals(i);
+			append_varint(((run_end - i) << 1) | 1, &coded);
+			coded.push_back(values[i]);
+			literals_start = run_end;
+		}
+		i = run_end;
+	}
+	add_literals(nr_values);
+
+	fw->unsigned_32(coded.size());
+	fw->data(coded.data(), coded.size());
+}
+
+std::vector<uint8_t>
+read_node_column(FileRead* fr, const uint32_t nr_nodes, const NodeColumnCoding coding) {
+	const uint32_t size = fr->unsigned_32();
+	const uint8_t* pos = reinterpret_cast<const uint8_t*>(fr->data(size));
+	const uint8_t* const end = pos + size;
+
+	std::vector<uint8_t> column;
+	column.reserve(nr_nodes);
+	while (pos < end) {
+		const uint32_t header = read_varint(&pos, end);
+		const uint32_t count = header >> 1;
+		if (count > nr_nodes - column.size()) {
+			throw wexception("node column has more than %u values", nr_nodes);
+		}
+		if (header & 1) {
+			if (pos == end) {
+				throw wexception("node column ends before the value of a run");
+			}
+			column.insert(column.end(), count, *pos++);
+		} else {
+			if (count > static_cast<size_t>(end - pos)) {
+				throw wexception("node column ends in the middle of a block");
+			}
+			column.insert(column.end(), pos, pos + count);
+			pos += count;
+		}
+	}
+	if (column.size() != nr_nodes) {
+		throw wexception(
+		   "node column has %u values instead of %u", static_cast<unsigned>(column.size()), nr_nodes);
+	}
+
+	if (coding == NodeColumnCoding::kDeltaRunLength) {
+		for (size_t i = 1; i < column.size(); ++i) {
+			column[i] += column[i - 1];
+		}
+	}
+	return column;
+}
+
+}  // namespace Widelands
@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2019 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#ifndef WL_MAP_IO_NODE_COLUMNS_H
+#define WL_MAP_IO_NODE_COLUMNS_H
+
+#include <vector>
+
+#include <stdint.h>
+
+class FileRead;
+class FileWrite;
+
+namespace Widelands {
+
+/**
+ * The packets that store something for every node of the map keep each kind
+ * of value (height, terrain, owner, ...) in a column of one byte per node, in
+ * the order of the map indices. Most columns are the same for long stretches
+ * of nodes, so they are run-length coded:
+ *
+ * The coded column is a sequence of blocks that each start with a varint. If
+ * its lowest bit is set, the block is a run of (varint >> 1) copies of the byte
+ * that follows, else (varint >> 1) bytes follow literally. The whole coded
+ * column is preceded by its size in bytes and is written and read in one go.
+ */
+enum class NodeColumnCoding {
+	kRunLength,
+	// Codes the differences between neighbouring nodes, so that slopes become
+	// runs too. For values that change gradually, like heights.
+	kDeltaRunLength
+};
+
+void write_node_column(const std::vector<uint8_t>& column, NodeColumnCoding coding, FileWrite* fw);
+
+// Reads a column of 'nr_nodes' values that 'write_node_column' wrote with the
+// same 'coding'. Throws if the column is broken.
+std::vector<uint8_t> read_node_column(FileRead* fr, uint32_t nr_nodes, NodeColumnCoding coding);
+
+}  // namespace Widelands
+
+#endif  // end of include guard: WL_MAP_IO_NODE_COLUMNS_H
@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2019 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include "base/macros.h"
+#include "base/wexception.h"
+#include "io/fileread.h"
+#include "io/filesystem/filesystem.h"
+#include "io/filewrite.h"
+#include "map_io/node_columns.h"
+
+// Triggered by BOOST_AUTO_TEST_CASE
+CLANG_DIAG_OFF("-Wdisabled-macro-expansion")
+CLANG_DIAG_OFF("-Wused-but-marked-unused")
+
+using Widelands::NodeColumnCoding;
+
+namespace {
+
+constexpr const char* kScratchFile = "test_node_columns.tmp";
+
+// Reads a column of 'nr_nodes' values from the bytes that 'fw' got.
+std::vector<uint8_t> read_back(FileWrite* fw, const uint32_t nr_nodes, NodeColumnCoding coding) {
+	std::unique_ptr<FileSystem> fs(&FileSystem::create(FileSystem::get_working_directory()));
+	fw->write(*fs, kScratchFile);
+	FileRead fr;
+	fr.open(*fs, kScratchFile);
+	fs->fs_unlink(kScratchFile);
+	return Widelands::read_node_column(&fr, nr_nodes, coding);
+}
+
+std::vector<uint8_t> round_trip(const std::vector<uint8_t>& column, NodeColumnCoding coding) {
+	FileWrite fw;
+	Widelands::write_node_column(column, coding, &fw);
+	return read_back(&fw, column.size(), coding);
+}
+
+// Reads a column that is coded as 'coded', with the size in front.
+std::vector<uint8_t> read_coded(const std::vector<uint8_t>& coded, const uint32_t nr_nodes) {
+	FileWrite fw;
+	fw.unsigned_32(coded.size());
+	fw.data(coded.data(), coded.size());
+	return read_back(&fw, nr_nodes, NodeColumnCoding::kRunLength);
+}
+
+// Runs that are too short to be coded as runs, long runs and literals.
+std::vector<uint8_t> mixed_column() {
+	std::vector<uint8_t> column;
+	for (uint32_t i = 0; i < 1000; ++i) {
+		column.push_back(i % 7 == 0 ? static_cast<uint8_t>(i) : 42);
+	}
+	column.insert(column.end(), 300, 0);
+	column.push_back(1);
+	column.push_back(1);
+	for (uint32_t i = 0; i < 200; ++i) {
+		column.push_back(static_cast<uint8_t>(i * 13));
+	}
+	return column;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(node_columns)
+
+BOOST_AUTO_TEST_CASE(round_trip_run_length) {
+	const std::vector<uint8_t> column = mixed_column();
+	BOOST_CHECK(round_trip(column, NodeColumnCoding::kRunLength) == column);
+}
+
+BOOST_AUTO_TEST_CASE(round_trip_delta_run_length) {
+	const std::vector<uint8_t> column = mixed_column();
+	BOOST_CHECK(round_trip(column, NodeColumnCoding::kDeltaRunLength) == column);
+
+	std::vector<uint8_t> slope;
+	for (uint32_t i = 0; i < 500; ++i) {
+		slope.push_back(static_cast<uint8_t>(i / 4));
+	}
+	BOOST_CHECK(round_trip(slope, NodeColumnCoding::kDeltaRunLength) == slope);
+}
+
+BOOST_AUTO_TEST_CASE(delta_wraps_around) {
+	// The differences between these do not fit into a byte without wrapping.
+	const std::vector<uint8_t> column{0, 255, 0, 60, 0, 255, 255, 255, 1, 254, 0};
+	BOOST_CHECK(round_trip(column, NodeColumnCoding::kDeltaRunLength) == column);
+}
+
+BOOST_AUTO_TEST_CASE(empty_and_single_value_columns) {
+	for (NodeColumnCoding coding :
+	     {NodeColumnCoding::kRunLength, NodeColumnCoding::kDeltaRunLength}) {
+		BOOST_CHECK(round_trip(std::vector<uint8_t>(), coding).empty());
+		const std::vector<uint8_t> single{17};
+		BOOST_CHECK(round_trip(single, coding) == single);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(truncated_columns_throw) {
+	// A run of 4 values (header 4 << 1 | 1) without the value.
+	BOOST_CHECK_THROW(read_coded({9}, 4), WException);
+	// 3 literal values (header 3 << 1) of which only 2 are there.
+	BOOST_CHECK_THROW(read_coded({6, 1, 2}, 3), WException);
+	// A block header that is cut off after its first byte.
+	BOOST_CHECK_THROW(read_coded({0x81}, 200), WException);
+	// A block header that does not end within 5 bytes.
+	BOOST_CHECK_THROW(read_coded({0x81, 0x80, 0x80, 0x80, 0x80, 0x00}, 200), WException);
+	// Fewer values than nodes.
+	BOOST_CHECK_THROW(read_coded({9, 5}, 5), WException);
+	// The size in front promises more bytes than the file has.
+	FileWrite fw;
+	fw.unsigned_32(10);
+	fw.unsigned_8(9);
+	BOOST_CHECK_THROW(
+	   read_back(&fw, 4, NodeColumnCoding::kRunLength), FileRead::FileBoundaryExceeded);
+}
+
+BOOST_AUTO_TEST_CASE(oversized_columns_throw) {
+	// A run of 5 values for 4 nodes.
+	BOOST_CHECK_THROW(read_coded({11, 5}, 4), WException);
+	// 2 literal values after a run that already filled the 4 nodes.
+	BOOST_CHECK_THROW(read_coded({9, 5, 4, 1, 2}, 4), WException);
+	// A run that is longer than any map.
+	BOOST_CHECK_THROW(read_coded({0xff, 0xff, 0xff, 0xff, 0x0f, 5}, 4), WException);
+	// One column longer than the map, written for a bigger map.
+	FileWrite fw;
+	Widelands::write_node_column(std::vector<uint8_t>(5, 3), NodeColumnCoding::kRunLength, &fw);
+	BOOST_CHECK_THROW(read_back(&fw, 4, NodeColumnCoding::kRunLength), WException);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2019 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+// Measures how many packets per second a BufferedConnection pushes through a
+// local socket pair.
+//
+// Usage: network_bufferedconnection_benchmark [number of packets] [packet size]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+
+#include "base/log.h"
+#include "network/bufferedconnection.h"
+#include "network/network.h"
+
+int main(int argc, char** argv) {
+	if (argc > 3) {
+		log("Usage: %s [number of packets] [packet size]\n", argv[0]);
+		return 1;
+	}
+	const size_t nr_packets = argc >= 2 ? std::max(1, atoi(argv[1])) : 200000;
+	// The 2 bytes of the packet length are included in the size
+	const size_t packet_size = argc >= 3 ? std::max(3, std::min(atoi(argv[2]), 0xffff)) : 24;
+
+#if BOOST_VERSION >= 106600
+	boost::asio::io_service io_service;
+	boost::asio::ip::tcp::acceptor acceptor(
+	   io_service, boost::asio::ip::tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0));
+
+	NetAddress address;
+	address.ip = boost::asio::ip::address_v4::loopback();
+	address.port = acceptor.local_endpoint().port();
+	std::unique_ptr<BufferedConnection> sender = BufferedConnection::connect(address);
+	std::unique_ptr<BufferedConnection> receiver = BufferedConnection::accept(acceptor);
+	if (!sender || !receiver) {
+		log("Could not establish a local connection.\n");
+		return 1;
+	}
+
+	SendPacket packet;
+	for (size_t i = 2; i < packet_size; ++i) {
+		packet.unsigned_8(i & 0xff);
+	}
+
+	const auto start = std::chrono::steady_clock::now();
+	std::thread producer([&sender, &packet, nr_packets]() {
+		for (size_t i = 0; i < nr_packets; ++i) {
+			sender->send(NetPriority::kNormal, packet);
+		}
+	});
+
+	size_t received = 0;
+	RecvPacket recv_packet;
+	while (received < nr_packets) {
+		if (BufferedConnection::Peeker(receiver.get()).recvpacket()) {
+			receiver->receive(&recv_packet);
+			++received;
+		} else if (!receiver->is_connected()) {
+			break;
+		} else {
+			std::this_thread::yield();
+		}
+	}
+	producer.join();
+	const double seconds =
+	   std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	if (received != nr_packets) {
+		log("Connection closed after %" PRIuS " of %" PRIuS " packets.\n", received, nr_packets);
+		return 1;
+	}
+	log("%" PRIuS " packets of %" PRIuS " bytes in %.3f s: %.0f packets/s, %.2f MiB/s\n",
+	    nr_packets, packet_size, seconds, nr_packets / seconds,
+	    nr_packets * packet_size / seconds / (1024. * 1024.));
+	return 0;
+#else
+	log("This benchmark needs boost 1.66 or newer.\n");
+	return 1;
+#endif
+}
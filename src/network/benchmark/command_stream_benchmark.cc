@@ -0,0 +1,210 @@
+/*
+ * Copyright (C) 2019 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+// Sends the player command stream of a replay over a loopback TCP connection,
+// once with one packet per command and once batched per network tick, and
+// reports how many bytes and packets each variant needs per minute of game time.
+//
+// Usage: network_command_stream_benchmark <replay.wrpl> [tick length in ms]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <boost/asio.hpp>
+
+#include "base/log.h"
+#include "base/wexception.h"
+#include "io/filesystem/filesystem.h"
+#include "io/streamread.h"
+#include "logic/playercommand.h"
+#include "network/network.h"
+#include "network/network_protocol.h"
+#include "network/player_command_batch.h"
+#include "random/random.h"
+
+namespace {
+
+// Must match the file format in logic/replay.cc
+constexpr uint32_t kReplayMagic = 0x2E21A101;
+constexpr uint8_t kReplayPacketVersion = 3;
+enum { pkt_end = 2, pkt_playercommand = 3, pkt_syncreport = 4 };
+
+struct RecordedCommand {
+	uint32_t issued;
+	std::unique_ptr<Widelands::PlayerCommand> command;
+};
+
+std::vector<RecordedCommand> read_command_stream(const std::string& path) {
+	std::unique_ptr<FileSystem> fs(&FileSystem::create(FileSystem::fs_dirname(path)));
+	std::unique_ptr<StreamRead> cmdlog(fs->open_stream_read(FileSystem::fs_filename(path.c_str())));
+
+	if (cmdlog->unsigned_32() != kReplayMagic) {
+		throw wexception("%s apparently not a valid replay file", path.c_str());
+	}
+	const uint8_t packet_version = cmdlog->unsigned_8();
+	if (packet_version != kReplayPacketVersion) {
+		throw wexception("Unhandled replay packet version %u", packet_version);
+	}
+	RNG rng;
+	rng.read_state(*cmdlog);
+
+	std::vector<RecordedCommand> result;
+	for (;;) {
+		switch (cmdlog->unsigned_8()) {
+		case pkt_playercommand: {
+			RecordedCommand recorded;
+			recorded.issued = cmdlog->unsigned_32();
+			const uint32_t duetime = cmdlog->unsigned_32();
+			cmdlog->unsigned_32();  // cmdserial
+			recorded.command.reset(Widelands::PlayerCommand::deserialize(*cmdlog));
+			recorded.command->set_duetime(duetime);
+			result.push_back(std::move(recorded));
+		} break;
+		case pkt_syncreport: {
+			uint8_t hash[16];
+			cmdlog->unsigned_32();
+			cmdlog->data(hash, sizeof(hash));
+		} break;
+		case pkt_end:
+			return result;
+		default:
+			throw wexception("Unknown replay packet");
+		}
+	}
+}
+
+/// One packet per command, as sent by GameHost::send_player_command() before batching.
+std::vector<std::vector<uint8_t>> encode_single(const std::vector<RecordedCommand>& commands) {
+	std::vector<std::vector<uint8_t>> packets;
+	for (const RecordedCommand& recorded : commands) {
+		SendPacket packet;
+		packet.unsigned_8(NETCMD_PLAYERCOMMAND);
+		packet.signed_32(recorded.command->duetime());
+		recorded.command->serialize(packet);
+		packets.emplace_back(packet.get_data(), packet.get_data() + packet.get_size());
+	}
+	return packets;
+}
+
+/// One packet per network tick in which commands have been issued.
+std::vector<std::vector<uint8_t>> encode_batched(const std::vector<RecordedCommand>& commands,
+                                                 uint32_t tick_length) {
+	std::vector<std::vector<uint8_t>> packets;
+	PlayerCommandBatch batch;
+	auto flush = [&packets, &batch]() {
+		if (!batch.empty()) {
+			SendPacket packet;
+			batch.write(packet);
+			packets.emplace_back(packet.get_data(), packet.get_data() + packet.get_size());
+		}
+	};
+	uint32_t current_tick = 0;
+	for (const RecordedCommand& recorded : commands) {
+		const uint32_t tick = recorded.issued / tick_length;
+		if (tick != current_tick || batch.size() >= kMaxPlayerCommandBatchSize) {
+			flush();
+			current_tick = tick;
+		}
+		batch.add(*recorded.command);
+	}
+	flush();
+	return packets;
+}
+
+/// Writes every packet with its own call into a loopback connection and
+/// returns the number of bytes that arrived at the other end.
+size_t send_over_loopback(const std::vector<std::vector<uint8_t>>& packets,
+                          double* elapsed_seconds) {
+	boost::asio::io_service io_service;
+	boost::asio::ip::tcp::acceptor acceptor(
+	   io_service,
+	   boost::asio::ip::tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0));
+	boost::asio::ip::tcp::socket sender(io_service);
+	boost::asio::ip::tcp::socket receiver(io_service);
+	sender.connect(acceptor.local_endpoint());
+	acceptor.accept(receiver);
+	sender.set_option(boost::asio::ip::tcp::no_delay(true));
+
+	size_t received = 0;
+	std::thread reader([&receiver, &received]() {
+		uint8_t buffer[kNetworkBufferSize];
+		boost::system::error_code ec;
+		for (;;) {
+			const size_t length = receiver.read_some(boost::asio::buffer(buffer), ec);
+			if (ec) {
+				break;
+			}
+			received += length;
+		}
+	});
+
+	const auto start = std::chrono::steady_clock::now();
+	for (const std::vector<uint8_t>& packet : packets) {
+		boost::asio::write(sender, boost::asio::buffer(packet));
+	}
+	sender.shutdown(boost::asio::ip::tcp::socket::shutdown_send);
+	reader.join();
+	*elapsed_seconds =
+	   std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	return received;
+}
+
+void report(const char* name,
+            const std::vector<std::vector<uint8_t>>& packets,
+            double game_minutes) {
+	double seconds = 0.;
+	const size_t bytes = send_over_loopback(packets, &seconds);
+	log("%-8s %8" PRIuS " packets %10" PRIuS " bytes | %10.1f packets/min %12.1f bytes/min | "
+	    "%.3f ms wall time\n",
+	    name, packets.size(), bytes, packets.size() / game_minutes, bytes / game_minutes,
+	    seconds * 1000.);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+	if (!(2 <= argc && argc <= 3)) {
+		log("Usage: %s <replay.wrpl> [tick length in ms]\n", argv[0]);
+		return 1;
+	}
+	const uint32_t tick_length = argc == 3 ? std::max(1, atoi(argv[2])) : 1000 / 30;
+
+	try {
+		const std::vector<RecordedCommand> commands = read_command_stream(argv[1]);
+		if (commands.empty()) {
+			log("The replay does not contain any player commands.\n");
+			return 1;
+		}
+		const double game_minutes =
+		   std::max(1U, commands.back().issued - commands.front().issued) / 60000.;
+
+		log("%" PRIuS " player commands over %.1f minutes of game time, tick length %u ms\n",
+		    commands.size(), game_minutes, tick_length);
+		report("single", encode_single(commands), game_minutes);
+		report("batched", encode_batched(commands, tick_length), game_minutes);
+	} catch (const std::exception& e) {
+		log("Exception: %s.\n", e.what());
+		return 1;
+	}
+	return 0;
+}
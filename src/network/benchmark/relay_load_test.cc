@@ -0,0 +1,651 @@
+/*
+ * Copyright (C) 2019 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+// Load test for hosting a game over the relay with many clients.
+//
+// Starts a local stand-in for the relay server, a host that talks the in-game
+// protocol through a NetHostProxy and a number of clients that connect with
+// NetClientProxy. The clients send player commands and chat messages at
+// roughly the rate of human players. Reports the latency until a command is
+// echoed back by the host, the CPU time used by the threads of the host (its
+// own and its networking thread, without the relay and the clients) and the
+// traffic through the relay. The CPU time is only measured on Linux.
+//
+// Usage: network_relay_load_test [players] [observers] [duration in s]
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <dirent.h>
+#include <unistd.h>
+#endif
+
+#include "base/log.h"
+#include "logic/playercommand.h"
+#include "logic/widelands_geometry.h"
+#include "network/bufferedconnection.h"
+#include "network/netclientproxy.h"
+#include "network/nethostproxy.h"
+#include "network/network.h"
+#include "network/network_protocol.h"
+#include "network/player_command_batch.h"
+#include "network/relay_protocol.h"
+
+#if BOOST_VERSION >= 106600
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const std::string kGameName = "loadtest";
+const std::string kHostPassword = "host";
+
+/// Relay connection ids are a single byte and 0 terminates id lists.
+constexpr size_t kMaxClients = 254;
+
+/// The host runs its network code once per frame.
+constexpr std::chrono::milliseconds kHostFrameLength(1000 / 30);
+
+/// Average time between two player commands or chat messages of one player.
+constexpr std::chrono::milliseconds kCommandInterval(2000);
+constexpr std::chrono::milliseconds kChatInterval(20000);
+
+/// The ids of the threads of this process. Empty if not supported.
+std::set<std::string> thread_ids() {
+	std::set<std::string> result;
+#ifdef __linux__
+	if (DIR* dir = opendir("/proc/self/task")) {
+		while (const dirent* entry = readdir(dir)) {
+			if (entry->d_name[0] != '.') {
+				result.insert(entry->d_name);
+			}
+		}
+		closedir(dir);
+	}
+#endif
+	return result;
+}
+
+/// CPU time used by the threads with the given ids, or a negative value if not
+/// supported. Threads that have ended are not counted.
+double threads_cpu_seconds(const std::set<std::string>& ids) {
+	if (ids.empty()) {
+		return -1.;
+	}
+	double result = 0.;
+#ifdef __linux__
+	for (const std::string& id : ids) {
+		std::ifstream stat("/proc/self/task/" + id + "/stat");
+		std::string line;
+		if (!std::getline(stat, line)) {
+			continue;
+		}
+		// The name in parentheses can contain spaces. utime and stime are the
+		// 14th and 15th field, the state after the name is the 3rd.
+		std::istringstream fields(line.substr(line.rfind(')') + 1));
+		std::string field;
+		for (int i = 3; i < 14; ++i) {
+			fields >> field;
+		}
+		unsigned long long utime = 0;
+		unsigned long long stime = 0;
+		fields >> utime >> stime;
+		result += static_cast<double>(utime + stime) / sysconf(_SC_CLK_TCK);
+	}
+#endif
+	return result;
+}
+
+/// Parses \p arg as a whole number in [\p min, \p max]. Returns false if it is not one.
+bool parse_count(const char* arg, long min, long max, long* result) {
+	char* end = nullptr;
+	errno = 0;
+	*result = strtol(arg, &end, 10);
+	return end != arg && *end == '\0' && errno == 0 && min <= *result && *result <= max;
+}
+
+/// Copies the unread rest of \p in into \p out, for forwarding it unchanged.
+void copy_packet(RecvPacket& in, SendPacket* out) {
+	while (!in.end_of_file()) {
+		out->unsigned_8(in.unsigned_8());
+	}
+}
+
+/**
+ * A minimal stand-in for the relay server run by the metaserver. It accepts a
+ * fixed number of connections, does the handshake and forwards packets between
+ * the host and the clients. It does not ping and does not check passwords.
+ */
+class StandInRelay {
+public:
+	explicit StandInRelay(size_t nr_connections)
+	   : acceptor_(io_service_,
+	               boost::asio::ip::tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0)),
+	     stop_(false),
+	     bytes_in_(0),
+	     bytes_out_(0) {
+		accept_thread_ = std::thread(&StandInRelay::accept_connections, this, nr_connections);
+		relay_thread_ = std::thread(&StandInRelay::run, this);
+	}
+
+	~StandInRelay() {
+		stop_ = true;
+		relay_thread_.join();
+		acceptor_.close();
+		accept_thread_.join();
+	}
+
+	NetAddress address() const {
+		NetAddress address;
+		address.ip = boost::asio::ip::address_v4::loopback();
+		address.port = acceptor_.local_endpoint().port();
+		return address;
+	}
+
+	uint64_t bytes_in() const {
+		return bytes_in_;
+	}
+	uint64_t bytes_out() const {
+		return bytes_out_;
+	}
+
+private:
+	void accept_connections(size_t nr_connections) {
+		for (size_t i = 0; i < nr_connections; ++i) {
+			std::unique_ptr<BufferedConnection> conn = BufferedConnection::accept(acceptor_);
+			if (!conn) {
+				return;
+			}
+			std::lock_guard<std::mutex> lock(mutex_);
+			incoming_.push_back(std::move(conn));
+		}
+	}
+
+	void run() {
+		while (!stop_) {
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				for (auto& conn : incoming_) {
+					unidentified_.push_back(std::move(conn));
+				}
+				incoming_.clear();
+			}
+
+			bool idle = true;
+			for (auto it = unidentified_.begin(); it != unidentified_.end();) {
+				if (handle_hello(*it)) {
+					it = unidentified_.erase(it);
+					idle = false;
+				} else {
+					++it;
+				}
+			}
+			if (host_) {
+				while (handle_host()) {
+					idle = false;
+				}
+			}
+			for (auto& client : clients_) {
+				while (handle_client(client.first, client.second.get())) {
+					idle = false;
+				}
+			}
+			if (idle) {
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+		}
+	}
+
+	/// Returns \c true if the connection has been identified as host or client.
+	bool handle_hello(std::unique_ptr<BufferedConnection>& conn) {
+		BufferedConnection::Peeker peek(conn.get());
+		RelayCommand cmd;
+		if (!peek.cmd(&cmd) || cmd != RelayCommand::kHello || !peek.uint8_t() || !peek.string() ||
+		    !peek.string()) {
+			return false;
+		}
+		uint8_t version;
+		std::string name;
+		std::string password;
+		conn->receive(&cmd);
+		conn->receive(&version);
+		conn->receive(&name);
+		conn->receive(&password);
+		conn->send(NetPriority::kNormal, RelayCommand::kWelcome, kRelayProtocolVersion, name);
+
+		if (password == kHostPassword) {
+			host_ = std::move(conn);
+			return true;
+		}
+		if (!host_) {
+			// Clients are connected after the host, this should not happen
+			log("[Relay] Client connected before the host\n");
+			conn->close();
+			return true;
+		}
+		const uint8_t id = clients_.size() + 1;
+		clients_[id] = std::move(conn);
+		host_->send(NetPriority::kNormal, RelayCommand::kConnectClient, id);
+		return true;
+	}
+
+	/// Forwards one message of the host. Returns \c false if none is complete.
+	bool handle_host() {
+		BufferedConnection::Peeker peek(host_.get());
+		RelayCommand cmd;
+		if (!peek.cmd(&cmd)) {
+			return false;
+		}
+		switch (cmd) {
+		case RelayCommand::kToClients: {
+			uint8_t id = 1;
+			while (id != 0) {
+				if (!peek.uint8_t(&id)) {
+					return false;
+				}
+			}
+			if (!peek.recvpacket()) {
+				return false;
+			}
+			host_->receive(&cmd);
+			std::vector<uint8_t> ids;
+			for (host_->receive(&id); id != 0; host_->receive(&id)) {
+				ids.push_back(id);
+			}
+			RecvPacket packet;
+			host_->receive(&packet);
+			SendPacket forward;
+			copy_packet(packet, &forward);
+			bytes_in_ += 2 + ids.size() + forward.get_size();
+			for (uint8_t client : ids) {
+				auto it = clients_.find(client);
+				if (it != clients_.end()) {
+					it->second->send(NetPriority::kNormal, RelayCommand::kFromHost, forward);
+					bytes_out_ += 1 + forward.get_size();
+				}
+			}
+		} break;
+		case RelayCommand::kDisconnectClient:
+		case RelayCommand::kPong: {
+			uint8_t id;
+			if (!peek.uint8_t()) {
+				return false;
+			}
+			host_->receive(&cmd);
+			host_->receive(&id);
+			bytes_in_ += 2;
+			if (cmd == RelayCommand::kDisconnectClient && clients_.count(id)) {
+				clients_[id]->close();
+			}
+		} break;
+		case RelayCommand::kDisconnect: {
+			if (!peek.string()) {
+				return false;
+			}
+			std::string reason;
+			host_->receive(&cmd);
+			host_->receive(&reason);
+			host_->close();
+			return false;
+		}
+		default:
+			log("[Relay] Unexpected command %i from host\n", static_cast<int>(cmd));
+			host_->close();
+			return false;
+		}
+		return true;
+	}
+
+	/// Forwards one message of a client. Returns \c false if none is complete.
+	bool handle_client(uint8_t id, BufferedConnection* conn) {
+		BufferedConnection::Peeker peek(conn);
+		RelayCommand cmd;
+		if (!peek.cmd(&cmd)) {
+			return false;
+		}
+		if (cmd == RelayCommand::kToHost) {
+			if (!peek.recvpacket()) {
+				return false;
+			}
+			conn->receive(&cmd);
+			RecvPacket packet;
+			conn->receive(&packet);
+			SendPacket forward;
+			copy_packet(packet, &forward);
+			host_->send(NetPriority::kNormal, RelayCommand::kFromClient, id, forward);
+			bytes_in_ += 1 + forward.get_size();
+			bytes_out_ += 2 + forward.get_size();
+			return true;
+		}
+		if (cmd == RelayCommand::kDisconnect) {
+			if (!peek.string()) {
+				return false;
+			}
+			std::string reason;
+			conn->receive(&cmd);
+			conn->receive(&reason);
+			conn->close();
+			return false;
+		}
+		log("[Relay] Unexpected command %i from client %i\n", static_cast<int>(cmd), id);
+		conn->close();
+		return false;
+	}
+
+	boost::asio::io_service io_service_;
+	boost::asio::ip::tcp::acceptor acceptor_;
+	std::thread accept_thread_;
+	std::thread relay_thread_;
+	std::atomic<bool> stop_;
+	std::atomic<uint64_t> bytes_in_;
+	std::atomic<uint64_t> bytes_out_;
+
+	std::mutex mutex_;
+	std::vector<std::unique_ptr<BufferedConnection>> incoming_;
+
+	// Only used by the relay thread
+	std::vector<std::unique_ptr<BufferedConnection>> unidentified_;
+	std::unique_ptr<BufferedConnection> host_;
+	std::map<uint8_t, std::unique_ptr<BufferedConnection>> clients_;
+};
+
+/**
+ * Does the network part of GameHost while a game is running: accepts player
+ * commands and chat messages, assigns duetimes, and broadcasts commands in
+ * batches once per frame together with the regular time updates.
+ */
+class SyntheticHost {
+public:
+	explicit SyntheticHost(std::unique_ptr<NetHostProxy> net)
+	   : net_(std::move(net)), networktime_(0), stop_(false) {
+	}
+
+	void start() {
+		thread_ = std::thread(&SyntheticHost::run, this);
+	}
+
+	void stop() {
+		stop_ = true;
+		thread_.join();
+	}
+
+private:
+	void run() {
+		const Clock::time_point start = Clock::now();
+		Clock::time_point next_frame = start;
+		Clock::time_point next_time_update = start;
+
+		while (!stop_) {
+			NetHostInterface::ConnectionId id;
+			while (net_->try_accept(&id)) {
+				clients_.push_back(id);
+			}
+			for (NetHostInterface::ConnectionId client : clients_) {
+				while (std::unique_ptr<RecvPacket> packet = net_->try_receive(client)) {
+					handle_packet(*packet);
+				}
+			}
+
+			const Clock::time_point now = Clock::now();
+			networktime_ = std::chrono::duration_cast<std::chrono::milliseconds>(now - start).count();
+			flush_player_commands();
+			if (now >= next_time_update) {
+				SendPacket packet;
+				packet.unsigned_8(NETCMD_TIME);
+				packet.signed_32(networktime_);
+				broadcast(packet);
+				next_time_update = now + std::chrono::milliseconds(SERVER_TIMESTAMP_INTERVAL);
+			}
+
+			next_frame += kHostFrameLength;
+			std::this_thread::sleep_until(next_frame);
+		}
+	}
+
+	void handle_packet(RecvPacket& packet) {
+		switch (packet.unsigned_8()) {
+		case NETCMD_PLAYERCOMMAND: {
+			packet.signed_32();  // the client's time, only used for checksums
+			std::unique_ptr<Widelands::PlayerCommand> pc(
+			   Widelands::PlayerCommand::deserialize(packet));
+			pc->set_duetime(++networktime_);
+			pending_commands_.add(*pc);
+			if (pending_commands_.size() >= kMaxPlayerCommandBatchSize) {
+				flush_player_commands();
+			}
+		} break;
+		case NETCMD_CHAT: {
+			const std::string message = packet.string();
+			SendPacket chat;
+			chat.unsigned_8(NETCMD_CHAT);
+			chat.signed_16(0);
+			chat.string("client");
+			chat.string(message);
+			chat.unsigned_8(0);
+			broadcast(chat);
+		} break;
+		default:
+			break;
+		}
+	}
+
+	void flush_player_commands() {
+		if (!pending_commands_.empty()) {
+			SendPacket packet;
+			pending_commands_.write(packet);
+			net_->send(clients_, packet);
+		}
+	}
+
+	void broadcast(SendPacket& packet) {
+		flush_player_commands();
+		net_->send(clients_, packet);
+	}
+
+	std::unique_ptr<NetHostProxy> net_;
+	std::vector<NetHostInterface::ConnectionId> clients_;
+	PlayerCommandBatch pending_commands_;
+	int32_t networktime_;
+	std::thread thread_;
+	std::atomic<bool> stop_;
+};
+
+struct SyntheticClient {
+	std::unique_ptr<NetClientProxy> net;
+	Widelands::PlayerNumber player;  // 0 for observers
+	Clock::time_point next_command;
+	Clock::time_point next_chat;
+	std::deque<Clock::time_point> commands_in_flight;
+};
+
+/// Handles everything the host sent to \p client and records command latencies.
+void receive_from_host(SyntheticClient* client, std::vector<double>* latencies) {
+	while (std::unique_ptr<RecvPacket> packet = client->net->try_receive()) {
+		if (packet->unsigned_8() != NETCMD_PLAYERCOMMAND_BATCH) {
+			continue;
+		}
+		const Clock::time_point now = Clock::now();
+		PlayerCommandBatch::read(*packet, [client, latencies, now](
+		                                     int32_t, Widelands::PlayerCommand* pc) {
+			if (pc->sender() == client->player && !client->commands_in_flight.empty()) {
+				latencies->push_back(
+				   std::chrono::duration<double, std::milli>(now - client->commands_in_flight.front())
+				      .count());
+				client->commands_in_flight.pop_front();
+			}
+			delete pc;
+		});
+	}
+}
+
+void send_to_host(SyntheticClient* client, std::mt19937* random) {
+	const Clock::time_point now = Clock::now();
+	std::uniform_int_distribution<int> jitter(-500, 500);
+	if (now >= client->next_command) {
+		Widelands::CmdBuildFlag cmd(
+		   0, client->player, Widelands::Coords((*random)() & 0xff, (*random)() & 0xff));
+		SendPacket packet;
+		packet.unsigned_8(NETCMD_PLAYERCOMMAND);
+		packet.signed_32(0);
+		cmd.serialize(packet);
+		client->net->send(packet);
+		client->commands_in_flight.push_back(now);
+		client->next_command = now + kCommandInterval + std::chrono::milliseconds(jitter(*random));
+	}
+	if (now >= client->next_chat) {
+		SendPacket packet;
+		packet.unsigned_8(NETCMD_CHAT);
+		packet.string("Hello, this is a synthetic player in a load test.");
+		client->net->send(packet);
+		client->next_chat = now + kChatInterval + std::chrono::milliseconds(jitter(*random));
+	}
+}
+
+double percentile(const std::vector<double>& sorted, double p) {
+	return sorted[std::min(sorted.size() - 1, static_cast<size_t>(p * sorted.size()))];
+}
+
+}  // namespace
+#endif
+
+int main(int argc, char** argv) {
+	const bool help =
+	   argc == 2 && (std::string(argv[1]) == "--help" || std::string(argv[1]) == "-h");
+	if (argc > 4 || help) {
+		log("Usage: %s [players] [observers] [duration in s]\n", argv[0]);
+		log("   players and observers: 0 to %" PRIuS " together, default 100 and 0\n", kMaxClients);
+		log("   duration: at least 1, default 30\n");
+		return help ? 0 : 1;
+	}
+#if BOOST_VERSION >= 106600
+	long players = 100;
+	long observers = 0;
+	long seconds_to_run = 30;
+	if ((argc >= 2 && !parse_count(argv[1], 0, kMaxClients, &players)) ||
+	    (argc >= 3 && !parse_count(argv[2], 0, kMaxClients, &observers)) ||
+	    (argc >= 4 && !parse_count(argv[3], 1, 24 * 60 * 60, &seconds_to_run))) {
+		log("Invalid arguments, see %s --help\n", argv[0]);
+		return 1;
+	}
+	const size_t nr_players = players;
+	const size_t nr_observers = observers;
+	const int duration = seconds_to_run;
+	if (nr_players + nr_observers > kMaxClients) {
+		log("The relay supports at most %" PRIuS " clients.\n", kMaxClients);
+		return 1;
+	}
+
+	StandInRelay relay(1 + nr_players + nr_observers);
+	// The threads that start while connecting and starting the host are its
+	// networking thread and the thread it runs on.
+	const std::set<std::string> threads_without_host = thread_ids();
+	std::unique_ptr<NetHostProxy> host_net = NetHostProxy::connect(
+	   std::make_pair(relay.address(), NetAddress()), kGameName, kHostPassword);
+	if (!host_net) {
+		log("Could not connect the host to the relay.\n");
+		return 1;
+	}
+	SyntheticHost host(std::move(host_net));
+	host.start();
+	std::set<std::string> host_threads;
+	for (const std::string& id : thread_ids()) {
+		if (!threads_without_host.count(id)) {
+			host_threads.insert(id);
+		}
+	}
+
+	std::mt19937 random(1);
+	std::uniform_int_distribution<int> initial_delay(0, kChatInterval.count());
+	std::vector<SyntheticClient> clients(nr_players + nr_observers);
+	for (size_t i = 0; i < clients.size(); ++i) {
+		SyntheticClient& client = clients[i];
+		client.net = NetClientProxy::connect(relay.address(), kGameName);
+		if (!client.net) {
+			log("Could not connect client %" PRIuS " to the relay.\n", i);
+			host.stop();
+			return 1;
+		}
+		client.player = i < nr_players ? i + 1 : 0;
+		client.next_command = Clock::now() + std::chrono::milliseconds(
+		                                        initial_delay(random) % kCommandInterval.count());
+		client.next_chat = Clock::now() + std::chrono::milliseconds(initial_delay(random));
+	}
+	log("%" PRIuS " players and %" PRIuS " observers connected, running for %i s\n", nr_players,
+	    nr_observers, duration);
+
+	std::vector<double> latencies;
+	const uint64_t bytes_in_start = relay.bytes_in();
+	const uint64_t bytes_out_start = relay.bytes_out();
+	const double cpu_start = threads_cpu_seconds(host_threads);
+	const Clock::time_point start = Clock::now();
+	const Clock::time_point end = start + std::chrono::seconds(duration);
+	while (Clock::now() < end) {
+		for (SyntheticClient& client : clients) {
+			receive_from_host(&client, &latencies);
+			if (client.player != 0) {
+				send_to_host(&client, &random);
+			}
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+	const double cpu_end = threads_cpu_seconds(host_threads);
+	host.stop();
+
+	size_t lost = 0;
+	for (const SyntheticClient& client : clients) {
+		lost += client.commands_in_flight.size();
+	}
+	log("%" PRIuS " commands echoed, %" PRIuS " still in flight at the end\n", latencies.size(),
+	    lost);
+	if (!latencies.empty()) {
+		std::sort(latencies.begin(), latencies.end());
+		log("Command latency: p50 %.1f ms, p90 %.1f ms, p99 %.1f ms, max %.1f ms\n",
+		    percentile(latencies, 0.5), percentile(latencies, 0.9), percentile(latencies, 0.99),
+		    latencies.back());
+	}
+	if (cpu_start >= 0.) {
+		const double cpu = cpu_end - cpu_start;
+		log("Host CPU (%" PRIuS " threads): %.2f %% of one core, %.4f %% per client\n",
+		    host_threads.size(), 100. * cpu / seconds,
+		    clients.empty() ? 0. : 100. * cpu / seconds / clients.size());
+	}
+	log("Relay traffic: %.1f KiB/s in, %.1f KiB/s out\n",
+	    (relay.bytes_in() - bytes_in_start) / seconds / 1024.,
+	    (relay.bytes_out() - bytes_out_start) / seconds / 1024.);
+	return 0;
+#else
+	log("This benchmark needs boost 1.66 or newer.\n");
+	return 1;
+#endif
+}
@@ -221,20 +221,28 @@ void BufferedConnection::start_sending() {
 		return;
 	}
 
-	// Find something to send
-	std::queue<std::vector<uint8_t>>* nonempty_queue = nullptr;
+	// Find something to send. Everything that has been queued for the most urgent
+	// priority so far is written at once. A failed write closes the socket, so
+	// nothing is ever left in flight here.
+	assert(buffer_in_flight_.empty());
 	for (auto& entry : buffers_to_send_) {
 		if (!entry.second.empty()) {
-			nonempty_queue = &entry.second;
+			buffer_in_flight_.swap(entry.second);
 			break;
 		}
 	}
 
-	if (nonempty_queue == nullptr) {
+	if (buffer_in_flight_.empty()) {
 		// Nothing (further) to send (right now)
 		return;
 	}
 
+	std::vector<boost::asio::const_buffer> buffers;
+	buffers.reserve(buffer_in_flight_.size());
+	for (const Chunk& chunk : buffer_in_flight_) {
+		buffers.push_back(boost::asio::buffer(chunk.bytes()));
+	}
+
 	currently_sending_ = true;
 	lock.unlock();
 
@@ -242,24 +250,36 @@ void BufferedConnection::start_sending() {
 	// the operating system is currently full.
 	// When done with sending, call the lambda method defined below
 	boost::asio::async_write(
-	   socket_, boost::asio::buffer(nonempty_queue->front()),
+	   socket_, buffers,
 #ifndef NDEBUG
-	   [this, nonempty_queue](boost::system::error_code ec, std::size_t length) {
+	   [this](boost::system::error_code ec, std::size_t length) {
 #else
-	   [this, nonempty_queue](boost::system::error_code ec, std::size_t /*length*/) {
+	   [this](boost::system::error_code ec, std::size_t /*length*/) {
 #endif
 		   std::unique_lock<std::mutex> lock2(mutex_send_);
 		   currently_sending_ = false;
 		   if (!ec) {
-			   // No error: Remove the buffer from the queue
-			   assert(nonempty_queue != nullptr);
-			   assert(!nonempty_queue->empty());
-			   assert(nonempty_queue->front().size() == length);
-			   nonempty_queue->pop();
+#ifndef NDEBUG
+			   size_t written = 0;
+			   for (const Chunk& chunk : buffer_in_flight_) {
+				   written += chunk.bytes().size();
+			   }
+			   assert(written == length);
+#endif
+			   // No error: Drop the data but keep some memory for the next write
+			   for (Chunk& chunk : buffer_in_flight_) {
+				   if (chunk.data.capacity() > spare_buffer_.capacity()) {
+					   chunk.data.clear();
+					   spare_buffer_.swap(chunk.data);
+				   }
+			   }
+			   buffer_in_flight_.clear();
 			   lock2.unlock();
 			   // Try to send some more data
 			   start_sending();
 		   } else {
+			   // Some of the data might have been written, so it cannot be sent again
+			   buffer_in_flight_.clear();
 			   if (socket_.is_open()) {
 				   log("[BufferedConnection] Error when sending packet to host (error %i: %s)\n",
 				       ec.value(), ec.message().c_str());
@@ -20,9 +20,12 @@
 #ifndef WL_NETWORK_BUFFEREDCONNECTION_H
 #define WL_NETWORK_BUFFEREDCONNECTION_H
 
+#include <deque>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <thread>
+#include <vector>
 
 #include "network/network.h"
 #include "network/relay_protocol.h"
@@ -205,29 +208,27 @@ public:
 	 *                 even when a large group of low priority data has been scheduled earlier.
 	 * @param Fargs A list of data objects that should be send as part of this packet.
 	 *              The following data types can be send:
-	 *              RelayCommand, uint8_t, std::string, std::vector<uint8_t>, SendPacket.
+	 *              RelayCommand, uint8_t, std::string, std::vector<uint8_t>, SendPacket,
+	 *              SharedPacket. A SharedPacket is queued by reference and not copied.
 	 */
 	/*
-	 This method creates a vector to store the data-to-be-send in. Basically this template magic
+	 This method appends the data-to-be-send to the buffer of the given priority. Basically this
+	 template magic
 	 (called "parameter pack") is similar to the var-arg magic used by printf(). An arbitrary
 	 number of arbitrary-typed parameters might be passed as the Fargs parameter. The compiler than
 	 decides which of the send_T_() methods have to be called. Since each of them takes a different
 	 first argument out of Fargs only one of them can match. The matching methods transforms the
-	 received first argument to an uint8_t string and appends it to the given vector. Then it
+	 received first argument to an uint8_t string and appends it to the given queue. Then it
 	 calls send_T_() again, but with one argument less. This results in a "recursive" call
 	 until no more arguments are left.
 	 */
 	template <typename... Targs> void send(NetPriority priority, const Targs&... Fargs) {
 
-		std::vector<uint8_t> v;
-		v.reserve(kNetworkBufferSize);
-
-		send_T_(v, Fargs...);
-
 		std::unique_lock<std::mutex> lock(mutex_send_);
-		// The map will automatically create the vector for the requested priority if it does not
-		// exist
-		buffers_to_send_[priority].push(v);
+		// The map will automatically create the queue for the requested priority if it does not
+		// exist. The data is appended in place, so once the buffer has grown to its working size
+		// no further memory is allocated per message.
+		send_T_(buffers_to_send_[priority], Fargs...);
 		lock.unlock();
 		start_sending();
 	}
@@ -236,48 +237,85 @@ private:
 	// I love this language... Sorry for the next functions,
 	// but you have to admit that this is cool! :-D
 
+	/**
+	 * A piece of the data waiting to be send. Either holds bytes that have been copied
+	 * into it or references a packet that is shared with other connections.
+	 */
+	struct Chunk {
+		std::vector<uint8_t> data;
+		SharedPacket shared;
+
+		const std::vector<uint8_t>& bytes() const {
+			return shared ? *shared : data;
+		}
+	};
+	using SendQueue = std::deque<Chunk>;
+
+	/**
+	 * Returns the buffer at the end of the given queue that further data can be appended to.
+	 * Must only be called while mutex_send_ is held.
+	 */
+	std::vector<uint8_t>& tail(SendQueue& q) {
+		if (q.empty() || q.back().shared) {
+			q.emplace_back();
+			// Reuse the memory of an earlier write
+			q.back().data.swap(spare_buffer_);
+		}
+		return q.back().data;
+	}
+
 	/**
 	 * Base function that is called when no arguments are left.
 	 */
-	void send_T_(std::vector<uint8_t>&) {
+	void send_T_(SendQueue&) {
 	}
 
 	/**
 	 * Takes one element (here: a RelayCommand) and transforms it to an uint8_t.
-	 * @param v The vector to add the data to.
+	 * @param q The queue to add the data to.
 	 * @param cmd The RelayCommand to transform.
 	 * @param Fargs Further arguments that will be handled in the next iteration.
 	 */
 	/// @{
 	template <typename... Targs>
-	void send_T_(std::vector<uint8_t>& v, RelayCommand cmd, const Targs&... Fargs) {
-		v.push_back(static_cast<uint8_t>(cmd));
-		send_T_(v, Fargs...);
+	void send_T_(SendQueue& q, RelayCommand cmd, const Targs&... Fargs) {
+		tail(q).push_back(static_cast<uint8_t>(cmd));
+		send_T_(q, Fargs...);
 	}
 
-	template <typename... Targs>
-	void send_T_(std::vector<uint8_t>& v, uint8_t u, const Targs&... Fargs) {
-		v.push_back(u);
-		send_T_(v, Fargs...);
+	template <typename... Targs> void send_T_(SendQueue& q, uint8_t u, const Targs&... Fargs) {
+		tail(q).push_back(u);
+		send_T_(q, Fargs...);
 	}
 
 	template <typename... Targs>
-	void send_T_(std::vector<uint8_t>& v, const std::string& str, const Targs&... Fargs) {
+	void send_T_(SendQueue& q, const std::string& str, const Targs&... Fargs) {
+		std::vector<uint8_t>& v = tail(q);
 		v.insert(v.end(), str.cbegin(), str.cend());
 		v.push_back(0);
-		send_T_(v, Fargs...);
+		send_T_(q, Fargs...);
 	}
 
 	template <typename... Targs>
-	void send_T_(std::vector<uint8_t>& v, const std::vector<uint8_t>& data, const Targs&... Fargs) {
+	void send_T_(SendQueue& q, const std::vector<uint8_t>& data, const Targs&... Fargs) {
+		std::vector<uint8_t>& v = tail(q);
 		v.insert(v.end(), data.begin(), data.end());
-		send_T_(v, Fargs...);
+		send_T_(q, Fargs...);
 	}
 
 	template <typename... Targs>
-	void send_T_(std::vector<uint8_t>& v, const SendPacket& packet, const Targs&... Fargs) {
+	void send_T_(SendQueue& q, const SendPacket& packet, const Targs&... Fargs) {
+		std::vector<uint8_t>& v = tail(q);
 		v.insert(v.end(), packet.get_data(), packet.get_data() + packet.get_size());
-		send_T_(v, Fargs...);
+		send_T_(q, Fargs...);
+	}
+
+	template <typename... Targs>
+	void send_T_(SendQueue& q, const SharedPacket& packet, const Targs&... Fargs) {
+		assert(packet);
+		q.emplace_back();
+		q.back().shared = packet;
+		send_T_(q, Fargs...);
 	}
 	/// @}
 
@@ -309,6 +347,8 @@ private:
 	 * Is called by send() each time new data is given to this class but only
 	 * does something when not already sending.
 	 * Will continue sending until all buffers_to_send_ are empty.
+	 * All data queued for the most urgent priority is written with a single call.
+	 * Shared packets are written from where they are, without copying them.
 	 */
 	void start_sending();
 
@@ -319,10 +359,17 @@ private:
 	 */
 	void start_receiving();
 
-	/// The buffers that are waiting to be send.
+	/// The data that is waiting to be send.
 	/// The map key is the priority of the packets stored in the queue.
-	/// Each packet in the queue is a vector of uint8_t.
-	std::map<uint8_t, std::queue<std::vector<uint8_t>>> buffers_to_send_;
+	/// Each queue only contains complete packets, stored back to back.
+	std::map<uint8_t, SendQueue> buffers_to_send_;
+
+	/// The data that is currently being written to the socket. It is swapped with
+	/// one of the buffers_to_send_ when a write starts.
+	SendQueue buffer_in_flight_;
+
+	/// Memory of a completely written chunk, kept for the next data that is copied in.
+	std::vector<uint8_t> spare_buffer_;
 
 	/// An io_service needed by boost.asio. Primarily needed for asynchronous operations.
 	boost::asio::io_service io_service_;
@@ -338,7 +385,7 @@ private:
 
 	/// A thread used for the asynchronous send/receive methods
 	std::thread asio_thread_;
-	/// Protects buffers_to_send_
+	/// Protects buffers_to_send_ and currently_sending_
 	std::mutex mutex_send_;
 	/// Protects receive_buffer_
 	std::mutex mutex_receive_;
@@ -47,6 +47,7 @@
 #include "network/netclientproxy.h"
 #include "network/network_gaming_messages.h"
 #include "network/network_protocol.h"
+#include "network/player_command_batch.h"
 #include "scripting/lua_interface.h"
 #include "scripting/lua_table.h"
 #include "ui_basic/messagebox.h"
@@ -884,6 +885,17 @@ void GameClient::handle_playercommand(RecvPacket& packet) {
 	d->time.receive(time);
 }
 
+void GameClient::handle_playercommand_batch(RecvPacket& packet) {
+	if (!d->game)
+		throw DisconnectException("PLAYERCMD_WO_GAME");
+
+	PlayerCommandBatch::read(packet, [this](int32_t time, Widelands::PlayerCommand* plcmd) {
+		plcmd->set_duetime(time);
+		d->game->enqueue_command(plcmd);
+		d->time.receive(time);
+	});
+}
+
 /**
  *
  */
@@ -1006,6 +1018,8 @@ void GameClient::handle_packet(RecvPacket& packet) {
 		break;
 	case NETCMD_PLAYERCOMMAND:
 		return handle_playercommand(packet);
+	case NETCMD_PLAYERCOMMAND_BATCH:
+		return handle_playercommand_batch(packet);
 	case NETCMD_SYNCREQUEST:
 		return handle_syncrequest(packet);
 	case NETCMD_CHAT:
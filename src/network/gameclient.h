@@ -128,6 +128,7 @@ private:
 	void handle_setting_tribes(RecvPacket& packet);
 	void handle_setting_allplayers(RecvPacket& packet);
 	void handle_playercommand(RecvPacket& packet);
+	void handle_playercommand_batch(RecvPacket& packet);
 	void handle_chat(RecvPacket& packet);
 	void handle_system_message(RecvPacket& packet);
 	void handle_desync(RecvPacket& packet);
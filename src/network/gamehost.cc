@@ -58,6 +58,7 @@
 #include "network/network_lan_promotion.h"
 #include "network/network_player_settings_backend.h"
 #include "network/network_protocol.h"
+#include "network/player_command_batch.h"
 #include "scripting/lua_interface.h"
 #include "ui_basic/progresswindow.h"
 #include "ui_fsmenu/launch_mpg.h"
@@ -442,6 +443,22 @@ struct GameHostImpl {
 	/// This is the time for local simulation
 	NetworkTime time;
 
+	/// Player commands that have been committed to but not yet been sent to
+	/// the clients. Flushed once per \ref GameHost::think() and before any
+	/// other packet is broadcast.
+	PlayerCommandBatch pending_commands;
+
+	/// If not 0, observers only get player commands and time updates every this
+	/// many milliseconds, so that they cannot hold up the players' network tick.
+	uint32_t observer_update_interval;
+	uint32_t last_observer_update;
+	/// Player commands that have not yet been sent to the observers.
+	PlayerCommandBatch observer_commands;
+	/// The networktime most recently sent to the players. Observers get it with
+	/// their next update if \ref observer_time_pending is set.
+	int32_t observer_networktime;
+	bool observer_time_pending;
+
 	/// Whether we're waiting for all clients to report back.
 	bool waiting;
 	uint32_t lastframe;
@@ -521,6 +538,10 @@ GameHost::GameHost(const std::string& playername, bool internet)
 	d->localdesiredspeed = 1000;
 	d->syncreport_pending = false;
 	d->syncreport_time = 0;
+	d->observer_update_interval = 0;
+	d->last_observer_update = 0;
+	d->observer_networktime = 0;
+	d->observer_time_pending = false;
 
 	d->settings.tribes = Widelands::get_all_tribeinfos();
 	set_multiplayer_game_settings();
@@ -635,6 +656,7 @@ void GameHost::run() {
 	game.set_ai_training_mode(get_config_bool("ai_training", false));
 	game.set_auto_speed(get_config_bool("auto_speed", false));
 	game.set_write_syncstream(get_config_bool("write_syncstreams", true));
+	d->observer_update_interval = get_config_natural("observer_update_interval", 0);
 
 	try {
 		std::unique_ptr<UI::ProgressWindow> loader_ui;
@@ -747,7 +769,15 @@ void GameHost::think() {
 				SendPacket packet;
 				packet.unsigned_8(NETCMD_TIME);
 				packet.signed_32(d->pseudo_networktime);
-				broadcast(packet);
+				if (d->observer_update_interval > 0) {
+					// Observers get the most recent time with their next update
+					flush_player_commands();
+					d->net->send(receivers(true, false), packet);
+					d->observer_networktime = d->pseudo_networktime;
+					d->observer_time_pending = true;
+				} else {
+					broadcast(packet);
+				}
 
 				committed_network_time(d->pseudo_networktime);
 
@@ -758,20 +788,71 @@ void GameHost::think() {
 		for (ComputerPlayer* cp : d->computerplayers) {
 			cp->think();
 		}
+
+		flush_player_commands();
+		if (d->observer_update_interval > 0 &&
+		    curtime - d->last_observer_update >= d->observer_update_interval) {
+			flush_observer_stream();
+		}
 	}
 }
 
 void GameHost::send_player_command(Widelands::PlayerCommand* pc) {
 	pc->set_duetime(d->committed_networktime + 1);
 
-	SendPacket packet;
-	packet.unsigned_8(NETCMD_PLAYERCOMMAND);
-	packet.signed_32(pc->duetime());
-	pc->serialize(packet);
-	broadcast(packet);
+	// Do not send the command right away. All commands of this network tick
+	// are sent together at the end of think().
+	d->pending_commands.add(*pc);
+	if (d->observer_update_interval > 0) {
+		d->observer_commands.add(*pc);
+	}
 	d->game->enqueue_command(pc);
 
 	committed_network_time(d->committed_networktime + 1);
+
+	if (d->pending_commands.size() >= kMaxPlayerCommandBatchSize) {
+		flush_player_commands();
+	}
+	if (d->observer_commands.size() >= kMaxPlayerCommandBatchSize) {
+		flush_observer_stream();
+	}
+}
+
+void GameHost::flush_player_commands() {
+	if (d->pending_commands.empty()) {
+		return;
+	}
+	SendPacket packet;
+	d->pending_commands.write(packet);
+	// Observers with coarse updates get their own batches
+	d->net->send(receivers(true, d->observer_update_interval == 0), packet);
+}
+
+/**
+ * Sends the player commands and the time update that have been held back for
+ * the observers since their last update.
+ */
+void GameHost::flush_observer_stream() {
+	if (d->observer_update_interval == 0) {
+		return;
+	}
+	d->last_observer_update = SDL_GetTicks();
+	if (d->observer_commands.empty() && !d->observer_time_pending) {
+		return;
+	}
+	const std::vector<NetHostInterface::ConnectionId> observers = receivers(false, true);
+	if (!d->observer_commands.empty()) {
+		SendPacket packet;
+		d->observer_commands.write(packet);
+		d->net->send(observers, packet);
+	}
+	if (d->observer_time_pending) {
+		SendPacket packet;
+		packet.unsigned_8(NETCMD_TIME);
+		packet.signed_32(d->observer_networktime);
+		d->net->send(observers, packet);
+		d->observer_time_pending = false;
+	}
 }
 
 /**
@@ -1478,14 +1559,28 @@ void GameHost::set_paused(bool /* paused */) {
 
 // Send the packet to all properly connected clients
 void GameHost::broadcast(SendPacket& packet) {
-	std::vector<NetHostInterface::ConnectionId> receivers;
+	// Clients rely on receiving player commands before anything that refers
+	// to a later game time, so pending commands always go out first.
+	flush_player_commands();
+	flush_observer_stream();
+
+	d->net->send(receivers(true, true), packet);
+}
+
+// The connections of all properly connected players and/or observers
+std::vector<NetHostInterface::ConnectionId> GameHost::receivers(bool players,
+                                                                bool observers) const {
+	std::vector<NetHostInterface::ConnectionId> result;
 	for (const Client& client : d->clients) {
-		if (client.playernum != UserSettings::not_connected()) {
+		if (client.playernum == UserSettings::not_connected()) {
+			continue;
+		}
+		if (client.playernum == UserSettings::none() ? observers : players) {
 			assert(client.sock_id > 0);
-			receivers.push_back(client.sock_id);
+			result.push_back(client.sock_id);
 		}
 	}
-	d->net->send(receivers, packet);
+	return result;
 }
 
 void GameHost::write_setting_map(SendPacket& packet) {
@@ -1753,6 +1848,9 @@ void GameHost::check_hung_clients() {
 	for (uint32_t i = 0; i < d->clients.size(); ++i) {
 		if (d->clients.at(i).playernum == UserSettings::not_connected())
 			continue;
+		// Observers with coarse updates are always behind, but nobody waits for them
+		if (d->clients.at(i).playernum == UserSettings::none() && d->observer_update_interval > 0)
+			continue;
 
 		int32_t const delta = d->committed_networktime - d->clients.at(i).time;
 
@@ -144,6 +144,9 @@ private:
 	void receive_client_time(uint32_t number, int32_t time);
 
 	void broadcast(SendPacket&);
+	std::vector<NetHostInterface::ConnectionId> receivers(bool players, bool observers) const;
+	void flush_player_commands();
+	void flush_observer_stream();
 	void write_setting_map(SendPacket&);
 	void write_setting_player(SendPacket&, uint8_t number);
 	void write_setting_all_players(SendPacket&);
@@ -129,9 +129,15 @@ void NetHost::send(const ConnectionId id, const SendPacket& packet, NetPriority
 	clients_.at(id)->send(priority, packet);
 }
 
-void NetHost::send(const std::vector<ConnectionId>& ids, const SendPacket& packet, NetPriority) {
+void NetHost::send(const std::vector<ConnectionId>& ids,
+                   const SendPacket& packet,
+                   NetPriority priority) {
+	// Encode the packet only once and let all connections refer to it
+	const SharedPacket shared = packet.share();
 	for (ConnectionId id : ids) {
-		send(id, packet);
+		if (is_connected(id)) {
+			clients_.at(id)->send(priority, shared);
+		}
 	}
 }
 
@@ -86,6 +86,7 @@ public:
 
 	/**
 	 * Sends a packet to a group of clients.
+	 * The packet is encoded only once, no matter how many clients receive it.
 	 * Calling this on a closed connection will silently fail.
 	 * \param ids The connection ids of the clients that should be sent to.
 	 * \param packet The packet to send.
@@ -205,6 +205,11 @@ uint8_t* SendPacket::get_data() const {
 	return &(buffer[0]);
 }
 
+SharedPacket SendPacket::share() const {
+	const uint8_t* const begin = get_data();
+	return std::make_shared<const std::vector<uint8_t>>(begin, begin + buffer.size());
+}
+
 /*** class RecvPacket ***/
 size_t RecvPacket::data(void* const packet_data, size_t const bufsize) {
 	if (index_ + bufsize > buffer.size())
@@ -217,7 +222,7 @@ size_t RecvPacket::data(void* const packet_data, size_t const bufsize) {
 }
 
 bool RecvPacket::end_of_file() const {
-	return index_ < buffer.size();
+	return index_ >= buffer.size();
 }
 
 DisconnectException::DisconnectException(const char* fmt, ...) {
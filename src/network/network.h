@@ -22,6 +22,7 @@
 
 #include <exception>
 #include <functional>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -140,6 +141,12 @@ private:
 	uint32_t latency_;
 };
 
+/**
+ * An encoded packet that can be queued on several connections at once.
+ * The data is immutable, so each connection only keeps a reference to it.
+ */
+using SharedPacket = std::shared_ptr<const std::vector<uint8_t>>;
+
 /**
  * Buffered StreamWrite object for assembling a packet that will be
  * sent over the network.
@@ -155,6 +162,9 @@ struct SendPacket : public StreamWrite {
 
 	uint8_t* get_data() const;
 
+	/// Returns a copy of the encoded packet for sending it to several receivers.
+	SharedPacket share() const;
+
 private:
 	// First two bytes are overwritten on call to get_data()
 	mutable std::vector<uint8_t> buffer;
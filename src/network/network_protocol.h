@@ -28,7 +28,7 @@ enum {
 	 * The current version of the in-game network protocol. Client and host
 	 * protocol versions must match.
 	 */
-	NETWORK_PROTOCOL_VERSION = 23,
+	NETWORK_PROTOCOL_VERSION = 24,
 
 	/**
 	 * The default interval (in milliseconds) in which the host issues
@@ -436,6 +436,19 @@ enum {
 	 */
 	NETCMD_PEACEFUL_MODE = 33,
 
+	/**
+	 * Sent by the host: All player commands the host issued during one network
+	 * tick. Payload is:
+	 * \li varint:    number of commands
+	 * \li signed_32: duetime of the first command
+	 * \li for each command: varint delta of its duetime to the duetime of the
+	 *     previous command, followed by the serialized \ref Widelands::PlayerCommand
+	 *
+	 * The client must handle each contained command like a separate
+	 * \ref NETCMD_PLAYERCOMMAND. See \ref PlayerCommandBatch.
+	 */
+	NETCMD_PLAYERCOMMAND_BATCH = 34,
+
 	/**
 	 * Sent by the metaserver to a freshly opened game to check connectability
 	 */
@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2019 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include "network/player_command_batch.h"
+
+#include "network/network_protocol.h"
+
+PlayerCommandBatch::PlayerCommandBatch() : nr_commands_(0), first_duetime_(0), last_duetime_(0) {
+}
+
+void PlayerCommandBatch::add(Widelands::PlayerCommand& pc) {
+	const int32_t duetime = pc.duetime();
+	if (nr_commands_ == 0) {
+		first_duetime_ = last_duetime_ = duetime;
+	}
+
+	// The host assigns consecutive duetimes, so the delta nearly always fits
+	// into a single byte. A decreasing duetime wraps around and takes 5 bytes.
+	body_.unsigned_varint(static_cast<uint32_t>(duetime) - static_cast<uint32_t>(last_duetime_));
+	pc.serialize(body_);
+
+	last_duetime_ = duetime;
+	++nr_commands_;
+}
+
+void PlayerCommandBatch::write(SendPacket& packet) {
+	assert(!empty());
+
+	packet.unsigned_8(NETCMD_PLAYERCOMMAND_BATCH);
+	packet.unsigned_varint(nr_commands_);
+	packet.signed_32(first_duetime_);
+	const std::string body = body_.get_data();
+	packet.data(body.data(), body.size());
+
+	body_.clear();
+	nr_commands_ = 0;
+}
+
+void PlayerCommandBatch::read(StreamRead& packet, const Callback& callback) {
+	const uint32_t nr_commands = packet.unsigned_varint();
+	uint32_t duetime = packet.signed_32();
+	for (uint32_t i = 0; i < nr_commands; ++i) {
+		duetime += packet.unsigned_varint();
+		callback(static_cast<int32_t>(duetime), Widelands::PlayerCommand::deserialize(packet));
+	}
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2019 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#ifndef WL_NETWORK_PLAYER_COMMAND_BATCH_H
+#define WL_NETWORK_PLAYER_COMMAND_BATCH_H
+
+#include <functional>
+
+#include "io/filewrite.h"
+#include "logic/playercommand.h"
+#include "network/network.h"
+
+/// Flush a batch before it grows beyond this many bytes, so that the resulting
+/// packet stays well below the 64 KiB limit of \ref SendPacket.
+constexpr size_t kMaxPlayerCommandBatchSize = 32 * 1024;
+
+/**
+ * Collects the player commands the host issues during one network tick, so
+ * that they can be sent as a single \ref NETCMD_PLAYERCOMMAND_BATCH packet
+ * instead of one \ref NETCMD_PLAYERCOMMAND packet per command.
+ *
+ * Commands are serialized as soon as they are added, because ownership passes
+ * on to the command queue right after that.
+ */
+class PlayerCommandBatch {
+public:
+	using Callback = std::function<void(int32_t duetime, Widelands::PlayerCommand*)>;
+
+	PlayerCommandBatch();
+
+	/// Appends the given command. Duetimes should be non-decreasing, any other
+	/// order works but makes the batch larger.
+	void add(Widelands::PlayerCommand& pc);
+
+	bool empty() const {
+		return nr_commands_ == 0;
+	}
+
+	/// Number of payload bytes collected so far.
+	size_t size() const {
+		return body_.get_pos();
+	}
+
+	/// Writes the batch including the command code to \p packet and clears it.
+	void write(SendPacket& packet);
+
+	/**
+	 * Reads the payload of a \ref NETCMD_PLAYERCOMMAND_BATCH packet and calls
+	 * \p callback for each contained command, in the order they were added.
+	 * The callback takes ownership of the command.
+	 */
+	static void read(StreamRead& packet, const Callback& callback);
+
+private:
+	FileWrite body_;
+	uint32_t nr_commands_;
+	int32_t first_duetime_;
+	int32_t last_duetime_;
+};
+
+#endif  // end of include guard: WL_NETWORK_PLAYER_COMMAND_BATCH_H
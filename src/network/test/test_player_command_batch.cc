@@ -0,0 +1,225 @@
+/*
+ * Copyright (C) 2019 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include "base/macros.h"
+#include "io/streamread.h"
+#include "io/streamwrite.h"
+#include "logic/playercommand.h"
+#include "logic/widelands_geometry.h"
+#include "network/network.h"
+#include "network/network_protocol.h"
+#include "network/player_command_batch.h"
+
+// Triggered by BOOST_AUTO_TEST_CASE
+CLANG_DIAG_OFF("-Wdisabled-macro-expansion")
+CLANG_DIAG_OFF("-Wused-but-marked-unused")
+
+namespace {
+
+class StringWrite : public StreamWrite {
+public:
+	void data(const void* const write_data, const size_t size) override {
+		bytes.append(static_cast<const char*>(write_data), size);
+	}
+
+	std::string bytes;
+};
+
+class StringRead : public StreamRead {
+public:
+	explicit StringRead(const std::string& bytes) : bytes_(bytes), index_(0) {
+	}
+
+	size_t data(void* const read_data, const size_t bufsize) override {
+		const size_t size = std::min(bufsize, bytes_.size() - index_);
+		memcpy(read_data, bytes_.data() + index_, size);
+		index_ += size;
+		return size;
+	}
+
+	bool end_of_file() const override {
+		return index_ >= bytes_.size();
+	}
+
+private:
+	const std::string bytes_;
+	size_t index_;
+};
+
+std::string encoded(const uint32_t value) {
+	StringWrite sw;
+	sw.unsigned_varint(value);
+	return sw.bytes;
+}
+
+// The bytes of the command without the duetime, which is not serialized.
+std::string serialized(Widelands::PlayerCommand* pc) {
+	StringWrite sw;
+	pc->serialize(sw);
+	return sw.bytes;
+}
+
+// What the callback of PlayerCommandBatch::read() got.
+struct ReadCommand {
+	int32_t duetime;
+	std::unique_ptr<Widelands::PlayerCommand> command;
+};
+
+// Writes 'commands' as one packet with 'batch' and reads them back.
+std::vector<ReadCommand>
+round_trip(const std::vector<std::unique_ptr<Widelands::PlayerCommand>>& commands,
+           PlayerCommandBatch* batch) {
+	for (const auto& pc : commands) {
+		batch->add(*pc);
+	}
+	SendPacket packet;
+	batch->write(packet);
+	BOOST_CHECK(batch->empty());
+
+	// Skip the length of the packet, like BufferedConnection does
+	StringRead sr(
+	   std::string(reinterpret_cast<const char*>(packet.get_data()) + 2, packet.get_size() - 2));
+	BOOST_CHECK_EQUAL(sr.unsigned_8(), NETCMD_PLAYERCOMMAND_BATCH);
+	std::vector<ReadCommand> result;
+	PlayerCommandBatch::read(sr, [&result](int32_t duetime, Widelands::PlayerCommand* pc) {
+		result.push_back(ReadCommand{duetime, std::unique_ptr<Widelands::PlayerCommand>(pc)});
+	});
+	BOOST_CHECK(sr.end_of_file());
+	return result;
+}
+
+void check_round_trip(const std::vector<std::unique_ptr<Widelands::PlayerCommand>>& commands,
+                      PlayerCommandBatch* batch) {
+	const std::vector<ReadCommand> read = round_trip(commands, batch);
+	BOOST_REQUIRE_EQUAL(read.size(), commands.size());
+	for (size_t i = 0; i < commands.size(); ++i) {
+		BOOST_CHECK_EQUAL(read[i].duetime, commands[i]->duetime());
+		BOOST_CHECK_EQUAL(read[i].command->sender(), commands[i]->sender());
+		BOOST_CHECK(serialized(read[i].command.get()) == serialized(commands[i].get()));
+	}
+}
+
+void check_round_trip(const std::vector<std::unique_ptr<Widelands::PlayerCommand>>& commands) {
+	PlayerCommandBatch batch;
+	check_round_trip(commands, &batch);
+}
+
+std::vector<std::unique_ptr<Widelands::PlayerCommand>>
+build_flags(const std::vector<int32_t>& duetimes) {
+	std::vector<std::unique_ptr<Widelands::PlayerCommand>> result;
+	for (size_t i = 0; i < duetimes.size(); ++i) {
+		const int16_t x = i;
+		result.emplace_back(
+		   new Widelands::CmdBuildFlag(duetimes[i], 1 + i % 8, Widelands::Coords(x, 2 * x)));
+	}
+	return result;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(unsigned_varint)
+
+BOOST_AUTO_TEST_CASE(sizes_at_the_7_bit_boundaries) {
+	BOOST_CHECK_EQUAL(encoded(0).size(), 1U);
+	BOOST_CHECK_EQUAL(encoded(0x7f).size(), 1U);
+	BOOST_CHECK_EQUAL(encoded(0x80).size(), 2U);
+	BOOST_CHECK_EQUAL(encoded(0x3fff).size(), 2U);
+	BOOST_CHECK_EQUAL(encoded(0x4000).size(), 3U);
+	BOOST_CHECK_EQUAL(encoded(0x1fffff).size(), 3U);
+	BOOST_CHECK_EQUAL(encoded(0x200000).size(), 4U);
+	BOOST_CHECK_EQUAL(encoded(0xfffffff).size(), 4U);
+	BOOST_CHECK_EQUAL(encoded(0x10000000).size(), 5U);
+	BOOST_CHECK_EQUAL(encoded(0xffffffff).size(), 5U);
+	BOOST_CHECK(encoded(0x80) == std::string("\x80\x01", 2));
+}
+
+BOOST_AUTO_TEST_CASE(round_trips) {
+	StringWrite sw;
+	std::vector<uint32_t> values;
+	for (uint32_t shift = 0; shift < 32; shift += 7) {
+		for (const uint32_t value : {(1U << shift) - 1, 1U << shift, (1U << shift) + 1}) {
+			values.push_back(value);
+		}
+	}
+	values.push_back(0xffffffff);
+	for (const uint32_t value : values) {
+		sw.unsigned_varint(value);
+	}
+
+	StringRead sr(sw.bytes);
+	for (const uint32_t value : values) {
+		BOOST_CHECK_EQUAL(sr.unsigned_varint(), value);
+	}
+	BOOST_CHECK(sr.end_of_file());
+}
+
+BOOST_AUTO_TEST_CASE(truncated_input) {
+	for (const uint32_t value : {0x80U, 0x4000U, 0x200000U, 0xffffffffU}) {
+		const std::string bytes = encoded(value);
+		for (size_t size = 0; size < bytes.size(); ++size) {
+			StringRead sr(bytes.substr(0, size));
+			BOOST_CHECK_THROW(sr.unsigned_varint(), StreamRead::DataError);
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(longer_than_5_bytes) {
+	StringRead sr(std::string("\x80\x80\x80\x80\x80\x01", 6));
+	BOOST_CHECK_THROW(sr.unsigned_varint(), StreamRead::DataError);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(player_command_batch)
+
+BOOST_AUTO_TEST_CASE(consecutive_duetimes) {
+	check_round_trip(build_flags({1000, 1001, 1002, 1003}));
+}
+
+BOOST_AUTO_TEST_CASE(equal_duetimes) {
+	check_round_trip(build_flags({5, 5, 5, 6, 6}));
+}
+
+BOOST_AUTO_TEST_CASE(out_of_order_duetimes) {
+	check_round_trip(build_flags({1000, 999, 500000, 3, 3, 0x7fffffff, 0}));
+}
+
+BOOST_AUTO_TEST_CASE(mixed_commands) {
+	std::vector<std::unique_ptr<Widelands::PlayerCommand>> commands = build_flags({20, 21});
+	commands.emplace_back(new Widelands::CmdBuild(21, 3, Widelands::Coords(7, 9), 4));
+	commands.emplace_back(new Widelands::CmdBuildFlag(300, 2, Widelands::Coords(511, 511)));
+	check_round_trip(commands);
+}
+
+BOOST_AUTO_TEST_CASE(batch_is_reused_after_write) {
+	PlayerCommandBatch batch;
+	check_round_trip(build_flags({10, 11}), &batch);
+	check_round_trip(build_flags({4, 8}), &batch);
+	check_round_trip(build_flags({4000}), &batch);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -29,9 +29,12 @@ enum class NoteId : uint32_t {
 	ChatMessage,
 	LogMessage,
 	Immovable,
+	FieldPlayerImmovableChanged,
 	ConstructionsiteEnhanced,
 	FieldPossession,
 	FieldTerrainChanged,
+	FieldsRecalculated,
+	FieldVisionChanged,
 	ProductionSiteOutOfResources,
 	TrainingSiteSoldierTrained,
 	Ship,
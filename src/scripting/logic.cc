@@ -19,10 +19,12 @@
 
 #include "scripting/logic.h"
 
+#include <chrono>
 #include <memory>
 
 #include <boost/algorithm/string/predicate.hpp>
 
+#include "base/log.h"
 #include "io/filesystem/layered_filesystem.h"
 #include "scripting/factory.h"
 #include "scripting/globals.h"
@@ -37,6 +39,7 @@
 #include "scripting/lua_ui.h"
 #include "scripting/persistence.h"
 #include "scripting/run_script.h"
+#include "wlapplication_options.h"
 
 namespace {
 
@@ -199,15 +202,23 @@ uint32_t LuaGameInterface::write_global_env(FileWrite& fw, Widelands::MapObjectS
 	// Clean out the garbage before writing.
 	lua_gc(lua_state_, LUA_GCCOLLECT, 0);
 
-	// Empty table + object to persist on the stack Stack
-	lua_newtable(lua_state_);
+	// Object to persist on the stack
 	lua_rawgeti(lua_state_, LUA_REGISTRYINDEX, LUA_RIDX_GLOBALS);
 
+	const auto start = std::chrono::steady_clock::now();
 	uint32_t nwritten = persist_object(lua_state_, fw, mos);
+	log("Persisting the Lua state: %u bytes in %ums\n", nwritten,
+	    static_cast<unsigned>(std::chrono::duration_cast<std::chrono::milliseconds>(
+	                             std::chrono::steady_clock::now() - start)
+	                             .count()));
+
+	if (get_config_bool("lua_persistence_report", false)) {
+		Widelands::MapObjectSaver report_mos;
+		log("Persisted size of the Lua globals:\n%s",
+		    persisted_globals_report(lua_state_, report_mos).c_str());
+	}
 
-	// Garbage collect once more, so we do not return unnecessary stuff.
-	lua_gc(lua_state_, LUA_GCCOLLECT, 0);
-
+	// The garbage that Eris left behind is collected incrementally.
 	return nwritten;
 }
 
@@ -19,13 +19,18 @@
 
 #include "scripting/lua_coroutine.h"
 
+#include <chrono>
 #include <memory>
 
+#include <boost/format.hpp>
+
+#include "base/log.h"
 #include "io/fileread.h"
 #include "io/filewrite.h"
 #include "scripting/lua_errors.h"
 #include "scripting/lua_game.h"
 #include "scripting/lua_map.h"
+#include "scripting/lua_profiler.h"
 
 namespace {
 
@@ -61,6 +66,8 @@ void unreference_coroutine(lua_State* L, uint32_t idx) {
 
 }  // namespace
 
+constexpr uint32_t LuaCoroutine::kTimeBudgetMs;
+
 LuaCoroutine::LuaCoroutine(lua_State* ms)
    : lua_state_(ms), idx_(LUA_REFNIL), ninput_args_(0), nreturn_values_(0) {
 	if (lua_state_) {
@@ -77,7 +84,22 @@ int LuaCoroutine::get_status() {
 }
 
 int LuaCoroutine::resume() {
+	// Only the first resume after creation or loading needs to look up the name.
+	name();
+	LuaProfiler::instance().begin_resume(lua_state_);
+	const auto start = std::chrono::steady_clock::now();
+
 	int rv = lua_resume(lua_state_, nullptr, ninput_args_);
+
+	const uint64_t duration_us = std::chrono::duration_cast<std::chrono::microseconds>(
+	                                std::chrono::steady_clock::now() - start)
+	                                .count();
+	LuaProfiler::instance().end_resume(lua_state_, name_, duration_us, rv != YIELDED);
+	if (duration_us > kTimeBudgetMs * 1000) {
+		log("WARNING: Lua coroutine %s ran for %.1f ms, more than its budget of %u ms\n",
+		    name_.c_str(), duration_us / 1000., kTimeBudgetMs);
+	}
+
 	ninput_args_ = 0;
 	nreturn_values_ = lua_gettop(lua_state_);
 
@@ -88,6 +110,36 @@ int LuaCoroutine::resume() {
 	return rv;
 }
 
+const std::string& LuaCoroutine::name() {
+	if (!name_.empty()) {
+		return name_;
+	}
+	lua_Debug ar;
+	if (lua_status(lua_state_) == LUA_OK) {
+		// Not started yet. The function is below the arguments on the stack.
+		const int function_index = lua_gettop(lua_state_) - ninput_args_;
+		if (function_index < 1 || !lua_isfunction(lua_state_, function_index)) {
+			name_ = "?";
+			return name_;
+		}
+		lua_pushvalue(lua_state_, function_index);
+		lua_getinfo(lua_state_, ">S", &ar);
+	} else {
+		// Suspended. The function is at the bottom of the call stack.
+		int level = 0;
+		while (lua_getstack(lua_state_, level + 1, &ar)) {
+			++level;
+		}
+		if (!lua_getstack(lua_state_, level, &ar)) {
+			name_ = "?";
+			return name_;
+		}
+		lua_getinfo(lua_state_, "S", &ar);
+	}
+	name_ = (boost::format("%s:%d") % ar.short_src % ar.linedefined).str();
+	return name_;
+}
+
 void LuaCoroutine::push_arg(const Widelands::Player* plr) {
 	to_lua<LuaGame::LuaPlayer>(lua_state_, new LuaGame::LuaPlayer(plr->player_number()));
 	ninput_args_++;
@@ -47,6 +47,9 @@ public:
 	// and can be deleted.
 	enum { DONE = 0, YIELDED = LUA_YIELD };
 
+	// A single resume should not take longer than this, because it stalls the game.
+	static constexpr uint32_t kTimeBudgetMs = 50;
+
 	explicit LuaCoroutine(lua_State* L);
 	virtual ~LuaCoroutine();
 
@@ -54,8 +57,12 @@ public:
 	int get_status();
 
 	// Resumes the coroutine and returns it's state after it did its execution.
+	// Logs a warning if this takes longer than 'kTimeBudgetMs'.
 	int resume();
 
+	// The file and line of the function that the coroutine runs.
+	const std::string& name();
+
 	// Push the given arguments onto the Lua stack, so that a Coroutine can
 	// receive them. This is for example used in the initialization scripts or
 	// in hooks.
@@ -81,6 +88,7 @@ private:
 	uint32_t nargs_;
 	uint32_t ninput_args_;
 	uint32_t nreturn_values_;
+	std::string name_;
 };
 
 #endif  // end of include guard: WL_SCRIPTING_LUA_COROUTINE_H
@@ -27,6 +27,7 @@
 #include "io/filesystem/layered_filesystem.h"
 #include "scripting/lua_globals.h"
 #include "scripting/lua_path.h"
+#include "scripting/lua_profiler.h"
 #include "scripting/lua_table.h"
 #include "scripting/run_script.h"
 
@@ -95,3 +96,8 @@ void LuaInterface::interpret_string(const std::string& cmd) {
 std::unique_ptr<LuaTable> LuaInterface::run_script(const std::string& path) {
 	return ::run_script(lua_state_, g_fs->fix_cross_file(path), g_fs);
 }
+
+void LuaInterface::set_profiling(const bool on) {
+	LuaProfiler::instance().set_enabled(on);
+	LuaProfiler::instance().install(lua_state_);
+}
@@ -40,6 +40,9 @@ public:
 	// Runs 'script' and returns the table it returned.
 	virtual std::unique_ptr<LuaTable> run_script(const std::string& script);
 
+	// Starts or stops the LuaProfiler and hooks it into this Lua state.
+	void set_profiling(bool on);
+
 protected:
 	lua_State* lua_state_;
 };
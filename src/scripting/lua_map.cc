@@ -19,6 +19,9 @@
 
 #include "scripting/lua_map.h"
 
+#include <algorithm>
+#include <functional>
+#include <limits>
 #include <memory>
 
 #include <boost/format.hpp>
@@ -104,6 +107,155 @@ bool check_has_caps(lua_State* L,
 	report_error(L, "Unknown caps queried: %s!", query.c_str());
 }
 
+// The conditions of a bulk field query, see LuaMap::count_fields().
+struct FieldFilter {
+	// Parses the optional filter table at 'index'.
+	FieldFilter(lua_State* L, int index) {
+		if (lua_gettop(L) < index || lua_isnil(L, index)) {
+			return;
+		}
+		luaL_checktype(L, index, LUA_TTABLE);
+		const EditorGameBase& egbase = get_egbase(L);
+		const World& world = egbase.world();
+
+		lua_getfield(L, index, "field");
+		if (!lua_isnil(L, -1)) {
+			has_area = true;
+			center = (*get_user_class<LuaField>(L, -1))->coords();
+		}
+		lua_pop(L, 1);
+
+		lua_getfield(L, index, "radius");
+		if (!lua_isnil(L, -1)) {
+			if (!has_area) {
+				report_error(L, "'radius' needs a 'field' to count from");
+			}
+			// Larger regions only wrap around the map again.
+			const uint32_t max_radius =
+			   std::max(egbase.map().get_width(), egbase.map().get_height());
+			const uint32_t value = luaL_checkuint32(L, -1);
+			if (value > max_radius) {
+				report_error(L, "'radius' must not be larger than %u", max_radius);
+			}
+			radius = value;
+		}
+		lua_pop(L, 1);
+
+		lua_getfield(L, index, "valuable");
+		valuable_only = !lua_isnil(L, -1) && luaL_checkboolean(L, -1);
+		lua_pop(L, 1);
+
+		lua_getfield(L, index, "owner");
+		if (!lua_isnil(L, -1)) {
+			match_owner = true;
+			const uint32_t value = luaL_checkuint32(L, -1);
+			if (value > egbase.map().get_nrplayers()) {
+				report_error(L, "'owner' must be 0 or one of the map's player numbers");
+			}
+			owner = value;
+		}
+		lua_pop(L, 1);
+
+		lua_getfield(L, index, "terrain");
+		if (!lua_isnil(L, -1)) {
+			const char* name = luaL_checkstring(L, -1);
+			terrain = world.terrains().get_index(name);
+			if (terrain == INVALID_INDEX) {
+				report_error(L, "Unknown terrain '%s'", name);
+			}
+		}
+		lua_pop(L, 1);
+
+		lua_getfield(L, index, "immovable_attribute");
+		if (!lua_isnil(L, -1)) {
+			match_attribute = true;
+			attribute = MapObjectDescr::get_attribute_id(luaL_checkstring(L, -1));
+		}
+		lua_pop(L, 1);
+
+		lua_getfield(L, index, "resource");
+		if (!lua_isnil(L, -1)) {
+			const char* name = luaL_checkstring(L, -1);
+			resource = world.get_resource(name);
+			if (resource == INVALID_INDEX) {
+				report_error(L, "Illegal resource: '%s'", name);
+			}
+		}
+		lua_pop(L, 1);
+
+		lua_getfield(L, index, "min_resource_amount");
+		if (!lua_isnil(L, -1)) {
+			const uint32_t value = luaL_checkuint32(L, -1);
+			if (value > std::numeric_limits<ResourceAmount>::max()) {
+				report_error(L, "'min_resource_amount' must not be larger than %u",
+				             std::numeric_limits<ResourceAmount>::max());
+			}
+			min_resource_amount = value;
+		}
+		lua_pop(L, 1);
+	}
+
+	bool matches(const FCoords& f) const {
+		if (match_owner && f.field->get_owned_by() != owner) {
+			return false;
+		}
+		if (terrain != INVALID_INDEX && f.field->terrain_r() != terrain &&
+		    f.field->terrain_d() != terrain) {
+			return false;
+		}
+		if (resource != INVALID_INDEX && (f.field->get_resources() != resource ||
+		                                  f.field->get_resources_amount() < min_resource_amount)) {
+			return false;
+		}
+		if (match_attribute) {
+			const BaseImmovable* imm = f.field->get_immovable();
+			if (imm == nullptr || !imm->has_attribute(attribute)) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// Calls 'callback' for every matching field. Walks the region if one was given, else the
+	// valuable fields or the whole map.
+	void for_each_match(const Map& map, const std::function<void(const FCoords&)>& callback) const {
+		if (has_area) {
+			MapRegion<Area<FCoords>> mr(map, Area<FCoords>(map.get_fcoords(center), radius));
+			do {
+				const FCoords& f = mr.location();
+				if ((!valuable_only || map.valuable_fields().count(f) == 1) && matches(f)) {
+					callback(f);
+				}
+			} while (mr.advance(map));
+		} else if (valuable_only) {
+			for (const FCoords& f : map.valuable_fields()) {
+				if (matches(f)) {
+					callback(f);
+				}
+			}
+		} else {
+			for (MapIndex i = 0; i < map.max_index(); ++i) {
+				const FCoords f = map.get_fcoords(map[i]);
+				if (matches(f)) {
+					callback(f);
+				}
+			}
+		}
+	}
+
+	bool has_area = false;
+	Coords center = Coords(0, 0);
+	uint16_t radius = 0;
+	bool valuable_only = false;
+	bool match_owner = false;
+	PlayerNumber owner = 0;
+	DescriptionIndex terrain = INVALID_INDEX;
+	bool match_attribute = false;
+	uint32_t attribute = 0;
+	DescriptionIndex resource = INVALID_INDEX;
+	ResourceAmount min_resource_amount = 1;
+};
+
 // Pushes a lua table with (name, count) pairs for the given 'ware_amount_container' on the
 // stack. The 'type' needs to be WARE or WORKER. Returns 1.
 int wares_or_workers_map_to_lua(lua_State* L,
@@ -1213,6 +1365,9 @@ const MethodType<LuaMap> LuaMap::Methods[] = {
    METHOD(LuaMap, count_conquerable_fields),
    METHOD(LuaMap, count_terrestrial_fields),
    METHOD(LuaMap, count_owned_valuable_fields),
+   METHOD(LuaMap, count_fields),
+   METHOD(LuaMap, count_fields_by_owner),
+   METHOD(LuaMap, find_fields),
    METHOD(LuaMap, place_immovable),
    METHOD(LuaMap, get_field),
    METHOD(LuaMap, recalculate),
@@ -1384,6 +1539,104 @@ int LuaMap::count_owned_valuable_fields(lua_State* L) {
 	return 1;
 }
 
+/* RST
+   .. method:: count_fields([filter])
+
+      (RO) Counts the fields that match all conditions in the filter table. This
+      is much faster than walking the fields with :meth:`get_field` or
+      :meth:`wl.map.Field.region` and checking them in Lua. All keys are optional:
+
+      .. code-block:: lua
+
+         {
+            -- Only check this field and the fields in the given radius around it
+            -- (default: the whole map). The radius can be at most the larger
+            -- one of the map's width and height.
+            field = map:get_field(10, 20), radius = 5,
+            -- Only check the fields found by count_conquerable_fields() or
+            -- count_terrestrial_fields().
+            valuable = true,
+            -- Player number of the owner, 0 for fields that nobody owns.
+            owner = 1,
+            -- Either of the field's two triangles has this terrain.
+            terrain = "summer_meadow1",
+            -- The field has an immovable with this attribute.
+            immovable_attribute = "tree",
+            -- The field has at least min_resource_amount (default: 1) of this resource.
+            resource = "coal", min_resource_amount = 5,
+         }
+
+      :arg filter: *Optional*. The conditions, see above.
+      :type filter: :class:`table`
+
+      :returns: An integer with the amount of matching fields.
+*/
+int LuaMap::count_fields(lua_State* L) {
+	const FieldFilter filter(L, 2);
+	uint32_t count = 0;
+	filter.for_each_match(get_egbase(L).map(), [&count](const FCoords&) { ++count; });
+	lua_pushuint32(L, count);
+	return 1;
+}
+
+/* RST
+   .. method:: count_fields_by_owner([filter])
+
+      (RO) Like :meth:`count_fields`, but counts the matching fields of each
+      owner separately.
+
+      :arg filter: *Optional*. The conditions, see :meth:`count_fields`.
+      :type filter: :class:`table`
+
+      :returns: A table mapping player numbers to their number of matching
+         fields. Fields that nobody owns are counted for player number 0. Players
+         without matching fields are not in the table.
+*/
+int LuaMap::count_fields_by_owner(lua_State* L) {
+	const FieldFilter filter(L, 2);
+	std::map<PlayerNumber, uint32_t> counts;
+	filter.for_each_match(get_egbase(L).map(), [&counts](const FCoords& f) {
+		++counts[f.field->get_owned_by()];
+	});
+
+	lua_newtable(L);
+	for (const auto& owner_count : counts) {
+		lua_pushinteger(L, owner_count.first);
+		lua_pushuint32(L, owner_count.second);
+		lua_settable(L, -3);
+	}
+	return 1;
+}
+
+/* RST
+   .. method:: find_fields([filter])
+
+      (RO) Collects the fields that match the filter, see :meth:`count_fields`.
+      To avoid creating a :class:`wl.map.Field` for each of them, the fields
+      are returned as their indices on the map. An index ``i`` belongs to the
+      field ``map:get_field(i % map.width, i // map.width)``.
+
+      :arg filter: *Optional*. The conditions, see :meth:`count_fields`.
+      :type filter: :class:`table`
+
+      :returns: An :class:`array` of integers.
+*/
+int LuaMap::find_fields(lua_State* L) {
+	const FieldFilter filter(L, 2);
+	const Map& map = get_egbase(L).map();
+	std::vector<MapIndex> indices;
+	filter.for_each_match(map, [&map, &indices](const FCoords& f) {
+		indices.push_back(map.get_index(f, map.get_width()));
+	});
+
+	lua_createtable(L, indices.size(), 0);
+	for (size_t i = 0; i < indices.size(); ++i) {
+		lua_pushuint32(L, indices[i]);
+		lua_rawseti(L, -2, i + 1);
+	}
+	return 1;
+}
+
 /* RST
    .. method:: place_immovable(name, field, from_where)
 
@@ -100,6 +100,9 @@ public:
 	int count_conquerable_fields(lua_State*);
 	int count_terrestrial_fields(lua_State*);
 	int count_owned_valuable_fields(lua_State*);
+	int count_fields(lua_State*);
+	int count_fields_by_owner(lua_State*);
+	int find_fields(lua_State*);
 	int place_immovable(lua_State*);
 	int get_field(lua_State*);
 	int recalculate(lua_State*);
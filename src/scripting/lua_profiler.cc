@@ -0,0 +1,299 @@
+/*
+ * Copyright (C) 2019 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include "scripting/lua_profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#include <boost/format.hpp>
+
+namespace {
+
+// The level of the function that is running in 'L', found with a binary search
+// like luaL_traceback does it. Only the public debug interface is used, so that
+// this does not depend on the internals of the Lua version.
+int stack_depth(lua_State* L) {
+	lua_Debug ar;
+	int low = 1;
+	int high = 1;
+	while (lua_getstack(L, high, &ar)) {
+		low = high;
+		high *= 2;
+	}
+	while (low < high) {
+		const int middle = (low + high) / 2;
+		if (lua_getstack(L, middle, &ar)) {
+			low = middle + 1;
+		} else {
+			high = middle;
+		}
+	}
+	return high - 1;
+}
+
+}  // namespace
+
+constexpr int LuaProfiler::kInstructionsPerSample;
+
+// static
+LuaProfiler& LuaProfiler::instance() {
+	static LuaProfiler profiler;
+	return profiler;
+}
+
+void LuaProfiler::set_enabled(const bool enabled) {
+	enabled_ = enabled;
+	threads_.clear();
+	resumed_ = nullptr;
+	if (enabled_) {
+		functions_.clear();
+		function_indices_.clear();
+		coroutines_.clear();
+		start_us_ = now_us();
+	}
+}
+
+void LuaProfiler::install(lua_State* L) {
+	if (enabled_) {
+		lua_sethook(L, &LuaProfiler::hook, LUA_MASKCALL | LUA_MASKRET | LUA_MASKCOUNT,
+		            kInstructionsPerSample);
+	} else if (lua_gethook(L) == &LuaProfiler::hook) {
+		lua_sethook(L, nullptr, 0, 0);
+	}
+}
+
+void LuaProfiler::begin_resume(lua_State* L) {
+	install(L);
+	if (!enabled_) {
+		return;
+	}
+	resumed_ = L;
+	resumed_instructions_ = 0;
+
+	// Do not count the time that the coroutine was suspended for its open calls.
+	ThreadState& thread = threads_[L];
+	if (thread.suspended_us > 0) {
+		const uint64_t suspended = now_us() - thread.suspended_us;
+		for (Frame& frame : thread.frames) {
+			frame.start_us += suspended;
+		}
+		thread.suspended_us = 0;
+	}
+}
+
+void LuaProfiler::end_resume(lua_State* L,
+                             const std::string& name,
+                             const uint64_t duration_us,
+                             const bool finished) {
+	if (!enabled_) {
+		return;
+	}
+	CoroutineStats& stats = coroutines_[name];
+	++stats.resumes;
+	stats.total_us += duration_us;
+	stats.max_us = std::max(stats.max_us, duration_us);
+	stats.instructions += resumed_instructions_;
+	resumed_ = nullptr;
+
+	if (finished) {
+		threads_.erase(L);
+	} else {
+		threads_[L].suspended_us = now_us();
+	}
+}
+
+// static
+void LuaProfiler::hook(lua_State* L, lua_Debug* ar) {
+	LuaProfiler& profiler = instance();
+	if (!profiler.enabled_) {
+		return;
+	}
+	const uint64_t now = profiler.now_us();
+	switch (ar->event) {
+	case LUA_HOOKCALL:
+		profiler.on_call(L, ar, now);
+		break;
+	case LUA_HOOKTAILCALL:
+		// The called function takes over the stack slot of the caller, which will
+		// not get a return event of its own.
+		profiler.on_return(L, ar, now);
+		profiler.on_call(L, ar, now);
+		break;
+	case LUA_HOOKRET:
+		profiler.on_return(L, ar, now);
+		break;
+	case LUA_HOOKCOUNT:
+		profiler.on_count(L);
+		break;
+	default:
+		break;
+	}
+}
+
+void LuaProfiler::on_call(lua_State* L, lua_Debug* ar, const uint64_t now) {
+	const int depth = stack_depth(L);
+	ThreadState& thread = threads_[L];
+	drop_frames(&thread, depth);
+
+	const size_t function = function_index(L, ar);
+	++functions_[function].calls;
+	const bool outermost = thread.active_calls[function]++ == 0;
+	thread.frames.push_back(Frame{function, depth, now, 0, outermost});
+}
+
+void LuaProfiler::on_return(lua_State* L, lua_Debug*, const uint64_t now) {
+	auto thread = threads_.find(L);
+	if (thread == threads_.end()) {
+		return;
+	}
+	const int depth = stack_depth(L);
+	drop_frames(&thread->second, depth + 1);
+	std::vector<Frame>& frames = thread->second.frames;
+	if (frames.empty() || frames.back().depth != depth) {
+		return;
+	}
+	const Frame frame = frames.back();
+	frames.pop_back();
+	--thread->second.active_calls[frame.function];
+
+	const uint64_t total = now - frame.start_us;
+	FunctionStats& stats = functions_[frame.function];
+	// The inner calls of a recursion are part of the outermost one.
+	if (frame.outermost) {
+		stats.total_us += total;
+	}
+	stats.self_us += total - std::min(total, frame.child_us);
+	if (!frames.empty()) {
+		frames.back().child_us += total;
+	}
+}
+
+void LuaProfiler::on_count(lua_State* L) {
+	if (resumed_ != nullptr) {
+		resumed_instructions_ += kInstructionsPerSample;
+	}
+	auto thread = threads_.find(L);
+	if (thread != threads_.end() && !thread->second.frames.empty()) {
+		functions_[thread->second.frames.back().function].instructions += kInstructionsPerSample;
+	}
+}
+
+void LuaProfiler::drop_frames(ThreadState* thread, const int min_depth) {
+	while (!thread->frames.empty() && thread->frames.back().depth >= min_depth) {
+		--thread->active_calls[thread->frames.back().function];
+		thread->frames.pop_back();
+	}
+}
+
+size_t LuaProfiler::function_index(lua_State* L, lua_Debug* ar) {
+	lua_getinfo(L, "Sf", ar);
+	const bool is_c = std::strcmp(ar->what, "C") == 0;
+	const std::pair<const void*, int> key =
+	   is_c ? std::make_pair(lua_topointer(L, -1), -1) :
+	          std::make_pair(static_cast<const void*>(ar->source), ar->linedefined);
+	lua_pop(L, 1);
+
+	const auto it = function_indices_.find(key);
+	if (it != function_indices_.end()) {
+		return it->second;
+	}
+
+	// The name is the one that the first caller used.
+	lua_getinfo(L, "n", ar);
+	FunctionStats stats;
+	if (is_c) {
+		stats.file = "[C]";
+		stats.name = (boost::format("%s [C]") % (ar->name != nullptr ? ar->name : "?")).str();
+	} else {
+		stats.file = ar->short_src;
+		stats.name = (boost::format("%s:%d") % ar->short_src % ar->linedefined).str();
+		if (ar->name != nullptr) {
+			stats.name += (boost::format(" (%s)") % ar->name).str();
+		}
+	}
+	functions_.push_back(stats);
+	function_indices_.emplace(key, functions_.size() - 1);
+	return functions_.size() - 1;
+}
+
+std::string LuaProfiler::report(const size_t max_rows) const {
+	std::string result =
+	   (boost::format("Lua profile of %.1f s\n") % ((now_us() - start_us_) / 1000000.)).str();
+
+	std::vector<std::pair<std::string, CoroutineStats>> coroutines(
+	   coroutines_.begin(), coroutines_.end());
+	std::sort(coroutines.begin(), coroutines.end(),
+	          [](const std::pair<std::string, CoroutineStats>& a,
+	             const std::pair<std::string, CoroutineStats>& b) {
+		          return a.second.total_us > b.second.total_us;
+		       });
+	result += "\nCoroutines:\n   resumes   total ms     max ms  instructions  coroutine\n";
+	for (size_t i = 0; i < coroutines.size() && i < max_rows; ++i) {
+		const CoroutineStats& stats = coroutines[i].second;
+		result += (boost::format("%10u %10.1f %10.1f %13u  %s\n") % stats.resumes %
+		           (stats.total_us / 1000.) % (stats.max_us / 1000.) % stats.instructions %
+		           coroutines[i].first)
+		             .str();
+	}
+
+	std::map<std::string, FunctionStats> files;
+	for (const FunctionStats& function : functions_) {
+		FunctionStats& file = files[function.file];
+		file.self_us += function.self_us;
+		file.instructions += function.instructions;
+	}
+	std::vector<std::pair<std::string, FunctionStats>> sorted_files(files.begin(), files.end());
+	std::sort(sorted_files.begin(), sorted_files.end(),
+	          [](const std::pair<std::string, FunctionStats>& a,
+	             const std::pair<std::string, FunctionStats>& b) {
+		          return a.second.self_us > b.second.self_us;
+		       });
+	result += "\nScript files:\n   self ms  instructions  file\n";
+	for (size_t i = 0; i < sorted_files.size() && i < max_rows; ++i) {
+		const FunctionStats& stats = sorted_files[i].second;
+		result += (boost::format("%10.1f %13u  %s\n") % (stats.self_us / 1000.) %
+		           stats.instructions % sorted_files[i].first)
+		             .str();
+	}
+
+	std::vector<const FunctionStats*> functions;
+	for (const FunctionStats& function : functions_) {
+		functions.push_back(&function);
+	}
+	std::sort(
+	   functions.begin(), functions.end(),
+	   [](const FunctionStats* a, const FunctionStats* b) { return a->self_us > b->self_us; });
+	result += "\nFunctions:\n     calls   total ms    self ms  instructions  function\n";
+	for (size_t i = 0; i < functions.size() && i < max_rows; ++i) {
+		const FunctionStats& stats = *functions[i];
+		result += (boost::format("%10u %10.1f %10.1f %13u  %s\n") % stats.calls %
+		           (stats.total_us / 1000.) % (stats.self_us / 1000.) % stats.instructions %
+		           stats.name)
+		             .str();
+	}
+	return result;
+}
+
+uint64_t LuaProfiler::now_us() const {
+	return std::chrono::duration_cast<std::chrono::microseconds>(
+	          std::chrono::steady_clock::now().time_since_epoch())
+	   .count();
+}
@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2019 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#ifndef WL_SCRIPTING_LUA_PROFILER_H
+#define WL_SCRIPTING_LUA_PROFILER_H
+
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <stdint.h>
+
+#include "base/macros.h"
+#include "scripting/lua.h"
+
+/**
+ * Attributes the time and the number of instructions spent in Lua to
+ * coroutines, script files and functions.
+ *
+ * Functions are timed with the call and return hooks of 'lua_sethook', and
+ * instructions are counted with its count hook, in steps of
+ * 'kInstructionsPerSample'. The hooks are installed on the main Lua state by
+ * 'install' and on every coroutine that LuaCoroutine::resume() resumes, and
+ * Lua passes them on to coroutines that are created by scripts. Time that a
+ * coroutine spends suspended is not counted, but only for coroutines that are
+ * resumed by LuaCoroutine.
+ *
+ * The hooks make Lua several times slower, so the profiler is off unless it
+ * is started from the debug console.
+ */
+class LuaProfiler {
+public:
+	static constexpr int kInstructionsPerSample = 1000;
+
+	static LuaProfiler& instance();
+
+	bool enabled() const {
+		return enabled_;
+	}
+
+	// Enabling starts a fresh recording.
+	void set_enabled(bool enabled);
+
+	// Installs the hooks on 'L' if the profiler is enabled, else removes them.
+	void install(lua_State* L);
+
+	// Called by LuaCoroutine::resume() around lua_resume(). 'name' identifies
+	// the coroutine in the report.
+	void begin_resume(lua_State* L);
+	void end_resume(lua_State* L, const std::string& name, uint64_t duration_us, bool finished);
+
+	// A table of the coroutines, files and functions that took the most time,
+	// with at most 'max_rows' rows per section.
+	std::string report(size_t max_rows) const;
+
+private:
+	friend struct LuaProfilerFixture;  // Checks the recorded functions.
+
+	// The time of a recursive function is counted once in 'total_us', from its
+	// outermost call.
+	struct FunctionStats {
+		std::string name;
+		std::string file;
+		uint64_t calls = 0;
+		uint64_t total_us = 0;
+		uint64_t self_us = 0;
+		uint64_t instructions = 0;
+	};
+
+	struct CoroutineStats {
+		uint64_t resumes = 0;
+		uint64_t total_us = 0;
+		uint64_t max_us = 0;
+		uint64_t instructions = 0;
+	};
+
+	// A function call that has not returned yet.
+	struct Frame {
+		size_t function;
+		// The number of levels on the Lua stack below the call, so that the return
+		// can be matched to it even if an error skipped the returns of the
+		// functions it called.
+		int depth;
+		uint64_t start_us;
+		uint64_t child_us;
+		// Whether no other call of the function was open when this one started.
+		bool outermost;
+	};
+
+	// The calls of one Lua thread.
+	struct ThreadState {
+		std::vector<Frame> frames;
+		// The number of open frames per function.
+		std::unordered_map<size_t, uint32_t> active_calls;
+		uint64_t suspended_us = 0;
+	};
+
+	LuaProfiler() = default;
+
+	static void hook(lua_State* L, lua_Debug* ar);
+	void on_call(lua_State* L, lua_Debug* ar, uint64_t now);
+	void on_return(lua_State* L, lua_Debug* ar, uint64_t now);
+	void on_count(lua_State* L);
+	// Forgets the frames at 'min_depth' or deeper, which were left by an error.
+	void drop_frames(ThreadState* thread, int min_depth);
+	size_t function_index(lua_State* L, lua_Debug* ar);
+	uint64_t now_us() const;
+
+	bool enabled_ = false;
+	uint64_t start_us_ = 0;
+	std::vector<FunctionStats> functions_;
+	// Lua functions are keyed by their source and first line, C functions by
+	// their address.
+	std::map<std::pair<const void*, int>, size_t> function_indices_;
+	std::map<std::string, CoroutineStats> coroutines_;
+	std::unordered_map<lua_State*, ThreadState> threads_;
+	// The thread that LuaCoroutine is resuming, or nullptr.
+	lua_State* resumed_ = nullptr;
+	uint64_t resumed_instructions_ = 0;
+
+	DISALLOW_COPY_AND_ASSIGN(LuaProfiler);
+};
+
+#endif  // end of include guard: WL_SCRIPTING_LUA_PROFILER_H
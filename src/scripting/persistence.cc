@@ -19,12 +19,18 @@
 
 #include "scripting/persistence.h"
 
+#include <algorithm>
+#include <chrono>
 #include <memory>
+#include <vector>
+
+#include <boost/format.hpp>
 
 #include "base/log.h"
 #include "io/fileread.h"
 #include "io/filewrite.h"
 #include "scripting/eris.h"
+#include "scripting/lua_errors.h"
 #include "scripting/luna_impl.h"
 
 /*
@@ -47,6 +53,11 @@ int LuaWriter(lua_State* /* L */, const void* write_data, size_t len, void* user
 	return 0;
 }
 
+int LuaCountingWriter(lua_State* /* L */, const void* /* write_data */, size_t len, void* userdata) {
+	*static_cast<size_t*>(userdata) += len;
+	return 0;
+}
+
 const char* LuaReader(lua_State* /* L */, void* userdata, size_t* bytes_read) {
 	const LuaReaderHelper& helper = *static_cast<LuaReaderHelper*>(userdata);
 
@@ -54,14 +65,49 @@ const char* LuaReader(lua_State* /* L */, void* userdata, size_t* bytes_read) {
 	return helper.data.get();
 }
 
+// Registry fields that cache the table of permanent objects between saves. The
+// values are also kept in an array, so that we notice when a global changed.
+const char* kPermanentsCache = "persist_permanents";
+const char* kPermanentValuesCache = "persist_permanent_values";
+
+struct DumpTarget {
+	lua_Writer writer;
+	void* userdata;
+};
+
+// Called in protected mode with S: permanents object target, so that errors
+// in Eris do not bring down the game.
+int protected_dump(lua_State* L) {
+	const DumpTarget& target = *static_cast<DumpTarget*>(lua_touserdata(L, 3));
+	lua_settop(L, 2);
+	eris_dump(L, target.writer, target.userdata);
+	return 0;
+}
+
+// Dumps the object at the top of the stack with the permanents at the absolute
+// index 'permanents' and pops it. Returns the error message, or an empty string
+// on success.
+std::string dump(lua_State* L, int permanents, DumpTarget target) {
+	lua_pushcfunction(L, &protected_dump);
+	lua_pushvalue(L, permanents);
+	lua_pushvalue(L, -3);
+	lua_pushlightuserdata(L, &target);
+	std::string error;
+	if (lua_pcall(L, 3, 0, 0) != LUA_OK) {
+		error = lua_tostring(L, -1);
+		lua_pop(L, 1);
+	}
+	lua_pop(L, 1);
+	return error;
+}
+
 }  // namespace
 
 /**
- * Add one object to the table of objects that should not
- * be touched. Returns true if the object was non nil and
- * therefore stored, false otherwise.
+ * Pushes the global 'name' onto the stack. 'name' can also be a field of a
+ * global table, like "coroutine.yield".
  */
-static bool add_object_to_not_persist(lua_State* L, std::string name, uint32_t nidx) {
+static void push_global(lua_State* L, std::string name) {
 	// Search for a dot. If one is found, we first have
 	// to get the global module.
 	std::string::size_type pos = name.find('.');
@@ -70,39 +116,23 @@ static bool add_object_to_not_persist(lua_State* L, std::string name, uint32_t n
 		std::string table = name.substr(0, pos);
 		name = name.substr(pos + 1);
 
-		lua_getglobal(L, table.c_str());  // table object table
+		lua_getglobal(L, table.c_str());  // S: table
 		assert(!lua_isnil(L, -1));
 
-		lua_getfield(L, -1, name.c_str());  // table object table function
-		if (lua_isnil(L, -1)) {
-			lua_pop(L, 1);
-			return false;
-		}
-
-		lua_pushint32(L, nidx);  // table object table function int
-		lua_settable(L, 1);      //  newtable[function] = int
-		lua_pop(L, 1);           // pop tabltable
+		lua_getfield(L, -1, name.c_str());  // S: table function
+		lua_remove(L, -2);                  // S: function
 	} else {
-		lua_getglobal(L, name.c_str());  // stack: table object value
-		if (lua_isnil(L, -1)) {
-			lua_pop(L, 1);
-			return false;
-		}
-		lua_pushint32(L, nidx);  // stack: table object value int
-		lua_settable(L, 1);      //  table[symbol] = integer
+		lua_getglobal(L, name.c_str());  // S: value
 	}
-	return true;
 }
 
 // Special handling for the upvalues of pairs and ipairs which are iterator
 // functions, but always the same and therefor need not be persisted (in fact
 // they are c functions, so they can't be persisted all the same)
-static void add_iterator_function_to_not_persist(lua_State* L, std::string global, uint32_t idx) {
+static void push_iterator_function(lua_State* L, std::string global) {
 	lua_getglobal(L, global.c_str());
 	lua_newtable(L);
 	lua_call(L, 1, 1);  // pairs{}, stack now contains iterator function
-	lua_pushuint32(L, idx);
-	lua_settable(L, 1);  //  table[function] = integer
 }
 
 static bool add_object_to_not_unpersist(lua_State* L, std::string name, uint32_t idx) {
@@ -203,43 +233,104 @@ static const char* kPersistentGlobals[] = {"_VERSION",
                                            nullptr};
 
 /**
- * Does all the persisting work. Returns the number of bytes
- * written
+ * Pushes the table of objects that are not persisted, but looked up again when
+ * loading, and returns its absolute stack index. The table maps each object to
+ * its index in the order of unpersist_object(). It is cached in the registry
+ * and only built again when one of the objects has changed since the last save.
  */
-uint32_t persist_object(lua_State* L, FileWrite& fw, Widelands::MapObjectSaver& mos) {
-	assert(lua_gettop(L) == 2);  // S: globals_table object
-
-	// Save a reference to the object saver
-	lua_pushlightuserdata(L, &mos);
-	lua_setfield(L, LUA_REGISTRYINDEX, "mos");
-
-	// Push objects that should not be touched while persisting into the empty
-	// table at stack position 1
-	uint32_t i = 1;
+static int push_permanents(lua_State* L) {
+	// S: ... current
+	lua_newtable(L);
+	const int current = lua_gettop(L);
+	uint32_t nr_permanents = 0;
 
 	// First, the restore function for __persist.
 	lua_pushcfunction(L, &luna_unpersisting_closure);
-	lua_pushuint32(L, i++);
-	lua_settable(L, 1);
+	lua_rawseti(L, current, ++nr_permanents);
 
 	// Now the iterators functions.
-	add_iterator_function_to_not_persist(L, "pairs", i++);
-	add_iterator_function_to_not_persist(L, "ipairs", i++);
+	push_iterator_function(L, "pairs");
+	lua_rawseti(L, current, ++nr_permanents);
+	push_iterator_function(L, "ipairs");
+	lua_rawseti(L, current, ++nr_permanents);
 
 	// And finally the globals.
 	for (int j = 0; kPersistentGlobals[j]; ++j) {
-		add_object_to_not_persist(L, kPersistentGlobals[j], i++);
+		push_global(L, kPersistentGlobals[j]);
+		lua_rawseti(L, current, ++nr_permanents);
+	}
+
+	lua_getfield(L, LUA_REGISTRYINDEX, kPermanentValuesCache);  // S: ... current cached
+	bool unchanged = lua_istable(L, -1);
+	for (uint32_t i = 1; unchanged && i <= nr_permanents; ++i) {
+		lua_rawgeti(L, current, i);
+		lua_rawgeti(L, -2, i);
+		unchanged = lua_rawequal(L, -1, -2);
+		lua_pop(L, 2);
+	}
+	lua_pop(L, 1);  // S: ... current
+
+	if (unchanged) {
+		lua_pop(L, 1);
+		lua_getfield(L, LUA_REGISTRYINDEX, kPermanentsCache);
+		return lua_gettop(L);
+	}
+
+	lua_newtable(L);  // S: ... current permanents
+	for (uint32_t i = 1; i <= nr_permanents; ++i) {
+		lua_rawgeti(L, current, i);
+		if (lua_isnil(L, -1)) {
+			lua_pop(L, 1);
+			continue;
+		}
+		lua_pushuint32(L, i);
+		lua_rawset(L, -3);  //  permanents[object] = index
 	}
+	lua_pushvalue(L, -1);
+	lua_setfield(L, LUA_REGISTRYINDEX, kPermanentsCache);
+	lua_insert(L, current);  // S: ... permanents current
+	lua_setfield(L, LUA_REGISTRYINDEX, kPermanentValuesCache);
+	return lua_gettop(L);
+}
 
-	// The next few lines make eris error messages much more useful, but make
-	// eris much slower too. Only enable if you need more debug information.
-	lua_pushboolean(L, true);
+/**
+ * Does all the persisting work. Returns the number of bytes
+ * written
+ */
+uint32_t persist_object(lua_State* L, FileWrite& fw, Widelands::MapObjectSaver& mos) {
+	assert(lua_gettop(L) == 1);  // S: object
+
+	// Save a reference to the object saver
+	lua_pushlightuserdata(L, &mos);
+	lua_setfield(L, LUA_REGISTRYINDEX, "mos");
+
+	push_permanents(L);  // S: object permanents
+	lua_insert(L, 1);    // S: permanents object
+	const int permanents = 1;
+
+	// Eris is much faster without tracking the path to the object that it is
+	// persisting, so we only do so to explain an error.
+	lua_pushboolean(L, false);
 	eris_set_setting(L, "path", lua_gettop(L));
 	lua_pop(L, 1);
 
-	size_t cpos = fw.get_pos();
-	eris_dump(L, &LuaWriter, &fw);
-	uint32_t nwritten = fw.get_pos() - cpos;
+	const size_t cpos = fw.get_pos();
+	lua_pushvalue(L, 2);
+	std::string error = dump(L, permanents, DumpTarget{&LuaWriter, &fw});
+	const uint32_t nwritten = fw.get_pos() - cpos;
+	if (!error.empty()) {
+		// The save is aborted anyway, so we only need the better error message.
+		lua_pushboolean(L, true);
+		eris_set_setting(L, "path", lua_gettop(L));
+		lua_pop(L, 1);
+		size_t ignored = 0;
+		lua_pushvalue(L, 2);
+		const std::string detailed_error =
+		   dump(L, permanents, DumpTarget{&LuaCountingWriter, &ignored});
+		if (!detailed_error.empty()) {
+			error = detailed_error;
+		}
+	}
 
 	lua_pop(L, 2);  // pop the object and the table
 
@@ -247,9 +338,63 @@ uint32_t persist_object(lua_State* L, FileWrite& fw, Widelands::MapObjectSaver&
 	lua_pushnil(L);
 	lua_setfield(L, LUA_REGISTRYINDEX, "mos");
 
+	if (!error.empty()) {
+		throw LuaError(error);
+	}
 	return nwritten;
 }
 
+std::string persisted_globals_report(lua_State* L, Widelands::MapObjectSaver& mos) {
+	struct GlobalSize {
+		std::string name;
+		size_t bytes;
+		uint64_t duration_us;
+		std::string error;
+	};
+	std::vector<GlobalSize> globals;
+
+	lua_pushlightuserdata(L, &mos);
+	lua_setfield(L, LUA_REGISTRYINDEX, "mos");
+	const int permanents = push_permanents(L);  // S: permanents
+
+	lua_rawgeti(L, LUA_REGISTRYINDEX, LUA_RIDX_GLOBALS);  // S: permanents globals
+	lua_pushnil(L);
+	while (lua_next(L, -2) != 0) {  // S: permanents globals key value
+		lua_pushvalue(L, -1);
+		lua_rawget(L, permanents);
+		const bool is_permanent = !lua_isnil(L, -1);
+		lua_pop(L, 1);
+		if (is_permanent || lua_type(L, -2) != LUA_TSTRING) {
+			lua_pop(L, 1);
+			continue;
+		}
+
+		GlobalSize global{lua_tostring(L, -2), 0, 0, ""};
+		const auto start = std::chrono::steady_clock::now();
+		global.error = dump(L, permanents, DumpTarget{&LuaCountingWriter, &global.bytes});
+		global.duration_us = std::chrono::duration_cast<std::chrono::microseconds>(
+		                        std::chrono::steady_clock::now() - start)
+		                        .count();
+		globals.push_back(global);
+	}
+	lua_pop(L, 2);
+
+	lua_pushnil(L);
+	lua_setfield(L, LUA_REGISTRYINDEX, "mos");
+
+	std::sort(globals.begin(), globals.end(), [](const GlobalSize& a, const GlobalSize& b) {
+		return a.bytes > b.bytes;
+	});
+	std::string result = "     bytes       ms  global\n";
+	for (const GlobalSize& global : globals) {
+		result += (boost::format("%10u %8.1f  %s%s\n") % global.bytes %
+		           (global.duration_us / 1000.) % global.name %
+		           (global.error.empty() ? "" : " (error: " + global.error + ")"))
+		             .str();
+	}
+	return result;
+}
+
 void unpersist_object(lua_State* L, FileRead& fr, Widelands::MapObjectLoader& mol, uint32_t size) {
 	assert(lua_gettop(L) == 0);  // S:
 
@@ -35,12 +35,20 @@ class Game;
 }  // namespace Widelands
 
 /**
- * This persists the lua object at the stack position
- * 2 after populating the (empty) table at position 1
- * with the items given in globals.
+ * This persists the lua object at the stack position 1 and pops it. The
+ * globals that are restored by name when loading are not persisted. Throws
+ * LuaError if the object cannot be persisted.
  */
 uint32_t persist_object(lua_State* L, FileWrite&, Widelands::MapObjectSaver&);
 
+/**
+ * Persists each global on its own into nowhere and returns a table with the
+ * number of bytes and the time that each global takes, largest first. Objects
+ * that can be reached from several globals count for each of them. Map objects
+ * are registered with 'mos', so pass one that is not used for saving.
+ */
+std::string persisted_globals_report(lua_State* L, Widelands::MapObjectSaver& mos);
+
 // Does all the unpersisting work. The unpersisted object is at the top of the
 // stack after the function returns.
 void unpersist_object(lua_State* L, FileRead& fr, Widelands::MapObjectLoader& mol, uint32_t size);
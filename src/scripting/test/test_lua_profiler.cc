@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2019 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include <chrono>
+#include <string>
+
+#include <boost/test/unit_test.hpp>
+
+#include "base/macros.h"
+#include "scripting/lua.h"
+#include "scripting/lua_profiler.h"
+
+// Triggered by BOOST_AUTO_TEST_CASE
+CLANG_DIAG_OFF("-Wdisabled-macro-expansion")
+CLANG_DIAG_OFF("-Wused-but-marked-unused")
+
+namespace {
+
+uint64_t now_us() {
+	return std::chrono::duration_cast<std::chrono::microseconds>(
+	          std::chrono::steady_clock::now().time_since_epoch())
+	   .count();
+}
+
+}  // namespace
+
+/// Runs scripts on a fresh Lua state with the profiler enabled.
+struct LuaProfilerFixture {
+	LuaProfilerFixture() : L(luaL_newstate()) {
+		luaL_openlibs(L);
+		LuaProfiler::instance().set_enabled(true);
+		LuaProfiler::instance().install(L);
+	}
+	~LuaProfilerFixture() {
+		LuaProfiler::instance().set_enabled(false);
+		lua_close(L);
+	}
+
+	// Runs 'script' and stops the profiler. Returns the wall time in us.
+	uint64_t run(const char* script) {
+		const uint64_t start_us = now_us();
+		BOOST_REQUIRE_EQUAL(luaL_dostring(L, script), 0);
+		const uint64_t wall_us = now_us() - start_us;
+		LuaProfiler::instance().set_enabled(false);
+		LuaProfiler::instance().install(L);
+		return wall_us;
+	}
+
+	const LuaProfiler::FunctionStats* find_function(const std::string& name) const {
+		for (const LuaProfiler::FunctionStats& function : LuaProfiler::instance().functions_) {
+			if (function.name.find(name) != std::string::npos) {
+				return &function;
+			}
+		}
+		return nullptr;
+	}
+
+	lua_State* L;
+};
+
+BOOST_FIXTURE_TEST_SUITE(lua_profiler, LuaProfilerFixture)
+
+BOOST_AUTO_TEST_CASE(recursion_is_counted_once) {
+	const char* script = "function recurse(depth)\n"
+	                     "   local sum = 0\n"
+	                     "   for i = 1, 2000 do sum = sum + i end\n"
+	                     "   if depth > 0 then sum = sum + recurse(depth - 1) end\n"
+	                     "   return sum\n"
+	                     "end\n"
+	                     "recurse(100)\n";
+	const uint64_t wall_us = run(script);
+
+	const auto* recurse = find_function("(recurse)");
+	BOOST_REQUIRE(recurse != nullptr);
+	BOOST_CHECK_EQUAL(recurse->calls, 101u);
+	BOOST_CHECK_LE(recurse->self_us, recurse->total_us);
+	BOOST_CHECK_LE(recurse->total_us, wall_us);
+}
+
+BOOST_AUTO_TEST_CASE(errors_do_not_leave_calls_open) {
+	// The error skips the returns of 'fail', so its later calls must still be
+	// counted as outermost ones.
+	const char* script = "function fail(depth)\n"
+	                     "   if depth == 0 then error('failed') end\n"
+	                     "   fail(depth - 1)\n"
+	                     "end\n"
+	                     "local caught = 0\n"
+	                     "for i = 1, 10 do\n"
+	                     "   if not pcall(function() fail(5) end) then\n"
+	                     "      caught = caught + 1\n"
+	                     "   end\n"
+	                     "end\n"
+	                     "assert(caught == 10)\n";
+	const uint64_t wall_us = run(script);
+
+	const auto* fail = find_function("(fail)");
+	BOOST_REQUIRE(fail != nullptr);
+	BOOST_CHECK_EQUAL(fail->calls, 60u);
+	BOOST_CHECK_LE(fail->total_us, wall_us);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
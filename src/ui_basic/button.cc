@@ -123,6 +123,7 @@ void Button::set_pic(const Image* pic) {
 		return;
 
 	title_image_ = pic;
+	invalidate_drawing();
 }
 
 /**
@@ -134,6 +135,7 @@ void Button::set_title(const std::string& title) {
 
 	title_image_ = nullptr;
 	title_ = title;
+	invalidate_drawing();
 }
 
 /**
@@ -156,6 +158,7 @@ void Button::set_enabled(bool const on) {
 		enabled_ = false;
 		highlighted_ = false;
 	}
+	invalidate_drawing();
 }
 
 /**
@@ -353,10 +356,12 @@ bool Button::handle_mousemove(const uint8_t, int32_t, int32_t, int32_t, int32_t)
 
 void Button::set_visual_state(UI::Button::VisualState input_state) {
 	visual_state_ = input_state;
+	invalidate_drawing();
 }
 
 void Button::set_disable_style(UI::ButtonDisableStyle input_style) {
 	disable_style_ = input_style;
+	invalidate_drawing();
 }
 
 void Button::set_perm_pressed(bool pressed) {
@@ -366,6 +371,7 @@ void Button::set_perm_pressed(bool pressed) {
 
 void Button::set_style(UI::ButtonStyle bstyle) {
 	style_ = &g_gr->styles().button_style(bstyle);
+	invalidate_drawing();
 }
 
 void Button::toggle() {
@@ -88,6 +88,7 @@ private:
 		flags_ &= ~flags;
 		if (enable)
 			flags_ |= flags;
+		invalidate_drawing();
 	}
 	const Image* pic_graphics_;
 	std::shared_ptr<const UI::RenderedText> rendered_text_;
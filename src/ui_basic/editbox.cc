@@ -143,6 +143,7 @@ void EditBox::set_text(const std::string& t) {
 		m_->text.erase(m_->text.begin() + m_->maxLength, m_->text.end());
 	if (caretatend || m_->caret > m_->text.size())
 		m_->caret = m_->text.size();
+	invalidate_drawing();
 }
 
 /**
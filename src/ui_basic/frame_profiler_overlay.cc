@@ -0,0 +1,186 @@
+/*
+ * Copyright (C) 2019 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include "ui_basic/frame_profiler_overlay.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/format.hpp>
+
+#include "base/frame_profiler.h"
+#include "graphic/font_handler.h"
+#include "graphic/text_layout.h"
+
+namespace UI {
+
+namespace {
+
+constexpr int kMargin = 5;
+constexpr int kWidth = 360;
+constexpr int kGraphHeight = 80;
+constexpr int kRowHeight = 8;
+constexpr int kMaxRows = 6;
+constexpr size_t kMaxLegendEntries = 8;
+// Number of frames that the averages are taken over.
+constexpr size_t kAveragedFrames = 30;
+// Vertical pixels per millisecond in the graph.
+constexpr float kPixelsPerMs = 2.f;
+
+// Every scope name gets its own color, which stays the same between frames.
+RGBAColor color_for(const char* name) {
+	static const RGBAColor kPalette[] = {
+	   RGBAColor(230, 25, 75, 255),  RGBAColor(60, 180, 75, 255),  RGBAColor(255, 225, 25, 255),
+	   RGBAColor(67, 99, 216, 255),  RGBAColor(245, 130, 49, 255), RGBAColor(145, 30, 180, 255),
+	   RGBAColor(66, 212, 244, 255), RGBAColor(240, 50, 230, 255), RGBAColor(191, 239, 69, 255),
+	   RGBAColor(250, 190, 190, 255)};
+	uint32_t hash = 2166136261u;
+	for (const char* c = name; *c != '\0'; ++c) {
+		hash = (hash ^ static_cast<uint8_t>(*c)) * 16777619u;
+	}
+	return kPalette[hash % (sizeof(kPalette) / sizeof(kPalette[0]))];
+}
+
+struct LegendEntry {
+	const char* name;
+	uint64_t total_us;
+};
+
+// Sums up the scopes of the last 'kAveragedFrames' frames by name, most
+// expensive first. Nested scopes are also part of their parents' time.
+std::vector<LegendEntry> legend_entries(const std::deque<FrameProfiler::Frame>& frames) {
+	std::vector<LegendEntry> entries;
+	const size_t first = frames.size() - std::min(frames.size(), kAveragedFrames);
+	for (size_t i = first; i < frames.size(); ++i) {
+		for (const FrameProfiler::Event& event : frames[i].events) {
+			auto it = std::find_if(entries.begin(), entries.end(), [&event](const LegendEntry& entry) {
+				return std::strcmp(entry.name, event.name) == 0;
+			});
+			if (it == entries.end()) {
+				entries.push_back(LegendEntry{event.name, event.duration_us});
+			} else {
+				it->total_us += event.duration_us;
+			}
+		}
+	}
+	std::sort(entries.begin(), entries.end(), [](const LegendEntry& a, const LegendEntry& b) {
+		return a.total_us > b.total_us;
+	});
+	if (entries.size() > kMaxLegendEntries) {
+		entries.resize(kMaxLegendEntries);
+	}
+	return entries;
+}
+
+std::shared_ptr<const RenderedText> render_line(const std::string& text) {
+	return g_fh->render(
+	   as_richtext_paragraph(richtext_escape(text), FontStyle::kWuiGameSpeedAndCoordinates));
+}
+
+}  // namespace
+
+void draw_frame_profiler_overlay(RenderTarget* dst) {
+	FrameProfiler::Scope profile("Frame profiler overlay");
+	const std::deque<FrameProfiler::Frame>& frames = FrameProfiler::instance().frames();
+	if (frames.empty()) {
+		return;
+	}
+
+	const size_t nr_averaged = std::min(frames.size(), kAveragedFrames);
+	uint64_t total_us = 0;
+	uint64_t max_us = 0;
+	for (size_t i = frames.size() - nr_averaged; i < frames.size(); ++i) {
+		total_us += frames[i].duration_us;
+		max_us = std::max(max_us, frames[i].duration_us);
+	}
+	const std::vector<LegendEntry> legend = legend_entries(frames);
+
+	std::vector<std::shared_ptr<const RenderedText>> lines;
+	lines.push_back(render_line(
+	   (boost::format("Frame: %.1f ms avg, %.1f ms max") % (total_us / nr_averaged / 1000.) %
+	    (max_us / 1000.))
+	      .str()));
+	for (const LegendEntry& entry : legend) {
+		lines.push_back(render_line(
+		   (boost::format("%s: %.1f ms") % entry.name % (entry.total_us / nr_averaged / 1000.))
+		      .str()));
+	}
+	int text_height = 0;
+	for (const auto& line : lines) {
+		text_height += line->height();
+	}
+
+	const int x = kMargin;
+	const int y = dst->height() - kMargin - kGraphHeight - kMaxRows * kRowHeight - text_height -
+	              4 * kMargin;
+	dst->fill_rect(Recti(x, y, kWidth, dst->height() - kMargin - y), RGBAColor(0, 0, 0, 180),
+	               BlendMode::UseAlpha);
+
+	// The frame times, newest on the right. The lines mark 60 and 30 frames per second.
+	const int graph_bottom = y + kMargin + kGraphHeight;
+	const size_t nr_bars = std::min<size_t>(frames.size(), (kWidth - 2 * kMargin) / 3);
+	for (size_t i = 0; i < nr_bars; ++i) {
+		const FrameProfiler::Frame& frame = frames[frames.size() - nr_bars + i];
+		const float ms = frame.duration_us / 1000.f;
+		const int height = std::min<int>(kGraphHeight, std::max(1.f, ms * kPixelsPerMs));
+		const RGBAColor color = ms < 1000.f / 60.f ? RGBAColor(60, 180, 75, 255) :
+		                        ms < 1000.f / 30.f ? RGBAColor(255, 225, 25, 255) :
+		                                             RGBAColor(230, 25, 75, 255);
+		dst->fill_rect(Recti(x + kMargin + 3 * i, graph_bottom - height, 2, height), color);
+	}
+	for (const float fps : {60.f, 30.f}) {
+		const int line_y = graph_bottom - static_cast<int>(1000.f / fps * kPixelsPerMs);
+		dst->fill_rect(Recti(x + kMargin, line_y, kWidth - 2 * kMargin, 1),
+		               RGBAColor(255, 255, 255, 128), BlendMode::UseAlpha);
+	}
+
+	// The timeline of the last frame.
+	const FrameProfiler::Frame& last = frames.back();
+	const int timeline_y = graph_bottom + kMargin;
+	const float pixels_per_us =
+	   last.duration_us > 0 ? static_cast<float>(kWidth - 2 * kMargin) / last.duration_us : 0.f;
+	for (const FrameProfiler::Event& event : last.events) {
+		if (event.depth >= static_cast<uint32_t>(kMaxRows)) {
+			continue;
+		}
+		const int event_x = (event.start_us - last.start_us) * pixels_per_us;
+		const int event_w = std::max(1, static_cast<int>(event.duration_us * pixels_per_us));
+		dst->fill_rect(Recti(x + kMargin + event_x, timeline_y + event.depth * kRowHeight, event_w,
+		                     kRowHeight - 1),
+		               color_for(event.name));
+	}
+
+	// The legend.
+	int line_y = timeline_y + kMaxRows * kRowHeight + kMargin;
+	for (size_t i = 0; i < lines.size(); ++i) {
+		if (i > 0) {
+			const int square = lines[i]->height() / 2;
+			dst->fill_rect(Recti(x + kMargin, line_y + square / 2, square, square),
+			               color_for(legend[i - 1].name));
+		}
+		const int indent = i > 0 ? lines[i]->height() / 2 : 0;
+		lines[i]->draw(*dst, Vector2i(x + 2 * kMargin + indent, line_y));
+		line_y += lines[i]->height();
+	}
+}
+
+}  // namespace UI
@@ -0,0 +1,35 @@
+/*
+ * Copyright (C) 2019 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#ifndef WL_UI_BASIC_FRAME_PROFILER_OVERLAY_H
+#define WL_UI_BASIC_FRAME_PROFILER_OVERLAY_H
+
+#include "graphic/rendertarget.h"
+
+namespace UI {
+
+// Draws the frames recorded by the FrameProfiler on top of everything: a
+// graph of the recent frame times, the timeline of the last frame with one row
+// per nesting level, and the average time per frame of the most expensive
+// scopes.
+void draw_frame_profiler_overlay(RenderTarget* dst);
+
+}  // namespace UI
+
+#endif  // end of include guard: WL_UI_BASIC_FRAME_PROFILER_OVERLAY_H
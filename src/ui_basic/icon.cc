@@ -41,6 +41,7 @@ Icon::Icon(Panel* const parent, const Image* picture_id)
 
 void Icon::set_icon(const Image* picture_id) {
 	pic_ = picture_id;
+	invalidate_drawing();
 }
 
 void Icon::set_frame(const RGBColor& color) {
@@ -48,10 +49,12 @@ void Icon::set_frame(const RGBColor& color) {
 	framecolor_.r = color.r;
 	framecolor_.g = color.g;
 	framecolor_.b = color.b;
+	invalidate_drawing();
 }
 
 void Icon::set_no_frame() {
 	draw_frame_ = false;
+	invalidate_drawing();
 }
 
 void Icon::draw(RenderTarget& dst) {
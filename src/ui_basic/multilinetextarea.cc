@@ -101,6 +101,7 @@ void MultilineTextarea::recompute() {
 			}
 			height = rendered_text_->height();
 		}
+		invalidate_drawing();
 
 		if (scrollmode_ == ScrollMode::kNoScrolling) {
 			scrollbar_.set_scrollpos(0);
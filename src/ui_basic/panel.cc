@@ -19,13 +19,16 @@
 
 #include "ui_basic/panel.h"
 
+#include "base/frame_profiler.h"
 #include "base/log.h"
 #include "graphic/font_handler.h"
 #include "graphic/graphic.h"
 #include "graphic/rendertarget.h"
 #include "graphic/text/font_set.h"
 #include "graphic/text_layout.h"
+#include "graphic/texture.h"
 #include "sound/sound_handler.h"
+#include "ui_basic/frame_profiler_overlay.h"
 #include "wlapplication.h"
 #include "wlapplication_options.h"
 
@@ -71,7 +74,8 @@ Panel::Panel(Panel* const nparent,
      desired_w_(nw),
      desired_h_(nh),
      running_(false),
-     tooltip_(tooltip_text) {
+     tooltip_(tooltip_text),
+     draw_cache_valid_(false) {
 	assert(nparent != this);
 	if (parent_) {
 		next_ = parent_->first_child_;
@@ -81,6 +85,7 @@ Panel::Panel(Panel* const nparent,
 		else
 			parent_->last_child_ = this;
 		parent_->first_child_ = this;
+		parent_->invalidate_drawing();
 	} else
 		prev_ = next_ = nullptr;
 }
@@ -113,6 +118,7 @@ Panel::~Panel() {
 			next_->prev_ = prev_;
 		else
 			parent_->last_child_ = prev_;
+		parent_->invalidate_drawing();
 	}
 }
 
@@ -170,20 +176,28 @@ int Panel::do_run() {
 	                                       Panel::ui_mousemove,  Panel::ui_key,
 	                                       Panel::ui_textinput,  Panel::ui_mousewheel};
 
+	FrameProfiler& profiler = FrameProfiler::instance();
 	const uint32_t initial_ticks = SDL_GetTicks();
 	uint32_t next_think_time = initial_ticks + kGameLogicDelay;
 	uint32_t next_draw_time = initial_ticks + draw_delay;
 	while (running_) {
 		const uint32_t start_time = SDL_GetTicks();
+		profiler.begin_frame();
 
-		app->handle_input(&input_callback);
+		{
+			FrameProfiler::Scope profile("WLApplication::handle_input");
+			app->handle_input(&input_callback);
+		}
 
 		if (start_time >= next_think_time) {
 			if (app->should_die()) {
 				end_modal<Returncodes>(Returncodes::kBack);
 			}
 
-			do_think();
+			{
+				FrameProfiler::Scope profile("Panel::do_think");
+				do_think();
+			}
 
 			if (flags_ & pf_child_die) {
 				check_child_death();
@@ -194,19 +208,27 @@ int Panel::do_run() {
 
 		if (start_time >= next_draw_time) {
 			RenderTarget& rt = *g_gr->get_render_target();
-			forefather->do_draw(rt);
-			rt.blit((app->get_mouse_position() - Vector2i(3, 7)),
-			        app->is_mouse_pressed() ? default_cursor_click_ : default_cursor_);
-
-			if (is_modal()) {
-				do_tooltip();
-			} else {
-				forefather->do_tooltip();
+			{
+				FrameProfiler::Scope profile("Panel::do_draw");
+				forefather->do_draw(rt);
+				rt.blit((app->get_mouse_position() - Vector2i(3, 7)),
+				        app->is_mouse_pressed() ? default_cursor_click_ : default_cursor_);
+
+				if (is_modal()) {
+					do_tooltip();
+				} else {
+					forefather->do_tooltip();
+				}
+			}
+
+			if (profiler.enabled()) {
+				draw_frame_profiler_overlay(&rt);
 			}
 
 			g_gr->refresh();
 			next_draw_time = start_time + draw_delay;
 		}
+		profiler.end_frame();
 
 		int32_t delay = std::min<int32_t>(next_draw_time, next_think_time) - SDL_GetTicks();
 		if (delay > 0) {
@@ -256,6 +278,7 @@ void Panel::set_size(const int nw, const int nh) {
 	// Make sure that we never get negative width/height in release builds.
 	w_ = std::max(0, nw);
 	h_ = std::max(0, nh);
+	invalidate_drawing();
 
 	if (parent_)
 		move_inside_parent();
@@ -269,6 +292,8 @@ void Panel::set_size(const int nw, const int nh) {
 void Panel::set_pos(const Vector2i n) {
 	x_ = n.x;
 	y_ = n.y;
+	if (parent_)
+		parent_->invalidate_drawing();
 	position_changed();
 }
 
@@ -419,6 +444,7 @@ void Panel::move_to_top() {
 		next_->prev_ = this;
 	else
 		parent_->last_child_ = this;
+	parent_->invalidate_drawing();
 }
 
 /**
@@ -431,6 +457,8 @@ void Panel::set_visible(bool const on) {
 	flags_ &= ~pf_visible;
 	if (on)
 		flags_ |= pf_visible;
+	if (parent_)
+		parent_->invalidate_drawing();
 }
 
 /**
@@ -679,6 +707,9 @@ void Panel::focus(const bool topcaller) {
 		return;
 	}
 
+	if (parent_->focus_ != this) {
+		parent_->invalidate_drawing();
+	}
 	parent_->focus_ = this;
 	parent_->focus(false);
 }
@@ -750,6 +781,26 @@ void Panel::check_child_death() {
 	flags_ &= ~pf_child_die;
 }
 
+/**
+ * Enables/Disables drawing the panel into an offscreen texture that is only
+ * redrawn after \ref invalidate_drawing.
+ */
+void Panel::set_cache_drawing(bool const on) {
+	if (on) {
+		flags_ |= pf_cache_drawing;
+	} else {
+		flags_ &= ~pf_cache_drawing;
+		draw_cache_.reset();
+	}
+	draw_cache_valid_ = false;
+}
+
+void Panel::invalidate_drawing() {
+	for (Panel* p = this; p; p = p->parent_) {
+		p->draw_cache_valid_ = false;
+	}
+}
+
 /**
  * Draw the inner region of the panel into the given target.
  *
@@ -771,6 +822,8 @@ void Panel::do_draw_inner(RenderTarget& dst) {
  * area and draw the inner area.
  * Draw child panels after drawing self.
  * Draw tooltip if required.
+ * With \ref set_cache_drawing, all of this goes into draw_cache_ when it is
+ * outdated, and draw_cache_ is blitted.
  *
  * \param dst RenderTarget for the parent Panel
  */
@@ -781,9 +834,30 @@ void Panel::do_draw(RenderTarget& dst) {
 	Recti outerrc;
 	Vector2i outerofs = Vector2i::zero();
 
+	if (get_cache_drawing() && w_ > 0 && h_ > 0) {
+		if (!draw_cache_ || draw_cache_->width() != w_ || draw_cache_->height() != h_) {
+			draw_cache_.reset(new Texture(w_, h_));
+			draw_cache_valid_ = false;
+		}
+		if (!draw_cache_valid_) {
+			draw_cache_->fill_rect(Rectf(0.f, 0.f, w_, h_), RGBAColor(0, 0, 0, 0));
+			RenderTarget cache_dst(draw_cache_.get());
+			do_draw_window(cache_dst);
+			draw_cache_valid_ = true;
+		}
+		dst.blit(Vector2i(x_, y_), draw_cache_.get(), BlendMode::UseAlpha);
+		return;
+	}
+
 	if (!dst.enter_window(Recti(Vector2i(x_, y_), w_, h_), &outerrc, &outerofs))
 		return;
 
+	do_draw_window(dst);
+
+	dst.set_window(outerrc, outerofs);
+}
+
+void Panel::do_draw_window(RenderTarget& dst) {
 	draw_border(dst);
 
 	Recti innerwindow(
@@ -791,8 +865,6 @@ void Panel::do_draw(RenderTarget& dst) {
 
 	if (dst.enter_window(innerwindow, nullptr, nullptr))
 		do_draw_inner(dst);
-
-	dst.set_window(outerrc, outerofs);
 }
 
 /**
@@ -828,6 +900,7 @@ void Panel::do_mousein(bool const inside) {
 		mousein_child_->do_mousein(false);
 		mousein_child_ = nullptr;
 	}
+	invalidate_drawing();
 	handle_mousein(inside);
 }
 
@@ -851,6 +924,7 @@ bool Panel::do_mousepress(const uint8_t btn, int32_t x, int32_t y) {
 			if (child->do_mousepress(btn, x - child->x_, y - child->y_))
 				return true;
 		}
+	invalidate_drawing();
 	return handle_mousepress(btn, x, y);
 }
 
@@ -873,7 +947,11 @@ bool Panel::do_mousewheel(uint32_t which, int32_t x, int32_t y, Vector2i rel_mou
 			return true;
 		}
 	}
-	return handle_mousewheel(which, x, y);
+	if (handle_mousewheel(which, x, y)) {
+		invalidate_drawing();
+		return true;
+	}
+	return false;
 }
 
 bool Panel::do_mouserelease(const uint8_t btn, int32_t x, int32_t y) {
@@ -884,6 +962,7 @@ bool Panel::do_mouserelease(const uint8_t btn, int32_t x, int32_t y) {
 		     child = child->next_)
 			if (child->do_mouserelease(btn, x - child->x_, y - child->y_))
 				return true;
+	invalidate_drawing();
 	return handle_mouserelease(btn, x, y);
 }
 
@@ -899,7 +978,12 @@ bool Panel::do_mousemove(
 			}
 		}
 	}
-	return handle_mousemove(state, x, y, xdiff, ydiff);
+	// Mouse movement is too frequent to redraw for it unless a panel used it.
+	if (handle_mousemove(state, x, y, xdiff, ydiff)) {
+		invalidate_drawing();
+		return true;
+	}
+	return false;
 }
 
 /**
@@ -918,6 +1002,7 @@ bool Panel::do_key(bool const down, SDL_Keysym const code) {
 	// If we handle text, it does not matter if we handled this key
 	// or not, it should not propagate.
 	if (handle_key(down, code) || handles_textinput()) {
+		invalidate_drawing();
 		return true;
 	}
 	return false;
@@ -932,6 +1017,7 @@ bool Panel::do_textinput(const std::string& text) {
 		return false;
 	}
 
+	invalidate_drawing();
 	return handle_textinput(text);
 }
 
@@ -22,6 +22,7 @@
 
 #include <cassert>
 #include <cstring>
+#include <memory>
 #include <string>
 
 #include <SDL_keyboard.h>
@@ -38,6 +39,7 @@
 
 class RenderTarget;
 class Image;
+class Texture;
 
 namespace UI {
 
@@ -60,6 +62,15 @@ namespace UI {
  * If a panel is the top-level panel, or if has \ref set_layout_toplevel, then whenever
  * its desired size changes, this automatically changes the actual size (which then invokes
  * \ref layout and \ref move_inside_parent).
+ *
+ * A panel can opt in to \ref set_cache_drawing. It is then drawn together with its children
+ * into an offscreen texture, which is blitted every frame until \ref invalidate_drawing is
+ * called for it or for one of its descendants. Input, size changes, added, removed and hidden
+ * children and the setters of the basic widgets invalidate automatically. Everything else
+ * that changes what is drawn, e.g. a model change picked up in think() or a change of a table
+ * entry that is already shown, has to call \ref invalidate_drawing explicitly. Because the
+ * texture starts out transparent, this is only correct for panels that draw an opaque
+ * background, like windows, and for panels that do not animate.
  */
 class Panel : public boost::signals2::trackable {
 public:
@@ -81,6 +92,8 @@ public:
 		pf_handle_textinput = 1024,
 		/// whether widget and its children will handle any key presses
 		pf_handle_keypresses = 2048,
+		/// whether the panel and its children are drawn into draw_cache_
+		pf_cache_drawing = 4096,
 	};
 
 	Panel(Panel* const nparent,
@@ -231,6 +244,14 @@ public:
 	virtual void draw_border(RenderTarget&);
 	virtual void draw_overlay(RenderTarget&);
 
+	// Retained drawing, see the class comment.
+	void set_cache_drawing(bool on);
+	bool get_cache_drawing() const {
+		return flags_ & pf_cache_drawing;
+	}
+	// Marks the cached drawing of this panel and of all panels containing it as outdated.
+	void invalidate_drawing();
+
 	// Events
 	virtual void think();
 
@@ -355,6 +376,8 @@ private:
 	void check_child_death();
 
 	void do_draw(RenderTarget&);
+	// Draws border and inner area into the outer rectangle of 'dst'. Changes its window.
+	void do_draw_window(RenderTarget&);
 	void do_draw_inner(RenderTarget&);
 	void do_think();
 
@@ -402,6 +425,11 @@ private:
 	int return_code_;
 
 	std::string tooltip_;
+
+	// Only used with pf_cache_drawing.
+	std::unique_ptr<Texture> draw_cache_;
+	bool draw_cache_valid_;
+
 	static Panel* modal_;
 	static Panel* mousegrab_;
 	static Panel* mousein_;
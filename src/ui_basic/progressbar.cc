@@ -50,6 +50,7 @@ ProgressBar::ProgressBar(Panel* const parent,
  */
 void ProgressBar::set_state(uint32_t state) {
 	state_ = state;
+	invalidate_drawing();
 }
 
 /**
@@ -58,6 +59,7 @@ void ProgressBar::set_state(uint32_t state) {
 void ProgressBar::set_total(uint32_t total) {
 	assert(total);
 	total_ = total;
+	invalidate_drawing();
 }
 
 /**
@@ -126,6 +126,7 @@ void Scrollbar::set_scrollpos(int32_t pos) {
 		return;
 
 	pos_ = pos;
+	invalidate_drawing();
 	moved(pos);
 }
 
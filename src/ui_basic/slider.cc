@@ -88,6 +88,7 @@ void Slider::set_value(int32_t new_value) {
 	if (new_value != value_) {
 		value_ = new_value;
 		calculate_cursor_position();
+		invalidate_drawing();
 		send_value_changed();
 	}
 }
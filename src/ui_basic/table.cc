@@ -197,6 +197,7 @@ void Table<void*>::clear_selections() {
 	multiselect_.clear();
 	selection_ = no_selection_index();
 	last_selection_ = no_selection_index();
+	invalidate_drawing();
 }
 
 uint32_t Table<void*>::get_eff_w() const {
@@ -460,6 +461,7 @@ void Table<void*>::select(const uint32_t i) {
 		multiselect_.insert(selection_);
 		last_multiselect_ = selection_;
 	}
+	invalidate_drawing();
 
 	selected(selection_);
 }
@@ -548,6 +550,7 @@ Table<void*>::EntryRecord& Table<void*>::add(void* const entry, const bool do_se
 	EntryRecord& result = *new EntryRecord(entry);
 	entry_records_.push_back(&result);
 	result.data_.resize(columns_.size());
+	invalidate_drawing();
 
 	if (do_select) {
 		select(entry_records_.size() - 1);
@@ -562,6 +565,7 @@ Table<void*>::EntryRecord& Table<void*>::add(void* const entry, const bool do_se
  */
 void Table<void*>::set_scrollpos(int32_t const i) {
 	scrollpos_ = i;
+	invalidate_drawing();
 }
 
 void Table<void*>::scroll_to_top() {
@@ -578,6 +582,7 @@ void Table<void*>::remove(const uint32_t i) {
 	const EntryRecordVector::iterator it = entry_records_.begin() + i;
 	delete *it;
 	entry_records_.erase(it);
+	invalidate_drawing();
 	if (selection_ == i) {
 		selection_ = no_selection_index();
 	} else if (selection_ > i && selection_ != no_selection_index()) {
@@ -715,6 +720,7 @@ void Table<void*>::sort(const uint32_t lower_bound, uint32_t upper_bound) {
 			multiselect_.insert(entry);
 		}
 	}
+	invalidate_drawing();
 }
 
 bool Table<void*>::default_compare_string(uint32_t column, uint32_t a, uint32_t b) {
@@ -208,6 +208,7 @@ void TabPanel::activate(uint32_t idx) {
 		tabs_[idx]->panel->set_visible(true);
 
 	active_ = idx;
+	invalidate_drawing();
 
 	update_desired_size();
 	sigclicked();
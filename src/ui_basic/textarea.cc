@@ -82,6 +82,7 @@ void Textarea::update() {
 	scaled_style.set_size(std::max(g_gr->styles().minimum_font_size(),
 	                               static_cast<int>(std::ceil(scaled_style.size() * font_scale_))));
 	rendered_text_ = autofit_text(richtext_escape(text_), scaled_style, fixed_width_);
+	invalidate_drawing();
 
 	if (layoutmode_ == LayoutMode::AutoMove) {
 		expand();
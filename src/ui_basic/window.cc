@@ -110,6 +110,7 @@ Window::Window(Panel* const parent,
 void Window::set_title(const std::string& text) {
 	assert(!is_richtext(text));
 	title_ = text;
+	invalidate_drawing();
 }
 
 /**
@@ -80,7 +80,6 @@ FullscreenMenuLoadGame::FullscreenMenuLoadGame(Widelands::Game& g,
 	layout();
 
 	ok_.set_enabled(false);
-	set_thinks(false);
 
 	if (is_replay_) {
 		back_.set_tooltip(_("Return to the main menu"));
@@ -190,3 +189,8 @@ bool FullscreenMenuLoadGame::handle_key(bool down, SDL_Keysym code) {
 
 	return FullscreenMenuLoadMapOrGame::handle_key(down, code);
 }
+
+void FullscreenMenuLoadGame::think() {
+	FullscreenMenuLoadMapOrGame::think();
+	load_or_save_.think();
+}
@@ -41,6 +41,7 @@ public:
 	const std::string& filename() const;
 
 	bool handle_key(bool down, SDL_Keysym code) override;
+	void think() override;
 
 protected:
 	/// Sets the current selected filename and ends the modal screen with 'Ok' status.
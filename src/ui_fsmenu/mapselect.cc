@@ -21,7 +21,9 @@
 #include <cstdio>
 #include <memory>
 
+#include <boost/algorithm/string.hpp>
 #include <boost/format.hpp>
+#include <boost/lexical_cast.hpp>
 
 #include "base/i18n.h"
 #include "base/log.h"
@@ -39,6 +41,90 @@
 
 using Widelands::WidelandsMapLoader;
 
+namespace {
+
+// Increase this whenever 'preload_map' changes what it stores.
+constexpr uint32_t kMapIndexVersion = 1;
+
+// Whether Map::get_correct_loader() has a loader for 'filename'.
+bool is_map_file(const std::string& filename) {
+	const std::string lower_filename = boost::algorithm::to_lower_copy(filename);
+	return boost::algorithm::ends_with(lower_filename, kWidelandsMapExtension) ||
+	       boost::algorithm::ends_with(lower_filename, kS2MapExtension1) ||
+	       boost::algorithm::ends_with(lower_filename, kS2MapExtension2);
+}
+
+// Suggested teams are stored as "1,2|3,4;1|2|3,4": lineups separated by ';',
+// teams by '|' and players by ','.
+std::string
+encode_suggested_teams(const std::vector<Widelands::SuggestedTeamLineup>& suggested_teams) {
+	std::vector<std::string> lineups;
+	for (const Widelands::SuggestedTeamLineup& lineup : suggested_teams) {
+		std::vector<std::string> teams;
+		for (const Widelands::SuggestedTeam& team : lineup) {
+			std::vector<std::string> players;
+			for (const Widelands::PlayerNumber player : team) {
+				players.push_back(std::to_string(static_cast<unsigned>(player)));
+			}
+			teams.push_back(boost::algorithm::join(players, ","));
+		}
+		lineups.push_back(boost::algorithm::join(teams, "|"));
+	}
+	return boost::algorithm::join(lineups, ";");
+}
+
+std::vector<Widelands::SuggestedTeamLineup> decode_suggested_teams(const std::string& encoded) {
+	std::vector<Widelands::SuggestedTeamLineup> suggested_teams;
+	if (encoded.empty()) {
+		return suggested_teams;
+	}
+	std::vector<std::string> lineups;
+	boost::split(lineups, encoded, boost::is_any_of(";"));
+	for (const std::string& lineup_string : lineups) {
+		Widelands::SuggestedTeamLineup lineup;
+		std::vector<std::string> teams;
+		boost::split(teams, lineup_string, boost::is_any_of("|"));
+		for (const std::string& team_string : teams) {
+			Widelands::SuggestedTeam team;
+			std::vector<std::string> players;
+			boost::split(players, team_string, boost::is_any_of(","));
+			for (const std::string& player : players) {
+				team.push_back(boost::lexical_cast<unsigned>(player));
+			}
+			lineup.push_back(team);
+		}
+		suggested_teams.push_back(lineup);
+	}
+	return suggested_teams;
+}
+
+// Runs on the threads of the preload index, so everything is stored untranslated.
+PreloadIndex::Record preload_map(const std::string& filename) {
+	Widelands::Map map;
+	std::unique_ptr<Widelands::MapLoader> ml = map.get_correct_loader(filename);
+	if (ml == nullptr) {
+		throw wexception("no map loader");
+	}
+	map.set_filename(filename);
+	ml->preload_map(true);
+
+	PreloadIndex::Record record;
+	record["name"] = map.get_name();
+	record["author"] = map.get_author();
+	record["description"] = map.get_description();
+	record["hint"] = map.get_hint();
+	record["nrplayers"] = std::to_string(static_cast<unsigned>(map.get_nrplayers()));
+	record["width"] = std::to_string(map.get_width());
+	record["height"] = std::to_string(map.get_height());
+	record["suggested_teams"] = encode_suggested_teams(map.get_suggested_teams());
+	record["tags"] = boost::algorithm::join(map.get_tags(), ",");
+	record["scenario_types"] = std::to_string(map.scenario_types());
+	record["widelands_map"] = dynamic_cast<WidelandsMapLoader*>(ml.get()) ? "1" : "0";
+	return record;
+}
+
+}  // namespace
+
 FullscreenMenuMapSelect::FullscreenMenuMapSelect(GameSettingsProvider* const settings,
                                                  GameController* const ctrl)
    : FullscreenMenuLoadMapOrGame(),
@@ -68,7 +154,8 @@ FullscreenMenuMapSelect::FullscreenMenuMapSelect(GameSettingsProvider* const set
      basedir_(kMapsDir),
      settings_(settings),
      ctrl_(ctrl),
-     has_translated_mapname_(false) {
+     has_translated_mapname_(false),
+     preload_index_("maps", kMapIndexVersion, preload_map) {
 	curdir_ = basedir_;
 	if (settings_->settings().multiplayer) {
 		back_.set_tooltip(_("Return to the multiplayer game setup"));
@@ -149,6 +236,28 @@ void FullscreenMenuMapSelect::think() {
 	if (ctrl_) {
 		ctrl_->think();
 	}
+
+	bool added = false;
+	preload_index_.collect(
+	   [this, &added](const std::string& filename, const PreloadIndex::Record& record,
+	                  const std::string& error) { added |= add_map(filename, record, error); });
+	if (added) {
+		// Keep the selection while the table fills up.
+		const std::string selected =
+		   table_.has_selection() ? maps_data_[table_.get_selected()].filename : "";
+		table_.fill(maps_data_, display_type());
+		for (size_t i = 0; i < table_.size(); ++i) {
+			if (maps_data_[table_[i]].filename == selected) {
+				table_.select(i);
+				break;
+			}
+		}
+		if (!table_.has_selection() && !table_.empty()) {
+			table_.select(0);
+		}
+		set_has_selection();
+		cb_dont_localize_mapnames_->set_visible(has_translated_mapname_);
+	}
 }
 
 bool FullscreenMenuMapSelect::compare_players(uint32_t rowa, uint32_t rowb) {
@@ -198,6 +307,60 @@ bool FullscreenMenuMapSelect::set_has_selection() {
 	return has_selection;
 }
 
+MapData::DisplayType FullscreenMenuMapSelect::display_type() const {
+	return cb_dont_localize_mapnames_->get_state() ? MapData::DisplayType::kMapnames :
+	                                                 MapData::DisplayType::kMapnamesLocalized;
+}
+
+bool FullscreenMenuMapSelect::add_map(const std::string& filename,
+                                      const PreloadIndex::Record& record,
+                                      const std::string& error) {
+	if (!error.empty()) {
+		log("Mapselect: Skip %s due to preload error: %s\n", filename.c_str(), error.c_str());
+		return false;
+	}
+	try {
+		const uint32_t width = boost::lexical_cast<uint32_t>(record.at("width"));
+		const uint32_t height = boost::lexical_cast<uint32_t>(record.at("height"));
+		if (!width || !height) {
+			return false;
+		}
+
+		MapData::MapType maptype;
+		if (boost::lexical_cast<Map::ScenarioTypes>(record.at("scenario_types")) & scenario_types_) {
+			maptype = MapData::MapType::kScenario;
+		} else if (record.at("widelands_map") == "1") {
+			maptype = MapData::MapType::kNormal;
+		} else {
+			maptype = MapData::MapType::kSettlers2;
+		}
+
+		std::set<std::string> tags;
+		if (!record.at("tags").empty()) {
+			boost::split(tags, record.at("tags"), boost::is_any_of(","));
+		}
+
+		MapData mapdata(filename, record.at("name"), record.at("author"), record.at("description"),
+		                record.at("hint"), boost::lexical_cast<uint32_t>(record.at("nrplayers")),
+		                width, height, decode_suggested_teams(record.at("suggested_teams")), tags,
+		                maptype, display_type());
+
+		has_translated_mapname_ =
+		   has_translated_mapname_ || (mapdata.name != mapdata.localized_name);
+
+		for (const uint32_t tag : req_tags_) {
+			if (!mapdata.tags.count(tags_ordered_[tag])) {
+				return false;
+			}
+		}
+		maps_data_.push_back(mapdata);
+		return true;
+	} catch (const std::exception& e) {
+		log("Mapselect: Skip %s due to broken preload data: %s\n", filename.c_str(), e.what());
+	}
+	return false;
+}
+
 void FullscreenMenuMapSelect::entry_selected() {
 	if (set_has_selection()) {
 		map_details_.update(
@@ -226,12 +389,6 @@ void FullscreenMenuMapSelect::fill_table() {
 
 	maps_data_.clear();
 
-	MapData::DisplayType display_type;
-	if (cb_dont_localize_mapnames_->get_state()) {
-		display_type = MapData::DisplayType::kMapnames;
-	} else {
-		display_type = MapData::DisplayType::kMapnamesLocalized;
-	}
 
 	// This is the normal case
 
@@ -244,47 +401,12 @@ void FullscreenMenuMapSelect::fill_table() {
 		maps_data_.push_back(MapData::create_parent_dir(curdir_));
 	}
 
-	Widelands::Map map;  //  MapLoader needs a place to put its preload data
-
+	// Add map files (compressed) and map directories (uncompressed). The ones
+	// that have not been preloaded before are added by think() when they are.
+	std::vector<std::string> mapfiles;
 	for (const std::string& mapfilename : files) {
-		// Add map file (compressed) or map directory (uncompressed)
-		std::unique_ptr<Widelands::MapLoader> ml = map.get_correct_loader(mapfilename);
-		if (ml != nullptr) {
-			try {
-				map.set_filename(mapfilename);
-				ml->preload_map(true);
-
-				if (!map.get_width() || !map.get_height()) {
-					continue;
-				}
-
-				MapData::MapType maptype;
-				if (map.scenario_types() & scenario_types_) {
-					maptype = MapData::MapType::kScenario;
-				} else if (dynamic_cast<WidelandsMapLoader*>(ml.get())) {
-					maptype = MapData::MapType::kNormal;
-				} else {
-					maptype = MapData::MapType::kSettlers2;
-				}
-
-				MapData mapdata(map, mapfilename, maptype, display_type);
-
-				has_translated_mapname_ =
-				   has_translated_mapname_ || (mapdata.name != mapdata.localized_name);
-
-				bool has_all_tags = true;
-				for (std::set<uint32_t>::const_iterator it = req_tags_.begin(); it != req_tags_.end();
-				     ++it)
-					has_all_tags &= mapdata.tags.count(tags_ordered_[*it]);
-				if (!has_all_tags) {
-					continue;
-				}
-				maps_data_.push_back(mapdata);
-			} catch (const std::exception& e) {
-				log("Mapselect: Skip %s due to preload error: %s\n", mapfilename.c_str(), e.what());
-			} catch (...) {
-				log("Mapselect: Skip %s due to unknown exception\n", mapfilename.c_str());
-			}
+		if (is_map_file(mapfilename)) {
+			mapfiles.push_back(mapfilename);
 		} else if (g_fs->is_directory(mapfilename)) {
 			// Add subdirectory to the list
 			const char* fs_filename = FileSystem::fs_filename(mapfilename.c_str());
@@ -293,8 +415,11 @@ void FullscreenMenuMapSelect::fill_table() {
 			maps_data_.push_back(MapData::create_directory(mapfilename));
 		}
 	}
+	preload_index_.list(
+	   mapfiles, [this](const std::string& filename, const PreloadIndex::Record& record,
+	                    const std::string& error) { add_map(filename, record, error); });
 
-	table_.fill(maps_data_, display_type);
+	table_.fill(maps_data_, display_type());
 	if (!table_.empty()) {
 		table_.select(0);
 	}
@@ -30,6 +30,7 @@
 #include "ui_fsmenu/load_map_or_game.h"
 #include "wui/mapdetails.h"
 #include "wui/maptable.h"
+#include "wui/preload_index.h"
 
 using Widelands::Map;
 class GameController;
@@ -60,6 +61,12 @@ private:
 
 	/// Updates buttons and text labels and returns whether a table entry is selected.
 	bool set_has_selection();
+	MapData::DisplayType display_type() const;
+	/// Adds a map from the preload index to 'maps_data_' unless the tags filter it out.
+	/// Returns whether it was added.
+	bool add_map(const std::string& filename,
+	             const PreloadIndex::Record& record,
+	             const std::string& error);
 	UI::Checkbox* add_tag_checkbox(UI::Box*, std::string, std::string);
 	void tagbox_changed(int32_t, bool);
 
@@ -91,6 +98,9 @@ private:
 	std::set<uint32_t> req_tags_;
 
 	std::vector<MapData> maps_data_;
+	/// Maps that are not in here yet are preloaded in the background, and think()
+	/// adds them to the table.
+	PreloadIndex preload_index_;
 };
 
 #endif  // end of include guard: WL_UI_FSMENU_MAPSELECT_H
@@ -19,6 +19,7 @@
 
 #include "wlapplication.h"
 
+#include <algorithm>
 #include <cerrno>
 #ifndef _WIN32
 #include <csignal>
@@ -28,6 +29,7 @@
 #include <ctime>
 #include <fstream>
 #include <iostream>
+#include <limits>
 #include <memory>
 #include <stdexcept>
 #include <string>
@@ -44,6 +46,7 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 
+#include "base/frame_profiler.h"
 #include "base/i18n.h"
 #include "base/log.h"
 #include "base/time_string.h"
@@ -54,6 +57,7 @@
 #include "editor/editorinteractive.h"
 #include "graphic/default_resolution.h"
 #include "graphic/font_handler.h"
+#include "graphic/image_io.h"
 #include "graphic/text/font_set.h"
 #include "io/filesystem/disk_filesystem.h"
 #include "io/filesystem/filesystem_exceptions.h"
@@ -383,6 +387,15 @@ WLApplication::WLApplication(int const argc, char const* const* const argv)
 	UI::g_fh = UI::create_fonthandler(
 	   &g_gr->images(), i18n::get_locale());  // This will create the fontset, so loading it first.
 
+	FrameProfiler::instance().set_enabled(get_config_bool("frame_profiler", false));
+
+	// Decoded pixels take a lot of disk space, so this is only for those who start often.
+	set_decoded_image_cache(
+	   get_config_bool("decoded_image_cache", false) ?
+	      kCacheDir + g_fs->file_separator() + "images" :
+	      "",
+	   std::max(0, get_config_int("decoded_image_cache_size", 2048)) * 1024ULL * 1024ULL);
+
 	g_gr->initialize(
 	   get_config_bool("debug_gl_trace", false) ? Graphic::TraceGl::kYes : Graphic::TraceGl::kNo,
 	   get_config_int("xres", DEFAULT_RESOLUTION_W), get_config_int("yres", DEFAULT_RESOLUTION_H),
@@ -583,6 +596,38 @@ bool WLApplication::handle_key(bool down, const SDL_Keycode& keycode, int modifi
 			}
 			return true;
 
+		case SDLK_F12:
+			// Ctrl+F12 toggles the frame profiler, Ctrl+Shift+F12 saves what it recorded.
+			if (ctrl) {
+				FrameProfiler& profiler = FrameProfiler::instance();
+				if (!(modifiers & KMOD_SHIFT)) {
+					profiler.set_enabled(!profiler.enabled());
+					return true;
+				}
+				if (profiler.frames().empty()) {
+					log("Omitting frame trace because no frames have been recorded\n");
+					return true;
+				}
+				if (g_fs->disk_space() < kMinimumDiskSpace) {
+					log("Omitting frame trace because diskspace is lower than %lluMB\n",
+					    kMinimumDiskSpace / (1000 * 1000));
+					return true;
+				}
+				g_fs->ensure_directory_exists(kTracesDir);
+				for (uint32_t nr = 0; nr < 10000; ++nr) {
+					const std::string filename =
+					   (boost::format("%s/frames%04u.json") % kTracesDir % nr).str();
+					if (g_fs->file_exists(filename)) {
+						continue;
+					}
+					const std::string trace = profiler.chrome_trace();
+					g_fs->write(filename, trace.data(), trace.size());
+					log("Saved frame trace to %s\n", filename.c_str());
+					break;
+				}
+			}
+			return true;
+
 		case SDLK_f: {
 			// Toggle fullscreen
 			const uint32_t time = SDL_GetTicks();
@@ -800,6 +845,7 @@ bool WLApplication::init_settings() {
 	get_config_bool("snap_windows_only_when_overlapping", false);
 	get_config_bool("animate_map_panning", false);
 	get_config_bool("write_syncstreams", false);
+	get_config_bool("replay_syncstream", false);
 	get_config_bool("nozip", false);
 	get_config_int("xres", 0);
 	get_config_int("yres", 0);
@@ -1476,6 +1522,15 @@ void WLApplication::replay() {
 		game.set_write_replay(false);
 		ReplayGameController rgc(game, filename_);
 
+		if (get_config_bool("replay_syncstream", false)) {
+			// Keep the syncstream for comparing it with other runs of the same replay.
+			// Play as fast as possible and quit when done, nobody is watching.
+			game.set_write_syncstream(true);
+			game.save_syncstream(true);
+			rgc.set_desired_speed(std::numeric_limits<uint16_t>::max());
+			rgc.set_exit_at_end(true);
+		}
+
 		game.save_handler().set_allow_saving(false);
 
 		game.set_loader_ui(&loader_ui);
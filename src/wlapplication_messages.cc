@@ -74,6 +74,10 @@ void show_usage(const std::string& build_id, const std::string& build_type) {
 	          << _(" --write_syncstreams=[true|false]\n"
 	               "                      Create syncstream dump files to help debug network games.")
 	          << endl
+	          << _(" --replay_syncstream  With --replay, play the replay as fast as possible,\n"
+	               "                      keep its syncstream dump and quit at the end.\n"
+	               "                      See utils/syncstream/bisect-desync.py.")
+	          << endl
 	          << _(" --autosave=[...]     Automatically save each n minutes") << endl
 	          << _(" --rolling_autosave=[...]\n"
 	               "                      Use this many files for rolling autosaves")
@@ -110,6 +114,13 @@ void show_usage(const std::string& build_id, const std::string& build_type) {
 	               "                      Only valid with --scenario, --loadgame, or --editor.")
 	          << endl
 	          /** TRANSLATORS: You may translate true/false, also as on/off or yes/no, but */
+	          /** TRANSLATORS: it HAS TO BE CONSISTENT with the translation in the widelands
+	             textdomain */
+	          << _(" --lua_persistence_report=[true|false]\n"
+	               "                      When saving, log how much space and time\n"
+	               "                      each global of the Lua scripts takes.")
+	          << endl
+	          /** TRANSLATORS: You may translate true/false, also as on/off or yes/no, but */
 	          /** TRANSLATORS: it HAS TO BE CONSISTENT with the translation in the widelands
 	             textdomain */
 	          << _(" --auto_roadbuild_mode=[true|false]\n"
@@ -130,6 +141,14 @@ void show_usage(const std::string& build_id, const std::string& build_type) {
 	          << _(" --xres=[...]         Width of the window in pixel.") << endl
 	          << _(" --yres=[...]         Height of the window in pixel.") << endl
 	          << _(" --maxfps=[5 ...]     Maximal optical framerate of the game.") << endl
+	          /** TRANSLATORS: You may translate true/false, also as on/off or yes/no, but */
+	          /** TRANSLATORS: it HAS TO BE CONSISTENT with the translation in the widelands
+	             textdomain */
+	          << _(" --frame_profiler=[true|false]\n"
+	               "                      Show how long the parts of each frame take.\n"
+	               "                      Toggle with Ctrl+F12, save a trace for\n"
+	               "                      chrome://tracing with Ctrl+Shift+F12.")
+	          << endl
 	          << endl
 	          /** TRANSLATORS: You may translate true/false, also as on/off or yes/no, but */
 	          /** TRANSLATORS: it HAS TO BE CONSISTENT with the translation in the widelands
@@ -51,6 +51,8 @@ EncyclopediaWindow::EncyclopediaWindow(InteractiveBase& parent,
    : UI::UniqueWindow(&parent, "encyclopedia", &registry, WINDOW_WIDTH, WINDOW_HEIGHT, ""),
      lua_(lua),
      tabs_(this, UI::TabPanelStyle::kWuiLight) {
+	// The help texts and images only change on user input.
+	set_cache_drawing(true);
 }
 
 void EncyclopediaWindow::init(InteractiveBase& parent, std::unique_ptr<LuaTable> table) {
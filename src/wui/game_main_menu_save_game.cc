@@ -120,7 +120,6 @@ GameMainMenuSaveGame::GameMainMenuSaveGame(InteractiveGameBase& parent,
 
 	filename_editbox_.focus();
 	pause_game(true);
-	set_thinks(false);
 	layout();
 }
 
@@ -195,6 +194,11 @@ bool GameMainMenuSaveGame::handle_key(bool down, SDL_Keysym code) {
 	return UI::Panel::handle_key(down, code);
 }
 
+void GameMainMenuSaveGame::think() {
+	UI::UniqueWindow::think();
+	load_or_save_.think();
+}
+
 void GameMainMenuSaveGame::pause_game(bool paused) {
 	if (igbase().is_multiplayer()) {
 		return;
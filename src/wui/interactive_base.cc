@@ -19,9 +19,10 @@
 
 #include "wui/interactive_base.h"
 
+#include <limits>
 #include <memory>
 
-#include <boost/algorithm/string/join.hpp>
+#include <boost/algorithm/string.hpp>
 #include <boost/bind.hpp>
 #include <boost/format.hpp>
 
@@ -36,7 +37,9 @@
 #include "graphic/font_handler.h"
 #include "graphic/rendertarget.h"
 #include "graphic/text_layout.h"
+#include "io/filesystem/layered_filesystem.h"
 #include "logic/cmd_queue.h"
+#include "logic/filesystem_constants.h"
 #include "logic/game.h"
 #include "logic/game_controller.h"
 #include "logic/map_objects/checkstep.h"
@@ -47,6 +50,7 @@
 #include "logic/player.h"
 #include "logic/widelands_geometry.h"
 #include "scripting/lua_interface.h"
+#include "scripting/lua_profiler.h"
 #include "sound/sound_handler.h"
 #include "wlapplication_options.h"
 #include "wui/game_chat_menu.h"
@@ -264,6 +268,7 @@ InteractiveBase::InteractiveBase(EditorGameBase& the_egbase, Section& global_s)
 
 	setDefaultCommand(boost::bind(&InteractiveBase::cmd_lua, this, _1));
 	addCommand("mapobject", boost::bind(&InteractiveBase::cmd_map_object, this, _1));
+	addCommand("luaprofiler", boost::bind(&InteractiveBase::cmd_lua_profiler, this, _1));
 }
 
 InteractiveBase::~InteractiveBase() {
@@ -742,9 +747,11 @@ void InteractiveBase::draw_overlay(RenderTarget& dst) {
 
 		// Blit FPS when playing a game in debug mode
 		if (get_display_flag(dfDebug)) {
-			static boost::format fps_format("%5.1f fps (avg: %5.1f fps)");
+			static boost::format fps_format("%5.1f fps (avg: %5.1f fps, prep: %4.1f ms)");
 			rendered_text = UI::g_fh->render(as_richtext_paragraph(
-			   (fps_format % (1000.0 / frametime_) % (1000.0 / (avg_usframetime_ / 1000))).str(),
+			   (fps_format % (1000.0 / frametime_) % (1000.0 / (avg_usframetime_ / 1000)) %
+			    map_view()->frame_prep_ms())
+			      .str(),
 			   UI::FontStyle::kWuiGameSpeedAndCoordinates));
 			rendered_text->draw(dst, Vector2i((get_w() - rendered_text->width()) / 2, 5));
 		}
@@ -1401,6 +1408,43 @@ void InteractiveBase::cmd_lua(const std::vector<std::string>& args) {
 	DebugConsole::write("Ending Lua interpretation!");
 }
 
+/**
+ * Start, stop and show the Lua profiler. 'dump' writes the full report into a file.
+ */
+void InteractiveBase::cmd_lua_profiler(const std::vector<std::string>& args) {
+	// The console is too small for more.
+	constexpr size_t kConsoleRows = 10;
+
+	const std::string command = args.size() == 2 ? args[1] : "";
+	if (command == "start" || command == "stop") {
+		egbase().lua().set_profiling(command == "start");
+		DebugConsole::write(command == "start" ? "Lua profiler started" : "Lua profiler stopped");
+	} else if (command == "report") {
+		std::vector<std::string> lines;
+		const std::string report = LuaProfiler::instance().report(kConsoleRows);
+		boost::split(lines, report, boost::is_any_of("\n"));
+		for (const std::string& line : lines) {
+			DebugConsole::write(line);
+		}
+	} else if (command == "dump") {
+		g_fs->ensure_directory_exists(kTracesDir);
+		for (uint32_t nr = 0; nr < 10000; ++nr) {
+			const std::string filename =
+			   (boost::format("%s/luaprofile%04u.txt") % kTracesDir % nr).str();
+			if (g_fs->file_exists(filename)) {
+				continue;
+			}
+			const std::string report =
+			   LuaProfiler::instance().report(std::numeric_limits<size_t>::max());
+			g_fs->write(filename, report.data(), report.size());
+			DebugConsole::write("Saved Lua profile to " + filename);
+			break;
+		}
+	} else {
+		DebugConsole::write("usage: luaprofiler start|stop|report|dump");
+	}
+}
+
 /**
  * Show a map object's debug window
  */
@@ -299,6 +299,7 @@ private:
 	void waterway_building_remove_overlay();
 	void cmd_map_object(const std::vector<std::string>& args);
 	void cmd_lua(const std::vector<std::string>& args);
+	void cmd_lua_profiler(const std::vector<std::string>& args);
 
 	// Rebuilds the subclass' showhidemenu_ according to current map settings
 	virtual void rebuild_showhide_menu() = 0;
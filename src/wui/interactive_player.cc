@@ -30,6 +30,7 @@
 #include "base/macros.h"
 #include "economy/flag.h"
 #include "game_io/game_loader.h"
+#include "graphic/render_queue.h"
 #include "logic/cmd_queue.h"
 #include "logic/map_objects/checkstep.h"
 #include "logic/map_objects/immovable.h"
@@ -60,30 +61,6 @@ using Widelands::Map;
 
 namespace {
 
-// Returns the brightness value in [0, 1.] for 'fcoords' at 'gametime' for
-// 'pf'. See 'field_brightness' in fields_to_draw.cc for scale of values.
-float adjusted_field_brightness(const Widelands::FCoords& fcoords,
-                                const uint32_t gametime,
-                                const Widelands::Player::Field& pf) {
-	if (pf.vision == 0) {
-		return 0.;
-	}
-
-	uint32_t brightness = 144 + fcoords.field->get_brightness();
-	brightness = std::min<uint32_t>(255, (brightness * 255) / 160);
-
-	if (pf.vision == 1) {
-		static const uint32_t kDecayTimeInMs = 20000;
-		const Widelands::Duration time_ago = gametime - pf.time_node_last_unseen;
-		if (time_ago < kDecayTimeInMs) {
-			brightness = (brightness * (2 * kDecayTimeInMs - time_ago)) / (2 * kDecayTimeInMs);
-		} else {
-			brightness = brightness / 2;
-		}
-	}
-	return brightness / 255.;
-}
-
 // Remove statistics from the text to draw if the player does not match the map object's owner
 TextToDraw filter_text_to_draw(TextToDraw text_to_draw,
                                const Widelands::MapObject* object,
@@ -384,34 +361,18 @@ void InteractivePlayer::draw_map_view(MapView* given_map_view, RenderTarget* dst
 	const Widelands::Player& plr = player();
 	const auto& gbase = egbase();
 	const Widelands::Map& map = gbase.map();
-	const uint32_t gametime = gbase.get_gametime();
 
 	Workareas workareas = get_workarea_overlays(map);
-	auto* fields_to_draw = given_map_view->draw_terrain(gbase, workareas, false, dst);
+	auto* fields_to_draw = given_map_view->draw_terrain(gbase, &plr, workareas, false, dst);
 	const auto& road_building = road_building_overlays();
 	const auto& waterway_building = waterway_building_overlays();
 
 	const float scale = 1.f / given_map_view->view().zoom;
 
+	RenderQueue::ScopedSpriteBatch sprite_batch;
 	for (size_t idx = 0; idx < fields_to_draw->size(); ++idx) {
 		auto* f = fields_to_draw->mutable_field(idx);
 
-		const Widelands::Player::Field& player_field =
-		   plr.fields()[map.get_index(f->fcoords, map.get_width())];
-
-		// Adjust this field for visibility for this player.
-		if (!plr.see_all()) {
-			f->brightness = adjusted_field_brightness(f->fcoords, gametime, player_field);
-			f->road_e = player_field.r_e;
-			f->road_se = player_field.r_se;
-			f->road_sw = player_field.r_sw;
-			f->vision = player_field.vision;
-			if (player_field.vision == 1) {
-				f->owner = player_field.owner != 0 ? gbase.get_player(player_field.owner) : nullptr;
-				f->is_border = player_field.border;
-			}
-		}
-
 		// Add road building overlays if applicable.
 		if (f->vision > 0) {
 			const auto rinfo = road_building.road_previews.find(f->fcoords);
@@ -462,7 +423,8 @@ void InteractivePlayer::draw_map_view(MapView* given_map_view, RenderTarget* dst
 				draw_bobs_for_visible_field(gbase, *f, scale, text_to_draw, plr, dst);
 			} else if (f->vision == 1) {
 				// We never show census or statistics for objects in the fog.
-				draw_immovable_for_formerly_visible_field(*f, player_field, scale, dst);
+				draw_immovable_for_formerly_visible_field(
+				   *f, plr.fields()[map.get_index(f->fcoords, map.get_width())], scale, dst);
 			}
 		}
 
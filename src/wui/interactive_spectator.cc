@@ -22,6 +22,7 @@
 #include "base/i18n.h"
 #include "base/macros.h"
 #include "chat/chat.h"
+#include "graphic/render_queue.h"
 #include "logic/game_controller.h"
 #include "logic/player.h"
 #include "ui_basic/textarea.h"
@@ -93,11 +94,12 @@ void InteractiveSpectator::draw_map_view(MapView* given_map_view, RenderTarget*
 	const Widelands::Game& the_game = game();
 	const Widelands::Map& map = the_game.map();
 	auto* fields_to_draw =
-	   given_map_view->draw_terrain(the_game, get_workarea_overlays(map), false, dst);
+	   given_map_view->draw_terrain(the_game, nullptr, get_workarea_overlays(map), false, dst);
 	const float scale = 1.f / given_map_view->view().zoom;
 	const uint32_t gametime = the_game.get_gametime();
 
 	const auto text_to_draw = get_text_to_draw();
+	RenderQueue::ScopedSpriteBatch sprite_batch;
 	for (size_t idx = 0; idx < fields_to_draw->size(); ++idx) {
 		const FieldsToDraw::Field& field = fields_to_draw->at(idx);
 
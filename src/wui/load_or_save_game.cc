@@ -24,6 +24,7 @@
 
 #include <boost/algorithm/string.hpp>
 #include <boost/format.hpp>
+#include <boost/lexical_cast.hpp>
 
 #include "base/i18n.h"
 #include "base/log.h"
@@ -65,6 +66,27 @@ map_filename(const std::string& filename, const std::string& mapname, bool local
 	}
 	return result;
 }
+// Increase this whenever 'preload_savegame' changes what it stores.
+constexpr uint32_t kSavegameIndexVersion = 1;
+
+// Runs on the threads of the preload index, so everything is stored untranslated.
+// Preloading does not touch the game.
+PreloadIndex::Record preload_savegame(const std::string& savename, Widelands::Game& game) {
+	Widelands::GamePreloadPacket gpdp;
+	Widelands::GameLoader gl(savename, game);
+	gl.preload_game(gpdp);
+
+	PreloadIndex::Record record;
+	record["gametype"] = std::to_string(static_cast<int>(gpdp.get_gametype()));
+	record["mapname"] = gpdp.get_mapname();
+	record["gametime"] = std::to_string(gpdp.get_gametime());
+	record["nrplayers"] = std::to_string(static_cast<unsigned>(gpdp.get_number_of_players()));
+	record["version"] = gpdp.get_version();
+	record["savetimestamp"] = std::to_string(gpdp.get_savetimestamp());
+	record["win_condition"] = gpdp.get_win_condition();
+	record["minimap_path"] = gpdp.get_minimap_path();
+	return record;
+}
 }  // namespace
 
 LoadOrSaveGame::LoadOrSaveGame(UI::Panel* parent,
@@ -92,7 +114,11 @@ LoadOrSaveGame::LoadOrSaveGame(UI::Panel* parent,
                             style == UI::PanelStyle::kFsMenu ? UI::ButtonStyle::kFsMenuSecondary :
                                                                UI::ButtonStyle::kWuiSecondary,
                             _("Delete"))),
-     game_(g) {
+     game_(g),
+     preload_index_(
+        filetype_ == FileType::kReplay ? "replays" : "savegames",
+        kSavegameIndexVersion,
+        [this](const std::string& savename) { return preload_savegame(savename, game_); }) {
 	table_.add_column(130, _("Save Date"), _("The date this game was saved"), UI::Align::kLeft);
 
 	if (filetype_ != FileType::kGameSinglePlayer) {
@@ -380,11 +406,8 @@ void LoadOrSaveGame::fill_table() {
 		});
 	}
 
-	Widelands::GamePreloadPacket gpdp;
-
+	std::vector<std::string> savenames;
 	for (const std::string& gamefilename : gamefiles) {
-		SavegameData gamedata;
-
 		std::string savename = gamefilename;
 		if (filetype_ == FileType::kReplay) {
 			savename += kSavegameExtension;
@@ -393,33 +416,59 @@ void LoadOrSaveGame::fill_table() {
 		if (!g_fs->file_exists(savename.c_str())) {
 			continue;
 		}
+		savenames.push_back(savename);
+	}
 
-		gamedata.filename = gamefilename;
+	// Files that have not been preloaded before are added by think() when they are.
+	preload_index_.list(
+	   savenames, [this](const std::string& savename, const PreloadIndex::Record& record,
+	                     const std::string& error) { add_entry(savename, record, error); });
+	table_.sort();
+	table_.focus();
+}
 
-		try {
-			Widelands::GameLoader gl(savename.c_str(), game_);
-			gl.preload_game(gpdp);
+void LoadOrSaveGame::think() {
+	bool added = false;
+	preload_index_.collect(
+	   [this, &added](const std::string& savename, const PreloadIndex::Record& record,
+	                  const std::string& error) { added |= add_entry(savename, record, error); });
+	if (added) {
+		table_.sort();
+	}
+}
 
-			gamedata.gametype = gpdp.get_gametype();
+bool LoadOrSaveGame::add_entry(const std::string& savename,
+                               const PreloadIndex::Record& record,
+                               std::string errormessage) {
+	SavegameData gamedata;
+	gamedata.filename =
+	   filetype_ == FileType::kReplay ?
+	      savename.substr(0, savename.size() - kSavegameExtension.size()) :
+	      savename;
+
+	if (errormessage.empty()) {
+		try {
+			gamedata.gametype = static_cast<GameController::GameType>(
+			   boost::lexical_cast<int>(record.at("gametype")));
 
 			// Skip singleplayer games in multiplayer mode and vice versa
 			if (filetype_ != FileType::kReplay && filetype_ != FileType::kShowAll) {
 				if (filetype_ == FileType::kGameMultiPlayer) {
 					if (gamedata.gametype == GameController::GameType::kSingleplayer) {
-						continue;
+						return false;
 					}
 				} else if ((gamedata.gametype != GameController::GameType::kSingleplayer) &&
 				           (gamedata.gametype != GameController::GameType::kReplay)) {
-					continue;
+					return false;
 				}
 			}
 
-			gamedata.set_mapname(gpdp.get_mapname());
-			gamedata.set_gametime(gpdp.get_gametime());
-			gamedata.set_nrplayers(gpdp.get_number_of_players());
-			gamedata.version = gpdp.get_version();
+			gamedata.set_mapname(record.at("mapname"));
+			gamedata.set_gametime(boost::lexical_cast<uint32_t>(record.at("gametime")));
+			gamedata.set_nrplayers(boost::lexical_cast<unsigned>(record.at("nrplayers")));
+			gamedata.version = record.at("version");
 
-			gamedata.savetimestamp = gpdp.get_savetimestamp();
+			gamedata.savetimestamp = boost::lexical_cast<time_t>(record.at("savetimestamp"));
 			time_t t;
 			time(&t);
 			struct tm* currenttime = localtime(&t);
@@ -480,8 +529,9 @@ void LoadOrSaveGame::fill_table() {
 				}
 			}
 
-			gamedata.wincondition = gpdp.get_localized_win_condition();
-			gamedata.minimap_path = gpdp.get_minimap_path();
+			gamedata.wincondition =
+			   Widelands::GamePreloadPacket::localize_win_condition(record.at("win_condition"));
+			gamedata.minimap_path = record.at("minimap_path");
 			games_data_.push_back(gamedata);
 
 			UI::Table<uintptr_t const>::EntryRecord& te = table_.add(games_data_.size() - 1);
@@ -535,34 +585,35 @@ void LoadOrSaveGame::fill_table() {
 			} else {
 				te.set_string(1, map_filename(gamedata.filename, gamedata.mapname, localize_autosave_));
 			}
+			return true;
 		} catch (const std::exception& e) {
-			std::string errormessage = e.what();
-			boost::replace_all(errormessage, "\n", "<br>");
-			gamedata.errormessage =
-			   ((boost::format("<p>%s</p><p>%s</p><p>%s</p>"))
-			    /** TRANSLATORS: Error message introduction for when an old savegame can't be loaded */
-			    % _("This file has the wrong format and can’t be loaded."
-			        " Maybe it was created with an older version of Widelands.")
-			    /** TRANSLATORS: This text is on a separate line with an error message below */
-			    % _("Error message:") % errormessage)
-			      .str();
-
-			gamedata.mapname = FileSystem::filename_without_ext(gamedata.filename.c_str());
-			games_data_.push_back(gamedata);
-
-			UI::Table<uintptr_t const>::EntryRecord& te = table_.add(games_data_.size() - 1);
-			te.set_string(0, "");
-			if (filetype_ != FileType::kGameSinglePlayer) {
-				te.set_string(1, "");
-				/** TRANSLATORS: Prefix for incompatible files in load game screens */
-				te.set_string(2, (boost::format(_("Incompatible: %s")) % gamedata.mapname).str());
-			} else {
-				te.set_string(1, (boost::format(_("Incompatible: %s")) % gamedata.mapname).str());
-			}
+			errormessage = e.what();
 		}
 	}
-	table_.sort();
-	table_.focus();
+
+	boost::replace_all(errormessage, "\n", "<br>");
+	gamedata.errormessage =
+	   ((boost::format("<p>%s</p><p>%s</p><p>%s</p>"))
+	    /** TRANSLATORS: Error message introduction for when an old savegame can't be loaded */
+	    % _("This file has the wrong format and can’t be loaded."
+	        " Maybe it was created with an older version of Widelands.")
+	    /** TRANSLATORS: This text is on a separate line with an error message below */
+	    % _("Error message:") % errormessage)
+	      .str();
+
+	gamedata.mapname = FileSystem::filename_without_ext(gamedata.filename.c_str());
+	games_data_.push_back(gamedata);
+
+	UI::Table<uintptr_t const>::EntryRecord& te = table_.add(games_data_.size() - 1);
+	te.set_string(0, "");
+	if (filetype_ != FileType::kGameSinglePlayer) {
+		te.set_string(1, "");
+		/** TRANSLATORS: Prefix for incompatible files in load game screens */
+		te.set_string(2, (boost::format(_("Incompatible: %s")) % gamedata.mapname).str());
+	} else {
+		te.set_string(1, (boost::format(_("Incompatible: %s")) % gamedata.mapname).str());
+	}
+	return true;
 }
 
 void LoadOrSaveGame::set_show_filenames(bool show_filenames) {
@@ -27,6 +27,7 @@
 #include "ui_basic/panel.h"
 #include "ui_basic/table.h"
 #include "wui/gamedetails.h"
+#include "wui/preload_index.h"
 
 /// Common functions for loading or saving a game or replay.
 class LoadOrSaveGame {
@@ -59,6 +60,9 @@ protected:
 	/// Read savegame/replay files and fill the table and games data.
 	void fill_table();
 
+	/// Adds the files that have been preloaded in the background since the last call.
+	void think();
+
 	/// Set whether to show filenames. Has only an effect for Replays.
 	void set_show_filenames(bool);
 
@@ -86,6 +90,12 @@ private:
 	/// Formats a given table selection as a list of filenames with savedate information.
 	const std::string filename_list_string(const std::set<uint32_t>& selections) const;
 
+	/// Adds the preloaded savegame/replay to the games data and the table, unless
+	/// it is filtered out. Returns whether it was added.
+	bool add_entry(const std::string& savename,
+	               const PreloadIndex::Record& record,
+	               std::string errormessage);
+
 	/// Reverse default sort order for save date column
 	bool compare_date_descending(uint32_t, uint32_t) const;
 
@@ -100,6 +110,8 @@ private:
 	UI::Button* delete_;
 
 	Widelands::Game& game_;
+	/// Savegames/replays that are not in here yet are preloaded in the background.
+	PreloadIndex preload_index_;
 };
 
 #endif  // end of include guard: WL_WUI_LOAD_OR_SAVE_GAME_H
@@ -41,24 +41,50 @@ MapData::MapData(const Widelands::Map& map,
                  const std::string& init_filename,
                  const MapData::MapType& init_maptype,
                  const MapData::DisplayType& init_displaytype)
+   : MapData(init_filename,
+             map.get_name(),
+             map.get_author(),
+             map.get_description(),
+             map.get_hint(),
+             map.get_nrplayers(),
+             map.get_width(),
+             map.get_height(),
+             map.get_suggested_teams(),
+             map.get_tags(),
+             init_maptype,
+             init_displaytype) {
+}
+
+MapData::MapData(const std::string& init_filename,
+                 const std::string& map_name,
+                 const std::string& map_author,
+                 const std::string& map_description,
+                 const std::string& map_hint,
+                 const uint32_t init_nrplayers,
+                 const uint32_t init_width,
+                 const uint32_t init_height,
+                 const std::vector<Widelands::SuggestedTeamLineup>& init_suggested_teams,
+                 const std::set<std::string>& init_tags,
+                 const MapData::MapType& init_maptype,
+                 const MapData::DisplayType& init_displaytype)
    : MapData(init_filename,
              _("No Name"),
-             map.get_author().empty() ? _("No Author") : map.get_author(),
+             map_author.empty() ? _("No Author") : map_author,
              init_maptype,
              init_displaytype) {
 
 	i18n::Textdomain td("maps");
-	if (!map.get_name().empty()) {
-		name = map.get_name();
+	if (!map_name.empty()) {
+		name = map_name;
 		localized_name = _(name);
 	}
-	description = map.get_description().empty() ? "" : _(map.get_description());
-	hint = map.get_hint().empty() ? "" : _(map.get_hint());
-	nrplayers = map.get_nrplayers();
-	width = map.get_width();
-	height = map.get_height();
-	suggested_teams = map.get_suggested_teams();
-	tags = map.get_tags();
+	description = map_description.empty() ? "" : _(map_description);
+	hint = map_hint.empty() ? "" : _(map_hint);
+	nrplayers = init_nrplayers;
+	width = init_width;
+	height = init_height;
+	suggested_teams = init_suggested_teams;
+	tags = init_tags;
 
 	if (maptype == MapData::MapType::kScenario) {
 		tags.insert("scenario");
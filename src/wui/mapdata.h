@@ -55,6 +55,21 @@ public:
 	        const MapData::MapType& init_maptype,
 	        const MapData::DisplayType& init_displaytype);
 
+	/// For normal maps and scenarios that are known from an earlier preload. The
+	/// strings are untranslated, as in Widelands::Map.
+	MapData(const std::string& init_filename,
+	        const std::string& map_name,
+	        const std::string& map_author,
+	        const std::string& map_description,
+	        const std::string& map_hint,
+	        uint32_t init_nrplayers,
+	        uint32_t init_width,
+	        uint32_t init_height,
+	        const std::vector<Widelands::SuggestedTeamLineup>& init_suggested_teams,
+	        const std::set<std::string>& init_tags,
+	        const MapData::MapType& init_maptype,
+	        const MapData::DisplayType& init_displaytype);
+
 	/// For directories
 	MapData(const std::string& init_filename, const std::string& init_localized_name);
 
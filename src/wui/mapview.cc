@@ -343,6 +343,7 @@ void MapView::mouse_to_pixel(const Vector2i& pixel, const Transition& transition
 }
 
 FieldsToDraw* MapView::draw_terrain(const Widelands::EditorGameBase& egbase,
+                                    const Widelands::Player* player,
                                     Workareas workarea,
                                     bool grid,
                                     RenderTarget* dst) {
@@ -387,9 +388,14 @@ FieldsToDraw* MapView::draw_terrain(const Widelands::EditorGameBase& egbase,
 		break;
 	}
 
-	fields_to_draw_.reset(egbase, view_.viewpoint, view_.zoom, dst);
+	const uint64_t prep_start = SDL_GetPerformanceCounter();
+	fields_to_draw_.reset(egbase, player, view_.viewpoint, view_.zoom, dst);
+	terrain_mesh_.update(egbase, player, view_.viewpoint, view_.zoom, *dst);
+	const float prep_ms =
+	   (SDL_GetPerformanceCounter() - prep_start) * 1000.f / SDL_GetPerformanceFrequency();
+	frame_prep_ms_ = (frame_prep_ms_ * 15.f + prep_ms) / 16.f;
 	const float scale = 1.f / view_.zoom;
-	::draw_terrain(egbase, fields_to_draw_, scale, workarea, grid, dst);
+	::draw_terrain(egbase, fields_to_draw_, &terrain_mesh_, scale, workarea, grid, dst);
 	return &fields_to_draw_;
 }
 
@@ -30,6 +30,7 @@
 #include "base/vector.h"
 #include "graphic/game_renderer.h"
 #include "graphic/gl/fields_to_draw.h"
+#include "graphic/gl/terrain_mesh.h"
 #include "logic/map.h"
 #include "logic/widelands_geometry.h"
 #include "ui_basic/panel.h"
@@ -176,13 +177,21 @@ public:
 	// True if a 'Transition::Smooth' animation is playing.
 	bool is_animating() const;
 
+	// Smoothed time in ms that the last frames needed to prepare the fields and
+	// the terrain for drawing. Shown in the debug overlay.
+	float frame_prep_ms() const {
+		return frame_prep_ms_;
+	}
+
 	// Scrolls the map and returns true if it did.
 	bool scroll_map();
 
-	// Schedules drawing of the terrain of this MapView. The returned value can
-	// be used to override contents of 'fields_to_draw' for player knowledge and
-	// visibility, and to correctly draw map objects, overlays and text.
+	// Schedules drawing of the terrain of this MapView as seen by 'player', or
+	// all of it if 'player' is nullptr. The returned fields already contain what
+	// 'player' knows about them. They can be used to add overlays like road
+	// building previews, and to correctly draw map objects, overlays and text.
 	FieldsToDraw* draw_terrain(const Widelands::EditorGameBase& egbase,
+	                           const Widelands::Player* player,
 	                           Workareas workarea,
 	                           bool grid,
 	                           RenderTarget* dst);
@@ -217,6 +226,8 @@ private:
 	// This is owned and handled by us, but handed to the RenderQueue, so we
 	// basically promise that this stays valid for one frame.
 	FieldsToDraw fields_to_draw_;
+	TerrainMesh terrain_mesh_;
+	float frame_prep_ms_ = 0.f;
 
 	View view_;
 	Vector2i last_mouse_pos_;
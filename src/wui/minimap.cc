@@ -41,6 +41,7 @@ MiniMap::View::View(UI::Panel& parent,
    : UI::Panel(&parent, x, y, 10, 10),
      ibase_(ibase),
      pic_map_spot_(g_gr->images().get("images/wui/overlays/map_spot.png")),
+     minimap_renderer_(ibase.egbase()),
      minimap_layers_(flags),
      minimap_type_(type) {
 }
@@ -50,9 +51,9 @@ void MiniMap::View::set_view(const Rectf& view_area) {
 }
 
 void MiniMap::View::draw(RenderTarget& dst) {
-	minimap_image_ = draw_minimap(ibase_.egbase(), ibase_.get_player(), view_area_, *minimap_type_,
-	                              *minimap_layers_ | MiniMapLayer::ViewWindow);
-	dst.blit(Vector2i::zero(), minimap_image_.get());
+	dst.blit(Vector2i::zero(),
+	         minimap_renderer_.draw(ibase_.get_player(), view_area_, *minimap_type_,
+	                                *minimap_layers_ | MiniMapLayer::ViewWindow));
 }
 
 /*
@@ -90,9 +90,9 @@ private:
 		Rectf view_area_;
 		const Image* pic_map_spot_;
 
-		// This needs to be owned since it will be rendered by the RenderQueue
-		// later, so it must be valid for the whole frame.
-		std::unique_ptr<Texture> minimap_image_;
+		// Owns the texture, which needs to be valid for the whole frame since it
+		// will be rendered by the RenderQueue later.
+		MiniMapRenderer minimap_renderer_;
 
 	public:
 		MiniMapLayer* minimap_layers_;
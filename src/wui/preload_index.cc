@@ -0,0 +1,226 @@
+/*
+ * Copyright (C) 2019 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#include "wui/preload_index.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "base/log.h"
+#include "io/fileread.h"
+#include "io/filesystem/layered_filesystem.h"
+#include "io/filewrite.h"
+#include "logic/filesystem_constants.h"
+
+namespace {
+
+// Preloading mostly waits for the disk and unpacks zip files, so a few threads
+// are plenty. One core is left to the main thread, which keeps the menu going.
+constexpr unsigned kMaxThreads = 4;
+
+unsigned nr_threads() {
+	const unsigned nr_cores = std::thread::hardware_concurrency();
+	return std::max(1u, std::min(kMaxThreads, nr_cores > 1 ? nr_cores - 1 : 1u));
+}
+
+void write_64(FileWrite* fw, const uint64_t value) {
+	fw->unsigned_32(value >> 32);
+	fw->unsigned_32(value & 0xffffffff);
+}
+
+uint64_t read_64(FileRead* fr) {
+	const uint64_t high = fr->unsigned_32();
+	return (high << 32) | fr->unsigned_32();
+}
+
+}  // namespace
+
+PreloadIndex::PreloadIndex(const std::string& name,
+                           const uint32_t version,
+                           const PreloadFunction& preload)
+   : filename_(kCacheDir + "/" + name + ".idx"), version_(version), preload_(preload) {
+	read();
+}
+
+PreloadIndex::~PreloadIndex() {
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		quit_ = true;
+	}
+	work_available_.notify_all();
+	for (std::thread& thread : threads_) {
+		thread.join();
+	}
+	if (changed_) {
+		write();
+	}
+}
+
+void PreloadIndex::list(const std::vector<std::string>& filenames, const ResultFunction& result) {
+	// Looking at the files is what is left of a listing once everything is in
+	// the index, so it is done before taking the lock.
+	std::vector<Job> jobs;
+	for (const std::string& filename : filenames) {
+		jobs.push_back(Job{filename, g_fs->file_stamp(filename)});
+	}
+
+	std::vector<std::pair<std::string, Entry>> indexed;
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		listed_ = std::set<std::string>(filenames.begin(), filenames.end());
+		queue_.clear();
+		finished_.clear();
+		for (const Job& job : jobs) {
+			const auto entry = entries_.find(job.filename);
+			if (entry != entries_.end() && entry->second.stamp == job.stamp) {
+				indexed.push_back(*entry);
+			} else if (!running_.count(job.filename)) {
+				// Files that are being preloaded already end up in 'finished_'.
+				queue_.push_back(job);
+			}
+		}
+		if (!queue_.empty() && threads_.empty()) {
+			for (unsigned i = nr_threads(); i > 0; --i) {
+				threads_.push_back(std::thread(&PreloadIndex::work, this));
+			}
+		}
+	}
+	work_available_.notify_all();
+
+	for (const auto& entry : indexed) {
+		result(entry.first, entry.second.record, entry.second.error);
+	}
+}
+
+bool PreloadIndex::collect(const ResultFunction& result) {
+	std::vector<std::pair<std::string, Entry>> finished;
+	bool pending = false;
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		for (const std::string& filename : finished_) {
+			finished.push_back(*entries_.find(filename));
+		}
+		finished_.clear();
+		pending = !queue_.empty() || std::any_of(running_.begin(), running_.end(),
+		                                         [this](const std::string& filename) {
+			                                         return listed_.count(filename) > 0;
+		                                         });
+		// Save what we have as soon as the listing is complete, and not only when
+		// the menu closes.
+		if (!pending && running_.empty() && changed_) {
+			write();
+		}
+	}
+
+	for (const auto& entry : finished) {
+		result(entry.first, entry.second.record, entry.second.error);
+	}
+	return pending;
+}
+
+void PreloadIndex::work() {
+	std::unique_lock<std::mutex> lock(mutex_);
+	for (;;) {
+		work_available_.wait(lock, [this] { return quit_ || !queue_.empty(); });
+		if (quit_) {
+			return;
+		}
+		const Job job = queue_.front();
+		queue_.pop_front();
+		running_.insert(job.filename);
+		lock.unlock();
+
+		Entry entry;
+		entry.stamp = job.stamp;
+		try {
+			entry.record = preload_(job.filename);
+		} catch (const std::exception& e) {
+			entry.error = e.what();
+		} catch (...) {
+			entry.error = "unknown error";
+		}
+
+		lock.lock();
+		running_.erase(job.filename);
+		entries_[job.filename] = std::move(entry);
+		changed_ = true;
+		if (listed_.count(job.filename)) {
+			finished_.push_back(job.filename);
+		}
+	}
+}
+
+void PreloadIndex::read() {
+	FileRead fr;
+	if (!fr.try_open(*g_fs, filename_)) {
+		return;
+	}
+	try {
+		if (fr.unsigned_32() != version_) {
+			return;
+		}
+		for (uint32_t i = fr.unsigned_32(); i > 0; --i) {
+			const std::string filename = fr.string();
+			Entry& entry = entries_[filename];
+			entry.stamp.size = read_64(&fr);
+			entry.stamp.modified = read_64(&fr);
+			entry.error = fr.string();
+			for (uint32_t j = fr.unsigned_32(); j > 0; --j) {
+				const std::string key = fr.string();
+				entry.record[key] = fr.string();
+			}
+		}
+	} catch (const std::exception& e) {
+		log("Preload index %s is unusable, rebuilding it: %s\n", filename_.c_str(), e.what());
+		entries_.clear();
+	}
+}
+
+// Forgets files that have been deleted. Failing to write the index is not an
+// error, the files are preloaded again the next time then.
+void PreloadIndex::write() {
+	changed_ = false;
+	for (auto it = entries_.begin(); it != entries_.end();) {
+		if (g_fs->file_exists(it->first)) {
+			++it;
+		} else {
+			it = entries_.erase(it);
+		}
+	}
+	try {
+		g_fs->ensure_directory_exists(kCacheDir);
+		FileWrite fw;
+		fw.unsigned_32(version_);
+		fw.unsigned_32(entries_.size());
+		for (const auto& entry : entries_) {
+			fw.string(entry.first);
+			write_64(&fw, entry.second.stamp.size);
+			write_64(&fw, entry.second.stamp.modified);
+			fw.string(entry.second.error);
+			fw.unsigned_32(entry.second.record.size());
+			for (const auto& value : entry.second.record) {
+				fw.string(value.first);
+				fw.string(value.second);
+			}
+		}
+		fw.write(*g_fs, filename_);
+	} catch (const std::exception& e) {
+		log("Could not write preload index %s: %s\n", filename_.c_str(), e.what());
+	}
+}
@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2019 by the Widelands Development Team
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ */
+
+#ifndef WL_WUI_PRELOAD_INDEX_H
+#define WL_WUI_PRELOAD_INDEX_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "base/macros.h"
+#include "io/filesystem/filesystem.h"
+
+/**
+ * Remembers what preloading maps or savegames gave, so that the menus that list
+ * them only need to preload the files that are new or have changed since they
+ * were last listed. The index is kept in the cache directory of the home
+ * directory and is keyed by filename, size and modification time.
+ *
+ * Files that are not in the index are preloaded on background threads, and
+ * 'collect' hands their results to the main thread as they arrive. The preload
+ * function therefore must only use the file system and objects of its own. In
+ * particular, it must not translate anything: records are stored untranslated
+ * and are translated by the menu when it shows them.
+ */
+class PreloadIndex {
+public:
+	// What preloading a file gave, as named values.
+	using Record = std::map<std::string, std::string>;
+
+	// Preloads 'filename'. If it throws, the message is remembered instead of a
+	// record, so that broken files are not preloaded again until they change.
+	using PreloadFunction = std::function<Record(const std::string& filename)>;
+
+	// Receives the record of 'filename', or the message why it could not be
+	// preloaded, in which case the record is empty.
+	using ResultFunction = std::function<void(
+	   const std::string& filename, const Record& record, const std::string& error)>;
+
+	// 'name' is the name of the index file. Increase 'version' whenever the
+	// records that 'preload' returns change.
+	PreloadIndex(const std::string& name, uint32_t version, const PreloadFunction& preload);
+
+	// Waits for the file that is being preloaded and writes the index.
+	~PreloadIndex();
+
+	// Makes 'filenames' the current listing. Calls 'result' right away for the
+	// files that are in the index and preloads the others in the background.
+	void list(const std::vector<std::string>& filenames, const ResultFunction& result);
+
+	// Calls 'result' for the files of the current listing that have been
+	// preloaded since the last call. Returns whether any are still left.
+	bool collect(const ResultFunction& result);
+
+private:
+	struct Entry {
+		FileStamp stamp;
+		Record record;
+		std::string error;
+	};
+
+	struct Job {
+		std::string filename;
+		FileStamp stamp;
+	};
+
+	void read();
+	void write();
+	void work();
+
+	const std::string filename_;
+	const uint32_t version_;
+	const PreloadFunction preload_;
+	std::vector<std::thread> threads_;
+
+	// Everything below is protected by 'mutex_'.
+	std::mutex mutex_;
+	std::condition_variable work_available_;
+	std::map<std::string, Entry> entries_;
+	std::set<std::string> listed_;
+	std::deque<Job> queue_;
+	// Files that a thread is preloading right now.
+	std::set<std::string> running_;
+	// Files of the current listing that have been preloaded but not collected.
+	std::vector<std::string> finished_;
+	bool changed_ = false;
+	bool quit_ = false;
+
+	DISALLOW_COPY_AND_ASSIGN(PreloadIndex);
+};
+
+#endif  // end of include guard: WL_WUI_PRELOAD_INDEX_H
@@ -33,3 +33,78 @@ function test_map:test_playerslots_starting_field()
    assert_equal(map:get_field(30,10), map.player_slots[2].starting_field)
    assert_equal(map:get_field(50,10), map.player_slots[3].starting_field)
 end
+
+-- ================
+-- Bulk field query
+-- ================
+local function _count_in_lua(fields, predicate)
+   local count = 0
+   for idx, f in ipairs(fields) do
+      if predicate(f) then
+         count = count + 1
+      end
+   end
+   return count
+end
+
+function test_map:test_count_fields_whole_map()
+   assert_equal(map.width * map.height, map:count_fields())
+end
+
+function test_map:test_count_fields_region()
+   local center = map:get_field(10, 10)
+   assert_equal(#center:region(4), map:count_fields{field = center, radius = 4})
+end
+
+function test_map:test_count_fields_by_terrain()
+   local center = map:get_field(25, 32)
+   local expected = _count_in_lua(center:region(6), function(f)
+      return f.terr == "summer_meadow1" or f.terd == "summer_meadow1"
+   end)
+   assert_equal(expected,
+      map:count_fields{field = center, radius = 6, terrain = "summer_meadow1"})
+end
+
+function test_map:test_count_fields_by_owner()
+   local center = map:get_field(10, 10)
+   local unowned = _count_in_lua(center:region(8), function(f) return f.owner == nil end)
+   local by_owner = map:count_fields_by_owner{field = center, radius = 8}
+   assert_equal(unowned, by_owner[0] or 0)
+   assert_equal(by_owner[1] or 0, map:count_fields{field = center, radius = 8, owner = 1})
+end
+
+function test_map:test_find_fields_by_resource()
+   local f = map:get_field(25, 32)
+   local old_resource = f.resource
+   local old_amount = f.resource_amount
+   f.resource = "coal"
+   f.resource_amount = 5
+   local found = map:find_fields{field = f, radius = 0, resource = "coal", min_resource_amount = 5}
+   assert_equal(1, #found)
+   assert_equal(f, map:get_field(found[1] % map.width, found[1] // map.width))
+   assert_equal(0, map:count_fields{field = f, radius = 0, resource = "coal",
+      min_resource_amount = 6})
+   f.resource = old_resource
+   f.resource_amount = old_amount
+end
+
+function test_map:test_count_fields_illegal_filter()
+   assert_error("Unknown terrain", function()
+      map:count_fields{terrain = "sjdhfsjkdh"}
+   end)
+   assert_error("Illegal resource", function()
+      map:count_fields{resource = "sjdhfsjkdh"}
+   end)
+   assert_error("radius needs field", function()
+      map:count_fields{radius = 3}
+   end)
+   assert_error("radius too large", function()
+      map:count_fields{field = map:get_field(10, 10), radius = 70000}
+   end)
+   assert_error("owner too large", function()
+      map:count_fields{owner = 256}
+   end)
+   assert_error("min_resource_amount too large", function()
+      map:count_fields{resource = "coal", min_resource_amount = 256}
+   end)
+end
@@ -0,0 +1,335 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""Finds the first point where two syncstreams of the same game diverge.
+
+The syncstreams can either be given directly (*.wss dumps or *.wse excerpts),
+or this script can create them by playing the same replay with two Widelands
+binaries or configurations side by side. For that, Widelands is started with
+--replay_syncstream, which plays the replay as fast as possible, keeps the
+syncstream dump and quits at the end of the replay.
+
+The streams are hashed at checkpoints every --interval milliseconds of game
+time. The first checkpoint with different hashes is found by binary search,
+and from there both streams are compared entry by entry. The report names the
+game time, the queue command that was running and the map objects involved.
+
+Examples:
+  bisect-desync.py streams host.wss client.wss
+  bisect-desync.py replay game.wrpl 'old/widelands --datadir=old/data' \\
+      'new/widelands --datadir=new/data'
+
+Widelands needs a display. On a headless machine, run this with xvfb-run.
+"""
+
+import argparse
+import glob
+import hashlib
+import mmap
+import os
+import re
+import shlex
+import shutil
+import struct
+import subprocess
+import sys
+import tempfile
+
+# WARNING!!
+# Keep this in sync with the enum SyncEntry in src/logic/game.h
+# Entry id -> (name, struct format of the payload, field names)
+ENTRIES = {
+    0x1: ('Desync', '<i', ('player',)),
+    0x2: ('DestroyObject', '<I', ('serial',)),
+    0x3: ('ProcessRequests', '<BBI', ('type', 'index', 'serial')),
+    0x4: ('HandleActiveSupplies', '<I', ('size',)),
+    0x5: ('StartTransfer', '<II', ('target serial', 'source serial')),
+    0x6: ('RunQueue', '<II', ('duetime', 'command')),
+    0x7: ('RandomSeed', '<I', ('seed',)),
+    0x8: ('Random', '<I', ('number',)),
+    0x9: ('CmdAct', '<IB', ('serial', 'type')),
+    0xA: ('Battle', '<II', ('serial first soldier', 'serial second soldier')),
+    0xB: ('BobSetPosition', '<Ihh', ('serial', 'x', 'y')),
+}
+RUN_QUEUE = 0x6
+CMD_ACT = 0x9
+
+# Fields that hold map object serials, per entry id
+SERIAL_FIELDS = {
+    0x2: (0,),
+    0x3: (2,),
+    0x5: (0, 1),
+    0x9: (0,),
+    0xA: (0, 1),
+    0xB: (0,),
+}
+
+SRC_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', '..', 'src')
+
+
+def read_enum(path, enum_name):
+    """Returns {value: name} for a C++ enum, so that the report can show names.
+
+    Returns an empty dict if the source file can not be found.
+    """
+    try:
+        with open(path) as f:
+            source = f.read()
+    except IOError:
+        return {}
+    match = re.search(r'enum class ' + enum_name + r'\s*:[^{]*\{(.*?)\};', source, re.S)
+    if not match:
+        return {}
+    result = {}
+    value = -1
+    for line in match.group(1).split('\n'):
+        line = line.split('//')[0].strip().rstrip(',')
+        if not line:
+            continue
+        name, _, explicit = line.partition('=')
+        value = int(explicit.strip(), 0) if explicit.strip() else value + 1
+        result[value] = name.strip()
+    return result
+
+
+COMMAND_NAMES = read_enum(os.path.join(SRC_DIR, 'logic', 'queue_cmd_ids.h'), 'QueueCommandTypes')
+OBJECT_TYPES = read_enum(os.path.join(SRC_DIR, 'logic', 'map_objects', 'map_object.h'),
+                         'MapObjectType')
+
+
+class Entry:
+    """A single syncstream entry."""
+
+    def __init__(self, data, offset):
+        self.offset = offset
+        self.code = data[offset]
+        self.id = self.code >> 4
+        self.raw = bytes(data[offset + 1:offset + 1 + (self.code & 0x0F)])
+        self.values = None
+        if self.id in ENTRIES and struct.calcsize(ENTRIES[self.id][1]) == len(self.raw):
+            self.values = struct.unpack(ENTRIES[self.id][1], self.raw)
+
+    def __eq__(self, other):
+        return self.code == other.code and self.raw == other.raw
+
+    def __str__(self):
+        if self.values is None:
+            return 'Unknown entry 0x%02x: %s' % (self.code, self.raw.hex())
+        name, _, fields = ENTRIES[self.id]
+        parts = []
+        for field, value in zip(fields, self.values):
+            if self.id == RUN_QUEUE and field == 'command':
+                value = '%d (%s)' % (value, COMMAND_NAMES.get(value, '?'))
+            elif self.id == CMD_ACT and field == 'type':
+                value = '%d (%s)' % (value, OBJECT_TYPES.get(value, '?'))
+            parts.append('%s %s' % (field, value))
+        return '%s: %s' % (name, ', '.join(parts))
+
+    def serials(self):
+        if self.values is None:
+            return []
+        return [self.values[i] for i in SERIAL_FIELDS.get(self.id, ())]
+
+
+class SyncStream:
+    """A syncstream file with checkpoint hashes."""
+
+    def __init__(self, filename, interval):
+        self.filename = filename
+        with open(filename, 'rb') as f:
+            if os.fstat(f.fileno()).st_size == 0:
+                self.data = b''
+            else:
+                self.data = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+        self.start = 0
+        if filename.endswith('.wse'):
+            self.start = self._skip_excerpt_header()
+        self.interval = interval
+        # Checkpoint k is the state before the first command with duetime >= k * interval:
+        # (offset, md5 of everything before offset)
+        self.checkpoints = []
+        self._scan()
+
+    def _skip_excerpt_header(self):
+        # build id, build type, number of the desynced player; see Game::report_desync()
+        offset = 0
+        for _ in range(2):
+            length = struct.unpack_from('<I', self.data, offset)[0]
+            offset += 4 + length
+        return offset + 4
+
+    def _scan(self):
+        md5 = hashlib.md5()
+        hashed = self.start
+        offset = self.start
+        data = self.data
+        size = len(data)
+        while offset < size:
+            code = data[offset]
+            if code >> 4 == RUN_QUEUE and offset + 9 <= size:
+                duetime = struct.unpack_from('<I', data, offset + 1)[0]
+                while len(self.checkpoints) * self.interval <= duetime:
+                    md5.update(data[hashed:offset])
+                    hashed = offset
+                    self.checkpoints.append((offset, md5.hexdigest()))
+            offset += 1 + (code & 0x0F)
+        md5.update(data[hashed:size])
+        self.checkpoints.append((size, md5.hexdigest()))
+
+    def entries(self, offset):
+        while offset < len(self.data):
+            entry = Entry(self.data, offset)
+            yield entry
+            offset += 1 + len(entry.raw)
+
+
+def first_differing_checkpoint(a, b):
+    """Binary search for the first checkpoint with different hashes.
+
+    Once two streams have diverged, the hashes of all later checkpoints differ
+    as well. Returns None if the streams are identical.
+    """
+    count = min(len(a.checkpoints), len(b.checkpoints))
+    if count == 0 or a.checkpoints[count - 1][1] == b.checkpoints[count - 1][1]:
+        if len(a.checkpoints) == len(b.checkpoints):
+            return None
+        return count
+    low, high = 0, count - 1
+    while low < high:
+        mid = (low + high) // 2
+        if a.checkpoints[mid][1] == b.checkpoints[mid][1]:
+            low = mid + 1
+        else:
+            high = mid
+    return low
+
+
+class Context:
+    """What was going on in a stream right before an entry."""
+
+    def __init__(self, history):
+        self.command = None
+        self.actor = None
+        for entry in history:
+            if entry.id == RUN_QUEUE:
+                self.command = entry
+                self.actor = None
+            elif entry.id == CMD_ACT:
+                self.actor = entry
+
+
+def report(a, b, checkpoint, context_size):
+    print('Streams diverge between game time %d and %d ms.' %
+          (max(0, checkpoint - 1) * a.interval, checkpoint * a.interval))
+    start = a.checkpoints[checkpoint - 1][0] if checkpoint > 0 else a.start
+    start_b = b.checkpoints[checkpoint - 1][0] if checkpoint > 0 else b.start
+    history = []
+    index = 0
+    entries_a = a.entries(start)
+    entries_b = b.entries(start_b)
+    while True:
+        entry_a = next(entries_a, None)
+        entry_b = next(entries_b, None)
+        if entry_a is None or entry_b is None or entry_a != entry_b:
+            break
+        history.append(entry_a)
+        index += 1
+
+    context = Context(history)
+    if context.command is not None:
+        print('Command running: %s' % context.command)
+    if context.actor is not None:
+        print('Acting object:   %s' % context.actor)
+    print('\nLast %d common entries:' % min(context_size, len(history)))
+    for entry in history[-context_size:]:
+        print('  %s' % entry)
+    print('\nFirst difference (entry %d after the checkpoint):' % index)
+    for name, entry in ((a.filename, entry_a), (b.filename, entry_b)):
+        print('  %s:' % name)
+        print('    %s' % (entry if entry is not None else 'End of stream'))
+    serials = set()
+    for entry in (entry_a, entry_b, context.actor):
+        if entry is not None:
+            serials.update(entry.serials())
+    if serials:
+        print('\nMap objects involved: %s' % ', '.join(str(s) for s in sorted(serials)))
+
+
+def compare(file_a, file_b, interval, context_size):
+    a = SyncStream(file_a, interval)
+    b = SyncStream(file_b, interval)
+    checkpoint = first_differing_checkpoint(a, b)
+    if checkpoint is None:
+        print('The syncstreams are identical (%d checkpoints).' % len(a.checkpoints))
+        return 0
+    report(a, b, checkpoint, context_size)
+    return 1
+
+
+def run_replay(replay, command, workdir):
+    """Starts Widelands with a fresh home directory to play the replay."""
+    replays = os.path.join(workdir, 'replays')
+    os.makedirs(replays)
+    name = os.path.basename(replay)
+    for path in glob.glob(replay + '*'):
+        shutil.copy(path, replays)
+    args = shlex.split(command) + ['--homedir=' + workdir,
+                                   '--replay=' + os.path.join('replays', name),
+                                   '--replay_syncstream=true']
+    print('Running: %s' % ' '.join(shlex.quote(arg) for arg in args))
+    return subprocess.Popen(args, stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+
+
+def find_syncstream(workdir):
+    streams = glob.glob(os.path.join(workdir, 'replays', '*.wss'))
+    if len(streams) != 1:
+        sys.exit('Expected one syncstream in %s, found %d' % (workdir, len(streams)))
+    return streams[0]
+
+
+def main():
+    common = argparse.ArgumentParser(add_help=False)
+    common.add_argument('--interval', type=int, default=1000,
+                        help='Milliseconds of game time between checkpoints (default: 1000)')
+    common.add_argument('--context', type=int, default=10,
+                        help='Number of common entries to show before the difference')
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    subparsers = parser.add_subparsers(dest='mode')
+    streams = subparsers.add_parser('streams', parents=[common],
+                                    help='Compare two existing syncstream files')
+    streams.add_argument('stream_a')
+    streams.add_argument('stream_b')
+    replay = subparsers.add_parser('replay', parents=[common],
+                                   help='Play a replay twice and compare the streams')
+    replay.add_argument('replay', help='The .wrpl file')
+    replay.add_argument('command_a', help='Widelands command line for the first run')
+    replay.add_argument('command_b', help='Widelands command line for the second run')
+    replay.add_argument('--keep', action='store_true', help='Keep the home directories')
+    args = parser.parse_args()
+
+    if args.mode not in ('streams', 'replay'):
+        parser.print_help()
+        return 2
+    if args.interval <= 0:
+        parser.error('The interval has to be positive')
+    if args.mode == 'streams':
+        return compare(args.stream_a, args.stream_b, args.interval, args.context)
+
+    workdir = tempfile.mkdtemp(prefix='wl_bisect_')
+    try:
+        dirs = [os.path.join(workdir, 'a'), os.path.join(workdir, 'b')]
+        runs = [run_replay(args.replay, command, d)
+                for command, d in zip((args.command_a, args.command_b), dirs)]
+        for run, command in zip(runs, (args.command_a, args.command_b)):
+            if run.wait() != 0:
+                print('Warning: "%s" exited with code %d' % (command, run.returncode))
+        return compare(find_syncstream(dirs[0]), find_syncstream(dirs[1]), args.interval,
+                       args.context)
+    finally:
+        if args.keep:
+            print('Home directories kept in %s' % workdir)
+        else:
+            shutil.rmtree(workdir)
+
+
+if __name__ == '__main__':
+    sys.exit(main())